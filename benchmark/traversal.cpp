@@ -0,0 +1,148 @@
+#include "file/DummySourceFile.h"
+#include "lexer/LexicalAnalyzer.h"
+#include "parser/SyntaxAnalyzer.h"
+#include "parser/ast/visitor/IAbstractSyntaxTreeVisitor.h"
+#include "parser/ast/visitor/StaticAstVisitor.h"
+#include <chrono>
+#include <format>
+#include <iostream>
+#include <string>
+
+using namespace mylang;
+
+// Compares a full traversal with IAbstractSyntaxTreeVisitor
+// against the same traversal with StaticAstVisitor.
+//
+// Usage: traversal_benchmark [number of functions] [number of repetitions]
+
+// Counts every node with virtual calls.
+class VirtualNodeCounter : public IAbstractSyntaxTreeVisitor
+{
+public:
+    virtual void Visit(Module* node) override { ++count; VisitEach(node->Declarations()); }
+
+    virtual void Visit(Parameter* node) override { ++count; }
+    virtual void Visit(FuncDecl* node) override { ++count; VisitEach(node->Parameters()); node->Body()->Accept(this); }
+    virtual void Visit(StructDecl* node) override { ++count; }
+
+    virtual void Visit(CompoundStmt* node) override { ++count; VisitEach(node->Statements()); }
+    virtual void Visit(IfStmt* node) override { ++count; VisitIfPresent(node->Condition()); VisitIfPresent(node->ThenBranch()); VisitIfPresent(node->ElseBranch()); }
+    virtual void Visit(ForStmt* node) override { ++count; VisitIfPresent(node->Initializer()); VisitIfPresent(node->Condition()); VisitIfPresent(node->IncrementExpr()); node->Body()->Accept(this); }
+    virtual void Visit(WhileStmt* node) override { ++count; node->Condition()->Accept(this); node->Body()->Accept(this); }
+    virtual void Visit(JumpStmt* node) override { ++count; VisitIfPresent(node->ReturnValueExpr()); }
+    virtual void Visit(VarDeclStmt* node) override { ++count; VisitIfPresent(node->Initializer()); }
+    virtual void Visit(ExprStmt* node) override { ++count; node->Expression()->Accept(this); }
+
+    virtual void Visit(VarInitExpr* node) override { ++count; node->Expression()->Accept(this); }
+    virtual void Visit(VarInitList* node) override { ++count; VisitEach(node->InitializerList()); }
+
+    virtual void Visit(ArrayAccessExpr* node) override { ++count; node->Operand()->Accept(this); node->Index()->Accept(this); }
+    virtual void Visit(BinaryExpr* node) override { ++count; node->LeftHandOperand()->Accept(this); node->RightHandOperand()->Accept(this); }
+    virtual void Visit(FuncCallExpr* node) override { ++count; node->Function()->Accept(this); VisitEach(node->ArgumentList()); }
+    virtual void Visit(Identifier* node) override { ++count; }
+    virtual void Visit(Literal* node) override { ++count; }
+    virtual void Visit(MemberAccessExpr* node) override { ++count; node->Struct()->Accept(this); }
+    virtual void Visit(PostfixExpr* node) override { ++count; node->Operand()->Accept(this); }
+    virtual void Visit(PrefixExpr* node) override { ++count; node->Operand()->Accept(this); }
+
+    size_t count = 0;
+
+private:
+    void VisitIfPresent(IAbstractSyntaxTree* node)
+    {
+        if (node)
+        {
+            node->Accept(this);
+        }
+    }
+
+    template<typename T>
+    void VisitEach(const std::vector<T*>& nodes)
+    {
+        for (auto node : nodes)
+        {
+            node->Accept(this);
+        }
+    }
+};
+
+// Counts every node with a switch.
+class StaticNodeCounter : public StaticAstVisitor<StaticNodeCounter>
+{
+public:
+    void Dispatch(IAbstractSyntaxTree* node)
+    {
+        ++count;
+        StaticAstVisitor<StaticNodeCounter>::Dispatch(node);
+    }
+
+    size_t count = 0;
+};
+
+std::string GenerateSourceCode(int num_functions)
+{
+    auto source_code = std::string("module bench;\npoint: struct = { x: i32; y: i32; }\n");
+    for (int i = 0; i < num_functions; ++i)
+    {
+        source_code += std::format(
+            "func{}: func = (a: i32[8], p: out point) -> i32 {{\n"
+            "    sum: i32 = 0;\n"
+            "    for (i: i32 = 0; i < 8; ++i) {{\n"
+            "        if (a[i] / 2 == 0) {{ sum += a[i] * {} + p.x; }} else {{ sum -= -a[i] + p.y * (i + 1); }}\n"
+            "    }}\n"
+            "    while (sum > 100) {{ sum = sum / 2 - 1; p.x++; }}\n"
+            "    return sum + func{}(a, p) * 3;\n"
+            "}}\n",
+            i, i, i
+        );
+    }
+    return source_code;
+}
+
+template<typename Function>
+double MeasureMilliseconds(int num_repetitions, Function function)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_repetitions; ++i)
+    {
+        function();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+int main(int argc, char** argv)
+{
+    auto num_functions = argc > 1 ? std::stoi(argv[1]) : 20000;
+    auto num_repetitions = argc > 2 ? std::stoi(argv[2]) : 20;
+
+    auto source_file = std::make_unique<DummySourceFile>(GenerateSourceCode(num_functions));
+    auto lexer = std::make_unique<LexicalAnalyzer>(std::move(source_file));
+    auto ast = SyntaxAnalyzer(std::move(lexer)).GenerateAST();
+
+    auto virtual_count = size_t{0};
+    auto virtual_ms = MeasureMilliseconds(num_repetitions, [&]() {
+        auto counter = VirtualNodeCounter();
+        ast->Accept(&counter);
+        virtual_count = counter.count;
+    });
+
+    auto static_count = size_t{0};
+    auto static_ms = MeasureMilliseconds(num_repetitions, [&]() {
+        auto counter = StaticNodeCounter();
+        counter.Dispatch(ast.get());
+        static_count = counter.count;
+    });
+
+    if (virtual_count != static_count)
+    {
+        std::cerr << std::format("node count mismatch: {} (virtual) vs {} (static)\n", virtual_count, static_count);
+        return 1;
+    }
+
+    auto num_visits = static_cast<double>(static_count) * num_repetitions;
+    std::cout << std::format("{} nodes, {} repetitions\n", static_count, num_repetitions);
+    std::cout << std::format("virtual visitor: {:.2f} ms ({:.2f} ns/node)\n", virtual_ms, virtual_ms * 1e6 / num_visits);
+    std::cout << std::format("static visitor:  {:.2f} ms ({:.2f} ns/node)\n", static_ms, static_ms * 1e6 / num_visits);
+    return 0;
+}
@@ -4,12 +4,17 @@
 #include "file/IOutputFileFactory.h"
 #include "parser/ProgramEnvironment.h"
 #include "parser/ast/visitor/IAbstractSyntaxTreeVisitor.h"
+#include "parser/ast/visitor/AstWalker.h"
 #include <map>
 
 namespace mylang
 {
 
-class CodeGenerator : public IAbstractSyntaxTreeVisitor
+// Translates modules into C++ header and source files.
+//
+// The tree is walked with an explicit stack (see AstWalker),
+// so a deeply nested statement can't overflow the native stack.
+class CodeGenerator : public IAbstractSyntaxTreeVisitor, private AstWalker<CodeGenerator>
 {
 public:
     CodeGenerator(
@@ -24,20 +29,47 @@ public:
     IOutputFile* GetFile(const std::string& file_name);
     void CloseAllFiles();
 
+    // Generates the module, which is the only kind of node that can be generated on its own.
     virtual void Visit(Module* node) override;
-    virtual void Visit(FuncDecl* node) override;
-    virtual void Visit(StructDecl* node) override;
-    virtual void Visit(CompoundStmt* node) override;
-    virtual void Visit(VarDeclStmt* node) override;
-    virtual void Visit(VarInitExpr* node) override;
-    virtual void Visit(VarInitList* node) override;
-    virtual void Visit(ExprStmt* node) override;
-    virtual void Visit(IfStmt* node) override;
-    virtual void Visit(ForStmt* node) override;
-    virtual void Visit(WhileStmt* node) override;
-    virtual void Visit(JumpStmt* node) override;
 
 private:
+    friend class AstWalker<CodeGenerator>;
+
+    using AstWalker<CodeGenerator>::PreVisit;
+    using AstWalker<CodeGenerator>::PostVisit;
+    using AstWalker<CodeGenerator>::BeforeChild;
+    using AstWalker<CodeGenerator>::AfterChild;
+
+    bool PreVisit(FuncDecl* node);
+    bool BeforeChild(FuncDecl* node, IAbstractSyntaxTree* child);
+    bool PreVisit(StructDecl* node);
+
+    bool PreVisit(CompoundStmt* node);
+    void PostVisit(CompoundStmt* node);
+
+    bool PreVisit(VarDeclStmt* node);
+    void PostVisit(VarDeclStmt* node);
+
+    bool PreVisit(VarInitExpr* node);
+    bool PreVisit(VarInitList* node);
+    bool BeforeChild(VarInitList* node, IAbstractSyntaxTree* child);
+    void PostVisit(VarInitList* node);
+
+    bool PreVisit(ExprStmt* node);
+
+    bool PreVisit(IfStmt* node);
+    bool BeforeChild(IfStmt* node, IAbstractSyntaxTree* child);
+
+    bool PreVisit(ForStmt* node);
+    bool BeforeChild(ForStmt* node, IAbstractSyntaxTree* child);
+    void AfterChild(ForStmt* node, IAbstractSyntaxTree* child);
+    void PostVisit(ForStmt* node);
+
+    bool PreVisit(WhileStmt* node);
+    bool BeforeChild(WhileStmt* node, IAbstractSyntaxTree* child);
+
+    bool PreVisit(JumpStmt* node);
+
     // Returns false if the module declaration was seen before.
     // This becomes true right after visiting a Module node with unseen module name.
     // Look at InitializeModuleFiles() for what happens if this returns false.
@@ -0,0 +1,57 @@
+#ifndef MYLANG_TASK_GRAPH_H
+#define MYLANG_TASK_GRAPH_H
+
+#include "common/ThreadPool.h"
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace mylang
+{
+
+// Tasks that run on a thread pool as soon as the tasks they depend on have finished.
+//
+// The pool runs tasks in FIFO order, so a task is only submitted once it is ready,
+// instead of holding a worker while its dependencies are still running.
+// A task can only depend on tasks added before it, so the graph can't have a cycle.
+class TaskGraph
+{
+public:
+    using TaskId = size_t;
+
+    // Throws std::invalid_argument if a dependency wasn't added before the task.
+    TaskId AddTask(std::function<void()> task, const std::vector<TaskId>& dependencies = {});
+
+    size_t NumTasks() const;
+
+    // Runs every task and returns once all of them have finished.
+    //
+    // If a task throws, the tasks that depend on it, directly or not, are skipped,
+    // while the others still run. Then 'on_error' is called with the first task
+    // that failed in the order they were added, and its exception is rethrown,
+    // no matter which task failed first.
+    void Run(ThreadPool& thread_pool, const std::function<void(TaskId)>& on_error = nullptr);
+
+private:
+    struct Node
+    {
+        std::function<void()> task;
+        std::vector<TaskId> dependents;
+        size_t num_dependencies;
+    };
+
+    // Progress of a Run(), shared with the tasks in flight.
+    struct RunState;
+
+    // Submits the task, or skips it if one of its dependencies failed.
+    void Start(TaskId id, const std::shared_ptr<RunState>& state, ThreadPool& thread_pool);
+
+    // Starts the dependents that were only waiting for this task.
+    void Finish(TaskId id, bool has_succeeded, const std::shared_ptr<RunState>& state, ThreadPool& thread_pool);
+
+    std::vector<Node> m_nodes;
+};
+
+} // namespace mylang
+
+#endif // MYLANG_TASK_GRAPH_H
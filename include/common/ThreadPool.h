@@ -0,0 +1,110 @@
+#ifndef MYLANG_THREAD_POOL_H
+#define MYLANG_THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace mylang
+{
+
+// A fixed number of worker threads that execute submitted tasks in FIFO order.
+//
+// Tasks are allowed to submit subtasks to the same pool and wait for them.
+// Wait() runs pending tasks on the calling thread instead of blocking,
+// so nested parallelism cannot deadlock even with a single worker.
+//
+// Within a task, Wait() only runs the tasks it submitted, directly or through its subtasks.
+// Otherwise a task waiting for its subtasks could start an unrelated task on top of its stack,
+// which could do the same, so the stack would grow with the number of pending tasks.
+// A thread outside the pool runs any pending task while it waits.
+// When there is nothing it may run, Wait() blocks until a task is submitted or finished.
+class ThreadPool
+{
+public:
+    // A pool with zero threads behaves like a pool with one thread.
+    ThreadPool(unsigned int num_threads);
+    ~ThreadPool();
+
+    unsigned int NumThreads() const;
+
+    // Schedule a callable and return a future for its result.
+    // Exceptions thrown by the callable are stored in the future
+    // and rethrown by Wait() or std::future<T>::get().
+    template<typename F>
+    auto Submit(F&& task) -> std::future<std::invoke_result_t<std::decay_t<F>>>;
+
+    // Returns the result of the future once it is ready.
+    // While waiting, the calling thread keeps executing the pending tasks it may run.
+    // The future should come from Submit() of this pool.
+    template<typename T>
+    T Wait(std::future<T>& future);
+
+private:
+    // A submitted task, and where it was submitted.
+    struct TaskNode
+    {
+        std::function<void()> run;
+
+        // The task that submitted this one, if any.
+        std::shared_ptr<TaskNode> parent;
+
+        // Whether a thread has taken the task to execute it.
+        bool is_taken = false;
+
+        // Pending tasks submitted by this task or its subtasks, in order of submission.
+        // Tasks taken by another thread are dropped once they reach the front.
+        std::deque<std::shared_ptr<TaskNode>> pending_descendants;
+    };
+
+    // Queue a task submitted by the task running on the calling thread (if any).
+    void Enqueue(std::function<void()> task);
+
+    // Main routine of each worker thread.
+    void RunWorker();
+
+    // Execute pending tasks that the calling thread may execute (see Wait())
+    // until 'is_ready' returns true, and block while there are none.
+    void WaitUntil(const std::function<bool()>& is_ready);
+
+    // Take the first pending task submitted below 'origin', or any pending task if it is nullptr.
+    // Returns nullptr if there is none. Expects the mutex to be held.
+    std::shared_ptr<TaskNode> TakePendingTask(TaskNode* origin);
+
+    // Wake the threads blocked in WaitUntil(), so that they check again. Expects the mutex to be held.
+    void NotifyWaitingThreads();
+
+    // Execute the task on the calling thread, as the origin of what it submits.
+    void RunTask(std::shared_ptr<TaskNode> task);
+
+    // The task running on the calling thread, or nullptr outside of any task.
+    static std::shared_ptr<TaskNode>& CurrentTask();
+
+    std::vector<std::thread> m_workers;
+
+    // Every pending task, in order of submission.
+    // Tasks taken by a waiting thread are dropped once they reach the front.
+    std::deque<std::shared_ptr<TaskNode>> m_tasks;
+
+    std::mutex m_mutex;
+    std::condition_variable m_task_available;
+
+    // Notified when a task is submitted or finished, while some thread waits.
+    std::condition_variable m_state_changed;
+    size_t m_num_waiting_threads = 0;
+
+    bool m_is_stopping = false;
+};
+
+// Implementation file
+#include "common/ThreadPool.tpp"
+
+} // namespace mylang
+
+#endif // MYLANG_THREAD_POOL_H
@@ -0,0 +1,22 @@
+template<typename F>
+auto ThreadPool::Submit(F&& task) -> std::future<std::invoke_result_t<std::decay_t<F>>>
+{
+    using ResultType = std::invoke_result_t<std::decay_t<F>>;
+
+    // std::function requires a copyable target,
+    // so the move-only packaged_task is shared instead.
+    auto packaged_task = std::make_shared<std::packaged_task<ResultType()>>(std::forward<F>(task));
+    auto future = packaged_task->get_future();
+    Enqueue([packaged_task](){ (*packaged_task)(); });
+
+    return future;
+}
+
+template<typename T>
+T ThreadPool::Wait(std::future<T>& future)
+{
+    using namespace std::chrono_literals;
+
+    WaitUntil([&](){ return future.wait_for(0s) == std::future_status::ready; });
+    return future.get();
+}
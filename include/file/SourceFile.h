@@ -4,6 +4,7 @@
 #include "file/ISourceFile.h"
 #include <filesystem>
 #include <fstream>
+#include <string>
 
 namespace mylang
 {
@@ -25,6 +26,10 @@ private:
     char m_current_char;
 };
 
+// Reads the whole content of a file at once.
+// Throws std::runtime_error if it fails to open the file.
+std::string ReadSourceCode(const std::filesystem::path& path);
+
 } // namespace mylang
 
 #endif // MYLANG_SOURCE_FILE_H
@@ -0,0 +1,34 @@
+#ifndef MYLANG_TOKEN_BUFFER_CURSOR_H
+#define MYLANG_TOKEN_BUFFER_CURSOR_H
+
+#include "common/IStream.h"
+#include "lexer/Token.h"
+#include <memory>
+#include <vector>
+
+namespace mylang
+{
+
+// Replays a range [begin, end) of an already lexed token buffer as a stream.
+// Once the range is exhausted, an EOF token is returned repeatedly.
+//
+// The buffer is never modified, so several cursors
+// can read the same buffer from different threads.
+class TokenBufferCursor : public IStream<Token>
+{
+public:
+    TokenBufferCursor(std::shared_ptr<const std::vector<Token>> tokens, size_t begin, size_t end);
+
+    virtual bool IsFinished() const override;
+    virtual Token GetNext() override;
+
+private:
+    std::shared_ptr<const std::vector<Token>> m_tokens;
+    size_t m_current_token_ind;
+    size_t m_end_token_ind;
+    bool m_is_finished = false;
+};
+
+} // namespace mylang
+
+#endif // MYLANG_TOKEN_BUFFER_CURSOR_H
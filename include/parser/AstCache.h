@@ -0,0 +1,42 @@
+#ifndef MYLANG_AST_CACHE_H
+#define MYLANG_AST_CACHE_H
+
+#include "parser/ast/IAbstractSyntaxTree.h"
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+namespace mylang
+{
+
+// Keeps parsed modules in a directory,
+// so that an unchanged source file doesn't need to be parsed again.
+//
+// Each input path has a single entry, named after a hash of the path,
+// so editing a file replaces its entry instead of adding another one.
+// Each entry also records the format version, the compiler version,
+// the whole source code, and a checksum of the encoded tree,
+// so a stale, colliding, or corrupted entry is never used.
+// Such entries are simply overwritten by the next Store().
+class AstCache
+{
+public:
+    AstCache(const std::filesystem::path& cache_directory);
+
+    // Returns nullptr if there is no valid entry for the source code read from the path.
+    std::shared_ptr<IAbstractSyntaxTree> Load(const std::filesystem::path& source_path, std::string_view source_code) const;
+
+    // Replaces the entry of the path.
+    // Failing to write an entry is not an error,
+    // since the cache only saves time.
+    void Store(const std::filesystem::path& source_path, std::string_view source_code, IAbstractSyntaxTree* ast) const;
+
+    std::filesystem::path EntryPath(const std::filesystem::path& source_path) const;
+
+private:
+    std::filesystem::path m_cache_directory;
+};
+
+} // namespace mylang
+
+#endif // MYLANG_AST_CACHE_H
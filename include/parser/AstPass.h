@@ -0,0 +1,66 @@
+#ifndef MYLANG_AST_PASS_H
+#define MYLANG_AST_PASS_H
+
+#include "parser/ast/IAbstractSyntaxTree.h"
+#include <bitset>
+#include <initializer_list>
+#include <string_view>
+#include <vector>
+
+namespace mylang
+{
+
+using AstNodeKindSet = std::bitset<NumAstNodeKinds>;
+
+AstNodeKindSet MakeAstNodeKindSet(std::initializer_list<AstNodeKind> kinds);
+
+// Receives the nodes of a tree on the way down and on the way up.
+class IAstNodeHooks
+{
+public:
+    virtual ~IAstNodeHooks() = default;
+
+    virtual void Enter(IAbstractSyntaxTree* node) = 0;
+    virtual void Leave(IAbstractSyntaxTree* node) = 0;
+};
+
+// An analysis run by PassManager.
+//
+// Most passes only care about nodes of a few kinds (see Interests()),
+// so PassManager runs many of them in a single walk over each tree,
+// calling Enter() and Leave() of each pass for the nodes it is interested in.
+//
+// A pass that needs to walk the tree in its own way (e.g., TypeChecker
+// visits the children of a node before checking the node itself) is a walker.
+// PassManager calls its Walk() instead, and the other passes
+// are run through the hooks that the walker calls around every child.
+class AstPass
+{
+public:
+    virtual ~AstPass() = default;
+
+    // Unique name, which other passes refer to in Prerequisites().
+    virtual std::string_view Name() const = 0;
+
+    // Names of the passes that should have finished on every module
+    // before this pass starts on any of them.
+    virtual std::vector<std::string_view> Prerequisites() const;
+
+    // Kinds of nodes that Enter() and Leave() are called with.
+    virtual AstNodeKindSet Interests() const;
+
+    virtual void Enter(IAbstractSyntaxTree* node);
+    virtual void Leave(IAbstractSyntaxTree* node);
+
+    // A walker should call hooks->Enter() and hooks->Leave()
+    // around every node it visits below the root.
+    virtual bool IsWalker() const;
+    virtual void Walk(IAbstractSyntaxTree* root, IAstNodeHooks* hooks);
+
+    // Called once the pass has run on every module.
+    virtual void Finish();
+};
+
+} // namespace mylang
+
+#endif // MYLANG_AST_PASS_H
@@ -0,0 +1,29 @@
+#ifndef MYLANG_AST_SERIALIZER_H
+#define MYLANG_AST_SERIALIZER_H
+
+#include "parser/ast/IAbstractSyntaxTree.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace mylang
+{
+
+// Version of the binary format written by SerializeAst().
+// Bump this whenever the encoding of any node, token, or type changes.
+const uint32_t AstFormatVersion = 2;
+
+// Encode a module into a compact binary form.
+// Every token is kept as-is, including its source positions,
+// so the decoded tree reports errors at the same locations.
+// Neither side recurses, so trees of any depth the parser accepts can be encoded.
+std::string SerializeAst(IAbstractSyntaxTree* ast);
+
+// Decode a module written by SerializeAst() into a new arena.
+// Throws std::runtime_error if the data is truncated or malformed.
+std::shared_ptr<IAbstractSyntaxTree> DeserializeAst(std::string_view data);
+
+} // namespace mylang
+
+#endif // MYLANG_AST_SERIALIZER_H
@@ -0,0 +1,74 @@
+#ifndef MYLANG_DECL_BOUNDARY_SCANNER_H
+#define MYLANG_DECL_BOUNDARY_SCANNER_H
+
+#include "lexer/Token.h"
+#include <vector>
+
+namespace mylang
+{
+
+// Finds where each top-level declaration starts in a token sequence
+// without actually parsing it, so that declarations can be parsed independently.
+//
+// A declaration starts with either "export" or "identifier : func|struct"
+// outside of any bracket pair. On a well-formed module, no other token
+// sequence can match these patterns, since types never start with "func" or "struct".
+//
+// The result is only a hint. If the tokens do not look like
+// "module-decl module-import* global-decl*", the scanner gives up (IsValid() == false)
+// and the caller is expected to fall back to ordinary sequential parsing,
+// which reports the exact syntax error.
+class DeclBoundaryScanner
+{
+public:
+    // Inspect the next token of the sequence.
+    // Tokens should be fed in order, excluding the EOF token.
+    void Feed(TokenType type);
+
+    // Returns false if the token sequence cannot be split.
+    bool IsValid() const;
+
+    // Number of tokens fed so far.
+    size_t NumTokens() const;
+
+    // Index of the first token after "module-decl module-import*".
+    size_t HeaderEnd() const;
+
+    // Indices of the first token of each declaration, in source order.
+    //
+    // Note: a declaration starting with an identifier is detected
+    //       only after two more tokens have been fed.
+    const std::vector<size_t>& DeclStarts() const;
+
+private:
+    enum class State
+    {
+        ModuleKeyword, // expecting "module"
+        ModuleName, // expecting identifier
+        ModuleSemicolon, // expecting ";"
+        ImportOrDecl, // expecting "import" or the first declaration
+        ImportExport, // expecting "export" or identifier after "import"
+        ImportName, // expecting identifier
+        ImportSemicolon, // expecting ";"
+        Declarations, // everything after the module header
+        Invalid
+    };
+
+    void FeedHeader(TokenType type);
+    void FeedDeclaration(TokenType type);
+
+    State m_state = State::ModuleKeyword;
+    size_t m_num_tokens = 0;
+    size_t m_header_end = 0;
+    int m_bracket_depth = 0;
+
+    // Recent tokens seen on bracket depth 0, used to detect "identifier : func|struct".
+    // An entry is (token index, token type).
+    std::vector<std::pair<size_t, TokenType>> m_recent_top_level_tokens;
+
+    std::vector<size_t> m_decl_starts;
+};
+
+} // namespace mylang
+
+#endif // MYLANG_DECL_BOUNDARY_SCANNER_H
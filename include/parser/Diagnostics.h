@@ -0,0 +1,116 @@
+#ifndef MYLANG_DIAGNOSTICS_H
+#define MYLANG_DIAGNOSTICS_H
+
+#include "file/SourcePos.h"
+#include <concepts>
+#include <string>
+#include <vector>
+
+namespace mylang
+{
+
+// What went wrong, which decides how the arguments of a diagnostic are formatted.
+enum class DiagnosticCode
+{
+    InvalidType,                // who, type
+    TypeMismatch,               // who, expected type, given type
+    ImplicitConversion,         // source type, destination type
+    DimensionMismatch,          // lhs type, rhs type
+    InitializerTooLarge,        // initializer type, variable type
+    MixedInitializerTypes,      // expected type, element type
+    MixedInitializerDimensions,
+    NonArrayAccess,             // operand type
+    UnexpectedArray,            // who, type
+    UnexpectedNonNumeric,       // who, type
+    InvalidOperation,           // lhs type, operator, rhs type
+    AssignmentToRvalue,
+    ArgumentCount,              // number of parameters, number of arguments
+    UnexpectedRvalue,           // who
+    NotCallable,                // type
+    UndefinedSymbol,            // name
+    TypeNameAsExpression,       // name
+    NotAStruct,                 // type
+    UnknownMember,              // struct type, member name
+};
+
+// An error found by semantic analysis, kept as its code and arguments
+// so that the message is only formatted when someone reads it.
+struct Diagnostic
+{
+    DiagnosticCode code;
+    SourcePos where;
+    std::vector<std::string> args;
+
+    // The message alone, e.g., "\"i32\" is not a struct type".
+    std::string Message() const;
+
+    // Same as the message of a SemanticError,
+    // e.g., "[Semantic Error][Ln 1, Col 2] \"i32\" is not a struct type".
+    std::string ToString() const;
+};
+
+// Describes the subject of a diagnostic, e.g., "parameter \"x\"",
+// either as a fixed string or as a callable that builds it.
+// The callable is only called if the diagnostic is reported,
+// so checks that pass never format anything.
+//
+// It refers to the callable instead of owning it, like std::string_view,
+// so it should only be passed down to the function that may report.
+class LazyMessage
+{
+public:
+    LazyMessage(const char* message);
+
+    template<typename F>
+        requires std::invocable<const F&> && (!std::convertible_to<const F&, const char*>)
+    LazyMessage(const F& builder);
+
+    std::string Build() const;
+
+private:
+    const char* m_message = nullptr;
+    const void* m_builder = nullptr;
+    std::string (*m_build)(const void* builder) = nullptr;
+};
+
+// Collects diagnostics instead of throwing them,
+// so that analysis can go on and report as many errors as it finds.
+//
+// Once 'error_limit' errors are kept (0 means no limit), the rest are only counted,
+// and passes are expected to stop at the next convenient point (see IsLimitReached()).
+// A sink isn't thread-safe, so concurrent tasks should report to sinks of their own
+// and merge them afterwards.
+class DiagnosticSink
+{
+public:
+    DiagnosticSink(size_t error_limit = 0);
+
+    void Report(DiagnosticCode code, const SourcePos& where, std::vector<std::string> args = {});
+
+    bool HasErrors() const;
+    bool IsLimitReached() const;
+    size_t ErrorLimit() const;
+
+    // Every error reported so far, including the ones dropped over the limit.
+    size_t NumReported() const;
+
+    // The errors that were kept, in the order they were reported.
+    const std::vector<Diagnostic>& Diagnostics() const;
+
+    // Reports the diagnostics of 'other' after the ones of this sink, within the limit.
+    void Merge(DiagnosticSink&& other);
+
+    void Clear();
+
+private:
+    size_t m_error_limit;
+    size_t m_num_dropped = 0;
+    std::vector<Diagnostic> m_diagnostics;
+};
+
+// Implementation file
+#include "parser/Diagnostics.tpp"
+
+} // namespace mylang
+
+#endif // MYLANG_DIAGNOSTICS_H
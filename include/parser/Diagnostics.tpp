@@ -0,0 +1,6 @@
+template<typename F>
+    requires std::invocable<const F&> && (!std::convertible_to<const F&, const char*>)
+LazyMessage::LazyMessage(const F& builder)
+    : m_builder(&builder)
+    , m_build([](const void* builder) -> std::string { return (*static_cast<const F*>(builder))(); })
+{}
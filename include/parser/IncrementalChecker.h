@@ -0,0 +1,221 @@
+#ifndef MYLANG_INCREMENTAL_CHECKER_H
+#define MYLANG_INCREMENTAL_CHECKER_H
+
+#include "parser/ast/IAbstractSyntaxTree.h"
+#include "parser/ast/SideTable.h"
+#include "parser/ast/visitor/TypeChecker.h"
+#include "parser/Diagnostics.h"
+#include "parser/NameBindings.h"
+#include "parser/ProgramEnvironment.h"
+#include <compare>
+#include <exception>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mylang
+{
+
+class GlobalDecl;
+class Identifier;
+class MemberAccessExpr;
+class StructType;
+
+// Keeps the result of semantic analysis for a set of source files,
+// so that it can be updated after some of them change without starting over.
+//
+// Each top-level declaration is bound and checked on its own,
+// and the checker records what it read from the other declarations:
+// 1. the global names it looked up, and the declaration each one resolved to
+// 2. the declarations whose signature its check depends on,
+//    i.e., the functions and structs it refers to and the structs whose members it reads
+//
+// After files change, the global symbols are scanned again, which only visits
+// top-level declarations. Then a declaration is bound and checked again only if
+// it changed structurally, a name it looked up resolves to another declaration,
+// or the signature of a declaration it depends on changed.
+// A declaration is matched with its last result by its module and its name.
+// If it was only copied to another position (e.g., moved by IncrementalParser),
+// its result is moved to the copy, along with its diagnostics.
+// Since a signature is computed from the bound types of a declaration,
+// a change is propagated to its dependents only if it changed what they can see.
+//
+// The other declarations keep their results. If a declaration they refer to
+// was parsed again without changing its signature, their bindings are moved to it.
+//
+// The diagnostics and types are the same as checking every module from scratch,
+// with NameBinder and a TypeChecker that reports to a sink.
+class IncrementalChecker
+{
+public:
+    // Sets the tree of a file, which adds a file if 'file_index' is NumFiles().
+    // The tree is kept until it is replaced, and it is checked by the next Check().
+    void UpdateFile(size_t file_index, std::shared_ptr<IAbstractSyntaxTree> ast);
+
+    size_t NumFiles() const;
+
+    // Brings the results up to date with the files.
+    //
+    // Throws like checking from scratch would: an error of the global symbols
+    // (e.g., a symbol defined twice or an unknown module imported) is thrown
+    // before anything is checked, and the results are left as they were.
+    // The first redefinition of a local symbol in the order of the files is thrown
+    // once everything else is checked, and its declaration is bound again next time.
+    void Check();
+
+    // Errors of the file found by the last Check(), in the order a walk over it reports them.
+    std::vector<Diagnostic> Diagnostics(size_t file_index) const;
+
+    // Results of a declaration of the last Check().
+    // Throws std::out_of_range if the declaration wasn't checked.
+    const NameBindings& Bindings(const GlobalDecl* decl) const;
+    const SideTable<ExprTrait>& ExprTraits(const GlobalDecl* decl) const;
+
+    // Number of declarations that the last Check() checked, or whose results it kept.
+    size_t NumCheckedDecls() const;
+    size_t NumReusedDecls() const;
+
+private:
+    // A global declaration, named by its module and its name.
+    struct SymbolKey
+    {
+        std::string module_name;
+        std::string name;
+
+        auto operator<=>(const SymbolKey&) const = default;
+    };
+
+    // A global declaration of the files, as the last scan found it.
+    struct SymbolEntry
+    {
+        const GlobalDecl* decl;
+        AstNodeId decl_id;
+        bool is_public;
+
+        // Signature of the declaration, once it is bound (see ComputeSignature()).
+        uint64_t signature = 0;
+    };
+
+    // A global name looked up from a module, and what it resolved to.
+    // Only a struct can be bound to a struct type, so that is part of the result.
+    struct Lookup
+    {
+        std::string name;
+        std::optional<SymbolKey> symbol;
+        bool is_struct;
+
+        bool operator==(const Lookup&) const = default;
+    };
+
+    // The result of a top-level declaration, along with what it depends on.
+    struct DeclState
+    {
+        DeclState(GlobalDecl* decl, const SymbolKey& key, std::shared_ptr<IAbstractSyntaxTree> file)
+            : decl(decl), key(key), file(std::move(file))
+        {
+        }
+
+        GlobalDecl* decl;
+        SymbolKey key;
+
+        // The tree of the declaration, which keeps it alive until it is compared with the next one.
+        std::shared_ptr<IAbstractSyntaxTree> file;
+
+        NameBindings bindings;
+        SideTable<ExprTrait> expr_traits;
+        DiagnosticSink diagnostics;
+
+        // The error that stopped binding the declaration, if any.
+        std::exception_ptr binding_error;
+
+        // Hash of the bound types others can see (see ComputeSignature()).
+        uint64_t signature = 0;
+
+        // Global names looked up from the module.
+        std::vector<Lookup> lookups;
+
+        // Declarations whose signature the check depends on, with the signature it saw.
+        std::vector<std::pair<SymbolKey, uint64_t>> dependencies;
+
+        // Where the bindings point to other global declarations.
+        std::vector<std::pair<const Identifier*, SymbolKey>> identifier_sites;
+        std::vector<std::pair<const StructType*, SymbolKey>> struct_type_sites;
+        std::vector<std::pair<const MemberAccessExpr*, SymbolKey>> member_sites;
+    };
+
+    // Global symbols of a scan, and what the declarations in it resolve to.
+    struct SymbolIndex
+    {
+        std::map<SymbolKey, SymbolEntry> symbols;
+        std::unordered_map<const Decl*, SymbolKey> keys;
+
+        // Import directives of each module, in the order symbols are searched.
+        std::map<std::string, std::vector<std::pair<std::string, bool>>> imports;
+    };
+
+    // Builds a new environment from the files, and indexes its global symbols.
+    // Throws if the global symbols are invalid.
+    void ScanGlobalSymbols(ProgramEnvironment& environment, SymbolIndex& index) const;
+
+    // The state of a declaration of the last Check(), or std::out_of_range if it wasn't checked.
+    const DeclState& FindDeclState(const GlobalDecl* decl) const;
+
+    // Declarations that looked up one of the names or depend on a declaration with one of them.
+    std::vector<SymbolKey> FindDependents(const std::set<std::string>& names) const;
+
+    // Moves the result of the declaration to 'decl', if it is the same declaration
+    // at another position, i.e., it is structurally equal and every position in it
+    // is shifted the same way. Otherwise, returns false and leaves the state as it was.
+    bool Relocate(DeclState& state, GlobalDecl* decl, std::shared_ptr<IAbstractSyntaxTree> file) const;
+
+    // Looks up the name from the module.
+    Lookup Resolve(
+        const ProgramEnvironment& environment,
+        const SymbolIndex& index,
+        std::string_view module_name,
+        std::string_view name
+    ) const;
+
+    // Whether any name the declaration looked up resolves differently with the index.
+    bool HasResolutionChanged(const DeclState& state, const ProgramEnvironment& environment, const SymbolIndex& index) const;
+
+    // Points the bindings of the declaration to the current declarations of their symbols.
+    void MoveBindings(DeclState& state, const SymbolIndex& index) const;
+
+    // Binds the declaration again, forgetting its last result, and computes its signature.
+    void Bind(DeclState& state, const ProgramEnvironment& environment, const SymbolIndex& index);
+
+    // Checks the bound declaration and records what it depends on.
+    // Every signature in the index should be up to date.
+    void TypeCheck(DeclState& state, const ProgramEnvironment& environment, const SymbolIndex& index);
+
+    // Hash of the parts of the declaration that its dependents can see:
+    // its kind and type, the members of a struct,
+    // and the declaration each struct type in them was bound to.
+    uint64_t ComputeSignature(const DeclState& state, const SymbolIndex& index) const;
+
+    // Keeps track of the declarations that depend on each name.
+    void AddDependents(const DeclState& state);
+    void RemoveDependents(const DeclState& state);
+
+    std::vector<std::shared_ptr<IAbstractSyntaxTree>> m_files;
+
+    // State of the last Check().
+    std::unique_ptr<ProgramEnvironment> m_environment;
+    SymbolIndex m_index;
+    std::map<SymbolKey, DeclState> m_decls;
+
+    // Declarations that looked up a name, or depend on a declaration with the name.
+    std::unordered_map<std::string, std::vector<SymbolKey>> m_dependents;
+
+    size_t m_num_checked_decls = 0;
+    size_t m_num_reused_decls = 0;
+};
+
+} // namespace mylang
+
+#endif // MYLANG_INCREMENTAL_CHECKER_H
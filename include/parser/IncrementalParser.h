@@ -0,0 +1,116 @@
+#ifndef MYLANG_INCREMENTAL_PARSER_H
+#define MYLANG_INCREMENTAL_PARSER_H
+
+#include "parser/ast/AstArena.h"
+#include "parser/ast/IAbstractSyntaxTree.h"
+#include "parser/ast/globdecl/GlobalDecl.h"
+#include "parser/routine/IParseRoutine.h"
+#include "lexer/Token.h"
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace mylang
+{
+
+// Replaces 'length' characters starting at 'offset' with 'replacement'.
+// Offsets are byte offsets into the source code.
+struct TextEdit
+{
+    size_t offset;
+    size_t length;
+    std::string replacement;
+};
+
+// Keeps the tokens and the tree of a source file,
+// so that they can be updated after each edit without starting over.
+//
+// Only the tokens around an edit are lexed again. Lexing restarts
+// from a token whose lookahead can't reach the edited range,
+// and stops as soon as the new tokens line up with the old ones.
+//
+// Then each top-level declaration made of unchanged tokens is reused.
+// If the edit moved it, it is copied with shifted source positions.
+// Only the declarations that overlap the changed tokens are parsed again.
+//
+// The resulting tree and any reported error are identical to a fresh parse,
+// since every malformed input is handed over to SyntaxAnalyzer.
+class IncrementalParser
+{
+public:
+    IncrementalParser(std::string source_code, int max_nesting_depth = DefaultMaxNestingDepth);
+
+    // Parse the whole source code.
+    // Throws exactly like SyntaxAnalyzer::GenerateAST().
+    std::shared_ptr<IAbstractSyntaxTree> Parse();
+
+    // Apply the edit and return the updated tree.
+    // Throws exactly like SyntaxAnalyzer::GenerateAST() on the edited source code,
+    // or std::out_of_range if the edit doesn't fit in the source code.
+    // The edit is applied even if an error is thrown.
+    std::shared_ptr<IAbstractSyntaxTree> ApplyEdit(const TextEdit& edit);
+
+    const std::string& SourceCode() const;
+
+    // Number of declarations in the last tree that were reused or parsed.
+    size_t NumReusedDecls() const;
+    size_t NumParsedDecls() const;
+
+private:
+    // A top-level declaration spanning tokens [begin, end).
+    // Each declaration has its own arena, so that it can be reused
+    // by a later tree while the rest is thrown away.
+    struct DeclEntry
+    {
+        size_t begin;
+        size_t end;
+        GlobalDecl* decl;
+        std::shared_ptr<AstArena> arena;
+    };
+
+    // Tokens in [begin, end) were lexed again by an edit,
+    // and they replaced the old tokens in [begin, old_end).
+    // Positions of the tokens after them have been shifted from old_edit_end to new_edit_end.
+    struct TokenWindow
+    {
+        size_t begin;
+        size_t end;
+        size_t old_end;
+        SourcePos old_edit_end;
+        SourcePos new_edit_end;
+    };
+
+    // Apply the edit to the source code and re-lex the tokens affected by it.
+    // Returns nothing if the new tokens contain a lexical error.
+    std::optional<TokenWindow> TryUpdateTokens(const TextEdit& edit);
+
+    // Build a tree from the current tokens, reusing declarations outside of the window.
+    // Returns nullptr if any part of the tokens failed to parse.
+    std::shared_ptr<IAbstractSyntaxTree> TryUpdateTree(const TokenWindow& window);
+
+    // Returns the declaration that spanned tokens [begin, end) in the last tree, if any.
+    const DeclEntry* FindDecl(size_t begin, size_t end) const;
+
+    // Parse with SyntaxAnalyzer and forget every reusable part.
+    std::shared_ptr<IAbstractSyntaxTree> ParseFromScratch();
+
+    std::string m_source_code;
+    int m_max_nesting_depth;
+
+    // Tokens of the current source code, and the offset of each token.
+    // Note: the last token is EOF.
+    std::shared_ptr<std::vector<Token>> m_tokens;
+    std::vector<size_t> m_token_offsets;
+    std::vector<DeclEntry> m_decls;
+
+    // False if the tokens and declarations above don't match the source code.
+    bool m_is_up_to_date = false;
+
+    size_t m_num_reused_decls = 0;
+    size_t m_num_parsed_decls = 0;
+};
+
+} // namespace mylang
+
+#endif // MYLANG_INCREMENTAL_PARSER_H
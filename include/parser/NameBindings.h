@@ -0,0 +1,59 @@
+#ifndef MYLANG_NAME_BINDINGS_H
+#define MYLANG_NAME_BINDINGS_H
+
+#include "parser/ast/SideTable.h"
+#include "parser/type/Type.h"
+
+namespace mylang
+{
+
+class Decl;
+class StructDecl;
+class Identifier;
+class MemberAccessExpr;
+
+// A member access resolved to the member it reads.
+struct MemberBinding
+{
+    const StructDecl* struct_decl;
+
+    // Index into StructDecl::Members().
+    size_t member_index;
+};
+
+// Declarations that names in the trees refer to, resolved once
+// so that later passes don't need to search scopes again.
+//
+// Identifiers are bound by NameBinder, along with every struct type
+// used in a declaration (see StructType::Declaration()).
+// A member access can only be bound once the type of its operand is known,
+// so TypeChecker binds it.
+class NameBindings
+{
+public:
+    // 'declaration' is nullptr if nothing with the name is visible.
+    void BindIdentifier(const Identifier* node, const Decl* declaration);
+    void BindMember(const MemberAccessExpr* node, const MemberBinding& binding);
+
+    // Returns nullptr if the identifier wasn't bound to any declaration.
+    const Decl* FindDeclaration(const Identifier* node) const;
+
+    // Returns nullptr if the member access wasn't bound.
+    const MemberBinding* FindMember(const MemberAccessExpr* node) const;
+
+    // Moves the bindings of 'other' into this one (see SideTable::Merge()).
+    void Merge(NameBindings&& other);
+
+private:
+    SideTable<const Decl*> m_declarations;
+    SideTable<MemberBinding> m_members;
+};
+
+// Whether every struct type the type mentions, including the ones
+// in the parameters and the return type of a function type,
+// was bound to a struct declaration.
+bool AreStructTypesBound(const Type& type);
+
+} // namespace mylang
+
+#endif // MYLANG_NAME_BINDINGS_H
@@ -0,0 +1,71 @@
+#ifndef MYLANG_PASS_MANAGER_H
+#define MYLANG_PASS_MANAGER_H
+
+#include "parser/AstPass.h"
+#include <chrono>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+namespace mylang
+{
+
+// Runs analyses over a set of modules with as few walks over each tree as possible.
+//
+// Passes are grouped into walks. A pass runs in a later walk than its prerequisites,
+// since they should have finished on every module first. Each walk has at most one walker.
+// A pass that isn't a walker runs in the latest walk its dependents allow,
+// so that it joins the walk of a walker (e.g., TypeChecker) instead of adding one.
+//
+// If no pass of a walk is a walker, the tree is walked by PassManager itself,
+// skipping subtrees that can't contain a node any of the passes is interested in.
+class PassManager
+{
+public:
+    struct PassTiming
+    {
+        std::string_view name;
+        std::chrono::nanoseconds elapsed;
+    };
+
+    // The pass should outlive the manager.
+    // Throws std::invalid_argument if another pass has the same name.
+    void AddPass(AstPass& pass);
+
+    // Lets passes added here require a pass that has already finished elsewhere,
+    // e.g., in another manager that ran on every module before this one is used on a few of them.
+    void AddFinishedPass(std::string_view name);
+
+    // Runs every pass on every module.
+    // Passes of a walk are finished before the next walk starts.
+    // Throws std::invalid_argument if a prerequisite is missing or circular.
+    // If a pass throws, 'on_error' is called with the index of the module
+    // and the exception is rethrown.
+    void Run(const std::vector<IAbstractSyntaxTree*>& modules, const std::function<void(size_t)>& on_error = nullptr);
+
+    // Measures the time spent in each pass from the next Run() on.
+    // It is off by default, since the clock would be read around every call of a pass.
+    void EnableTimings();
+
+    // Names of the passes in each walk, in the order the walks run.
+    // Throws like Run().
+    std::vector<std::vector<std::string_view>> Schedule() const;
+
+    // Time spent in each pass by the last Run(), in the order they were added,
+    // followed by the time spent walking the trees ("tree walk").
+    // Every time is zero unless timings are enabled.
+    const std::vector<PassTiming>& Timings() const;
+
+private:
+    // Returns the walk of each pass, in the order they were added.
+    std::vector<size_t> AssignWalks() const;
+
+    std::vector<AstPass*> m_passes;
+    std::vector<std::string_view> m_finished_passes;
+    std::vector<PassTiming> m_timings;
+    bool m_should_time_passes = false;
+};
+
+} // namespace mylang
+
+#endif // MYLANG_PASS_MANAGER_H
@@ -3,12 +3,24 @@
 
 #include "parser/ast/Module.h"
 #include "parser/SymbolTable.h"
-#include <map>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 namespace mylang
 {
 
+// Dense ID of a logical module, given in the order modules are first declared.
+// Passes hold on to it to reach the module's information without looking up its name.
+using ModuleHandle = uint32_t;
+
+// An import directive whose module has been looked up.
+struct ResolvedImport
+{
+    ModuleHandle module;
+    bool should_export;
+};
+
 // ModuleInfo is used to aggregate declarations and import directives for a logical module.
 //
 // Note that a ModuleInfo instance corresponds to a single logical module,
@@ -21,8 +33,16 @@ namespace mylang
 // file4: "module c; ..."
 struct ModuleInfo
 {
+    std::string_view name;
     std::set<ModuleImportInfo> import_list;
     SymbolTable local_symbol_table;
+
+    // Same as 'import_list', resolved by ValidateModuleDependency() or BuildExportIndex().
+    std::vector<ResolvedImport> resolved_imports;
+
+    // Public symbols of other modules that are visible through the import directives,
+    // each mapped to the one that is found first (see ProgramEnvironment::BuildExportIndex()).
+    std::unordered_map<std::string_view, Symbol> imported_symbols;
 };
 
 // Manages symbol table for each module and provide
@@ -34,17 +54,51 @@ public:
     // In case of multiple files implementing a single logical module,
     // the first AddModuleDeclaration() will create a new symbol table
     // and the follosing invocations will simply append import directives.
-    void AddModuleDeclaration(const Module* module);
+    //
+    // Returns the handle of the module, which is the same for every file of it.
+    ModuleHandle AddModuleDeclaration(const Module* module);
+
+    // Returns the handle of a module with specified name.
+    // If a module doesn't exist, an exception will be thrown.
+    ModuleHandle GetModuleHandle(std::string_view name) const;
 
-    // Throws an exception when a module tries to import a non-existing module.
-    // If nothing happens, all of the import direcitves are valid.
+    // Same as GetModuleHandle(), but returns nothing instead of throwing.
+    std::optional<ModuleHandle> TryGetModuleHandle(std::string_view name) const;
+
+    // Throws a SemanticError when a module tries to import a non-existing module.
+    // If nothing happens, all of the import direcitves are valid,
+    // and the export index is built as in BuildExportIndex().
     void ValidateModuleDependency();
 
+    // Collects the symbols each module imports into its ModuleInfo,
+    // so that FindSymbol() doesn't have to search the imported modules.
+    //
+    // The index is dropped when a module declaration or a public symbol is added,
+    // and FindSymbol() falls back to searching until it is built again.
+    // Throws a SemanticError if a module imports a non-existing module,
+    // in which case the index stays dropped and 'resolved_imports' is left unchanged.
+    void BuildExportIndex();
+
+    // Once every global symbol is scanned, the symbol tables are only read,
+    // so passes can look symbols up from several threads at once.
+    // Adding a module or a symbol, opening or closing a scope,
+    // and rebuilding the export index throw an exception from then on.
+    // Note: passes keep their local scopes to themselves (see NameBinder).
+    void Freeze();
+    bool IsFrozen() const;
+
     // Wrapper functions for SymbolTable::OpenScope() and CloseScope().
+    void OpenScope(ModuleHandle context_module);
+    void CloseScope(ModuleHandle context_module);
     void OpenScope(std::string_view context_module_name);
     void CloseScope(std::string_view context_module_name);
 
     // Wrapper function for SymbolTable::AddSymbol().
+    void AddSymbol(
+        ModuleHandle context_module,
+        Decl* declaration,
+        bool is_public
+    );
     void AddSymbol(
         std::string_view context_module_name,
         Decl* declaration,
@@ -60,14 +114,32 @@ public:
     //
     // If we fail to find a symbol, an exception will be thrown.
     Symbol FindSymbol(
+        ModuleHandle context_module,
+        std::string_view symbol_name
+    ) const;
+    Symbol FindSymbol(
+        std::string_view context_module_name,
+        std::string_view symbol_name
+    ) const;
+
+    // Same as FindSymbol(), but returns nothing instead of throwing,
+    // which is much cheaper for callers that expect to miss (e.g., validating types).
+    std::optional<Symbol> TryFindSymbol(
+        ModuleHandle context_module,
+        std::string_view symbol_name
+    ) const;
+    std::optional<Symbol> TryFindSymbol(
         std::string_view context_module_name,
         std::string_view symbol_name
     ) const;
 
-    // Returns a ModuleInfo instance for a module with specified name.
+    // Returns a ModuleInfo instance for a module with specified handle or name.
     // The const version is used in FindSymbol().
     //
     // If a module doesn't exist, an exception will be thrown.
+    // Note: the reference may be invalidated by AddModuleDeclaration().
+    ModuleInfo& GetModuleInfo(ModuleHandle handle);
+    const ModuleInfo& GetModuleInfo(ModuleHandle handle) const;
     ModuleInfo& GetModuleInfo(std::string_view name);
     const ModuleInfo& GetModuleInfo(std::string_view name) const;
 
@@ -97,8 +169,34 @@ private:
         std::set<std::string_view>& visited_modules
     ) const;
 
-    // Maps a module name to its corresponding ModuleInfo instance.
-    std::map<std::string_view, ModuleInfo> m_modules;
+    // Resolves the import directives of every module into 'resolved_imports'.
+    // Throws a SemanticError without changing any of them if a module imports a non-existing module.
+    void ResolveImports();
+
+    // Adds the public symbols of the module and of the modules it exports
+    // to 'imported_symbols', unless a symbol with the same name is already there.
+    //
+    // Modules are visited in the same order as FindImportedSymbol() does,
+    // so the symbol that comes first is the one it would have found.
+    void CollectImportedSymbols(
+        ModuleHandle imported_module,
+        std::vector<bool>& visited_modules,
+        std::unordered_map<std::string_view, Symbol>& imported_symbols
+    ) const;
+
+    // ModuleInfo instances indexed by their handles.
+    std::vector<ModuleInfo> m_modules;
+
+    // Maps a module name to its handle.
+    std::unordered_map<std::string_view, ModuleHandle> m_module_handles;
+
+    // Throws an exception if the environment was frozen.
+    void ValidateNotFrozen() const;
+
+    // Whether 'imported_symbols' of every module is up to date.
+    bool m_has_export_index = false;
+
+    bool m_is_frozen = false;
 };
 
 } // namespace mylang
@@ -0,0 +1,111 @@
+#ifndef MYLANG_RESUMABLE_PARSER_H
+#define MYLANG_RESUMABLE_PARSER_H
+
+#include "parser/ast/AstArena.h"
+#include "parser/ast/Module.h"
+#include "parser/ast/globdecl/GlobalDecl.h"
+#include "parser/routine/IParseRoutine.h"
+#include "lexer/Token.h"
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <vector>
+
+namespace mylang
+{
+
+// Parses a module whose tokens become available over time (e.g., read from a pipe).
+//
+// The parser is a coroutine that suspends whenever it runs out of tokens,
+// and resumes when the next token is fed. Each top-level declaration is parsed
+// as soon as the next one is known to start, so parsing overlaps with reading the input.
+//
+// The resulting tree and any reported error are identical to the sequential parser,
+// since malformed inputs are handed over to it once the input is over.
+class ResumableParser
+{
+public:
+    ResumableParser(int max_nesting_depth = DefaultMaxNestingDepth);
+
+    // The coroutine refers to the parser, so it can't be copied or moved.
+    ResumableParser(const ResumableParser&) = delete;
+    ResumableParser& operator=(const ResumableParser&) = delete;
+
+    // Hand over the next token, and parse every declaration it completes.
+    // Tokens should be fed in order, up to and including the EOF token.
+    void Feed(Token token);
+
+    // End the input with an error raised while reading the next token (e.g., a lexical error).
+    // Result() rethrows it if the sequential parser would have read that token.
+    void Fail(std::exception_ptr error);
+
+    // True once the EOF token or an error has been fed.
+    bool IsFinished() const;
+
+    // Number of top-level declarations parsed so far.
+    size_t NumParsedDecls() const;
+
+    // Returns the tree after the input is over.
+    // Throws exactly like SyntaxAnalyzer::GenerateAST() on the same input,
+    // or std::logic_error if the input is not over yet.
+    std::shared_ptr<IAbstractSyntaxTree> Result();
+
+private:
+    // Owns the coroutine frame of Run().
+    class Routine
+    {
+    public:
+        struct promise_type
+        {
+            Routine get_return_object();
+
+            // Nothing runs until the first token is fed.
+            std::suspend_always initial_suspend() noexcept;
+
+            // The frame is kept until Routine is destroyed.
+            std::suspend_always final_suspend() noexcept;
+
+            void return_void();
+            void unhandled_exception();
+
+            std::exception_ptr exception;
+        };
+
+        Routine(std::coroutine_handle<promise_type> handle);
+        Routine(Routine&& other) noexcept;
+        ~Routine();
+
+        // Run until the coroutine suspends again. Does nothing once it is done.
+        void Resume();
+
+        // Rethrow an unexpected exception that escaped the coroutine, if any.
+        void RethrowIfFailed() const;
+
+    private:
+        std::coroutine_handle<promise_type> m_handle;
+    };
+
+    // Parse declarations as they are completed.
+    // Finishes early if anything fails, leaving m_ast empty.
+    Routine Run();
+
+    bool TryParseDecl(size_t begin, size_t end, size_t header_end);
+
+    int m_max_nesting_depth;
+    std::shared_ptr<AstArena> m_arena;
+
+    std::shared_ptr<std::vector<Token>> m_tokens;
+    std::exception_ptr m_pending_error;
+    bool m_is_input_over = false;
+
+    Module* m_header = nullptr;
+    std::vector<GlobalDecl*> m_declarations;
+    Module* m_ast = nullptr;
+
+    // Declared last, so that the coroutine is destroyed first.
+    Routine m_routine;
+};
+
+} // namespace mylang
+
+#endif // MYLANG_RESUMABLE_PARSER_H
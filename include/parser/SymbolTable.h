@@ -5,6 +5,8 @@
 #include <memory>
 #include <vector>
 #include <optional>
+#include <string_view>
+#include <unordered_map>
 
 namespace mylang
 {
@@ -33,6 +35,8 @@ public:
     // When there are several entries with identical name,
     // the one with higher scope level will be selected.
     // If there were no matches, an empty optional will be returned.
+    //
+    // Takes constant time regardless of the number of visible symbols.
     std::optional<Symbol> FindSymbol(std::string_view name) const;
 
     // Returns all symbols declared with "export" keyword.
@@ -50,7 +54,14 @@ private:
     int m_current_scope_level = 0;
 
     // A stack-based data structure where TOS comes at the back.
+    // It also serves as the undo log of m_symbol_index,
+    // since CloseScope() removes exactly the symbols at the top.
     std::vector<Symbol> m_symbols;
+
+    // Maps a symbol name to the positions of the symbols with that name in m_symbols,
+    // in declaration order, so the visible one (if any) comes at the back.
+    // Names are owned by the declarations.
+    std::unordered_map<std::string_view, std::vector<size_t>> m_symbol_index;
 };
 
 } // namespace mylang
@@ -2,8 +2,11 @@
 #define MYLANG_SYNTAX_ANALYZER_H
 
 #include "common/BufferedStream.h"
+#include "common/ThreadPool.h"
 #include "parser/routine/ModuleParser.h"
+#include <exception>
 #include <memory>
+#include <vector>
 
 namespace mylang
 {
@@ -12,15 +15,63 @@ namespace mylang
 class SyntaxAnalyzer
 {
 public:
-    SyntaxAnalyzer(std::unique_ptr<IStream<Token>>&& lexer);
+    // Expressions and statements nested deeper than max_nesting_depth
+    // are reported as a syntax error instead of being parsed.
+    SyntaxAnalyzer(std::unique_ptr<IStream<Token>>&& lexer, int max_nesting_depth = DefaultMaxNestingDepth);
 
+    // The returned tree keeps every node alive
+    // by sharing the ownership of the arena they were created in.
+    //
+    // Tokens are read one by one and fed to a ResumableParser,
+    // which parses each declaration as soon as it is complete.
     std::shared_ptr<IAbstractSyntaxTree> GenerateAST();
 
+    // Same as GenerateAST(), but top-level declarations are parsed concurrently.
+    //
+    // The whole token stream is read in advance and split on declaration boundaries.
+    // Each declaration is then parsed by its own parser instance,
+    // reading the shared token buffer through a separate cursor.
+    //
+    // The resulting tree and any reported error are identical to GenerateAST(),
+    // since malformed inputs are handed over to the sequential parser.
+    std::shared_ptr<IAbstractSyntaxTree> GenerateAST(ThreadPool& thread_pool);
+
 private:
     std::shared_ptr<BufferedStream<Token>> m_lexer;
-    std::unique_ptr<ModuleParser> m_parser;
+    std::shared_ptr<AstArena> m_arena;
+    int m_max_nesting_depth;
 };
 
+// Parse the whole token buffer with a single recursive descent parser,
+// which reports the exact error of a malformed input.
+// If the parser reads past the last token, 'pending_error' is rethrown (if any),
+// so that an error raised while reading tokens in advance is observed at exactly the same point.
+std::shared_ptr<IAbstractSyntaxTree> ParseSequentially(
+    std::shared_ptr<const std::vector<Token>> tokens,
+    std::exception_ptr pending_error,
+    int max_nesting_depth
+);
+
+// Parse tokens in range [begin, end) as a module header (i.e., a module without declarations).
+// Returns nullptr unless the range is exactly one valid module header.
+Module* TryParseModuleHeader(
+    std::shared_ptr<const std::vector<Token>> tokens,
+    size_t begin,
+    size_t end,
+    std::shared_ptr<AstArena> arena,
+    int max_nesting_depth
+);
+
+// Parse tokens in range [begin, end) as a single global declaration.
+// Returns nullptr unless the range is exactly one valid declaration.
+GlobalDecl* TryParseGlobalDecl(
+    std::shared_ptr<const std::vector<Token>> tokens,
+    size_t begin,
+    size_t end,
+    std::shared_ptr<AstArena> arena,
+    int max_nesting_depth
+);
+
 } // namespace mylang
 
 #endif // MYLANG_SYNTAX_ANALYZER_H
@@ -78,6 +78,25 @@ private:
     std::string m_message;
 };
 
+// This error occurs when expressions or statements are nested
+// deeper than the parser's limit (e.g., "((((((...))))))").
+//
+// Unlike other errors, it is propagated without being wrapped
+// in PatternMismatchError, since the pattern stack would be
+// as deep as the nesting itself.
+class NestingLimitError : public ParseRoutineError
+{
+public:
+    NestingLimitError(const Token& token, int max_nesting_depth);
+
+    virtual const SourcePos& Location() const override;
+    virtual std::string_view Description() const override;
+
+private:
+    SourcePos m_location;
+    std::string m_message;
+};
+
 class LeftoverTokenError : public ParseRoutineError
 {
 public:
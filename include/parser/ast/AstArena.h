@@ -0,0 +1,68 @@
+#ifndef MYLANG_AST_ARENA_H
+#define MYLANG_AST_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace mylang
+{
+
+// Size of each memory block.
+// A larger request gets its own block.
+const size_t DefaultAstArenaBlockSize = 64 * 1024;
+
+// Owns every node of abstract syntax trees generated from a single source file.
+//
+// Nodes are constructed in large memory blocks with a bump pointer
+// and refer to their children with raw pointers, so creating a node
+// doesn't require a separate heap allocation or a reference count.
+//
+// When the arena is destroyed, nodes are destroyed in reverse order
+// of creation (i.e., without recursion) and the blocks are released at once.
+class AstArena
+{
+public:
+    // A small block size suits an arena that only holds a few nodes.
+    AstArena(size_t block_size = DefaultAstArenaBlockSize);
+    ~AstArena();
+
+    AstArena(const AstArena&) = delete;
+    AstArena& operator=(const AstArena&) = delete;
+
+    // Construct a node of type T in this arena.
+    // The node is valid until the arena is destroyed.
+    template<typename T, typename... Args>
+    T* Create(Args&&... args);
+
+    // Keep another arena alive until this arena is destroyed.
+    // This is required if nodes of this arena refer to the other arena's nodes.
+    void Retain(std::shared_ptr<AstArena> other);
+
+    // Total number of bytes occupied by nodes.
+    size_t NumBytesUsed() const;
+
+private:
+    // Returns uninitialized memory with the given size and alignment.
+    void* Allocate(size_t size, size_t alignment);
+
+    size_t m_block_size;
+    std::vector<std::unique_ptr<std::byte[]>> m_blocks;
+    std::byte* m_current = nullptr;
+    size_t m_num_bytes_left = 0;
+    size_t m_num_bytes_used = 0;
+
+    // Destructor of each node, in order of creation.
+    std::vector<std::pair<void*, void(*)(void*)>> m_destructors;
+
+    std::vector<std::shared_ptr<AstArena>> m_retained_arenas;
+};
+
+// Implementation file
+#include "parser/ast/AstArena.tpp"
+
+} // namespace mylang
+
+#endif // MYLANG_AST_ARENA_H
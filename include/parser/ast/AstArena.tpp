@@ -0,0 +1,17 @@
+template<typename T, typename... Args>
+T* AstArena::Create(Args&&... args)
+{
+    auto memory = Allocate(sizeof(T), alignof(T));
+
+    // Reserve the slot of the destructor before constructing the node,
+    // so that growing the vector can't throw after the node exists.
+    // Note: the slot is found by index since the constructor may create other nodes.
+    // If the constructor throws, the slot is left as a no-op and the memory is simply left unused.
+    auto slot = m_destructors.size();
+    m_destructors.emplace_back(nullptr, [](void*){});
+
+    auto node = new (memory) T(std::forward<Args>(args)...);
+    m_destructors[slot] = {node, [](void* node){ static_cast<T*>(node)->~T(); }};
+
+    return node;
+}
\ No newline at end of file
@@ -0,0 +1,152 @@
+#ifndef MYLANG_FLAT_AST_H
+#define MYLANG_FLAT_AST_H
+
+#include "lexer/Token.h"
+#include "parser/ast/Module.h"
+#include "parser/ast/globdecl/StructDecl.h"
+#include "parser/type/Type.h"
+#include "parser/type/base/FuncType.h"
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace mylang
+{
+
+class IAbstractSyntaxTree;
+
+// One for each concrete node class of the tree representation.
+enum class FlatNodeKind : uint8_t
+{
+    Module,
+
+    Parameter,
+    FuncDecl,
+    StructDecl,
+
+    CompoundStmt,
+    IfStmt,
+    ForStmt,
+    WhileStmt,
+    JumpStmt,
+    VarDeclStmt,
+    ExprStmt,
+
+    VarInitExpr,
+    VarInitList,
+
+    ArrayAccessExpr,
+    BinaryExpr,
+    FuncCallExpr,
+    Identifier,
+    Literal,
+    MemberAccessExpr,
+    PostfixExpr,
+    PrefixExpr,
+};
+
+std::string_view FlatNodeKindName(FlatNodeKind kind);
+
+// Index of a node in FlatAst.
+using FlatNodeId = uint32_t;
+const FlatNodeId InvalidFlatNodeId = std::numeric_limits<FlatNodeId>::max();
+
+// Tells which optional children exist, since a missing child is simply skipped.
+// For example, children of ForStmt without initializer are (condition, increment, body).
+enum FlatNodeFlag : uint8_t
+{
+    FlatNodeNoFlag = 0,
+    FlatNodeExport = 1 << 0, // FuncDecl, StructDecl
+    FlatNodeHasInitializer = 1 << 1, // ForStmt, VarDeclStmt
+    FlatNodeHasCondition = 1 << 2, // ForStmt
+    FlatNodeHasIncrement = 1 << 3, // ForStmt
+    FlatNodeHasElse = 1 << 4, // IfStmt
+    FlatNodeHasReturnValue = 1 << 5, // JumpStmt
+};
+
+// Abstract syntax tree stored as a struct of arrays.
+//
+// Nodes are numbered in pre-order, so the root is always 0
+// and visiting every node is a linear scan of the arrays.
+// Each node has a kind, links to its first child, next sibling and parent,
+// the index of its main token (e.g., operator of BinaryExpr, name of FuncDecl)
+// and a kind-specific payload index:
+//
+//  - Type: FuncDecl (return type), VarDeclStmt, Literal
+//  - ParamType: Parameter
+//  - Range of MemberVariable: StructDecl
+//  - Range of ModuleImportInfo: Module
+//
+// Every node also remembers the tree node it was converted from,
+// so both representations can be used together during migration.
+class FlatAst
+{
+public:
+    // Append a new node, which should be the pre-order successor of the last node.
+    // 'previous_sibling' should be the last child of 'parent' so far, if any.
+    FlatNodeId AddNode(
+        FlatNodeKind kind,
+        FlatNodeId parent,
+        FlatNodeId previous_sibling,
+        IAbstractSyntaxTree* source
+    );
+
+    void AddFlags(FlatNodeId node, uint8_t flags);
+    void SetToken(FlatNodeId node, const Token& token);
+    void SetType(FlatNodeId node, const Type& type);
+    void SetParamType(FlatNodeId node, const ParamType& param_type);
+    void SetMembers(FlatNodeId node, const std::vector<MemberVariable>& members);
+    void SetImportList(FlatNodeId node, const std::vector<ModuleImportInfo>& import_list);
+
+    size_t NumNodes() const;
+
+    FlatNodeKind Kind(FlatNodeId node) const;
+    bool HasFlags(FlatNodeId node, uint8_t flags) const;
+    FlatNodeId Parent(FlatNodeId node) const;
+    FlatNodeId FirstChild(FlatNodeId node) const;
+    FlatNodeId NextSibling(FlatNodeId node) const;
+
+    // Returns the n-th child, or InvalidFlatNodeId if there are fewer children.
+    FlatNodeId Child(FlatNodeId node, size_t n) const;
+    size_t NumChildren(FlatNodeId node) const;
+
+    IAbstractSyntaxTree* SourceNode(FlatNodeId node) const;
+
+    // The following accessors require the node to have the corresponding payload.
+    const Token& NodeToken(FlatNodeId node) const;
+    const Type& NodeType(FlatNodeId node) const;
+    const ParamType& NodeParamType(FlatNodeId node) const;
+    std::span<const MemberVariable> Members(FlatNodeId node) const;
+    std::span<const ModuleImportInfo> ImportList(FlatNodeId node) const;
+
+private:
+    struct Range
+    {
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    // Per-node arrays
+    std::vector<FlatNodeKind> m_kinds;
+    std::vector<uint8_t> m_flags;
+    std::vector<FlatNodeId> m_parents;
+    std::vector<FlatNodeId> m_first_children;
+    std::vector<FlatNodeId> m_next_siblings;
+    std::vector<uint32_t> m_token_indices;
+    std::vector<uint32_t> m_payloads;
+    std::vector<IAbstractSyntaxTree*> m_source_nodes;
+
+    // Payload arrays
+    std::vector<Token> m_tokens;
+    std::vector<Type> m_types;
+    std::vector<ParamType> m_param_types;
+    std::vector<Range> m_ranges;
+    std::vector<MemberVariable> m_members;
+    std::vector<ModuleImportInfo> m_imports;
+};
+
+} // namespace mylang
+
+#endif // MYLANG_FLAT_AST_H
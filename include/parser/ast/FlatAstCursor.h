@@ -0,0 +1,49 @@
+#ifndef MYLANG_FLAT_AST_CURSOR_H
+#define MYLANG_FLAT_AST_CURSOR_H
+
+#include "parser/ast/FlatAst.h"
+
+namespace mylang
+{
+
+// Walks a subtree of FlatAst in pre-order without recursion.
+//
+// Since nodes are stored in pre-order, moving to the next node
+// mostly advances to the adjacent element of the arrays.
+//
+// ex)
+// for (auto cursor = FlatAstCursor(ast); cursor.IsValid(); cursor.Next())
+// {
+//     ...
+// }
+class FlatAstCursor
+{
+public:
+    // Starts from 'root', and stops after its last descendant.
+    FlatAstCursor(const FlatAst& ast, FlatNodeId root = 0);
+
+    // Returns false after every node of the subtree has been visited.
+    bool IsValid() const;
+
+    FlatNodeId Node() const;
+    FlatNodeKind Kind() const;
+
+    // Distance from the root of the walk.
+    int Depth() const;
+
+    // Move to the next node in pre-order.
+    void Next();
+
+    // Same as Next(), but the descendants of the current node are skipped.
+    void SkipChildren();
+
+private:
+    const FlatAst& m_ast;
+    FlatNodeId m_root;
+    FlatNodeId m_node;
+    int m_depth = 0;
+};
+
+} // namespace mylang
+
+#endif // MYLANG_FLAT_AST_CURSOR_H
@@ -2,23 +2,102 @@
 #define MYLANG_I_ABSTRACT_SYNTAX_TREE_H
 
 #include "file/SourcePos.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
 
 namespace mylang
 {
 
 class IAbstractSyntaxTreeVisitor;
 
+// Identifies a node among every node created by the process.
+// Each thread takes IDs from a block of its own in order of construction,
+// so the nodes of a tree (or of a declaration parsed by a task) get dense IDs
+// that can index a plain array (see SideTable), even while other threads parse.
+// IDs are 64-bit, so that a long-running process never runs out of them.
+using AstNodeId = uint64_t;
+
+// Concrete type of a node, so that it can be dispatched with a switch
+// instead of a virtual call (see StaticAstVisitor).
+enum class AstNodeKind : uint8_t
+{
+    Module,
+
+    Parameter,
+    FuncDecl,
+    StructDecl,
+
+    CompoundStmt,
+    IfStmt,
+    ForStmt,
+    WhileStmt,
+    JumpStmt,
+    VarDeclStmt,
+    ExprStmt,
+
+    VarInitExpr,
+    VarInitList,
+
+    ArrayAccessExpr,
+    BinaryExpr,
+    FuncCallExpr,
+    Identifier,
+    Literal,
+    MemberAccessExpr,
+    PostfixExpr,
+    PrefixExpr,
+};
+
+const size_t NumAstNodeKinds = static_cast<size_t>(AstNodeKind::PrefixExpr) + 1;
+
+// Name of the class of each kind, e.g., "BinaryExpr".
+std::string_view AstNodeKindName(AstNodeKind kind);
+
 class IAbstractSyntaxTree
 {
 public:
+    IAbstractSyntaxTree();
     virtual ~IAbstractSyntaxTree() = default;
 
+    // A copy would share the ID of the original node.
+    IAbstractSyntaxTree(const IAbstractSyntaxTree&) = delete;
+    IAbstractSyntaxTree& operator=(const IAbstractSyntaxTree&) = delete;
+
     // Implement visitor pattern
     virtual void Accept(IAbstractSyntaxTreeVisitor* visitor) = 0;
 
     // Returns the starting source location of this node's region.
     // For example, module declaration should return its name token location.
     virtual const SourcePos& StartPos() const = 0;
+
+    // Note: both of the Stmt and Decl parts of VarDeclStmt have the same ID.
+    AstNodeId NodeId() const;
+
+    // Defined here, so that StaticAstVisitor can inline it.
+    AstNodeKind NodeKind() const
+    {
+        return m_node_kind;
+    }
+
+    // Hash of the subtree rooted at this node, computed when the node is constructed.
+    // Source positions are ignored (see StructuralHasher and IsStructurallyEqual).
+    uint64_t StructuralHash() const;
+
+protected:
+    // Each node sets its hash from its fields and the hashes of its children.
+    void SetStructuralHash(uint64_t hash);
+
+    // Each node sets its own kind.
+    void SetNodeKind(AstNodeKind kind);
+
+    // Lets a node with two IAbstractSyntaxTree bases give both of them one ID.
+    void SetNodeId(AstNodeId id);
+
+private:
+    AstNodeId m_node_id;
+    AstNodeKind m_node_kind = AstNodeKind::Module;
+    uint64_t m_structural_hash = 0;
 };
 
 } // namespace mylang
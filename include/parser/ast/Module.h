@@ -4,7 +4,6 @@
 #include "parser/ast/IAbstractSyntaxTree.h"
 #include "lexer/Token.h"
 #include <vector>
-#include <memory>
 
 namespace mylang
 {
@@ -27,19 +26,19 @@ struct ModuleImportInfo
 class Module : public IAbstractSyntaxTree
 {
 public:
-    Module(const Token& module_name, const std::vector<ModuleImportInfo>& import_list, const std::vector<std::shared_ptr<GlobalDecl>>& global_declarations);
+    Module(const Token& module_name, const std::vector<ModuleImportInfo>& import_list, const std::vector<GlobalDecl*>& global_declarations);
 
     virtual void Accept(IAbstractSyntaxTreeVisitor* visitor) override;
     virtual const SourcePos& StartPos() const override;
 
     const Token& ModuleName() const;
     const std::vector<ModuleImportInfo>& ImportList() const;
-    const std::vector<std::shared_ptr<GlobalDecl>>& Declarations() const;
+    const std::vector<GlobalDecl*>& Declarations() const;
 
 private:
     Token m_module_name;
     std::vector<ModuleImportInfo> m_import_list;
-    std::vector<std::shared_ptr<GlobalDecl>> m_global_declarations;
+    std::vector<GlobalDecl*> m_global_declarations;
 };
 
 } // namespace mylang
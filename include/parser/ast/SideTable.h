@@ -0,0 +1,79 @@
+#ifndef MYLANG_SIDE_TABLE_H
+#define MYLANG_SIDE_TABLE_H
+
+#include "parser/ast/IAbstractSyntaxTree.h"
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace mylang
+{
+
+// A range of IDs this small is always stored in the vector of a SideTable.
+const size_t MinSideTableSpan = 1024;
+
+// Otherwise, the vector spans at most this many IDs per value.
+const size_t MaxSideTableSpanPerValue = 4;
+
+// Attaches a value of type T to AST nodes, without touching the nodes themselves.
+//
+// Values are stored in a vector indexed by node ID,
+// so every access is a constant-time array access.
+// The vector only spans the IDs that have been given a value,
+// since nodes of a single tree are created close to each other.
+// IDs far outside of that range (e.g., nodes parsed by another thread,
+// or merged from another table) go to a hash map instead,
+// so the memory of a table stays proportional to its number of values.
+// Each pass can keep its own table of annotations.
+template<typename T>
+class SideTable
+{
+public:
+    // Replaces the value if the node already has one.
+    void Set(const IAbstractSyntaxTree* node, T value);
+
+    // Moves every value of 'other' into this table, replacing the values of the same nodes.
+    // Lets several threads annotate their own part of the trees and combine the results.
+    void Merge(SideTable&& other);
+
+    // Returns nullptr if the node has no value.
+    const T* Find(const IAbstractSyntaxTree* node) const;
+    T* Find(const IAbstractSyntaxTree* node);
+
+    // Throws std::out_of_range if the node has no value.
+    const T& At(const IAbstractSyntaxTree* node) const;
+
+    bool Contains(const IAbstractSyntaxTree* node) const;
+
+    // Number of nodes with a value.
+    size_t Size() const;
+
+    void Clear();
+
+private:
+    void SetById(AstNodeId id, T value);
+
+    // Whether the vector may grow to span 'span' IDs.
+    bool CanSpan(size_t span) const;
+
+    // Once the vector has grown, the values it now spans are moved into it.
+    void MoveSparseValuesInRange();
+
+    // m_values[i] belongs to the node with ID m_first_id + i.
+    std::vector<std::optional<T>> m_values;
+    AstNodeId m_first_id = 0;
+
+    // Values of the nodes outside of the range of 'm_values'.
+    std::unordered_map<AstNodeId, T> m_sparse_values;
+
+    size_t m_size = 0;
+};
+
+// Implementation file
+#include "parser/ast/SideTable.tpp"
+
+} // namespace mylang
+
+#endif // MYLANG_SIDE_TABLE_H
@@ -0,0 +1,151 @@
+template<typename T>
+void SideTable<T>::Set(const IAbstractSyntaxTree* node, T value)
+{
+    SetById(node->NodeId(), std::move(value));
+}
+
+template<typename T>
+void SideTable<T>::Merge(SideTable&& other)
+{
+    for (size_t i = 0; i < other.m_values.size(); ++i)
+    {
+        if (other.m_values[i].has_value())
+        {
+            SetById(other.m_first_id + static_cast<AstNodeId>(i), std::move(*other.m_values[i]));
+        }
+    }
+    for (auto& [id, value] : other.m_sparse_values)
+    {
+        SetById(id, std::move(value));
+    }
+    other.Clear();
+}
+
+template<typename T>
+void SideTable<T>::SetById(AstNodeId id, T value)
+{
+    auto is_in_range = !m_values.empty() && id >= m_first_id && id - m_first_id < m_values.size();
+    if (!is_in_range)
+    {
+        if (auto it = m_sparse_values.find(id); it != m_sparse_values.end())
+        {
+            it->second = std::move(value);
+            return;
+        }
+
+        if (m_values.empty())
+        {
+            m_first_id = id;
+            m_values.resize(1);
+        }
+        else if (id < m_first_id && CanSpan(m_first_id - id + m_values.size()))
+        {
+            // Leave as much room in front as the vector already spans,
+            // so that values set in decreasing order are moved only a few times.
+            auto num_front = static_cast<size_t>(m_first_id - id);
+            auto headroom = static_cast<size_t>(std::min<AstNodeId>(id, m_values.size()));
+            auto values = std::vector<std::optional<T>>(headroom + num_front + m_values.size());
+            std::move(m_values.begin(), m_values.end(), values.begin() + headroom + num_front);
+            m_values = std::move(values);
+            m_first_id = id - headroom;
+        }
+        else if (id > m_first_id && CanSpan(id - m_first_id + 1))
+        {
+            // Grow geometrically, since IDs mostly come in increasing order.
+            auto index = static_cast<size_t>(id - m_first_id);
+            m_values.resize(std::max(index + 1, m_values.size() * 2));
+        }
+        else
+        {
+            m_sparse_values.emplace(id, std::move(value));
+            ++m_size;
+            return;
+        }
+        MoveSparseValuesInRange();
+    }
+
+    auto& slot = m_values[id - m_first_id];
+    if (!slot.has_value())
+    {
+        ++m_size;
+    }
+    slot = std::move(value);
+}
+
+template<typename T>
+void SideTable<T>::MoveSparseValuesInRange()
+{
+    for (auto it = m_sparse_values.begin(); it != m_sparse_values.end();)
+    {
+        auto id = it->first;
+        if (id >= m_first_id && id - m_first_id < m_values.size())
+        {
+            m_values[id - m_first_id] = std::move(it->second);
+            it = m_sparse_values.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+template<typename T>
+bool SideTable<T>::CanSpan(size_t span) const
+{
+    return span <= MinSideTableSpan || span <= (m_size + 1) * MaxSideTableSpanPerValue;
+}
+
+template<typename T>
+const T* SideTable<T>::Find(const IAbstractSyntaxTree* node) const
+{
+    auto id = node->NodeId();
+    if (id >= m_first_id && id - m_first_id < m_values.size())
+    {
+        const auto& slot = m_values[id - m_first_id];
+        return slot.has_value() ? &*slot : nullptr;
+    }
+    if (m_sparse_values.empty())
+    {
+        return nullptr;
+    }
+    auto it = m_sparse_values.find(id);
+    return (it != m_sparse_values.end()) ? &it->second : nullptr;
+}
+
+template<typename T>
+T* SideTable<T>::Find(const IAbstractSyntaxTree* node)
+{
+    return const_cast<T*>(static_cast<const SideTable*>(this)->Find(node));
+}
+
+template<typename T>
+const T& SideTable<T>::At(const IAbstractSyntaxTree* node) const
+{
+    if (auto value = Find(node))
+    {
+        return *value;
+    }
+    throw std::out_of_range("SideTable::At(): the node has no value");
+}
+
+template<typename T>
+bool SideTable<T>::Contains(const IAbstractSyntaxTree* node) const
+{
+    return Find(node) != nullptr;
+}
+
+template<typename T>
+size_t SideTable<T>::Size() const
+{
+    return m_size;
+}
+
+template<typename T>
+void SideTable<T>::Clear()
+{
+    m_values.clear();
+    m_sparse_values.clear();
+    m_first_id = 0;
+    m_size = 0;
+}
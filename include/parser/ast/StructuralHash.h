@@ -0,0 +1,59 @@
+#ifndef MYLANG_STRUCTURAL_HASH_H
+#define MYLANG_STRUCTURAL_HASH_H
+
+#include "parser/ast/IAbstractSyntaxTree.h"
+#include "parser/type/Type.h"
+#include "lexer/Token.h"
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace mylang
+{
+
+// Builds the structural hash of a node from its kind, its own tokens and types,
+// and the hashes of its children (see IAbstractSyntaxTree::StructuralHash()).
+//
+// Source positions are ignored, so code that is moved around keeps its hash.
+// The hash doesn't depend on the process or the platform (64-bit FNV-1a).
+class StructuralHasher
+{
+public:
+    // Nodes of different kinds never share the same sequence of fields.
+    StructuralHasher(std::string_view node_kind);
+
+    StructuralHasher& Add(uint64_t value);
+    StructuralHasher& Add(std::string_view value);
+
+    // Only the type and the lexeme of a token are used.
+    StructuralHasher& Add(const Token& token);
+    StructuralHasher& Add(const Type& type);
+
+    // Adds the hash of a child node, or a marker if the optional child is missing.
+    StructuralHasher& Add(const IAbstractSyntaxTree* node);
+
+    template<typename T>
+    StructuralHasher& Add(const std::vector<T*>& nodes);
+
+    uint64_t Hash() const;
+
+private:
+    void AddBytes(const void* data, size_t size);
+
+    uint64_t m_hash;
+};
+
+// Returns true if both trees are made of the same kinds of nodes
+// with the same tokens and types, regardless of their source positions.
+//
+// Different hashes tell the trees apart in constant time.
+// Equal hashes are confirmed by comparing the trees node by node,
+// so a hash collision never makes different trees equal.
+bool IsStructurallyEqual(IAbstractSyntaxTree* lhs, IAbstractSyntaxTree* rhs);
+
+// Implementation file
+#include "parser/ast/StructuralHash.tpp"
+
+} // namespace mylang
+
+#endif // MYLANG_STRUCTURAL_HASH_H
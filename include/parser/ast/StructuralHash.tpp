@@ -0,0 +1,10 @@
+template<typename T>
+StructuralHasher& StructuralHasher::Add(const std::vector<T*>& nodes)
+{
+    Add(static_cast<uint64_t>(nodes.size()));
+    for (auto node : nodes)
+    {
+        Add(static_cast<const IAbstractSyntaxTree*>(node));
+    }
+    return *this;
+}
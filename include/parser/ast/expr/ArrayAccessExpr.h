@@ -2,7 +2,6 @@
 #define MYLANG_ARRAY_ACCESS_EXPR_H
 
 #include "parser/ast/expr/Expr.h"
-#include <memory>
 
 namespace mylang
 {
@@ -10,18 +9,17 @@ namespace mylang
 class ArrayAccessExpr : public Expr
 {
 public:
-    ArrayAccessExpr(std::shared_ptr<Expr> expr, std::shared_ptr<Expr> index);
+    ArrayAccessExpr(Expr* expr, Expr* index);
 
     virtual void Accept(IAbstractSyntaxTreeVisitor* visitor) override;
     virtual const SourcePos& StartPos() const override;
-    virtual std::string ToString() const override;
 
     Expr* Operand();
     Expr* Index();
 
 private:
-    std::shared_ptr<Expr> m_expr;
-    std::shared_ptr<Expr> m_index;
+    Expr* m_expr;
+    Expr* m_index;
 };
 
 } // namespace mylang
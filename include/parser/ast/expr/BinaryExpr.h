@@ -2,7 +2,6 @@
 #define MYLANG_BINARY_EXPR_H
 
 #include "parser/ast/expr/Expr.h"
-#include <memory>
 
 namespace mylang
 {
@@ -10,11 +9,10 @@ namespace mylang
 class BinaryExpr : public Expr
 {
 public:
-    BinaryExpr(const Token& op, std::shared_ptr<Expr> lhs, std::shared_ptr<Expr> rhs);
+    BinaryExpr(const Token& op, Expr* lhs, Expr* rhs);
 
     virtual void Accept(IAbstractSyntaxTreeVisitor* visitor) override;
     virtual const SourcePos& StartPos() const override;
-    virtual std::string ToString() const override;
 
     const Token& Operator() const;
     Expr* LeftHandOperand();
@@ -22,8 +20,8 @@ public:
 
 private:
     Token m_op;
-    std::shared_ptr<Expr> m_lhs;
-    std::shared_ptr<Expr> m_rhs;
+    Expr* m_lhs;
+    Expr* m_rhs;
 };
 
 } // namespace mylang
@@ -10,7 +10,12 @@ namespace mylang
 class Expr : public IAbstractSyntaxTree
 {
 public:
-    virtual std::string ToString() const = 0;
+    // Source code of the expression, with every operation in parentheses.
+    // e.g., "a + b * -c" => "(a + (b * (-c)))"
+    //
+    // The expression is walked without recursion (see AstWalker),
+    // so that this works for an expression of any depth.
+    std::string ToString() const;
 };
 
 } // namespace mylang
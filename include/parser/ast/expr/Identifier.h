@@ -13,7 +13,8 @@ public:
 
     virtual void Accept(IAbstractSyntaxTreeVisitor* visitor) override;
     virtual const SourcePos& StartPos() const override;
-    virtual std::string ToString() const override;
+
+    const Token& Id() const;
 
 private:
     Token m_id;
@@ -14,8 +14,8 @@ public:
 
     virtual void Accept(IAbstractSyntaxTreeVisitor* visitor) override;
     virtual const SourcePos& StartPos() const override;
-    virtual std::string ToString() const override;
 
+    const Token& LiteralToken() const;
     const Type& DeclType() const;
 
 private:
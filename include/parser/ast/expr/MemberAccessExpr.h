@@ -2,7 +2,6 @@
 #define MYLANG_MEMBER_ACCESS_EXPR_H
 
 #include "parser/ast/expr/Expr.h"
-#include <memory>
 
 namespace mylang
 {
@@ -10,17 +9,17 @@ namespace mylang
 class MemberAccessExpr : public Expr
 {
 public:
-    MemberAccessExpr(std::shared_ptr<Expr> expr, const Token& id);
+    MemberAccessExpr(Expr* expr, const Token& id);
 
     virtual void Accept(IAbstractSyntaxTreeVisitor* visitor) override;
     virtual const SourcePos& StartPos() const override;
-    virtual std::string ToString() const override;
 
     Expr* Struct();
+    const Expr* Struct() const;
     const Token& MemberName() const;
 
 private:
-    std::shared_ptr<Expr> m_expr;
+    Expr* m_expr;
     Token m_id;
 };
 
@@ -2,7 +2,6 @@
 #define MYLANG_POSTFIX_EXPR_H
 
 #include "parser/ast/expr/Expr.h"
-#include <memory>
 
 namespace mylang
 {
@@ -10,18 +9,17 @@ namespace mylang
 class PostfixExpr : public Expr
 {
 public:
-    PostfixExpr(const Token& op, std::shared_ptr<Expr> expr);
+    PostfixExpr(const Token& op, Expr* expr);
 
     virtual void Accept(IAbstractSyntaxTreeVisitor* visitor) override;
     virtual const SourcePos& StartPos() const override;
-    virtual std::string ToString() const override;
 
     const Token& Operator() const;
     Expr* Operand();
     
 private:
     Token m_op;
-    std::shared_ptr<Expr> m_expr;
+    Expr* m_expr;
 };
 
 } // namespace mylang
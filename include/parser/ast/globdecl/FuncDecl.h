@@ -15,7 +15,7 @@ class FuncDecl : public GlobalDecl
 public:
     // 'should_export' is true iff "export" prefix was found.
     // 'return_Type' can be empty if void is intended.
-    FuncDecl(bool should_export, const Token& name, std::optional<Type> return_type, const std::vector<std::shared_ptr<Parameter>>& parameters, std::shared_ptr<Stmt> body);
+    FuncDecl(bool should_export, const Token& name, std::optional<Type> return_type, const std::vector<Parameter*>& parameters, Stmt* body);
 
     virtual void Accept(IAbstractSyntaxTreeVisitor* visitor) override;
     virtual const SourcePos& StartPos() const override;
@@ -25,15 +25,15 @@ public:
     virtual bool ShouldExport() const override;
 
     const Type& ReturnType() const;
-    const std::vector<std::shared_ptr<Parameter>>& Parameters() const;
+    const std::vector<Parameter*>& Parameters() const;
     Stmt* Body();
 
 private:
     bool m_should_export;
     Token m_name;
     Type m_return_type;
-    std::vector<std::shared_ptr<Parameter>> m_parameters;
-    std::shared_ptr<Stmt> m_body;
+    std::vector<Parameter*> m_parameters;
+    Stmt* m_body;
 
     // The type of functions itself.
     Type m_type;
@@ -3,6 +3,9 @@
 
 #include "parser/ast/globdecl/GlobalDecl.h"
 #include "parser/type/Type.h"
+#include <optional>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace mylang
@@ -29,11 +32,19 @@ public:
 
     const std::vector<MemberVariable>& Members() const;
 
+    // Returns the index of the member in Members(), or nothing if there is no such member.
+    // If several members have the same name, the first one is found.
+    std::optional<size_t> FindMember(std::string_view name) const;
+
 private:
     bool m_should_export;
     Token m_name;
     std::vector<MemberVariable> m_members;
 
+    // Maps the name of each member to its index.
+    // Keys refer to the names in 'm_members', which don't change after construction.
+    std::unordered_map<std::string_view, size_t> m_member_index;
+
     // The type of struct itself.
     Type m_type;
 };
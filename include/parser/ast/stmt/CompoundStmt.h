@@ -2,7 +2,6 @@
 #define MYLANG_COMPOUND_STMT_H
 
 #include "parser/ast/stmt/Stmt.h"
-#include <memory>
 #include <vector>
 
 namespace mylang
@@ -11,15 +10,15 @@ namespace mylang
 class CompoundStmt : public Stmt
 {
 public:
-    CompoundStmt(const std::vector<std::shared_ptr<Stmt>>& statements);
+    CompoundStmt(const std::vector<Stmt*>& statements);
 
     virtual void Accept(IAbstractSyntaxTreeVisitor* visitor) override;
     virtual const SourcePos& StartPos() const override;
 
-    const std::vector<std::shared_ptr<Stmt>>& Statements() const;
+    const std::vector<Stmt*>& Statements() const;
 
 private:
-    std::vector<std::shared_ptr<Stmt>> m_statements;
+    std::vector<Stmt*> m_statements;
 };
 
 } // namespace mylang
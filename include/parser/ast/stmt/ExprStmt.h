@@ -3,7 +3,6 @@
 
 #include "parser/ast/stmt/Stmt.h"
 #include "parser/ast/expr/Expr.h"
-#include <memory>
 
 namespace mylang
 {
@@ -11,7 +10,7 @@ namespace mylang
 class ExprStmt : public Stmt
 {
 public:
-    ExprStmt(std::shared_ptr<Expr> expr);
+    ExprStmt(Expr* expr);
 
     virtual void Accept(IAbstractSyntaxTreeVisitor* visitor) override;
     virtual const SourcePos& StartPos() const override;
@@ -19,7 +18,7 @@ public:
     Expr* Expression();
 
 private:
-    std::shared_ptr<Expr> m_expr;
+    Expr* m_expr;
 };
 
 } // namespace mylang
@@ -3,7 +3,6 @@
 
 #include "parser/ast/stmt/Stmt.h"
 #include "parser/ast/expr/Expr.h"
-#include <memory>
 
 namespace mylang
 {
@@ -15,10 +14,10 @@ public:
     // 'condition' and 'increment_expr' could be nullptr.
     // 'body' is expected to be a compound statement.
     ForStmt(
-        std::shared_ptr<Stmt> initializer,
-        std::shared_ptr<Expr> condition,
-        std::shared_ptr<Expr> increment_expr,
-        std::shared_ptr<Stmt> body
+        Stmt* initializer,
+        Expr* condition,
+        Expr* increment_expr,
+        Stmt* body
     );
 
     virtual void Accept(IAbstractSyntaxTreeVisitor* visitor) override;
@@ -30,10 +29,10 @@ public:
     Stmt* Body();
 
 private:
-    std::shared_ptr<Stmt> m_initializer;
-    std::shared_ptr<Expr> m_condition;
-    std::shared_ptr<Expr> m_increment_expr;
-    std::shared_ptr<Stmt> m_body;
+    Stmt* m_initializer;
+    Expr* m_condition;
+    Expr* m_increment_expr;
+    Stmt* m_body;
 };
 
 } // namespace mylang
@@ -3,7 +3,6 @@
 
 #include "parser/ast/stmt/Stmt.h"
 #include "parser/ast/expr/Expr.h"
-#include <memory>
 
 namespace mylang
 {
@@ -16,9 +15,9 @@ public:
     // if statement ('else-if' chaining),
     // or a compound statement (final 'else' branch)
     IfStmt(
-        std::shared_ptr<Expr> condition,
-        std::shared_ptr<Stmt> then_branch,
-        std::shared_ptr<Stmt> else_branch
+        Expr* condition,
+        Stmt* then_branch,
+        Stmt* else_branch
     );
 
     virtual void Accept(IAbstractSyntaxTreeVisitor* visitor) override;
@@ -29,9 +28,9 @@ public:
     Stmt* ElseBranch();
 
 private:
-    std::shared_ptr<Expr> m_condition;
-    std::shared_ptr<Stmt> m_then_branch;
-    std::shared_ptr<Stmt> m_else_branch;
+    Expr* m_condition;
+    Stmt* m_then_branch;
+    Stmt* m_else_branch;
 };
 
 } // namespace mylang
@@ -4,7 +4,6 @@
 #include "parser/ast/stmt/Stmt.h"
 #include "parser/ast/expr/Expr.h"
 #include "lexer/Token.h"
-#include <memory>
 
 namespace mylang
 {
@@ -14,7 +13,7 @@ class JumpStmt : public Stmt
 public:
     // 'jump_type' should be either "return", "break", or "continue".
     // 'expr' could be nullptr, if a function has no return type.
-    JumpStmt(const Token& jump_type, std::shared_ptr<Expr> expr);
+    JumpStmt(const Token& jump_type, Expr* expr);
 
     virtual void Accept(IAbstractSyntaxTreeVisitor* visitor) override;
     virtual const SourcePos& StartPos() const override;
@@ -24,7 +23,7 @@ public:
 
 private:
     Token m_jump_type;
-    std::shared_ptr<Expr> m_expr;
+    Expr* m_expr;
 };
 
 } // namespace mylang
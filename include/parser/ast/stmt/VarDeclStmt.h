@@ -5,7 +5,6 @@
 #include "parser/ast/stmt/Stmt.h"
 #include "parser/ast/expr/Expr.h"
 #include "parser/ast/Decl.h"
-#include <memory>
 
 namespace mylang
 {
@@ -14,7 +13,7 @@ class VarDeclStmt : public Stmt, public Decl
 {
 public:
     // 'initializer' is an optional part, so nullptr is allowed.
-    VarDeclStmt(const Token& name, const Type& type, std::shared_ptr<VarInit> initializer);
+    VarDeclStmt(const Token& name, const Type& type, VarInit* initializer);
 
     virtual void Accept(IAbstractSyntaxTreeVisitor* visitor) override;
     virtual const SourcePos& StartPos() const override;
@@ -27,7 +26,7 @@ public:
 private:
     Token m_name;
     Type m_type;
-    std::shared_ptr<VarInit> m_initializer;
+    VarInit* m_initializer;
 };
 
 } // namespace mylang
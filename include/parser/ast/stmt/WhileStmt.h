@@ -3,7 +3,6 @@
 
 #include "parser/ast/stmt/Stmt.h"
 #include "parser/ast/expr/Expr.h"
-#include <memory>
 
 namespace mylang
 {
@@ -12,7 +11,7 @@ class WhileStmt : public Stmt
 {
 public:
     // 'body' is expected to be a compound statement.
-    WhileStmt(std::shared_ptr<Expr> condition, std::shared_ptr<Stmt> body);
+    WhileStmt(Expr* condition, Stmt* body);
 
     virtual void Accept(IAbstractSyntaxTreeVisitor* visitor) override;
     virtual const SourcePos& StartPos() const override;
@@ -21,8 +20,8 @@ public:
     Stmt* Body();
 
 private:
-    std::shared_ptr<Expr> m_condition;
-    std::shared_ptr<Stmt> m_body;
+    Expr* m_condition;
+    Stmt* m_body;
 };
 
 } // namespace mylang
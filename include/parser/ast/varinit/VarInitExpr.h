@@ -3,7 +3,6 @@
 
 #include "parser/ast/varinit/VarInit.h"
 #include "parser/ast/expr/Expr.h"
-#include <memory>
 
 namespace mylang
 {
@@ -11,7 +10,7 @@ namespace mylang
 class VarInitExpr : public VarInit
 {
 public:
-    VarInitExpr(std::shared_ptr<Expr> expr);
+    VarInitExpr(Expr* expr);
 
     virtual void Accept(IAbstractSyntaxTreeVisitor* visitor) override;
     virtual const SourcePos& StartPos() const override;
@@ -19,7 +18,7 @@ public:
     Expr* Expression();
 
 private:
-    std::shared_ptr<Expr> m_expr;
+    Expr* m_expr;
 };
 
 } // namespace mylang
@@ -3,7 +3,6 @@
 
 #include "parser/ast/varinit/VarInit.h"
 #include <vector>
-#include <memory>
 
 namespace mylang
 {
@@ -11,15 +10,15 @@ namespace mylang
 class VarInitList : public VarInit
 {
 public:
-    VarInitList(const std::vector<std::shared_ptr<VarInit>>& initializer_list);
+    VarInitList(const std::vector<VarInit*>& initializer_list);
 
     virtual void Accept(IAbstractSyntaxTreeVisitor* visitor) override;
     virtual const SourcePos& StartPos() const override;
 
-    const std::vector<std::shared_ptr<VarInit>>& InitializerList() const;
+    const std::vector<VarInit*>& InitializerList() const;
 
 private:
-    std::vector<std::shared_ptr<VarInit>> m_initializer_list;
+    std::vector<VarInit*> m_initializer_list;
 };
 
 } // namespace mylang
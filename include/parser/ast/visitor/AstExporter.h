@@ -0,0 +1,77 @@
+#ifndef MYLANG_AST_EXPORTER_H
+#define MYLANG_AST_EXPORTER_H
+
+#include "parser/ast/IAbstractSyntaxTree.h"
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string_view>
+
+namespace mylang
+{
+
+enum class AstExportFormat
+{
+    JsonLines,
+    Binary,
+};
+
+// Returns nothing for a name other than "json" or "bin".
+std::optional<AstExportFormat> ParseAstExportFormat(std::string_view name);
+
+class AstNodeEncoder;
+
+// Writes trees in a machine-readable form for external tools,
+// with the same information as verbose TreePrinter.
+//
+// Each node is encoded as soon as the walk reaches it, straight into the buffer of the stream,
+// so no string is built for the tree and memory only grows with the depth of the tree.
+//
+// Nodes are written in preorder. Along with the fields below,
+// every node has its kind (see AstNodeKindName()) and its start position.
+//
+//   Module            name, imports: [{name, export}]
+//   Parameter         name, type
+//   FuncDecl          name, export, return_type
+//   StructDecl        name, export, members: [{name, type}]
+//   ForStmt           has_initializer, has_condition, has_increment
+//   JumpStmt          jump
+//   VarDeclStmt       name, type
+//   BinaryExpr        op
+//   Identifier        name
+//   Literal           value, type
+//   MemberAccessExpr  member
+//   PostfixExpr       op
+//   PrefixExpr        op
+//
+// JSON Lines: one object per node, numbered in preorder from 0 for each tree.
+// Every node but the root refers to its parent by number, e.g.,
+//
+//   {"id":0,"kind":"Module","line":1,"col":8,"name":"a","imports":[]}
+//   {"id":1,"parent":0,"kind":"FuncDecl","line":1,"col":11,"name":"f","export":false,"return_type":"void"}
+//
+// Binary: the stream starts with "MYAST" and a version byte.
+// Then each node is its kind plus one as a byte, its line and column,
+// and its fields in the order above, followed by its children and a 0 byte.
+// Numbers are unsigned LEB128, strings are a length followed by bytes,
+// booleans are a byte, and lists are a length followed by their elements.
+//
+// Note: this format is for tools outside of the compiler, and it is kept stable.
+// Unlike AstSerializer, it doesn't keep enough to rebuild the tree.
+class AstExporter
+{
+public:
+    AstExporter(std::ostream& output_stream, AstExportFormat format);
+    ~AstExporter();
+
+    // The stream is set to badbit if anything fails to be written.
+    void Export(IAbstractSyntaxTree* ast);
+
+private:
+    std::ostream& m_output_stream;
+    std::unique_ptr<AstNodeEncoder> m_encoder;
+};
+
+} // namespace mylang
+
+#endif // MYLANG_AST_EXPORTER_H
@@ -0,0 +1,130 @@
+#ifndef MYLANG_AST_WALKER_H
+#define MYLANG_AST_WALKER_H
+
+#include "parser/ast/IAbstractSyntaxTree.h"
+#include "parser/ast/Module.h"
+#include "parser/ast/globdecl/Parameter.h"
+#include "parser/ast/globdecl/FuncDecl.h"
+#include "parser/ast/globdecl/StructDecl.h"
+
+#include "parser/ast/stmt/CompoundStmt.h"
+#include "parser/ast/stmt/IfStmt.h"
+#include "parser/ast/stmt/ForStmt.h"
+#include "parser/ast/stmt/WhileStmt.h"
+#include "parser/ast/stmt/JumpStmt.h"
+#include "parser/ast/stmt/VarDeclStmt.h"
+#include "parser/ast/stmt/ExprStmt.h"
+
+#include "parser/ast/varinit/VarInitExpr.h"
+#include "parser/ast/varinit/VarInitList.h"
+
+#include "parser/ast/expr/ArrayAccessExpr.h"
+#include "parser/ast/expr/BinaryExpr.h"
+#include "parser/ast/expr/FuncCallExpr.h"
+#include "parser/ast/expr/Identifier.h"
+#include "parser/ast/expr/Literal.h"
+#include "parser/ast/expr/MemberAccessExpr.h"
+#include "parser/ast/expr/PostfixExpr.h"
+#include "parser/ast/expr/PrefixExpr.h"
+#include <vector>
+
+namespace mylang
+{
+
+// Calls 'func' with the node cast to its concrete type, and returns the result.
+//
+// Note: VarDeclStmt should be passed through its Stmt part,
+// which is how it appears in a tree.
+template<typename Func>
+decltype(auto) CallWithConcreteNode(IAbstractSyntaxTree* node, Func&& func);
+
+// Depth-first walk that keeps its stack on the heap instead of recursing.
+//
+// The parser accepts trees of any depth (e.g., a long chain of "a + a + ..."
+// or "else if"), so a recursive visitor can overflow the native stack
+// long after parsing succeeded. Here, each node on the path from the root
+// takes a small frame in a vector, and the children waiting to be walked
+// take one pointer each, so memory grows with the depth of the tree
+// and nothing else limits it.
+//
+// Derived receives the following hooks, each for the concrete type of the node:
+//
+//   bool PreVisit(X* node)                            before the children, returns false to skip them
+//   void PostVisit(X* node)                           after the children (even if they were skipped)
+//   bool BeforeChild(X* node, IAbstractSyntaxTree*)   before each child, returns false to skip it
+//   void AfterChild(X* node, IAbstractSyntaxTree*)    after each child that wasn't skipped
+//
+// Children are walked in the same order as TreePrinter, and missing optional
+// children are left out. Derived hides the hooks it cares about, e.g.:
+//
+//   class Counter : public AstWalker<Counter>
+//   {
+//   public:
+//       using AstWalker<Counter>::PostVisit;
+//       void PostVisit(Identifier* node) { ++count; }
+//       int count = 0;
+//   };
+//
+// Derived may also hide PreVisitNode() and PostVisitNode() to run something
+// around every node, as long as it calls the ones of AstWalker in turn.
+template<typename Derived>
+class AstWalker
+{
+public:
+    // Hooks may throw, which leaves the walk where it was.
+    // The walker can be used again for another walk afterwards,
+    // but not from inside a hook while a walk is going on.
+    void Walk(IAbstractSyntaxTree* root);
+
+    bool PreVisitNode(IAbstractSyntaxTree* node);
+    void PostVisitNode(IAbstractSyntaxTree* node);
+
+    template<typename Node>
+    bool PreVisit(Node* node);
+
+    template<typename Node>
+    void PostVisit(Node* node);
+
+    template<typename Node>
+    bool BeforeChild(Node* node, IAbstractSyntaxTree* child);
+
+    template<typename Node>
+    void AfterChild(Node* node, IAbstractSyntaxTree* child);
+
+protected:
+    // Number of ancestors of the node being visited (0 for the root).
+    size_t Depth() const;
+
+private:
+    // A node on the path from the root.
+    // Its children are in m_children[begin, end), and the ones before 'next' have been walked.
+    struct Frame
+    {
+        IAbstractSyntaxTree* node;
+        size_t begin;
+        size_t next;
+        size_t end;
+    };
+
+    // Push the node and visit it, along with its children if PreVisit() allows.
+    void Enter(IAbstractSyntaxTree* node);
+
+    // Append the children of the node to m_children.
+    void PushChildren(IAbstractSyntaxTree* node);
+
+    template<typename T>
+    void PushEach(const std::vector<T*>& nodes);
+    void PushIfPresent(IAbstractSyntaxTree* node);
+
+    Derived& Self();
+
+    std::vector<Frame> m_frames;
+    std::vector<IAbstractSyntaxTree*> m_children;
+};
+
+// Implementation file
+#include "parser/ast/visitor/AstWalker.tpp"
+
+} // namespace mylang
+
+#endif // MYLANG_AST_WALKER_H
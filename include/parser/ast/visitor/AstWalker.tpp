@@ -0,0 +1,267 @@
+template<typename Func>
+decltype(auto) CallWithConcreteNode(IAbstractSyntaxTree* node, Func&& func)
+{
+    switch (node->NodeKind())
+    {
+    case AstNodeKind::Module:
+        return func(static_cast<Module*>(node));
+
+    case AstNodeKind::Parameter:
+        return func(static_cast<Parameter*>(node));
+    case AstNodeKind::FuncDecl:
+        return func(static_cast<FuncDecl*>(node));
+    case AstNodeKind::StructDecl:
+        return func(static_cast<StructDecl*>(node));
+
+    case AstNodeKind::CompoundStmt:
+        return func(static_cast<CompoundStmt*>(node));
+    case AstNodeKind::IfStmt:
+        return func(static_cast<IfStmt*>(node));
+    case AstNodeKind::ForStmt:
+        return func(static_cast<ForStmt*>(node));
+    case AstNodeKind::WhileStmt:
+        return func(static_cast<WhileStmt*>(node));
+    case AstNodeKind::JumpStmt:
+        return func(static_cast<JumpStmt*>(node));
+    case AstNodeKind::VarDeclStmt:
+        return func(static_cast<VarDeclStmt*>(static_cast<Stmt*>(node)));
+    case AstNodeKind::ExprStmt:
+        return func(static_cast<ExprStmt*>(node));
+
+    case AstNodeKind::VarInitExpr:
+        return func(static_cast<VarInitExpr*>(node));
+    case AstNodeKind::VarInitList:
+        return func(static_cast<VarInitList*>(node));
+
+    case AstNodeKind::ArrayAccessExpr:
+        return func(static_cast<ArrayAccessExpr*>(node));
+    case AstNodeKind::BinaryExpr:
+        return func(static_cast<BinaryExpr*>(node));
+    case AstNodeKind::FuncCallExpr:
+        return func(static_cast<FuncCallExpr*>(node));
+    case AstNodeKind::Identifier:
+        return func(static_cast<Identifier*>(node));
+    case AstNodeKind::Literal:
+        return func(static_cast<Literal*>(node));
+    case AstNodeKind::MemberAccessExpr:
+        return func(static_cast<MemberAccessExpr*>(node));
+    case AstNodeKind::PostfixExpr:
+        return func(static_cast<PostfixExpr*>(node));
+    case AstNodeKind::PrefixExpr:
+        break;
+    }
+
+    // The last kind is handled out of the switch,
+    // so that every path returns a value.
+    return func(static_cast<PrefixExpr*>(node));
+}
+
+template<typename Derived>
+void AstWalker<Derived>::Walk(IAbstractSyntaxTree* root)
+{
+    // Clean up after a walk that was stopped by an exception.
+    m_frames.clear();
+    m_children.clear();
+
+    Enter(root);
+    while (!m_frames.empty())
+    {
+        auto& frame = m_frames.back();
+
+        // Every child is done, so leave the node.
+        if (frame.next == frame.end)
+        {
+            auto node = frame.node;
+            Self().PostVisitNode(node);
+            m_children.resize(frame.begin);
+            m_frames.pop_back();
+
+            if (!m_frames.empty())
+            {
+                auto parent = m_frames.back().node;
+                CallWithConcreteNode(parent, [&](auto* concrete_parent) {
+                    Self().AfterChild(concrete_parent, node);
+                });
+            }
+            continue;
+        }
+
+        // Note: 'frame' is invalidated once the child is entered.
+        auto parent = frame.node;
+        auto child = m_children[frame.next++];
+        auto should_enter = CallWithConcreteNode(parent, [&](auto* concrete_parent) {
+            return Self().BeforeChild(concrete_parent, child);
+        });
+        if (should_enter)
+        {
+            Enter(child);
+        }
+    }
+}
+
+template<typename Derived>
+void AstWalker<Derived>::Enter(IAbstractSyntaxTree* node)
+{
+    auto begin = m_children.size();
+    m_frames.push_back(Frame{node, begin, begin, begin});
+    if (Self().PreVisitNode(node))
+    {
+        PushChildren(node);
+        m_frames.back().end = m_children.size();
+    }
+}
+
+template<typename Derived>
+bool AstWalker<Derived>::PreVisitNode(IAbstractSyntaxTree* node)
+{
+    return CallWithConcreteNode(node, [&](auto* concrete_node) {
+        return Self().PreVisit(concrete_node);
+    });
+}
+
+template<typename Derived>
+void AstWalker<Derived>::PostVisitNode(IAbstractSyntaxTree* node)
+{
+    CallWithConcreteNode(node, [&](auto* concrete_node) {
+        Self().PostVisit(concrete_node);
+    });
+}
+
+template<typename Derived>
+template<typename Node>
+bool AstWalker<Derived>::PreVisit(Node*)
+{
+    return true;
+}
+
+template<typename Derived>
+template<typename Node>
+void AstWalker<Derived>::PostVisit(Node*)
+{}
+
+template<typename Derived>
+template<typename Node>
+bool AstWalker<Derived>::BeforeChild(Node*, IAbstractSyntaxTree*)
+{
+    return true;
+}
+
+template<typename Derived>
+template<typename Node>
+void AstWalker<Derived>::AfterChild(Node*, IAbstractSyntaxTree*)
+{}
+
+template<typename Derived>
+size_t AstWalker<Derived>::Depth() const
+{
+    return m_frames.empty() ? 0 : m_frames.size() - 1;
+}
+
+template<typename Derived>
+void AstWalker<Derived>::PushChildren(IAbstractSyntaxTree* node)
+{
+    switch (node->NodeKind())
+    {
+    case AstNodeKind::Module:
+        return PushEach(static_cast<Module*>(node)->Declarations());
+
+    case AstNodeKind::FuncDecl:
+    {
+        auto func = static_cast<FuncDecl*>(node);
+        PushEach(func->Parameters());
+        return PushIfPresent(func->Body());
+    }
+
+    case AstNodeKind::CompoundStmt:
+        return PushEach(static_cast<CompoundStmt*>(node)->Statements());
+    case AstNodeKind::IfStmt:
+    {
+        auto if_stmt = static_cast<IfStmt*>(node);
+        PushIfPresent(if_stmt->Condition());
+        PushIfPresent(if_stmt->ThenBranch());
+        return PushIfPresent(if_stmt->ElseBranch());
+    }
+    case AstNodeKind::ForStmt:
+    {
+        auto for_stmt = static_cast<ForStmt*>(node);
+        PushIfPresent(for_stmt->Initializer());
+        PushIfPresent(for_stmt->Condition());
+        PushIfPresent(for_stmt->IncrementExpr());
+        return PushIfPresent(for_stmt->Body());
+    }
+    case AstNodeKind::WhileStmt:
+    {
+        auto while_stmt = static_cast<WhileStmt*>(node);
+        PushIfPresent(while_stmt->Condition());
+        return PushIfPresent(while_stmt->Body());
+    }
+    case AstNodeKind::JumpStmt:
+        return PushIfPresent(static_cast<JumpStmt*>(node)->ReturnValueExpr());
+    case AstNodeKind::VarDeclStmt:
+        return PushIfPresent(static_cast<VarDeclStmt*>(static_cast<Stmt*>(node))->Initializer());
+    case AstNodeKind::ExprStmt:
+        return PushIfPresent(static_cast<ExprStmt*>(node)->Expression());
+
+    case AstNodeKind::VarInitExpr:
+        return PushIfPresent(static_cast<VarInitExpr*>(node)->Expression());
+    case AstNodeKind::VarInitList:
+        return PushEach(static_cast<VarInitList*>(node)->InitializerList());
+
+    case AstNodeKind::ArrayAccessExpr:
+    {
+        auto array_access = static_cast<ArrayAccessExpr*>(node);
+        PushIfPresent(array_access->Operand());
+        return PushIfPresent(array_access->Index());
+    }
+    case AstNodeKind::BinaryExpr:
+    {
+        auto binary = static_cast<BinaryExpr*>(node);
+        PushIfPresent(binary->LeftHandOperand());
+        return PushIfPresent(binary->RightHandOperand());
+    }
+    case AstNodeKind::FuncCallExpr:
+    {
+        auto func_call = static_cast<FuncCallExpr*>(node);
+        PushIfPresent(func_call->Function());
+        return PushEach(func_call->ArgumentList());
+    }
+    case AstNodeKind::MemberAccessExpr:
+        return PushIfPresent(static_cast<MemberAccessExpr*>(node)->Struct());
+    case AstNodeKind::PostfixExpr:
+        return PushIfPresent(static_cast<PostfixExpr*>(node)->Operand());
+    case AstNodeKind::PrefixExpr:
+        return PushIfPresent(static_cast<PrefixExpr*>(node)->Operand());
+
+    // Leaves.
+    case AstNodeKind::Parameter:
+    case AstNodeKind::StructDecl:
+    case AstNodeKind::Identifier:
+    case AstNodeKind::Literal:
+        return;
+    }
+}
+
+template<typename Derived>
+template<typename T>
+void AstWalker<Derived>::PushEach(const std::vector<T*>& nodes)
+{
+    for (auto node : nodes)
+    {
+        m_children.push_back(node);
+    }
+}
+
+template<typename Derived>
+void AstWalker<Derived>::PushIfPresent(IAbstractSyntaxTree* node)
+{
+    if (node)
+    {
+        m_children.push_back(node);
+    }
+}
+
+template<typename Derived>
+Derived& AstWalker<Derived>::Self()
+{
+    return static_cast<Derived&>(*this);
+}
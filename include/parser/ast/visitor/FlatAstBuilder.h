@@ -0,0 +1,70 @@
+#ifndef MYLANG_FLAT_AST_BUILDER_H
+#define MYLANG_FLAT_AST_BUILDER_H
+
+#include "parser/ast/visitor/IAbstractSyntaxTreeVisitor.h"
+#include "parser/ast/FlatAst.h"
+#include <vector>
+
+namespace mylang
+{
+
+// Converts a tree into FlatAst.
+//
+// Children are appended in the same order as TreePrinter visits them,
+// except that missing optional children are recorded as node flags.
+class FlatAstBuilder : public IAbstractSyntaxTreeVisitor
+{
+public:
+    //  traversal
+    virtual void Visit(Module* node) override;
+
+    virtual void Visit(Parameter* node) override;
+    virtual void Visit(FuncDecl* node) override;
+    virtual void Visit(StructDecl* node) override;
+
+    virtual void Visit(CompoundStmt* node) override;
+    virtual void Visit(IfStmt* node) override;
+    virtual void Visit(ForStmt* node) override;
+    virtual void Visit(WhileStmt* node) override;
+    virtual void Visit(JumpStmt* node) override;
+    virtual void Visit(VarDeclStmt* node) override;
+    virtual void Visit(ExprStmt* node) override;
+
+    virtual void Visit(VarInitExpr* node) override;
+    virtual void Visit(VarInitList* node) override;
+
+    virtual void Visit(ArrayAccessExpr* node) override;
+    virtual void Visit(BinaryExpr* node) override;
+    virtual void Visit(FuncCallExpr* node) override;
+    virtual void Visit(Identifier* node) override;
+    virtual void Visit(Literal* node) override;
+    virtual void Visit(MemberAccessExpr* node) override;
+    virtual void Visit(PostfixExpr* node) override;
+    virtual void Visit(PrefixExpr* node) override;
+
+    // Returns the nodes built so far and resets the builder.
+    FlatAst Release();
+
+private:
+    // Append a node as the next child of the current node, and make it current.
+    FlatNodeId BeginNode(FlatNodeKind kind, IAbstractSyntaxTree* source);
+
+    // Make the parent of the current node current again.
+    void EndNode();
+
+    struct OpenNode
+    {
+        FlatNodeId node;
+        FlatNodeId last_child;
+    };
+
+    FlatAst m_ast;
+    std::vector<OpenNode> m_open_nodes;
+};
+
+// Convenience function that converts the whole tree.
+FlatAst CreateFlatAst(IAbstractSyntaxTree* ast);
+
+} // namespace mylang
+
+#endif // MYLANG_FLAT_AST_BUILDER_H
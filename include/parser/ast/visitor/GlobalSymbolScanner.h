@@ -2,6 +2,7 @@
 #define MYLANG_GLOBAL_SYMBOL_SCANNER_H
 
 #include "parser/ast/visitor/IAbstractSyntaxTreeVisitor.h"
+#include "parser/AstPass.h"
 #include "parser/ProgramEnvironment.h"
 
 namespace mylang
@@ -9,11 +10,20 @@ namespace mylang
 
 // Traverses an AST to collect global declarations and
 // adds those symbols to the corresponding module's symbol table.
-class GlobalSymbolScanner : public IAbstractSyntaxTreeVisitor
+//
+// As a pass, it only needs to see Module nodes.
+// Once every module is scanned, it lets the environment index the exported symbols
+// and freezes it, so that later passes only read the global symbols.
+class GlobalSymbolScanner : public IAbstractSyntaxTreeVisitor, public AstPass
 {
 public:
     GlobalSymbolScanner(ProgramEnvironment& environment);
 
+    virtual std::string_view Name() const override;
+    virtual AstNodeKindSet Interests() const override;
+    virtual void Enter(IAbstractSyntaxTree* node) override;
+    virtual void Finish() override;
+
     virtual void Visit(Module* node) override;
     virtual void Visit(FuncDecl* node) override;
     virtual void Visit(StructDecl* node) override;
@@ -40,7 +50,7 @@ public:
 
 private:
     ProgramEnvironment& m_environment;
-    std::string_view m_module_name;
+    ModuleHandle m_module = 0;
 };
 
 } // namespace mylang
@@ -1,27 +1,30 @@
 #ifndef MYLANG_JUMP_STMT_USAGE_CHECKER_H
 #define MYLANG_JUMP_STMT_USAGE_CHECKER_H
 
-#include "parser/ast/visitor/IAbstractSyntaxTreeVisitor.h"
+#include "parser/AstPass.h"
 
 namespace mylang
 {
 
 // Checks if break or continue is used only inside a loop.
 //
-// Since ExprStmt and VarDeclStmt cannot contain JumpStmt
-// and any JumpStmt in WhileStmt and ForStmt is valid,
-// we only need to traverse and inspect IfStmt and CompoundStmt.
+// Since any JumpStmt in WhileStmt and ForStmt is valid,
+// we only need to count the loops we are in when a JumpStmt is entered.
+// This only looks at a few kinds of nodes,
+// so it shares the walk of another pass (see PassManager).
 //
-// On valid AST, we should NOT encounter any break or continue.
-class JumpStmtUsageChecker : public IAbstractSyntaxTreeVisitor
+// On valid AST, we should NOT encounter any break or continue outside a loop.
+class JumpStmtUsageChecker : public AstPass
 {
 public:
-    virtual void Visit(Module* node) override;
-    virtual void Visit(FuncDecl* node) override;
+    virtual std::string_view Name() const override;
+    virtual AstNodeKindSet Interests() const override;
 
-    virtual void Visit(IfStmt* node) override;
-    virtual void Visit(CompoundStmt* node) override;
-    virtual void Visit(JumpStmt* node) override;
+    virtual void Enter(IAbstractSyntaxTree* node) override;
+    virtual void Leave(IAbstractSyntaxTree* node) override;
+
+private:
+    int m_loop_depth = 0;
 };
 
 } // namespace mylang
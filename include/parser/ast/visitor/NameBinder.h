@@ -0,0 +1,99 @@
+#ifndef MYLANG_NAME_BINDER_H
+#define MYLANG_NAME_BINDER_H
+
+#include "parser/ast/visitor/IAbstractSyntaxTreeVisitor.h"
+#include "parser/ast/visitor/AstWalker.h"
+#include "parser/AstPass.h"
+#include "parser/NameBindings.h"
+#include "parser/ProgramEnvironment.h"
+
+namespace mylang
+{
+
+// Resolves every name in the trees to its declaration, once:
+// 1. each identifier, to the variable, parameter, function or struct it refers to
+// 2. each struct type used in a declaration, to its StructDecl
+//
+// Names are looked up with the same scoping rules TypeChecker used to apply,
+// e.g., a local variable is only visible after its initializer
+// and it can hide a struct type with the same name until the end of its scope.
+// A name that can't be resolved is bound to nothing,
+// and TypeChecker reports it where it used to.
+//
+// Redefining a local symbol in the same scope is reported here,
+// since this is where local scopes are built. They are kept in the binder,
+// so the global symbols in the environment are only read.
+class NameBinder : public IAbstractSyntaxTreeVisitor, public AstPass, private AstWalker<NameBinder>
+{
+public:
+    NameBinder(const ProgramEnvironment& environment, NameBindings& bindings);
+
+    virtual std::string_view Name() const override;
+    virtual std::vector<std::string_view> Prerequisites() const override;
+    virtual bool IsWalker() const override;
+    virtual void Walk(IAbstractSyntaxTree* root, IAstNodeHooks* hooks) override;
+
+    // Binds the module, which is the only kind of node that can be bound on its own.
+    virtual void Visit(Module* node) override;
+
+    // Binds a single top-level declaration of the module, e.g., one that changed
+    // since the module was bound. Names are resolved just as in Visit(Module*).
+    void BindDeclaration(ModuleHandle module, GlobalDecl* decl);
+
+private:
+    friend class AstWalker<NameBinder>;
+
+    // Call the hooks of the other passes around every node below the root, if any.
+    bool PreVisitNode(IAbstractSyntaxTree* node);
+    void PostVisitNode(IAbstractSyntaxTree* node);
+
+    using AstWalker<NameBinder>::PreVisit;
+    using AstWalker<NameBinder>::PostVisit;
+    using AstWalker<NameBinder>::BeforeChild;
+    using AstWalker<NameBinder>::AfterChild;
+
+    bool PreVisit(Module* node);
+
+    bool PreVisit(FuncDecl* node);
+    void PostVisit(FuncDecl* node);
+    bool PreVisit(Parameter* node);
+
+    bool PreVisit(StructDecl* node);
+
+    bool PreVisit(CompoundStmt* node);
+    void PostVisit(CompoundStmt* node);
+
+    bool BeforeChild(IfStmt* node, IAbstractSyntaxTree* child);
+    void AfterChild(IfStmt* node, IAbstractSyntaxTree* child);
+
+    bool PreVisit(ForStmt* node);
+    void PostVisit(ForStmt* node);
+
+    bool PreVisit(VarDeclStmt* node);
+    void PostVisit(VarDeclStmt* node);
+
+    void PostVisit(Identifier* node);
+
+    // Looks for a local symbol first, then for a global one of the module.
+    std::optional<Symbol> FindVisibleSymbol(std::string_view name) const;
+
+    // Binds every struct type in 'type' to the struct visible with its name.
+    void BindStructTypes(const Type& type);
+
+    const ProgramEnvironment& m_environment;
+    NameBindings& m_bindings;
+
+    // The module we are binding
+    ModuleHandle m_context_module = 0;
+
+    // Parameters and local variables of the function we are binding.
+    // Level 0 is left empty, since it belongs to the global symbols of the module.
+    SymbolTable m_local_scopes;
+
+    // Hooks of the passes that share the walk, while Walk() runs.
+    IAstNodeHooks* m_hooks = nullptr;
+};
+
+} // namespace mylang
+
+#endif // MYLANG_NAME_BINDER_H
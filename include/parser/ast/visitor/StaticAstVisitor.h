@@ -0,0 +1,106 @@
+#ifndef MYLANG_STATIC_AST_VISITOR_H
+#define MYLANG_STATIC_AST_VISITOR_H
+
+#include "parser/ast/IAbstractSyntaxTree.h"
+#include "parser/ast/Module.h"
+#include "parser/ast/globdecl/Parameter.h"
+#include "parser/ast/globdecl/FuncDecl.h"
+#include "parser/ast/globdecl/StructDecl.h"
+
+#include "parser/ast/stmt/CompoundStmt.h"
+#include "parser/ast/stmt/IfStmt.h"
+#include "parser/ast/stmt/ForStmt.h"
+#include "parser/ast/stmt/WhileStmt.h"
+#include "parser/ast/stmt/JumpStmt.h"
+#include "parser/ast/stmt/VarDeclStmt.h"
+#include "parser/ast/stmt/ExprStmt.h"
+
+#include "parser/ast/varinit/VarInitExpr.h"
+#include "parser/ast/varinit/VarInitList.h"
+
+#include "parser/ast/expr/ArrayAccessExpr.h"
+#include "parser/ast/expr/BinaryExpr.h"
+#include "parser/ast/expr/FuncCallExpr.h"
+#include "parser/ast/expr/Identifier.h"
+#include "parser/ast/expr/Literal.h"
+#include "parser/ast/expr/MemberAccessExpr.h"
+#include "parser/ast/expr/PostfixExpr.h"
+#include "parser/ast/expr/PrefixExpr.h"
+#include <vector>
+
+namespace mylang
+{
+
+// Visitor whose calls are resolved at compile time.
+//
+// IAbstractSyntaxTreeVisitor costs two virtual calls per node
+// (Accept() and Visit()), and neither can be inlined.
+// Here, Dispatch() switches on the node kind and calls the Visit() overload
+// of Derived directly, so a whole pass compiles into a single switch loop.
+//
+// Every Visit() overload visits the children of the node by default,
+// in the same order as TreePrinter. Derived hides the ones it cares about
+// and calls StaticAstVisitor::Visit(node) to keep going down, e.g.:
+//
+//   class Counter : public StaticAstVisitor<Counter>
+//   {
+//   public:
+//       using StaticAstVisitor<Counter>::Visit;
+//       void Visit(Identifier* node) { ++count; }
+//       int count = 0;
+//   };
+//
+// Derived may also hide Dispatch() to run something around every node,
+// as long as it calls StaticAstVisitor::Dispatch(node) in turn.
+//
+// Note: VarDeclStmt should be dispatched through its Stmt part,
+// which is how it appears in a tree.
+template<typename Derived>
+class StaticAstVisitor
+{
+public:
+    void Dispatch(IAbstractSyntaxTree* node);
+
+    void Visit(Module* node);
+
+    void Visit(Parameter* node);
+    void Visit(FuncDecl* node);
+    void Visit(StructDecl* node);
+
+    void Visit(CompoundStmt* node);
+    void Visit(IfStmt* node);
+    void Visit(ForStmt* node);
+    void Visit(WhileStmt* node);
+    void Visit(JumpStmt* node);
+    void Visit(VarDeclStmt* node);
+    void Visit(ExprStmt* node);
+
+    void Visit(VarInitExpr* node);
+    void Visit(VarInitList* node);
+
+    void Visit(ArrayAccessExpr* node);
+    void Visit(BinaryExpr* node);
+    void Visit(FuncCallExpr* node);
+    void Visit(Identifier* node);
+    void Visit(Literal* node);
+    void Visit(MemberAccessExpr* node);
+    void Visit(PostfixExpr* node);
+    void Visit(PrefixExpr* node);
+
+protected:
+    // Does nothing for a missing optional child.
+    void DispatchIfPresent(IAbstractSyntaxTree* node);
+
+    template<typename T>
+    void DispatchEach(const std::vector<T*>& nodes);
+
+private:
+    Derived& Self();
+};
+
+// Implementation file
+#include "parser/ast/visitor/StaticAstVisitor.tpp"
+
+} // namespace mylang
+
+#endif // MYLANG_STATIC_AST_VISITOR_H
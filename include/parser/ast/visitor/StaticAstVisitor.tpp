@@ -0,0 +1,206 @@
+template<typename Derived>
+void StaticAstVisitor<Derived>::Dispatch(IAbstractSyntaxTree* node)
+{
+    switch (node->NodeKind())
+    {
+    case AstNodeKind::Module:
+        return Self().Visit(static_cast<Module*>(node));
+
+    case AstNodeKind::Parameter:
+        return Self().Visit(static_cast<Parameter*>(node));
+    case AstNodeKind::FuncDecl:
+        return Self().Visit(static_cast<FuncDecl*>(node));
+    case AstNodeKind::StructDecl:
+        return Self().Visit(static_cast<StructDecl*>(node));
+
+    case AstNodeKind::CompoundStmt:
+        return Self().Visit(static_cast<CompoundStmt*>(node));
+    case AstNodeKind::IfStmt:
+        return Self().Visit(static_cast<IfStmt*>(node));
+    case AstNodeKind::ForStmt:
+        return Self().Visit(static_cast<ForStmt*>(node));
+    case AstNodeKind::WhileStmt:
+        return Self().Visit(static_cast<WhileStmt*>(node));
+    case AstNodeKind::JumpStmt:
+        return Self().Visit(static_cast<JumpStmt*>(node));
+    case AstNodeKind::VarDeclStmt:
+        return Self().Visit(static_cast<VarDeclStmt*>(static_cast<Stmt*>(node)));
+    case AstNodeKind::ExprStmt:
+        return Self().Visit(static_cast<ExprStmt*>(node));
+
+    case AstNodeKind::VarInitExpr:
+        return Self().Visit(static_cast<VarInitExpr*>(node));
+    case AstNodeKind::VarInitList:
+        return Self().Visit(static_cast<VarInitList*>(node));
+
+    case AstNodeKind::ArrayAccessExpr:
+        return Self().Visit(static_cast<ArrayAccessExpr*>(node));
+    case AstNodeKind::BinaryExpr:
+        return Self().Visit(static_cast<BinaryExpr*>(node));
+    case AstNodeKind::FuncCallExpr:
+        return Self().Visit(static_cast<FuncCallExpr*>(node));
+    case AstNodeKind::Identifier:
+        return Self().Visit(static_cast<Identifier*>(node));
+    case AstNodeKind::Literal:
+        return Self().Visit(static_cast<Literal*>(node));
+    case AstNodeKind::MemberAccessExpr:
+        return Self().Visit(static_cast<MemberAccessExpr*>(node));
+    case AstNodeKind::PostfixExpr:
+        return Self().Visit(static_cast<PostfixExpr*>(node));
+    case AstNodeKind::PrefixExpr:
+        return Self().Visit(static_cast<PrefixExpr*>(node));
+    }
+}
+
+template<typename Derived>
+void StaticAstVisitor<Derived>::Visit(Module* node)
+{
+    DispatchEach(node->Declarations());
+}
+
+template<typename Derived>
+void StaticAstVisitor<Derived>::Visit(Parameter* node)
+{}
+
+template<typename Derived>
+void StaticAstVisitor<Derived>::Visit(FuncDecl* node)
+{
+    DispatchEach(node->Parameters());
+    Self().Dispatch(node->Body());
+}
+
+template<typename Derived>
+void StaticAstVisitor<Derived>::Visit(StructDecl* node)
+{}
+
+template<typename Derived>
+void StaticAstVisitor<Derived>::Visit(CompoundStmt* node)
+{
+    DispatchEach(node->Statements());
+}
+
+template<typename Derived>
+void StaticAstVisitor<Derived>::Visit(IfStmt* node)
+{
+    Self().Dispatch(node->Condition());
+    Self().Dispatch(node->ThenBranch());
+    DispatchIfPresent(node->ElseBranch());
+}
+
+template<typename Derived>
+void StaticAstVisitor<Derived>::Visit(ForStmt* node)
+{
+    DispatchIfPresent(node->Initializer());
+    DispatchIfPresent(node->Condition());
+    DispatchIfPresent(node->IncrementExpr());
+    Self().Dispatch(node->Body());
+}
+
+template<typename Derived>
+void StaticAstVisitor<Derived>::Visit(WhileStmt* node)
+{
+    Self().Dispatch(node->Condition());
+    Self().Dispatch(node->Body());
+}
+
+template<typename Derived>
+void StaticAstVisitor<Derived>::Visit(JumpStmt* node)
+{
+    DispatchIfPresent(node->ReturnValueExpr());
+}
+
+template<typename Derived>
+void StaticAstVisitor<Derived>::Visit(VarDeclStmt* node)
+{
+    DispatchIfPresent(node->Initializer());
+}
+
+template<typename Derived>
+void StaticAstVisitor<Derived>::Visit(ExprStmt* node)
+{
+    Self().Dispatch(node->Expression());
+}
+
+template<typename Derived>
+void StaticAstVisitor<Derived>::Visit(VarInitExpr* node)
+{
+    Self().Dispatch(node->Expression());
+}
+
+template<typename Derived>
+void StaticAstVisitor<Derived>::Visit(VarInitList* node)
+{
+    DispatchEach(node->InitializerList());
+}
+
+template<typename Derived>
+void StaticAstVisitor<Derived>::Visit(ArrayAccessExpr* node)
+{
+    Self().Dispatch(node->Operand());
+    Self().Dispatch(node->Index());
+}
+
+template<typename Derived>
+void StaticAstVisitor<Derived>::Visit(BinaryExpr* node)
+{
+    Self().Dispatch(node->LeftHandOperand());
+    Self().Dispatch(node->RightHandOperand());
+}
+
+template<typename Derived>
+void StaticAstVisitor<Derived>::Visit(FuncCallExpr* node)
+{
+    Self().Dispatch(node->Function());
+    DispatchEach(node->ArgumentList());
+}
+
+template<typename Derived>
+void StaticAstVisitor<Derived>::Visit(Identifier* node)
+{}
+
+template<typename Derived>
+void StaticAstVisitor<Derived>::Visit(Literal* node)
+{}
+
+template<typename Derived>
+void StaticAstVisitor<Derived>::Visit(MemberAccessExpr* node)
+{
+    Self().Dispatch(node->Struct());
+}
+
+template<typename Derived>
+void StaticAstVisitor<Derived>::Visit(PostfixExpr* node)
+{
+    Self().Dispatch(node->Operand());
+}
+
+template<typename Derived>
+void StaticAstVisitor<Derived>::Visit(PrefixExpr* node)
+{
+    Self().Dispatch(node->Operand());
+}
+
+template<typename Derived>
+void StaticAstVisitor<Derived>::DispatchIfPresent(IAbstractSyntaxTree* node)
+{
+    if (node)
+    {
+        Self().Dispatch(node);
+    }
+}
+
+template<typename Derived>
+template<typename T>
+void StaticAstVisitor<Derived>::DispatchEach(const std::vector<T*>& nodes)
+{
+    for (auto node : nodes)
+    {
+        Self().Dispatch(node);
+    }
+}
+
+template<typename Derived>
+Derived& StaticAstVisitor<Derived>::Self()
+{
+    return static_cast<Derived&>(*this);
+}
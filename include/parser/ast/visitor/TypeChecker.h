@@ -2,14 +2,20 @@
 #define MYLANG_TYPE_CHECKER_H
 
 #include "parser/ast/visitor/IAbstractSyntaxTreeVisitor.h"
-#include "parser/ProgramEnvironment.h"
-#include <map>
+#include "parser/ast/visitor/AstWalker.h"
+#include "parser/AstPass.h"
+#include "parser/NameBindings.h"
+#include "parser/Diagnostics.h"
+#include "parser/ast/SideTable.h"
+#include "common/ThreadPool.h"
+#include <functional>
 #include <stack>
 
 namespace mylang
 {
 
 class Expr;
+class GlobalDecl;
 class StructType;
 class FuncType;
 class IAbstractSyntaxTree;
@@ -34,84 +40,160 @@ struct ExprTrait
 // 10. return value's type should match function definition
 //
 // Since the type of an AST node is a synthesized attribute (i.e., depends on child node),
-// we first visit the children to perform preorder traversal and then do the type checking.
-class TypeChecker : public IAbstractSyntaxTreeVisitor
+// we first visit the children and then do the type checking on the way up (see PostVisit()).
+//
+// Names are not looked up here. Identifiers and struct types are checked against
+// the declarations NameBinder bound them to, and member accesses are bound here
+// as soon as the type of their operand is known.
+// The tree is walked with an explicit stack, so a deep tree can't overflow the native stack.
+//
+// Errors are reported to a DiagnosticSink, and the check goes on with the next node.
+// A node that depends on one that failed (e.g., an operator whose operand has no type)
+// is skipped without reporting anything, so each mistake is reported once.
+// Without a sink, the first error is thrown as a SemanticError once the walk is done.
+//
+// As a pass, it walks the tree by itself and lets other passes of the same walk
+// see every node it visits (see PassManager).
+class TypeChecker : public IAbstractSyntaxTreeVisitor, public AstPass, private AstWalker<TypeChecker>
 {
 public:
-    TypeChecker(ProgramEnvironment& environment);
+    // Errors are thrown as a SemanticError if 'diagnostics' is nullptr.
+    TypeChecker(NameBindings& bindings, DiagnosticSink* diagnostics = nullptr);
 
-    virtual void Visit(Module* node) override;
+    virtual std::string_view Name() const override;
+    virtual std::vector<std::string_view> Prerequisites() const override;
+    virtual bool IsWalker() const override;
+    virtual void Walk(IAbstractSyntaxTree* root, IAstNodeHooks* hooks) override;
 
-    virtual void Visit(FuncDecl* node) override;
-    virtual void Visit(Parameter* node) override;
+    // Checks the module, which is the only kind of node that can be checked on its own.
+    virtual void Visit(Module* node) override;
 
-    virtual void Visit(StructDecl* node) override;
+    // Checks the declarations of every module on the thread pool, instead of through PassManager.
+    //
+    // Every name should have been bound by then (see NameBinder), and the checks only read
+    // the bindings, so each task checks a run of consecutive declarations with a checker
+    // and a sink of its own. Their results are merged in the order of the modules,
+    // so the diagnostics are reported in the same order as a walk over the modules would,
+    // no matter which task finished first.
+    //
+    // Without a sink, if any declaration fails, 'on_error' is called with the index
+    // of the module of the first one in that order and its error is thrown.
+    void CheckConcurrently(
+        const std::vector<IAbstractSyntaxTree*>& modules,
+        ThreadPool& thread_pool,
+        const std::function<void(size_t)>& on_error = nullptr
+    );
+
+    // Checks a single top-level declaration, e.g., one that changed since its module was checked.
+    // Its names should have been bound (see NameBinder::BindDeclaration()),
+    // and errors are handled as in Visit(Module*).
+    void CheckDeclaration(GlobalDecl* decl);
+
+    // Type of every expression checked so far, which later passes can look up.
+    const SideTable<ExprTrait>& ExprTraits() const;
+
+    // Moves the types out of the checker, for a caller that keeps them on its own.
+    SideTable<ExprTrait> TakeExprTraits();
 
-    virtual void Visit(CompoundStmt* node) override;
+private:
+    friend class AstWalker<TypeChecker>;
 
-    virtual void Visit(IfStmt* node) override;
+    // Call the hooks of the other passes around every node below the root, if any.
+    bool PreVisitNode(IAbstractSyntaxTree* node);
+    void PostVisitNode(IAbstractSyntaxTree* node);
 
-    virtual void Visit(ForStmt* node) override;
-    
-    virtual void Visit(WhileStmt* node) override;
+    using AstWalker<TypeChecker>::PreVisit;
+    using AstWalker<TypeChecker>::PostVisit;
+    using AstWalker<TypeChecker>::BeforeChild;
+    using AstWalker<TypeChecker>::AfterChild;
 
-    virtual void Visit(JumpStmt* node) override;
+    bool PreVisit(FuncDecl* node);
+    bool PreVisit(Parameter* node);
 
-    virtual void Visit(ExprStmt* node) override;
+    bool PreVisit(StructDecl* node);
 
-    virtual void Visit(VarDeclStmt* node) override;
+    void AfterChild(IfStmt* node, IAbstractSyntaxTree* child);
 
-    virtual void Visit(VarInitExpr* node) override;
+    void AfterChild(ForStmt* node, IAbstractSyntaxTree* child);
 
-    virtual void Visit(VarInitList* node) override;
+    void AfterChild(WhileStmt* node, IAbstractSyntaxTree* child);
 
-    virtual void Visit(ArrayAccessExpr* node) override;
+    void PostVisit(JumpStmt* node);
 
-    virtual void Visit(BinaryExpr* node) override;
+    bool PreVisit(VarDeclStmt* node);
+    void PostVisit(VarDeclStmt* node);
 
-    virtual void Visit(FuncCallExpr* node) override;
+    void PostVisit(VarInitExpr* node);
+    void PostVisit(VarInitList* node);
 
-    virtual void Visit(Identifier* node) override;
-    virtual void Visit(Literal* node) override;
+    void PostVisit(ArrayAccessExpr* node);
+    void PostVisit(BinaryExpr* node);
+    void PostVisit(FuncCallExpr* node);
+    void PostVisit(Identifier* node);
+    void PostVisit(Literal* node);
+    void PostVisit(MemberAccessExpr* node);
+    void PostVisit(PostfixExpr* node);
+    void PostVisit(PrefixExpr* node);
 
+    // Getter and setter that wraps SideTable implementation details
+    void SetExprTrait(const IAbstractSyntaxTree* node, const Type& type, bool is_lvalue = false);
+    const ExprTrait& GetExprTrait(const IAbstractSyntaxTree* node) const;
 
-    virtual void Visit(MemberAccessExpr* node) override;
+    // The sink errors are reported to.
+    DiagnosticSink& Diagnostics();
 
-    virtual void Visit(PostfixExpr* node) override;
-    virtual void Visit(PrefixExpr* node) override;
+    // Throws the first error reported to the checker's own sink, if any.
+    void ThrowFirstError();
 
-private:
-    // Getter and setter that wraps std::map implementation details
-    void SetExprTrait(const IAbstractSyntaxTree* node, const Type& type, bool is_lvalue = false);
-    const ExprTrait& GetExprTrait(const IAbstractSyntaxTree* node) const;
+    // Errors reported so far, along with the nodes that failed silently.
+    size_t NumFailures() const;
 
-    // Checks if a type is valid (i.e. all struct types are visible in this context).
-    // If not, semantic error will be thrown.
-    void ValidateTypeExistence(const Type& type, std::string_view who, const SourcePos& where);
+    // Checks if a type is valid (i.e. all struct types were bound to a struct).
+    // If not, an error is reported and false is returned.
+    bool ValidateTypeExistence(const Type& type, LazyMessage who, const SourcePos& where);
 
     // Check if the expression has bool type.
-    // If not, semantic error will be thrown.
-    void ValidateConditionExprType(const Expr* condition_expr);
+    // If not, an error is reported and false is returned.
+    bool ValidateConditionExprType(const Expr* condition_expr);
 
     // Check if the expression is an lvalue.
-    // If not, semantic error will be thrown.
-    void ValidateLValueQualifier(const Expr* expr, std::string_view who, const SourcePos& where);
+    // If not, an error is reported and false is returned.
+    bool ValidateLValueQualifier(const Expr* expr, LazyMessage who, const SourcePos& where);
 
     // Find the declaration of the type.
-    // If it wasn't a struct type, semantic error will be thrown.
+    // If it wasn't a struct type, an error is reported and nullptr is returned.
     const StructDecl* TryToFindStructTypeDecl(const Type &type, const SourcePos &where);
 
-    ProgramEnvironment& m_environment;
+    const NameBindings& m_bindings;
 
-    // The name of module we are parsing
-    std::string_view m_context_module_name;
+    // Where member accesses are bound, which is 'm_bindings' unless this checker
+    // is a task of CheckConcurrently() with bindings of its own.
+    NameBindings* m_member_bindings;
 
-    // Stores temporary expression node's type
-    std::map<const IAbstractSyntaxTree*, ExprTrait> m_expr_trait_dict;
+    // Stores expression node's type
+    SideTable<ExprTrait> m_expr_traits;
 
     // Used to store a currently analyzed function's signature.
     // Return type matching is the key purpose for saving this info.
-    FuncDecl* m_current_function;
+    FuncDecl* m_current_function = nullptr;
+
+    // Hooks of the passes that share the walk, while Walk() runs.
+    IAstNodeHooks* m_hooks = nullptr;
+
+    // Where errors are reported, or nullptr to collect them in 'm_own_diagnostics' and throw.
+    DiagnosticSink* m_diagnostics;
+    DiagnosticSink m_own_diagnostics;
+
+    // Nodes that failed without reporting anything,
+    // because what they refer to had already been reported.
+    size_t m_num_silent_failures = 0;
+
+    // NumFailures() when each node on the path from the root was entered.
+    std::vector<size_t> m_failures_on_entry;
+
+    // Whether anything failed in the subtree of the node that was left last,
+    // which AfterChild() looks at.
+    bool m_has_left_node_failed = false;
 };
 
 } // namespace mylang
@@ -3,27 +3,48 @@
 
 #include "parser/routine/IParseRoutine.h"
 #include "parser/ast/expr/Expr.h"
+#include "parser/ast/AstArena.h"
 
 namespace mylang
 {
 
-class ExprParser : public IParseRoutine<std::shared_ptr<Expr>>
+// Parses expressions without recursion.
+//
+// Every nested "expr" in the grammar (parenthesized expression, array index,
+// function argument, and right-hand side of assignment) is parsed on an explicit
+// stack of frames, and binary operators are resolved by operator precedence.
+// The resulting tree and error messages are the same as those of
+// a recursive descent parser for the grammar written on each routine.
+//
+// Nesting deeper than max_nesting_depth throws NestingLimitError.
+// Each nested expr and each prefix operator counts as one level.
+class ExprParser : public IParseRoutine<Expr*>
 {
 public:
-    ExprParser(std::shared_ptr<BufferedStream<Token>> token_stream);
+    ExprParser(std::shared_ptr<BufferedStream<Token>> token_stream, std::shared_ptr<AstArena> arena, int max_nesting_depth = DefaultMaxNestingDepth);
 
     virtual bool CanStartParsing() override;
-    virtual std::shared_ptr<Expr> Parse() override;
+    virtual Expr* Parse() override;
 
 private:
-    std::shared_ptr<Expr> ParseOrExpr();
-    std::shared_ptr<Expr> ParseAndExpr();
-    std::shared_ptr<Expr> ParseCompareExpr();
-    std::shared_ptr<Expr> ParseAddExpr();
-    std::shared_ptr<Expr> ParseMultExpr();
-    std::shared_ptr<Expr> ParsePrefixExpr();
-    std::shared_ptr<Expr> ParsePostfixExpr();
-    std::shared_ptr<Expr> ParsePrimaryExpr();
+    enum class Step;
+    enum class FrameContext;
+    struct Frame;
+    struct ParseState;
+
+    // Each step consumes some tokens for the current frame
+    // and returns the step that should come next.
+    Step ParseOperand(ParseState& state);
+    Step ParsePostfixOps(ParseState& state);
+    Step ParseBinaryOp(ParseState& state);
+    Step CompleteFrame(ParseState& state);
+
+    // Start parsing a nested expr right after the given token.
+    void PushFrame(ParseState& state, FrameContext context, const Token& token);
+    void EnterNesting(ParseState& state, const Token& token);
+
+    std::shared_ptr<AstArena> m_arena;
+    int m_max_nesting_depth;
 };
 
 } // namespace mylang
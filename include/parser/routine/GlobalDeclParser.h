@@ -2,6 +2,7 @@
 #define MYLANG_GLOBAL_DECL_PARSER_H
 
 #include "parser/routine/IParseRoutine.h"
+#include "parser/ast/AstArena.h"
 #include "parser/ast/globdecl/GlobalDecl.h"
 #include "parser/ast/stmt/Stmt.h"
 #include "parser/type/Type.h"
@@ -13,29 +14,31 @@ struct MemberVariable;
 class Parameter;
 enum class ParamUsage;
 
-class GlobalDeclParser : public IParseRoutine<std::shared_ptr<GlobalDecl>>
+class GlobalDeclParser : public IParseRoutine<GlobalDecl*>
 {
 public:
     GlobalDeclParser(
         std::shared_ptr<BufferedStream<Token>> token_stream,
-        std::shared_ptr<IParseRoutine<std::shared_ptr<Stmt>>> stmt_parser,
+        std::shared_ptr<AstArena> arena,
+        std::shared_ptr<IParseRoutine<Stmt*>> stmt_parser,
         std::shared_ptr<IParseRoutine<Type>> type_parser
     );
 
     virtual bool CanStartParsing() override;
-    virtual std::shared_ptr<GlobalDecl> Parse() override;
+    virtual GlobalDecl* Parse() override;
 
 private:
-    std::shared_ptr<GlobalDecl> ParseFuncDecl(bool should_export, const Token& name);
-    std::shared_ptr<GlobalDecl> ParseStructDecl(bool should_export, const Token& name);
+    GlobalDecl* ParseFuncDecl(bool should_export, const Token& name);
+    GlobalDecl* ParseStructDecl(bool should_export, const Token& name);
 
-    std::vector<std::shared_ptr<Parameter>> ParseParamList();
-    std::shared_ptr<Parameter> ParseParam();
+    std::vector<Parameter*> ParseParamList();
+    Parameter* ParseParam();
     ParamUsage ParseParamUsage();
 
     MemberVariable ParseMemberDecl();
 
-    std::shared_ptr<IParseRoutine<std::shared_ptr<Stmt>>> m_stmt_parser;
+    std::shared_ptr<AstArena> m_arena;
+    std::shared_ptr<IParseRoutine<Stmt*>> m_stmt_parser;
     std::shared_ptr<IParseRoutine<Type>> m_type_parser;
 };
 
@@ -11,6 +11,11 @@
 namespace mylang
 {
 
+// Default limit on how deeply expressions and statements can be nested.
+// Parse routines for nested constructs keep their state on the heap,
+// but the resulting tree is still processed recursively by the later stages.
+const int DefaultMaxNestingDepth = 256;
+
 // Interface for parse routines that convert
 // specific token pattern into an object of type T.
 // It is mostly used to generate AST nodes,
@@ -2,28 +2,31 @@
 #define MYLANG_MODULE_PARSER_H
 
 #include "parser/routine/IParseRoutine.h"
+#include "parser/ast/AstArena.h"
 #include "parser/ast/Module.h"
 #include "parser/ast/globdecl/GlobalDecl.h"
 
 namespace mylang
 {
 
-class ModuleParser : public IParseRoutine<std::shared_ptr<Module>>
+class ModuleParser : public IParseRoutine<Module*>
 {
 public:
     ModuleParser(
         std::shared_ptr<BufferedStream<Token>> token_stream,
-        std::shared_ptr<IParseRoutine<std::shared_ptr<GlobalDecl>>> global_decl_parser
+        std::shared_ptr<AstArena> arena,
+        std::shared_ptr<IParseRoutine<GlobalDecl*>> global_decl_parser
     );
 
     virtual bool CanStartParsing() override;
-    virtual std::shared_ptr<Module> Parse() override;
+    virtual Module* Parse() override;
 
 private:
     Token ParseModuleDecl();
     ModuleImportInfo ParseModuleImport();
 
-    std::shared_ptr<IParseRoutine<std::shared_ptr<GlobalDecl>>> m_global_decl_parser;
+    std::shared_ptr<AstArena> m_arena;
+    std::shared_ptr<IParseRoutine<GlobalDecl*>> m_global_decl_parser;
 };
 
 } // namespace mylang
@@ -2,6 +2,7 @@
 #define MYLANG_STMT_PARSER_H
 
 #include "parser/routine/IParseRoutine.h"
+#include "parser/ast/AstArena.h"
 #include "parser/ast/varinit/VarInit.h"
 #include "parser/ast/stmt/Stmt.h"
 #include "parser/ast/expr/Expr.h"
@@ -10,32 +11,61 @@
 namespace mylang
 {
 
-class StmtParser : public IParseRoutine<std::shared_ptr<Stmt>>
+// Parses statements without recursion.
+//
+// Statements containing a compound-stmt (i.e., compound, if, for, and while)
+// are parsed on an explicit stack of frames, so that deeply nested blocks
+// don't exhaust the native stack. The same goes for nested initializer lists.
+// The resulting tree and error messages are the same as those of
+// a recursive descent parser for the grammar written on each routine.
+//
+// Nesting blocks or initializer lists deeper than max_nesting_depth
+// throws NestingLimitError. An "else if" is not considered as nesting.
+class StmtParser : public IParseRoutine<Stmt*>
 {
 public:
     StmtParser(
         std::shared_ptr<BufferedStream<Token>> token_stream,
-        std::shared_ptr<IParseRoutine<std::shared_ptr<Expr>>> expr_parser,
-        std::shared_ptr<IParseRoutine<Type>> type_parser
+        std::shared_ptr<AstArena> arena,
+        std::shared_ptr<IParseRoutine<Expr*>> expr_parser,
+        std::shared_ptr<IParseRoutine<Type>> type_parser,
+        int max_nesting_depth = DefaultMaxNestingDepth
     );
 
     virtual bool CanStartParsing() override;
-    virtual std::shared_ptr<Stmt> Parse() override;
+    virtual Stmt* Parse() override;
 
 private:
+    enum class FrameType;
+    struct Frame;
+
     bool CanStartParsingVarDecl();
 
-    std::shared_ptr<Stmt> ParseCompoundStmt();
-    std::shared_ptr<Stmt> ParseIfStmt();
-    std::shared_ptr<Stmt> ParseForStmt();
-    std::shared_ptr<Stmt> ParseWhileStmt();
-    std::shared_ptr<Stmt> ParseJumpStmt();
-    std::shared_ptr<Stmt> ParseVarDeclStmt();
-    std::shared_ptr<VarInit> ParseVarInit();
-    std::shared_ptr<Stmt> ParseExprStmt();
+    // Each function pushes the frame for a statement and
+    // parses tokens until the next nested compound-stmt begins.
+    // Statements without nested compound-stmt are returned immediately,
+    // while nullptr means the statement is waiting on the stack.
+    Stmt* BeginStmt(std::vector<Frame>& frames);
+    Stmt* BeginCompoundStmt(std::vector<Frame>& frames);
+    Stmt* BeginIfStmt(std::vector<Frame>& frames);
+    Stmt* BeginForStmt(std::vector<Frame>& frames);
+    Stmt* BeginWhileStmt(std::vector<Frame>& frames);
+
+    // Resume the statement on top of the stack with the result of
+    // the nested statement (nullptr if nothing has been parsed yet).
+    Stmt* ResumeStmt(std::vector<Frame>& frames, Stmt* nested_stmt);
+
+    void PushFrame(std::vector<Frame>& frames, FrameType type, std::string_view pattern);
+
+    Stmt* ParseJumpStmt();
+    Stmt* ParseVarDeclStmt();
+    VarInit* ParseVarInit();
+    Stmt* ParseExprStmt();
 
-    std::shared_ptr<IParseRoutine<std::shared_ptr<Expr>>> m_expr_parser;
+    std::shared_ptr<AstArena> m_arena;
+    std::shared_ptr<IParseRoutine<Expr*>> m_expr_parser;
     std::shared_ptr<IParseRoutine<Type>> m_type_parser;
+    int m_max_nesting_depth;
 };
 
 } // namespace mylang
@@ -2,9 +2,11 @@
 #define MYLANG_TYPE_H
 
 #include "parser/type/base/IBaseType.h"
+#include "parser/type/TypeTable.h"
 #include "lexer/Token.h"
 #include <vector>
 #include <memory>
+#include <optional>
 
 namespace mylang
 {
@@ -12,6 +14,9 @@ namespace mylang
 // Type is a tuple of base type and array info.
 // It provides turning every base type into array of base type,
 // and some compile-type type manipulations such as removing an array dimension.
+//
+// Each distinct type is interned in the global TypeTable,
+// so comparing types and spelling them don't build any string.
 class Type
 {
 public:
@@ -23,14 +28,24 @@ public:
     bool IsArray() const;
     int NumDimensions() const;
 
+    // The same type without array dimensions.
+    // ex) i32[10][20] -> i32
+    Type ElementType() const;
+
+    // Either i32 or f32, not an array.
+    bool IsNumeric() const;
+
     // Wrapper functions for underlying base type.
-    std::string ToString() const;
-    std::string ToCppString() const;
+    const std::string& ToString() const;
+    const std::string& ToCppString() const;
     bool IsValid(
         ProgramEnvironment& environment,
         std::string_view context_module_name
     ) const;
 
+    // Whether the type is valid in every context, or depends on the symbols of the module.
+    TypeValidity Validity() const;
+
     // ex) i32[10][20] -> i32[20]
     // ex) bool[5] -> bool
     void RemoveLeftmostArrayDim();
@@ -48,12 +63,17 @@ public:
     bool operator!=(const Type& other) const;
 
 protected:
+    // The base type this Type was created with, which keeps its own source positions.
     std::shared_ptr<IBaseType> m_base_type;
-    std::vector<int> m_array_sizes;
+
+    // The interned type, which is the same for every equal Type.
+    const TypeEntry* m_entry;
 };
 
 // A factory method for primitive types: i32, f32, bool, and str.
+// Throws an exception for any other type, unlike TryCreatePrimiveType() which returns nothing.
 Type CreatePrimiveType(TokenType type);
+std::optional<Type> TryCreatePrimiveType(TokenType type);
 Type CreateVoidType();
 
 } // namespace mylang
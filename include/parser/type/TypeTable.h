@@ -0,0 +1,110 @@
+#ifndef MYLANG_TYPE_TABLE_H
+#define MYLANG_TYPE_TABLE_H
+
+#include "parser/type/base/IBaseType.h"
+#include <array>
+#include <deque>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mylang
+{
+
+// Whether a type is valid, if it can be told without looking at the symbols.
+enum class TypeValidity
+{
+    Valid,
+    Invalid,
+
+    // The type mentions a struct type, which should be visible
+    // as a struct in the module (see IBaseType::IsValid()).
+    DependsOnContext,
+};
+
+// A distinct type, shared by every Type that compares equal to it.
+// Its properties are computed once when it is interned, and never change.
+//
+// Note: an entry doesn't keep any base type, since a struct type refers to
+// its declaration, which lives no longer than the tree it was bound in.
+// Each Type keeps its own base type instead.
+struct TypeEntry
+{
+    // The entry without any array dimension,
+    // which is the entry itself for a non-array type.
+    const TypeEntry* element_entry;
+
+    std::vector<int> array_sizes;
+
+    // Same as Type::ToString() and Type::ToCppString().
+    std::string name;
+    std::string cpp_name;
+
+    // Either i32 or f32.
+    bool is_numeric;
+
+    TypeValidity validity;
+};
+
+// Interns types, so that each distinct type is a single TypeEntry.
+//
+// Base types are told apart by their spelling (IBaseType::ToString()),
+// and array types by their element entry and array sizes,
+// so comparing two types is comparing their entries.
+//
+// Entries are never freed. Types are interned while parsing,
+// possibly on several threads at once. Primitive types and void are interned
+// up front, so they are found without spelling them or taking the lock.
+// Other lookups share the lock, and only adding an entry takes it exclusively.
+class TypeTable
+{
+public:
+    TypeTable();
+
+    // The table shared by the whole compiler.
+    static TypeTable& Global();
+
+    const TypeEntry* Intern(const std::shared_ptr<IBaseType>& base_type, const std::vector<int>& array_sizes);
+
+    // Returns the entry with the element type of 'element_entry' and the given array sizes.
+    const TypeEntry* InternArray(const TypeEntry* element_entry, const std::vector<int>& array_sizes);
+
+private:
+    struct ArrayTypeKey
+    {
+        const TypeEntry* element_entry;
+        std::vector<int> array_sizes;
+
+        bool operator==(const ArrayTypeKey& other) const = default;
+    };
+
+    struct ArrayTypeKeyHash
+    {
+        size_t operator()(const ArrayTypeKey& key) const;
+    };
+
+    // Returns nothing unless the base type was interned up front.
+    const TypeEntry* FindPredefinedEntry(const IBaseType* base_type) const;
+
+    const TypeEntry* InternElement(const IBaseType* base_type);
+
+    std::shared_mutex m_mutex;
+
+    // Entries of i32, f32, bool, and str, and of void.
+    std::array<const TypeEntry*, 4> m_primitive_entries;
+    const TypeEntry* m_void_entry;
+
+    // Entries don't move once they are added.
+    std::deque<TypeEntry> m_entries;
+
+    // Maps the spelling of a base type to its entry.
+    std::unordered_map<std::string, const TypeEntry*> m_element_entries;
+
+    std::unordered_map<ArrayTypeKey, const TypeEntry*, ArrayTypeKeyHash> m_array_entries;
+};
+
+} // namespace mylang
+
+#endif // MYLANG_TYPE_TABLE_H
@@ -20,6 +20,8 @@ public:
         std::string_view context_module_name
     ) const override;
 
+    const Token& TypeToken() const;
+
 private:
     Token m_type;
 };
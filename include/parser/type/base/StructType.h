@@ -7,6 +7,8 @@
 namespace mylang
 {
 
+class StructDecl;
+
 // A base type class for user-defined struct types.
 class StructType : public IBaseType
 {
@@ -20,8 +22,19 @@ public:
         std::string_view context_module_name
     ) const override;
 
+    const Token& TypeToken() const;
+
+    // The struct that the name referred to where the type was used,
+    // or nullptr if it wasn't bound yet or didn't name a struct (see NameBinder).
+    // Copies of a Type share their base type, so they share the binding as well.
+    const StructDecl* Declaration() const;
+    void BindDeclaration(const StructDecl* declaration) const;
+
 private:
     Token m_type;
+
+    // Binding doesn't change what the type is, only where its name was resolved to.
+    mutable const StructDecl* m_declaration = nullptr;
 };
 
 } // namespace mylang
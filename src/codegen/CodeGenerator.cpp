@@ -147,7 +147,7 @@ void CodeGenerator::EmitForwardDecl(IOutputFile* output_file, const std::vector<
     
     for (const auto& symbol : symbols)
     {
-        symbol.declaration->Accept(this);
+        Walk(symbol.declaration);
     }
 
     // Enable recursive tree traversal.
@@ -159,6 +159,7 @@ void CodeGenerator::Visit(Module* node)
     const auto& module_name = node->ModuleName().lexeme;
 
     // Handle per-module actions such as header file generation.
+    // Note: this walks the global declarations, so it should be done before walking the module.
     if (!IsModuleNodeVisited(module_name))
     {
         MarkModuleAsVisited(module_name);
@@ -170,13 +171,10 @@ void CodeGenerator::Visit(Module* node)
     // From now on, all implementation codes will be emitted to this file.
     m_current_output_file = GetFile(SourceFileName(module_name));
 
-    for (const auto& decl : node->Declarations())
-    {
-        decl->Accept(this);
-    }
+    Walk(node);
 }
 
-void CodeGenerator::Visit(FuncDecl* node)
+bool CodeGenerator::PreVisit(FuncDecl* node)
 {
     m_current_output_file->Print(std::format("{} {}(",
         node->ReturnType().ToCppString(),
@@ -201,15 +199,22 @@ void CodeGenerator::Visit(FuncDecl* node)
     if (m_is_forward_decl_step)
     {
         m_current_output_file->Print(";\n");
+        return false;
     }
     else
     {
         m_current_output_file->Print(" ");
-        node->Body()->Accept(this);
+        return true;
     }
 }
 
-void CodeGenerator::Visit(StructDecl* node)
+// Parameters are already printed along with the signature.
+bool CodeGenerator::BeforeChild(FuncDecl* node, IAbstractSyntaxTree* child)
+{
+    return child == node->Body();
+}
+
+bool CodeGenerator::PreVisit(StructDecl* node)
 {
     // In C++, we cannot use a struct type before providing the definition.
     // This means that forward declaration doesn't work as in functions!
@@ -233,21 +238,23 @@ void CodeGenerator::Visit(StructDecl* node)
         m_current_output_file->DecreaseDepth();
         m_current_output_file->Print("};\n");
     }
+    return false;
 }
 
-void CodeGenerator::Visit(CompoundStmt* node)
+bool CodeGenerator::PreVisit(CompoundStmt* node)
 {
     m_current_output_file->PrintIndented("{\n");
     m_current_output_file->IncreaseDepth();
-    for (const auto& stmt : node->Statements())
-    {
-        stmt->Accept(this);
-    }
+    return true;
+}
+
+void CodeGenerator::PostVisit(CompoundStmt* node)
+{
     m_current_output_file->DecreaseDepth();
     m_current_output_file->PrintIndented("}\n");
 }
 
-void CodeGenerator::Visit(VarDeclStmt* node)
+bool CodeGenerator::PreVisit(VarDeclStmt* node)
 {
     const auto& var_type = node->DeclType();
     m_current_output_file->PrintIndented(std::format("{} {}",
@@ -256,88 +263,107 @@ void CodeGenerator::Visit(VarDeclStmt* node)
     ));
 
     // Handle optional initializer part.
-    if (auto initializer = node->Initializer())
+    if (node->Initializer())
     {
         m_current_output_file->Print(" = ");
         if (var_type.IsArray())
         {
             m_current_output_file->Print("{");
         }
-
-        initializer->Accept(this);
-        
-        if (var_type.IsArray())
-        {
-            m_current_output_file->Print("}");
-        }
-        m_current_output_file->Print(";\n");
     }
-    else
+    return true;
+}
+
+void CodeGenerator::PostVisit(VarDeclStmt* node)
+{
+    if (node->Initializer() && node->DeclType().IsArray())
     {
-        m_current_output_file->Print(";\n");
+        m_current_output_file->Print("}");
     }
+    m_current_output_file->Print(";\n");
 }
 
-void CodeGenerator::Visit(VarInitExpr* node)
+// Expressions are printed as a whole, so there is no need to go further down.
+bool CodeGenerator::PreVisit(VarInitExpr* node)
 {
     m_current_output_file->Print(node->Expression()->ToString());
+    return false;
 }
 
-void CodeGenerator::Visit(VarInitList* node)
+bool CodeGenerator::PreVisit(VarInitList* node)
 {
     m_current_output_file->Print("{");
-    const auto& list_elem = node->InitializerList();
-    for (int i = 0; i < list_elem.size(); ++i)
-    {
-        // Separator between elements.
-        if (i > 0)
-        {
-            m_current_output_file->Print(", ");
-        }
+    return true;
+}
 
-        list_elem[i]->Accept(this);
+bool CodeGenerator::BeforeChild(VarInitList* node, IAbstractSyntaxTree* child)
+{
+    // Separator between elements.
+    if (child != node->InitializerList().front())
+    {
+        m_current_output_file->Print(", ");
     }
+    return true;
+}
+
+void CodeGenerator::PostVisit(VarInitList* node)
+{
     m_current_output_file->Print("}");
 }
 
-void CodeGenerator::Visit(ExprStmt* node)
+bool CodeGenerator::PreVisit(ExprStmt* node)
 {
     m_current_output_file->PrintIndented(std::format("{};\n", node->Expression()->ToString()));
+    return false;
 }
 
-void CodeGenerator::Visit(IfStmt* node)
+bool CodeGenerator::PreVisit(IfStmt* node)
 {
     m_current_output_file->PrintIndented(std::format("if ({}) ", node->Condition()->ToString()));
     m_current_output_file->DisableNextIndentation(); // We want to place then-branch at the same line.
-    node->ThenBranch()->Accept(this);
+    return true;
+}
+
+bool CodeGenerator::BeforeChild(IfStmt* node, IAbstractSyntaxTree* child)
+{
+    // The condition is already printed.
+    if (child == node->Condition())
+    {
+        return false;
+    }
 
-    if (auto else_branch = node->ElseBranch())
+    if (child == node->ElseBranch())
     {
         m_current_output_file->PrintIndented("else ");
         m_current_output_file->DisableNextIndentation(); // We want to place else-branch at the same line.
-        else_branch->Accept(this);
     }
+    return true;
 }
 
-void CodeGenerator::Visit(ForStmt* node)
+// Create a nested scope to prevent the variable declared in the initializer
+// from being visible on the scope outside the loop body.
+// ex) "for (init; cond; inc) body" gets translated to the following C++ code:
+// {
+//     init;
+//     while (true) {
+//         if (cond == false) break;
+//         body;
+//         inc;
+//     }
+// }
+bool CodeGenerator::PreVisit(ForStmt* node)
 {
-    // Create a nested scope to prevent the variable declared in the initializer
-    // from being visible on the scope outside the loop body.
-    // ex) "for (init; cond; inc) body" gets translated to the following C++ code:
-    // {
-    //     init;
-    //     while (true) {
-    //         if (cond == false) break;
-    //         body;
-    //         inc;
-    //     }
-    // }
     m_current_output_file->PrintIndented("{\n");
     m_current_output_file->IncreaseDepth();
+    return true;
+}
 
-    if (auto initializer = node->Initializer())
+// The condition and the increment are printed around the body.
+bool CodeGenerator::BeforeChild(ForStmt* node, IAbstractSyntaxTree* child)
+{
+    if (child != node->Body())
     {
-        initializer->Accept(this);
+        return child == node->Initializer();
     }
 
     m_current_output_file->PrintIndented("while (true) {\n");
@@ -347,9 +373,16 @@ void CodeGenerator::Visit(ForStmt* node)
     {
         m_current_output_file->PrintIndented(std::format("if ({} == false) break;\n", condition->ToString()));
     }
+    return true;
+}
+
+void CodeGenerator::AfterChild(ForStmt* node, IAbstractSyntaxTree* child)
+{
+    if (child != node->Body())
+    {
+        return;
+    }
 
-    node->Body()->Accept(this);
-    
     if (auto increment = node->IncrementExpr())
     {
         m_current_output_file->PrintIndented(increment->ToString());
@@ -358,19 +391,28 @@ void CodeGenerator::Visit(ForStmt* node)
     
     m_current_output_file->DecreaseDepth();
     m_current_output_file->PrintIndented("}\n"); // End of while (true){...}
+}
 
+void CodeGenerator::PostVisit(ForStmt* node)
+{
     m_current_output_file->DecreaseDepth();
     m_current_output_file->PrintIndented("}\n"); // End of the outermost block "{ while (true){ ... } }"
 }
 
-void CodeGenerator::Visit(WhileStmt* node)
+bool CodeGenerator::PreVisit(WhileStmt* node)
 {
     m_current_output_file->PrintIndented(std::format("while ({}) ", node->Condition()->ToString()));
     m_current_output_file->DisableNextIndentation(); // We want to place the loop body at the same line.
-    node->Body()->Accept(this);
+    return true;
+}
+
+// The condition is already printed.
+bool CodeGenerator::BeforeChild(WhileStmt* node, IAbstractSyntaxTree* child)
+{
+    return child == node->Body();
 }
 
-void CodeGenerator::Visit(JumpStmt* node)
+bool CodeGenerator::PreVisit(JumpStmt* node)
 {
     m_current_output_file->PrintIndented(node->JumpType().lexeme);
     if (auto return_expr = node->ReturnValueExpr())
@@ -379,6 +421,7 @@ void CodeGenerator::Visit(JumpStmt* node)
         m_current_output_file->Print(return_expr->ToString());
     }
     m_current_output_file->Print(";\n");
+    return false;
 }
 
 } // namespace mylang
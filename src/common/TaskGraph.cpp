@@ -0,0 +1,143 @@
+#include "common/TaskGraph.h"
+#include <stdexcept>
+
+namespace mylang
+{
+
+struct TaskGraph::RunState
+{
+    std::mutex mutex;
+    std::vector<size_t> num_pending_dependencies;
+
+    // Not std::vector<bool>, whose neighbouring flags share a word,
+    // since Start() reads the flag of a task without the lock.
+    std::vector<char> has_failed_dependency;
+    size_t num_finished = 0;
+
+    // Each slot is written only by its own task.
+    std::vector<std::exception_ptr> errors;
+
+    // Set by the last task to finish, after which the state is no longer touched by it.
+    std::promise<void> all_finished;
+};
+
+TaskGraph::TaskId TaskGraph::AddTask(std::function<void()> task, const std::vector<TaskId>& dependencies)
+{
+    auto id = m_nodes.size();
+    for (auto dependency : dependencies)
+    {
+        if (dependency >= id)
+        {
+            throw std::invalid_argument("[Task Error] a task can only depend on the tasks added before it");
+        }
+    }
+
+    for (auto dependency : dependencies)
+    {
+        m_nodes[dependency].dependents.push_back(id);
+    }
+    m_nodes.push_back(Node{std::move(task), {}, dependencies.size()});
+    return id;
+}
+
+size_t TaskGraph::NumTasks() const
+{
+    return m_nodes.size();
+}
+
+void TaskGraph::Run(ThreadPool& thread_pool, const std::function<void(TaskId)>& on_error)
+{
+    if (m_nodes.empty())
+    {
+        return;
+    }
+
+    // The last task may still hold the state after Run() returns, so it is shared.
+    auto state = std::make_shared<RunState>();
+    state->has_failed_dependency.assign(m_nodes.size(), false);
+    state->errors.resize(m_nodes.size());
+    for (const auto& node : m_nodes)
+    {
+        state->num_pending_dependencies.push_back(node.num_dependencies);
+    }
+    auto all_finished = state->all_finished.get_future();
+
+    for (TaskId id = 0; id < m_nodes.size(); ++id)
+    {
+        if (m_nodes[id].num_dependencies == 0)
+        {
+            Start(id, state, thread_pool);
+        }
+    }
+    thread_pool.Wait(all_finished);
+
+    for (TaskId id = 0; id < m_nodes.size(); ++id)
+    {
+        if (state->errors[id])
+        {
+            if (on_error)
+            {
+                on_error(id);
+            }
+            std::rethrow_exception(state->errors[id]);
+        }
+    }
+}
+
+void TaskGraph::Start(TaskId id, const std::shared_ptr<RunState>& state, ThreadPool& thread_pool)
+{
+    // The flag was last written under the lock that saw the last dependency finish.
+    if (state->has_failed_dependency[id])
+    {
+        Finish(id, false, state, thread_pool);
+        return;
+    }
+
+    thread_pool.Submit([this, id, state, &thread_pool]() {
+        auto has_succeeded = true;
+        try
+        {
+            m_nodes[id].task();
+        }
+        catch(...)
+        {
+            state->errors[id] = std::current_exception();
+            has_succeeded = false;
+        }
+        Finish(id, has_succeeded, state, thread_pool);
+    });
+}
+
+void TaskGraph::Finish(TaskId id, bool has_succeeded, const std::shared_ptr<RunState>& state, ThreadPool& thread_pool)
+{
+    auto ready_tasks = std::vector<TaskId>();
+    auto is_last_task = false;
+    {
+        auto lock = std::lock_guard(state->mutex);
+        for (auto dependent : m_nodes[id].dependents)
+        {
+            if (!has_succeeded)
+            {
+                state->has_failed_dependency[dependent] = true;
+            }
+            if (--state->num_pending_dependencies[dependent] == 0)
+            {
+                ready_tasks.push_back(dependent);
+            }
+        }
+        is_last_task = (++state->num_finished == m_nodes.size());
+    }
+
+    // Nothing is ready once every task has finished,
+    // so Run() can't return while this still starts other tasks.
+    for (auto ready_task : ready_tasks)
+    {
+        Start(ready_task, state, thread_pool);
+    }
+    if (is_last_task)
+    {
+        state->all_finished.set_value();
+    }
+}
+
+} // namespace mylang
@@ -0,0 +1,146 @@
+#include "common/ThreadPool.h"
+#include <algorithm>
+#include <utility>
+
+namespace mylang
+{
+
+ThreadPool::ThreadPool(unsigned int num_threads)
+{
+    num_threads = std::max(num_threads, 1u);
+    for (unsigned int i = 0; i < num_threads; ++i)
+    {
+        m_workers.emplace_back([this](){ RunWorker(); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        auto lock = std::lock_guard(m_mutex);
+        m_is_stopping = true;
+    }
+    m_task_available.notify_all();
+
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+unsigned int ThreadPool::NumThreads() const
+{
+    return static_cast<unsigned int>(m_workers.size());
+}
+
+void ThreadPool::Enqueue(std::function<void()> task)
+{
+    auto node = std::make_shared<TaskNode>();
+    node->run = std::move(task);
+    node->parent = CurrentTask();
+    {
+        auto lock = std::lock_guard(m_mutex);
+        m_tasks.push_back(node);
+        for (auto origin = node->parent.get(); origin; origin = origin->parent.get())
+        {
+            origin->pending_descendants.push_back(node);
+        }
+        NotifyWaitingThreads();
+    }
+    m_task_available.notify_one();
+}
+
+void ThreadPool::RunWorker()
+{
+    while (true)
+    {
+        auto task = std::shared_ptr<TaskNode>();
+        {
+            auto lock = std::unique_lock(m_mutex);
+            m_task_available.wait(lock, [&](){
+                task = TakePendingTask(nullptr);
+                return task || m_is_stopping;
+            });
+
+            // Remaining tasks are still executed before the pool shuts down.
+            if (!task)
+            {
+                return;
+            }
+        }
+        RunTask(std::move(task));
+    }
+}
+
+void ThreadPool::WaitUntil(const std::function<bool()>& is_ready)
+{
+    auto current_task = CurrentTask().get();
+    auto lock = std::unique_lock(m_mutex);
+    while (!is_ready())
+    {
+        // Help other workers instead of blocking this thread.
+        if (auto task = TakePendingTask(current_task))
+        {
+            lock.unlock();
+            RunTask(std::move(task));
+            lock.lock();
+            continue;
+        }
+
+        // Nothing may run here, so what we wait for is running somewhere else.
+        ++m_num_waiting_threads;
+        m_state_changed.wait(lock);
+        --m_num_waiting_threads;
+    }
+}
+
+std::shared_ptr<ThreadPool::TaskNode> ThreadPool::TakePendingTask(TaskNode* origin)
+{
+    // Only the tasks below the current one in the tree of origins may run on top of it.
+    auto& tasks = origin ? origin->pending_descendants : m_tasks;
+    while (!tasks.empty())
+    {
+        auto task = std::move(tasks.front());
+        tasks.pop_front();
+        if (!task->is_taken)
+        {
+            task->is_taken = true;
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+void ThreadPool::RunTask(std::shared_ptr<TaskNode> task)
+{
+    // Tasks may be nested on a thread that waits, so the outer one is restored afterwards.
+    auto outer_task = std::exchange(CurrentTask(), task);
+    task->run();
+    CurrentTask() = std::move(outer_task);
+
+    {
+        auto lock = std::lock_guard(m_mutex);
+
+        // Release the result and the subtasks that are still pending elsewhere,
+        // which refer back to this task.
+        task->run = nullptr;
+        task->pending_descendants.clear();
+        NotifyWaitingThreads();
+    }
+}
+
+void ThreadPool::NotifyWaitingThreads()
+{
+    if (m_num_waiting_threads > 0)
+    {
+        m_state_changed.notify_all();
+    }
+}
+
+std::shared_ptr<ThreadPool::TaskNode>& ThreadPool::CurrentTask()
+{
+    thread_local auto current_task = std::shared_ptr<TaskNode>();
+    return current_task;
+}
+
+} // namespace mylang
@@ -1,5 +1,6 @@
 #include "file/SourceFile.h"
 #include <format>
+#include <sstream>
 
 namespace mylang
 {
@@ -38,4 +39,17 @@ void SourceFile::LoadNextChar()
     }
 }
 
+std::string ReadSourceCode(const std::filesystem::path& path)
+{
+    auto file = std::ifstream(path, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error(std::format("[I/O Error] failed to open input file on path '{}'", path.string()));
+    }
+
+    auto content = std::ostringstream();
+    content << file.rdbuf();
+    return content.str();
+}
+
 } // namespace mylang
@@ -0,0 +1,40 @@
+#include "lexer/TokenBufferCursor.h"
+
+namespace mylang
+{
+
+TokenBufferCursor::TokenBufferCursor(std::shared_ptr<const std::vector<Token>> tokens, size_t begin, size_t end)
+    : m_tokens(tokens)
+    , m_current_token_ind(begin)
+    , m_end_token_ind(end)
+{}
+
+bool TokenBufferCursor::IsFinished() const
+{
+    return m_is_finished;
+}
+
+Token TokenBufferCursor::GetNext()
+{
+    if (m_current_token_ind < m_end_token_ind)
+    {
+        return (*m_tokens)[m_current_token_ind++];
+    }
+
+    // Report EOF at the location where the range ends.
+    m_is_finished = true;
+    auto eof = Token{
+        .type = TokenType::EndOfFile,
+        .lexeme = "$",
+        .start_pos = SourcePos{0, 0},
+        .end_pos = SourcePos{0, 0}
+    };
+    if (m_end_token_ind < m_tokens->size())
+    {
+        eof.start_pos = (*m_tokens)[m_end_token_ind].start_pos;
+        eof.end_pos = eof.start_pos;
+    }
+    return eof;
+}
+
+} // namespace mylang
@@ -1,11 +1,22 @@
 #include "file/SourceFile.h"
+#include "file/DummySourceFile.h"
 #include "file/OutputFileFactory.h"
 #include "lexer/LexicalAnalyzer.h"
 #include "parser/SyntaxAnalyzer.h"
+#include "parser/AstCache.h"
+#include "parser/PassManager.h"
+#include "parser/Diagnostics.h"
+#include "parser/SemanticError.h"
 #include "parser/ast/visitor/GlobalSymbolScanner.h"
+#include "parser/ast/visitor/NameBinder.h"
 #include "parser/ast/visitor/TypeChecker.h"
 #include "parser/ast/visitor/JumpStmtUsageChecker.h"
+#include "parser/ast/visitor/AstExporter.h"
 #include "codegen/CodeGenerator.h"
+#include "common/TaskGraph.h"
+#include <algorithm>
+#include <charconv>
+#include <fstream>
 #include <iostream>
 
 using namespace mylang;
@@ -14,24 +25,99 @@ struct CommandLineArguments
 {
     std::filesystem::path output_directory;
     std::vector<std::filesystem::path> input_file_paths;
+
+    // Print the time spent in each pass and pipeline stage.
+    bool should_time_passes = false;
+
+    // Write each AST next to the generated code for external tools.
+    std::optional<AstExportFormat> dump_ast_format;
+
+    // Number of threads that parse, check and generate code for the input files.
+    // 0 means one for each hardware thread.
+    unsigned int num_jobs = 0;
+
+    // Type errors reported before the rest are dropped. 0 means no limit.
+    size_t error_limit = 20;
 };
 
+// Parses the N of "-j N" or "-jN".
+unsigned int ParseNumJobs(std::string_view value)
+{
+    auto num_jobs = 0u;
+    auto result = std::from_chars(value.data(), value.data() + value.size(), num_jobs);
+    if (value.empty() || result.ec != std::errc() || result.ptr != value.data() + value.size() || num_jobs == 0)
+    {
+        throw std::exception("[Argument Error] invalid number of jobs, expected -j N with N greater than 0");
+    }
+    return num_jobs;
+}
+
+// Parses the N of "--error-limit=N".
+size_t ParseErrorLimit(std::string_view value)
+{
+    auto error_limit = size_t{0};
+    auto result = std::from_chars(value.data(), value.data() + value.size(), error_limit);
+    if (value.empty() || result.ec != std::errc() || result.ptr != value.data() + value.size())
+    {
+        throw std::exception("[Argument Error] invalid error limit, expected --error-limit=N with N of 0 or more");
+    }
+    return error_limit;
+}
+
 auto ParseCommandLine(int argc, char** argv)
 {
+    // Options may appear anywhere, and the rest are positional arguments.
+    // Note: the executable's name is the first argument, so we start from argv[1].
+    auto arguments = CommandLineArguments{};
+    auto positional_arguments = std::vector<std::string>();
+    for (int i = 1; i < argc; ++i)
+    {
+        auto argument = std::string_view(argv[i]);
+        if (argument == "--time-passes")
+        {
+            arguments.should_time_passes = true;
+        }
+        else if (argument == "-j")
+        {
+            if (i + 1 == argc)
+            {
+                throw std::exception("[Argument Error] invalid number of jobs, expected -j N with N greater than 0");
+            }
+            arguments.num_jobs = ParseNumJobs(argv[++i]);
+        }
+        else if (argument.starts_with("-j"))
+        {
+            arguments.num_jobs = ParseNumJobs(argument.substr(2));
+        }
+        else if (argument.starts_with("--error-limit="))
+        {
+            arguments.error_limit = ParseErrorLimit(argument.substr(std::string_view("--error-limit=").size()));
+        }
+        else if (argument.starts_with("--dump-ast="))
+        {
+            arguments.dump_ast_format = ParseAstExportFormat(argument.substr(std::string_view("--dump-ast=").size()));
+            if (!arguments.dump_ast_format)
+            {
+                throw std::exception("[Argument Error] invalid AST dump format, expected --dump-ast=json or --dump-ast=bin");
+            }
+        }
+        else
+        {
+            positional_arguments.push_back(argv[i]);
+        }
+    }
+
     // We need output directory and at least one input file.
-    // Note: since the executable's name is treated as the first argument,
-    //       we should validate that argc is greater than 2.
-    if (argc <= 2)
+    if (positional_arguments.size() < 2)
     {
-        throw std::exception("[Argument Error] more than two arguments are required: [output directory] [input file 1] [input file 2] ... [input file N]");
+        throw std::exception("[Argument Error] more than two arguments are required: [--time-passes] [--dump-ast=json|bin] [--error-limit=N] [-j N] [output directory] [input file 1] [input file 2] ... [input file N]");
     }
 
     // Store arguments as path.
-    auto arguments = CommandLineArguments{};
-    arguments.output_directory = argv[1];
-    for (int i = 2; i < argc; ++i)
+    arguments.output_directory = positional_arguments[0];
+    for (size_t i = 1; i < positional_arguments.size(); ++i)
     {
-        arguments.input_file_paths.push_back(argv[i]);
+        arguments.input_file_paths.push_back(positional_arguments[i]);
     }
 
     // Make sure we can access the output directory.
@@ -48,103 +134,456 @@ auto ParseCommandLine(int argc, char** argv)
 }
 
 // Generates an AST for a given input file.
+// Top-level declarations are parsed concurrently on the given thread pool.
+// If the same source code was parsed before, the AST is loaded from the cache instead.
 // An exception will be thrown for any lexical or syntactic error.
-std::shared_ptr<IAbstractSyntaxTree> RunLexicalAndSyntaxAnalysis(const std::filesystem::path& input_file_path)
+std::shared_ptr<IAbstractSyntaxTree> RunLexicalAndSyntaxAnalysis(
+    const std::filesystem::path& input_file_path,
+    ThreadPool& thread_pool,
+    const AstCache& ast_cache
+)
 {
-    auto source_file = std::make_unique<SourceFile>(input_file_path);
+    auto source_code = ReadSourceCode(input_file_path);
+    if (auto ast = ast_cache.Load(input_file_path, source_code))
+    {
+        return ast;
+    }
+
+    // Parse the same content that the cache entry will be keyed by.
+    auto source_file = std::make_unique<DummySourceFile>(std::string(source_code));
     auto lexer = std::make_unique<LexicalAnalyzer>(std::move(source_file));
     auto syntax_analyzer = SyntaxAnalyzer(std::move(lexer));
+    auto ast = syntax_analyzer.GenerateAST(thread_pool);
 
-    return syntax_analyzer.GenerateAST();
+    ast_cache.Store(input_file_path, source_code, ast.get());
+    return ast;
 }
 
-// Perform semantic analysis and collect global symbol
-// information in the given 'environment' instance.
-// An exception will be thrown for any semantic error.
-void RunSemanticAnalysis(ProgramEnvironment& environment, IAbstractSyntaxTree* ast)
+void PrintFrontendError(const std::filesystem::path& input_file_path)
 {
-    auto scanner = GlobalSymbolScanner(environment);
-    auto type_checker = TypeChecker(environment);
-    auto jump_stmt_checker = JumpStmtUsageChecker();
+    std::cerr << std::format("# Error occured while parsing file \'{}\'\n", input_file_path.string());
+}
+
+// Writes the AST of each input file into the output directory,
+// as "<input index>-<input file name>.ast.jsonl" or "<input index>-<input file name>.ast.bin".
+// The index keeps files with the same name in different directories apart.
+void DumpAsts(
+    const std::filesystem::path& output_directory,
+    const std::vector<std::shared_ptr<IAbstractSyntaxTree>>& ast_list,
+    const std::vector<std::filesystem::path>& input_file_paths,
+    AstExportFormat format
+)
+{
+    auto extension = (format == AstExportFormat::JsonLines) ? ".ast.jsonl" : ".ast.bin";
+    for (size_t i = 0; i < ast_list.size(); ++i)
+    {
+        auto dump_path = output_directory / std::format("{}-{}{}", i, input_file_paths[i].filename().string(), extension);
+
+        auto file = std::ofstream(dump_path, std::ios::binary | std::ios::trunc);
+        AstExporter(file, format).Export(ast_list[i].get());
+        file.flush();
+        if (!file)
+        {
+            throw std::exception("[I/O Error] failed to write AST dump");
+        }
+    }
+}
 
-    ast->Accept(&scanner);
-    ast->Accept(&type_checker);
-    ast->Accept(&jump_stmt_checker);
+// Generates the code of a logical module from its files, in input order.
+// One header file and one source file will be created for the module.
+void RunCompilerBackend(
+    const std::filesystem::path& output_directory,
+    const std::vector<IAbstractSyntaxTree*>& asts,
+    ProgramEnvironment& environment
+)
+{
+    auto file_factory = std::make_unique<OutputFileFactory>();
+    auto generator = std::make_shared<CodeGenerator>(environment, output_directory, std::move(file_factory));
+
+    for (auto ast : asts)
+    {
+        ast->Accept(generator.get());
+    }
 }
 
-void PrintFrontendError(const std::filesystem::path& input_file_path)
+// Returns the first file that imports a missing module at 'pos', if any.
+std::optional<size_t> FindFileOfMissingImport(
+    const ProgramEnvironment& environment,
+    const std::vector<IAbstractSyntaxTree*>& modules,
+    SourcePos pos
+)
 {
-    std::cerr << std::format("# Error occured while parsing file \'{}\'\n", input_file_path.string());
+    for (size_t i = 0; i < modules.size(); ++i)
+    {
+        for (const auto& imported : static_cast<Module*>(modules[i])->ImportList())
+        {
+            if (imported.name.start_pos == pos && !environment.TryGetModuleHandle(imported.name.lexeme))
+            {
+                return i;
+            }
+        }
+    }
+    return {};
 }
 
-std::vector<std::shared_ptr<IAbstractSyntaxTree>> RunCompilerFrontend(
+// Scan import directives and global symbols of every module
+// into the given 'environment' instance, which is frozen afterwards.
+// An exception will be thrown for any semantic error,
+// including an import of a module that none of the files declares.
+std::vector<PassManager::PassTiming> ScanGlobalSymbols(
+    ProgramEnvironment& environment,
+    const std::vector<IAbstractSyntaxTree*>& modules,
     const std::vector<std::filesystem::path>& input_file_paths,
-    ProgramEnvironment& environment
+    bool should_time_passes
 )
 {
-    // Step 1) generate AST for each input source file.
-    auto ast_list = std::vector<std::shared_ptr<IAbstractSyntaxTree>>();
-    for (const auto& input_file_path : input_file_paths)
+    auto scanner = GlobalSymbolScanner(environment);
+    auto pass_manager = PassManager();
+    pass_manager.AddPass(scanner);
+    if (should_time_passes)
     {
-        try
+        pass_manager.EnableTimings();
+    }
+    auto has_reported_file = false;
+    try
+    {
+        pass_manager.Run(modules, [&](size_t i) {
+            has_reported_file = true;
+            PrintFrontendError(input_file_paths[i]);
+        });
+    }
+    catch (const SemanticError& error)
+    {
+        // Missing modules are only found once every file is scanned,
+        // so the file with the import has to be looked up by its position.
+        if (!has_reported_file)
         {
-            ast_list.push_back(RunLexicalAndSyntaxAnalysis(input_file_path));
+            if (auto i = FindFileOfMissingImport(environment, modules, error.where()))
+            {
+                PrintFrontendError(input_file_paths[*i]);
+            }
         }
-        catch(...)
+        throw;
+    }
+    return pass_manager.Timings();
+}
+
+// Adds each timing to the total with the same name, or appends it if there is none.
+void AddTimings(std::vector<PassManager::PassTiming>& totals, const std::vector<PassManager::PassTiming>& timings)
+{
+    for (const auto& timing : timings)
+    {
+        auto it = std::find_if(totals.begin(), totals.end(), [&](const auto& total) {
+            return total.name == timing.name;
+        });
+        if (it == totals.end())
+        {
+            totals.push_back(timing);
+        }
+        else
         {
-            PrintFrontendError(input_file_path);
-            throw;
+            it->elapsed += timing.elapsed;
         }
     }
+}
 
-    // Step 2) scan import directives and global symbols.
-    auto scanner = GlobalSymbolScanner(environment);
-    for (int i = 0; i < ast_list.size(); ++i)
+// A logical module on its way through the pipeline (see RunModulePipeline()).
+struct PipelinedModule
+{
+    // Its files, in input order.
+    std::vector<size_t> file_indices;
+    std::vector<IAbstractSyntaxTree*> asts;
+
+    // Names in a module are only bound by its own task, so each module has bindings of its own.
+    NameBindings bindings;
+
+    // Type errors of each file.
+    std::vector<DiagnosticSink> diagnostics;
+
+    // The file that failed to bind, if any.
+    std::optional<size_t> failed_file;
+
+    // Time spent in each stage of this module.
+    std::vector<PassManager::PassTiming> timings;
+};
+
+// Every module its declarations can refer to: itself and its imports, transitively.
+// Imports may be circular, so each module is visited once.
+std::vector<ModuleHandle> CollectReachableModules(const ProgramEnvironment& environment, ModuleHandle module, size_t num_modules)
+{
+    auto reachable = std::vector<ModuleHandle>{module};
+    auto is_visited = std::vector<bool>(num_modules, false);
+    is_visited[module] = true;
+    for (size_t i = 0; i < reachable.size(); ++i)
     {
-        try
+        for (const auto& imported : environment.GetModuleInfo(reachable[i]).resolved_imports)
         {
-            ast_list[i]->Accept(&scanner);
+            if (!is_visited[imported.module])
+            {
+                is_visited[imported.module] = true;
+                reachable.push_back(imported.module);
+            }
         }
-        catch(...)
+    }
+    return reachable;
+}
+
+// Prints the type errors of every file in input order,
+// up to 'error_limit' errors over all of them (0 means no limit).
+void PrintTypeErrors(
+    const std::vector<PipelinedModule>& modules,
+    const std::vector<std::filesystem::path>& input_file_paths,
+    size_t error_limit
+)
+{
+    auto file_diagnostics = std::vector<const DiagnosticSink*>(input_file_paths.size(), nullptr);
+    for (const auto& module : modules)
+    {
+        for (size_t i = 0; i < module.diagnostics.size(); ++i)
         {
-            PrintFrontendError(input_file_paths[i]);
-            throw;
+            file_diagnostics[module.file_indices[i]] = &module.diagnostics[i];
         }
     }
 
-    // Step 3) run semantic checks.
-    auto type_checker = TypeChecker(environment);
-    auto jump_stmt_checker = JumpStmtUsageChecker();
-    for (int i = 0; i < ast_list.size(); ++i)
+    auto num_printed = size_t{0};
+    auto num_not_shown = size_t{0};
+    for (size_t i = 0; i < file_diagnostics.size(); ++i)
     {
-        try
+        auto diagnostics = file_diagnostics[i];
+        if (!diagnostics || !diagnostics->HasErrors())
         {
-            ast_list[i]->Accept(&type_checker);
-            ast_list[i]->Accept(&jump_stmt_checker);
+            continue;
         }
-        catch(...)
+
+        auto num_shown = diagnostics->Diagnostics().size();
+        if (error_limit != 0)
+        {
+            num_shown = std::min(num_shown, error_limit - num_printed);
+        }
+        if (num_shown > 0)
         {
             PrintFrontendError(input_file_paths[i]);
-            throw;
         }
+        for (size_t j = 0; j < num_shown; ++j)
+        {
+            std::cerr << diagnostics->Diagnostics()[j].ToString() << '\n';
+        }
+        num_printed += num_shown;
+        num_not_shown += diagnostics->NumReported() - num_shown;
     }
 
-    return ast_list;
+    if (num_not_shown > 0)
+    {
+        std::cerr << std::format("# {} more errors were not shown (error limit of {})\n", num_not_shown, error_limit);
+    }
 }
 
-void RunCompilerBackend(
+// Binds, checks and generates code for each logical module on the thread pool,
+// as soon as what the module depends on is ready:
+// 1. names of a module are bound once the global symbols of every module are final
+// 2. a module is type checked once every module it can reach through its imports is bound,
+//    since the types of their declarations (e.g., the return type of an imported function)
+//    are bound by their own modules
+// 3. code of a module is generated as soon as its own checks pass,
+//    while other modules may still be checked
+//
+// Type errors don't stop the other modules, and every one of them is reported
+// within 'error_limit' once the pipeline is done. Other errors are thrown after that,
+// once every module that doesn't depend on the failed one is done.
+// Either way, code may have been generated for the modules that passed.
+// Errors are reported in a fixed order, whichever failed first: type errors of each file,
+// then the first binding error or I/O error of code generation in the order of the modules.
+void RunModulePipeline(
     const std::filesystem::path& output_directory,
-    const std::vector<std::shared_ptr<IAbstractSyntaxTree>>& ast_list,
-    ProgramEnvironment& environment
+    ProgramEnvironment& environment,
+    const std::vector<IAbstractSyntaxTree*>& asts,
+    const std::vector<std::filesystem::path>& input_file_paths,
+    size_t error_limit,
+    bool should_time_passes,
+    ThreadPool& thread_pool,
+    std::vector<PassManager::PassTiming>& timings
 )
 {
-    auto file_factory = std::make_unique<OutputFileFactory>();
-    auto generator = std::make_shared<CodeGenerator>(environment, output_directory, std::move(file_factory));
-    
+    // Handles are given in the order modules are first declared, so they are dense.
+    auto modules = std::vector<PipelinedModule>();
+    for (size_t i = 0; i < asts.size(); ++i)
+    {
+        auto handle = environment.GetModuleHandle(static_cast<Module*>(asts[i])->ModuleName().lexeme);
+        if (handle >= modules.size())
+        {
+            modules.resize(handle + 1);
+        }
+        modules[handle].file_indices.push_back(i);
+        modules[handle].asts.push_back(asts[i]);
+        modules[handle].diagnostics.emplace_back(error_limit);
+    }
+
+    auto graph = TaskGraph();
+
+    // The module of each task, to report the file of the one that failed.
+    auto task_modules = std::vector<ModuleHandle>();
+    auto add_task = [&](ModuleHandle handle, std::function<void()> task, const std::vector<TaskGraph::TaskId>& dependencies = {}) {
+        task_modules.push_back(handle);
+        return graph.AddTask(std::move(task), dependencies);
+    };
+
+    auto bind_tasks = std::vector<TaskGraph::TaskId>();
+    for (ModuleHandle handle = 0; handle < modules.size(); ++handle)
+    {
+        auto& module = modules[handle];
+        bind_tasks.push_back(add_task(handle, [&]() {
+            auto binder = NameBinder(environment, module.bindings);
+            auto jump_stmt_checker = JumpStmtUsageChecker();
+
+            // Checks that only look at a few kinds of nodes share the walk of the name binder.
+            auto pass_manager = PassManager();
+            pass_manager.AddFinishedPass("global-symbol-scan");
+            pass_manager.AddPass(binder);
+            pass_manager.AddPass(jump_stmt_checker);
+            if (should_time_passes)
+            {
+                pass_manager.EnableTimings();
+            }
+            pass_manager.Run(module.asts, [&](size_t i) {
+                module.failed_file = module.file_indices[i];
+            });
+            module.timings = pass_manager.Timings();
+        }));
+    }
+
+    auto check_tasks = std::vector<TaskGraph::TaskId>();
+    for (ModuleHandle handle = 0; handle < modules.size(); ++handle)
+    {
+        auto dependencies = std::vector<TaskGraph::TaskId>();
+        for (auto reachable_module : CollectReachableModules(environment, handle, modules.size()))
+        {
+            dependencies.push_back(bind_tasks[reachable_module]);
+        }
+
+        auto& module = modules[handle];
+        check_tasks.push_back(add_task(handle, [&]() {
+            // Each file is checked with a sink of its own, so its errors can be printed under its name.
+            auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < module.asts.size(); ++i)
+            {
+                auto type_checker = TypeChecker(module.bindings, &module.diagnostics[i]);
+                type_checker.CheckConcurrently({module.asts[i]}, thread_pool);
+            }
+            module.timings.push_back({"type-check", std::chrono::steady_clock::now() - start});
+        }, dependencies));
+    }
+
+    for (ModuleHandle handle = 0; handle < modules.size(); ++handle)
+    {
+        auto& module = modules[handle];
+        add_task(handle, [&]() {
+            auto has_type_errors = std::any_of(module.diagnostics.begin(), module.diagnostics.end(), [](const auto& diagnostics) {
+                return diagnostics.HasErrors();
+            });
+            if (has_type_errors)
+            {
+                return;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            RunCompilerBackend(output_directory, module.asts, environment);
+            module.timings.push_back({"codegen", std::chrono::steady_clock::now() - start});
+        }, {check_tasks[handle]});
+    }
+
+    auto error = std::exception_ptr();
+    auto failed_module = ModuleHandle{0};
+    try
+    {
+        graph.Run(thread_pool, [&](TaskGraph::TaskId id) {
+            failed_module = task_modules[id];
+        });
+    }
+    catch(...)
+    {
+        error = std::current_exception();
+    }
+
+    PrintTypeErrors(modules, input_file_paths, error_limit);
+    if (error)
+    {
+        if (auto failed_file = modules[failed_module].failed_file)
+        {
+            PrintFrontendError(input_file_paths[*failed_file]);
+        }
+        std::rethrow_exception(error);
+    }
+
+    for (const auto& module : modules)
+    {
+        AddTimings(timings, module.timings);
+    }
+}
+
+// Generates an AST for each input file and scans their global symbols.
+// Parsed files are cached in the output directory.
+std::vector<std::shared_ptr<IAbstractSyntaxTree>> RunCompilerFrontend(
+    const CommandLineArguments& arguments,
+    ProgramEnvironment& environment,
+    ThreadPool& thread_pool,
+    std::vector<PassManager::PassTiming>& timings
+)
+{
+    const auto& input_file_paths = arguments.input_file_paths;
+
+    // Step 1) generate AST for each input source file.
+    // Files are independent of each other until their global symbols are scanned,
+    // so they are parsed concurrently, sharing the pool with their declarations.
+    auto ast_cache = AstCache(arguments.output_directory / ".mylang-cache");
+    auto parsed_files = std::vector<std::future<std::shared_ptr<IAbstractSyntaxTree>>>();
+    for (const auto& input_file_path : input_file_paths)
+    {
+        parsed_files.push_back(thread_pool.Submit([&]() {
+            return RunLexicalAndSyntaxAnalysis(input_file_path, thread_pool, ast_cache);
+        }));
+    }
+
+    // Every file is waited for before anything is thrown, since the tasks refer to this frame.
+    // The error of the first file in input order is reported, whichever failed first.
+    auto ast_list = std::vector<std::shared_ptr<IAbstractSyntaxTree>>();
+    auto first_error = std::exception_ptr();
+    auto first_failed_file = size_t{0};
+    for (size_t i = 0; i < parsed_files.size(); ++i)
+    {
+        try
+        {
+            ast_list.push_back(thread_pool.Wait(parsed_files[i]));
+        }
+        catch(...)
+        {
+            if (!first_error)
+            {
+                first_error = std::current_exception();
+                first_failed_file = i;
+            }
+        }
+    }
+    if (first_error)
+    {
+        PrintFrontendError(input_file_paths[first_failed_file]);
+        std::rethrow_exception(first_error);
+    }
+
+    // The ASTs are dumped before semantic analysis, so they are available even if it fails.
+    if (arguments.dump_ast_format)
+    {
+        DumpAsts(arguments.output_directory, ast_list, input_file_paths, *arguments.dump_ast_format);
+    }
+
+    // Step 2) scan import directives and global symbols, which every module depends on.
+    auto modules = std::vector<IAbstractSyntaxTree*>();
     for (const auto& ast : ast_list)
     {
-        ast->Accept(generator.get());
+        modules.push_back(ast.get());
     }
+    AddTimings(timings, ScanGlobalSymbols(environment, modules, input_file_paths, arguments.should_time_passes));
+
+    return ast_list;
 }
 
 int main(int argc, char** argv)
@@ -153,18 +592,45 @@ int main(int argc, char** argv)
     {
         // Get the output directory and list of input file paths.
         auto arguments = ParseCommandLine(argc, argv);
+        auto num_jobs = arguments.num_jobs ? arguments.num_jobs : std::thread::hardware_concurrency();
+        auto thread_pool = ThreadPool(num_jobs);
+        auto timings = std::vector<PassManager::PassTiming>();
 
-        // Read and analyze the input files to generate AST.
-        // This step involves lexical analyzer, syntax analyzer, and semantic analyzer.
+        // Read the input files to generate AST and scan their global symbols.
+        // This step involves lexical analyzer, syntax analyzer, and global symbol scanner.
+        // Parsed files are cached in the output directory.
         auto environment = ProgramEnvironment();
-        auto ast_list = RunCompilerFrontend(arguments.input_file_paths, environment);
+        auto ast_list = RunCompilerFrontend(arguments, environment, thread_pool, timings);
 
-        // Generate C++ code for given ASTs.
-        // One header file and one source file will be created for each logical module.
-        RunCompilerBackend(arguments.output_directory, ast_list, environment);
+        // Check each logical module and generate C++ code for it as soon as it passes.
+        auto modules = std::vector<IAbstractSyntaxTree*>();
+        for (const auto& ast : ast_list)
+        {
+            modules.push_back(ast.get());
+        }
+        RunModulePipeline(
+            arguments.output_directory,
+            environment,
+            modules,
+            arguments.input_file_paths,
+            arguments.error_limit,
+            arguments.should_time_passes,
+            thread_pool,
+            timings
+        );
+
+        // Time spent in each pass and stage, summed over the modules.
+        if (arguments.should_time_passes)
+        {
+            for (const auto& timing : timings)
+            {
+                auto milliseconds = std::chrono::duration<double, std::milli>(timing.elapsed).count();
+                std::cerr << std::format("# {}: {:.3f} ms\n", timing.name, milliseconds);
+            }
+        }
     }
     catch(const std::exception& e)
     {
         std::cerr << e.what() << '\n';
-    }   
+    }
 }
@@ -0,0 +1,193 @@
+#include "parser/AstCache.h"
+#include "parser/AstSerializer.h"
+#include <format>
+#include <fstream>
+#include <random>
+
+#ifndef MYLANG_VERSION
+#define MYLANG_VERSION "unknown"
+#endif
+
+namespace mylang
+{
+
+// Every entry starts with this signature.
+const std::string_view AstCacheSignature = "MYLANGAC";
+
+// 64-bit FNV-1a
+uint64_t HashBytes(std::string_view data, uint64_t hash = 14695981039346656037ull)
+{
+    for (auto c : data)
+    {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+
+void AppendU32(std::string& output, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        output.push_back(static_cast<char>(value >> (i * 8)));
+    }
+}
+
+void AppendU64(std::string& output, uint64_t value)
+{
+    AppendU32(output, static_cast<uint32_t>(value));
+    AppendU32(output, static_cast<uint32_t>(value >> 32));
+}
+
+void AppendString(std::string& output, std::string_view value)
+{
+    AppendU32(output, static_cast<uint32_t>(value.size()));
+    output.append(value);
+}
+
+// Returns false if there are not enough bytes left.
+bool ConsumeU32(std::string_view& input, uint32_t& value)
+{
+    if (input.size() < 4)
+    {
+        return false;
+    }
+
+    value = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        value |= static_cast<uint32_t>(static_cast<uint8_t>(input[i])) << (i * 8);
+    }
+    input.remove_prefix(4);
+    return true;
+}
+
+// Returns false if there are not enough bytes left.
+bool ConsumeU64(std::string_view& input, uint64_t& value)
+{
+    auto low = uint32_t{};
+    auto high = uint32_t{};
+    if (!ConsumeU32(input, low) || !ConsumeU32(input, high))
+    {
+        return false;
+    }
+
+    value = (static_cast<uint64_t>(high) << 32) | low;
+    return true;
+}
+
+// Returns false if there are not enough bytes left.
+bool ConsumeString(std::string_view& input, std::string_view& value)
+{
+    auto size = uint32_t{};
+    if (!ConsumeU32(input, size) || input.size() < size)
+    {
+        return false;
+    }
+
+    value = input.substr(0, size);
+    input.remove_prefix(size);
+    return true;
+}
+
+AstCache::AstCache(const std::filesystem::path& cache_directory)
+    : m_cache_directory(cache_directory)
+{}
+
+std::shared_ptr<IAbstractSyntaxTree> AstCache::Load(const std::filesystem::path& source_path, std::string_view source_code) const
+{
+    // Read the whole entry at once.
+    auto path = EntryPath(source_path);
+    auto error = std::error_code{};
+    auto file_size = std::filesystem::file_size(path, error);
+    if (error)
+    {
+        return nullptr;
+    }
+
+    auto file = std::ifstream(path, std::ios::binary);
+    auto content = std::string(file_size, '\0');
+    if (!file.read(content.data(), file_size))
+    {
+        return nullptr;
+    }
+
+    // Validate the header.
+    auto input = std::string_view(content);
+    auto format_version = uint32_t{};
+    auto compiler_version = std::string_view();
+    auto cached_source_code = std::string_view();
+    auto payload = std::string_view();
+    auto payload_hash = uint64_t{};
+    if (!input.starts_with(AstCacheSignature))
+    {
+        return nullptr;
+    }
+    input.remove_prefix(AstCacheSignature.size());
+
+    if (!ConsumeU32(input, format_version) || format_version != AstFormatVersion ||
+        !ConsumeString(input, compiler_version) || compiler_version != MYLANG_VERSION ||
+        !ConsumeString(input, cached_source_code) || cached_source_code != source_code ||
+        !ConsumeString(input, payload) ||
+        !ConsumeU64(input, payload_hash) || payload_hash != HashBytes(payload) || !input.empty())
+    {
+        return nullptr;
+    }
+
+    // A broken entry is treated as a cache miss.
+    try
+    {
+        return DeserializeAst(payload);
+    }
+    catch (const std::exception&)
+    {
+        return nullptr;
+    }
+}
+
+void AstCache::Store(const std::filesystem::path& source_path, std::string_view source_code, IAbstractSyntaxTree* ast) const
+{
+    auto content = std::string(AstCacheSignature);
+    AppendU32(content, AstFormatVersion);
+    AppendString(content, MYLANG_VERSION);
+    AppendString(content, source_code);
+    auto payload = SerializeAst(ast);
+    AppendString(content, payload);
+    AppendU64(content, HashBytes(payload));
+
+    // Write to a temporary file first and rename it,
+    // so that other processes never see a partially written entry.
+    auto path = EntryPath(source_path);
+    auto temp_path = path;
+    temp_path += std::format(".{:x}.tmp", std::random_device()());
+
+    auto error = std::error_code{};
+    std::filesystem::create_directories(m_cache_directory, error);
+    {
+        auto file = std::ofstream(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file.write(content.data(), content.size()))
+        {
+            file.close();
+            std::filesystem::remove(temp_path, error);
+            return;
+        }
+    }
+
+    std::filesystem::rename(temp_path, path, error);
+    if (error)
+    {
+        std::filesystem::remove(temp_path, error);
+    }
+}
+
+std::filesystem::path AstCache::EntryPath(const std::filesystem::path& source_path) const
+{
+    // The same file may be given with different relative paths.
+    auto error = std::error_code{};
+    auto absolute_path = std::filesystem::absolute(source_path, error);
+    auto hash = HashBytes((error ? source_path : absolute_path).lexically_normal().generic_string());
+    return m_cache_directory / std::format("{:016x}.ast", hash);
+}
+
+} // namespace mylang
@@ -0,0 +1,43 @@
+#include "parser/AstPass.h"
+
+namespace mylang
+{
+
+AstNodeKindSet MakeAstNodeKindSet(std::initializer_list<AstNodeKind> kinds)
+{
+    auto set = AstNodeKindSet();
+    for (auto kind : kinds)
+    {
+        set.set(static_cast<size_t>(kind));
+    }
+    return set;
+}
+
+std::vector<std::string_view> AstPass::Prerequisites() const
+{
+    return {};
+}
+
+AstNodeKindSet AstPass::Interests() const
+{
+    return {};
+}
+
+void AstPass::Enter(IAbstractSyntaxTree* node)
+{}
+
+void AstPass::Leave(IAbstractSyntaxTree* node)
+{}
+
+bool AstPass::IsWalker() const
+{
+    return false;
+}
+
+void AstPass::Walk(IAbstractSyntaxTree* root, IAstNodeHooks* hooks)
+{}
+
+void AstPass::Finish()
+{}
+
+} // namespace mylang
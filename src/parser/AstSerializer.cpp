@@ -0,0 +1,689 @@
+#include "parser/AstSerializer.h"
+#include "parser/ast/AstArena.h"
+#include "parser/ast/visitor/AstWalker.h"
+#include "parser/ast/Module.h"
+#include "parser/ast/globdecl/FuncDecl.h"
+#include "parser/ast/globdecl/StructDecl.h"
+
+#include "parser/ast/stmt/CompoundStmt.h"
+#include "parser/ast/stmt/IfStmt.h"
+#include "parser/ast/stmt/ForStmt.h"
+#include "parser/ast/stmt/WhileStmt.h"
+#include "parser/ast/stmt/JumpStmt.h"
+#include "parser/ast/stmt/VarDeclStmt.h"
+#include "parser/ast/stmt/ExprStmt.h"
+
+#include "parser/ast/varinit/VarInitExpr.h"
+#include "parser/ast/varinit/VarInitList.h"
+
+#include "parser/ast/expr/ArrayAccessExpr.h"
+#include "parser/ast/expr/BinaryExpr.h"
+#include "parser/ast/expr/FuncCallExpr.h"
+#include "parser/ast/expr/Identifier.h"
+#include "parser/ast/expr/Literal.h"
+#include "parser/ast/expr/MemberAccessExpr.h"
+#include "parser/ast/expr/PostfixExpr.h"
+#include "parser/ast/expr/PrefixExpr.h"
+
+#include "parser/type/base/PrimitiveType.h"
+#include "parser/type/base/StructType.h"
+#include "parser/type/base/FuncType.h"
+#include "parser/type/base/VoidType.h"
+#include <format>
+#include <stdexcept>
+
+namespace mylang
+{
+
+enum class BaseTypeTag : uint8_t
+{
+    Void,
+    Primitive,
+    Struct,
+    Func,
+};
+
+// Nodes are written in postorder: each node is its kind as a byte and its fields,
+// right after its children. So the reader can rebuild the tree with a stack
+// of finished nodes, and neither side recurses on deep trees.
+// A node with optional children records which of them are present.
+//
+// Every integer is written in little-endian order regardless of the platform.
+class AstWriter : public AstWalker<AstWriter>
+{
+public:
+    using AstWalker<AstWriter>::PostVisit;
+
+    void PostVisitNode(IAbstractSyntaxTree* node);
+
+    void PostVisit(Module* node);
+
+    void PostVisit(Parameter* node);
+    void PostVisit(FuncDecl* node);
+    void PostVisit(StructDecl* node);
+
+    void PostVisit(CompoundStmt* node);
+    void PostVisit(IfStmt* node);
+    void PostVisit(ForStmt* node);
+    void PostVisit(JumpStmt* node);
+    void PostVisit(VarDeclStmt* node);
+
+    void PostVisit(VarInitList* node);
+
+    void PostVisit(BinaryExpr* node);
+    void PostVisit(FuncCallExpr* node);
+    void PostVisit(Identifier* node);
+    void PostVisit(Literal* node);
+    void PostVisit(MemberAccessExpr* node);
+    void PostVisit(PostfixExpr* node);
+    void PostVisit(PrefixExpr* node);
+
+    std::string Release();
+
+private:
+    void WriteU8(uint8_t value);
+    void WriteU32(uint32_t value);
+    void WriteI32(int value);
+    void WriteBool(bool value);
+    void WriteString(std::string_view value);
+    void WriteToken(const Token& token);
+    void WriteType(const Type& type);
+    void WriteParamType(const ParamType& param_type);
+
+    std::string m_output;
+};
+
+class AstReader
+{
+public:
+    AstReader(std::string_view data, AstArena& arena);
+
+    // Reads every node, and returns the module at the root.
+    Module* ReadModule();
+
+private:
+    uint8_t ReadU8();
+    uint32_t ReadU32();
+    int ReadI32();
+    bool ReadBool();
+    std::string ReadString();
+    AstNodeKind ReadKind();
+    Token ReadToken();
+    Type ReadType();
+    ParamType ReadParamType();
+
+    // Reads the fields of a node, and builds it from the children on top of the stack.
+    IAbstractSyntaxTree* ReadNode(AstNodeKind kind);
+
+    // Takes the last finished node, which should be a T.
+    template<typename T>
+    T* Pop();
+
+    template<typename T>
+    T* PopIfPresent(bool is_present);
+
+    // Takes the last 'count' finished nodes, in the order they were written.
+    template<typename T>
+    std::vector<T*> PopList(uint32_t count);
+
+    // Reads the number of elements of a list,
+    // which can't exceed the number of remaining bytes.
+    uint32_t ReadCount();
+
+    [[noreturn]] void ThrowMalformedData() const;
+
+    std::string_view m_data;
+    size_t m_cursor = 0;
+    AstArena& m_arena;
+
+    // Finished nodes whose parent hasn't been read yet.
+    std::vector<IAbstractSyntaxTree*> m_finished_nodes;
+};
+
+void AstWriter::PostVisitNode(IAbstractSyntaxTree* node)
+{
+    WriteU8(static_cast<uint8_t>(node->NodeKind()));
+    AstWalker<AstWriter>::PostVisitNode(node);
+}
+
+void AstWriter::PostVisit(Module* node)
+{
+    WriteToken(node->ModuleName());
+
+    WriteU32(static_cast<uint32_t>(node->ImportList().size()));
+    for (const auto& import_info : node->ImportList())
+    {
+        WriteBool(import_info.should_export);
+        WriteToken(import_info.name);
+    }
+
+    WriteU32(static_cast<uint32_t>(node->Declarations().size()));
+}
+
+void AstWriter::PostVisit(Parameter* node)
+{
+    WriteToken(node->Name());
+    WriteParamType(node->DeclParamType());
+}
+
+void AstWriter::PostVisit(FuncDecl* node)
+{
+    WriteBool(node->ShouldExport());
+    WriteToken(node->Name());
+    WriteType(node->ReturnType());
+    WriteU32(static_cast<uint32_t>(node->Parameters().size()));
+}
+
+void AstWriter::PostVisit(StructDecl* node)
+{
+    WriteBool(node->ShouldExport());
+    WriteToken(node->Name());
+
+    WriteU32(static_cast<uint32_t>(node->Members().size()));
+    for (const auto& member : node->Members())
+    {
+        WriteToken(member.name);
+        WriteType(member.type);
+    }
+}
+
+void AstWriter::PostVisit(CompoundStmt* node)
+{
+    WriteU32(static_cast<uint32_t>(node->Statements().size()));
+}
+
+void AstWriter::PostVisit(IfStmt* node)
+{
+    WriteBool(node->ElseBranch() != nullptr);
+}
+
+void AstWriter::PostVisit(ForStmt* node)
+{
+    WriteBool(node->Initializer() != nullptr);
+    WriteBool(node->Condition() != nullptr);
+    WriteBool(node->IncrementExpr() != nullptr);
+}
+
+void AstWriter::PostVisit(JumpStmt* node)
+{
+    WriteToken(node->JumpType());
+    WriteBool(node->ReturnValueExpr() != nullptr);
+}
+
+void AstWriter::PostVisit(VarDeclStmt* node)
+{
+    WriteToken(node->Name());
+    WriteType(node->DeclType());
+    WriteBool(node->Initializer() != nullptr);
+}
+
+void AstWriter::PostVisit(VarInitList* node)
+{
+    WriteU32(static_cast<uint32_t>(node->InitializerList().size()));
+}
+
+void AstWriter::PostVisit(BinaryExpr* node)
+{
+    WriteToken(node->Operator());
+}
+
+void AstWriter::PostVisit(FuncCallExpr* node)
+{
+    WriteU32(static_cast<uint32_t>(node->ArgumentList().size()));
+}
+
+void AstWriter::PostVisit(Identifier* node)
+{
+    WriteToken(node->Id());
+}
+
+void AstWriter::PostVisit(Literal* node)
+{
+    // The type is deduced from the token again when it is read.
+    WriteToken(node->LiteralToken());
+}
+
+void AstWriter::PostVisit(MemberAccessExpr* node)
+{
+    WriteToken(node->MemberName());
+}
+
+void AstWriter::PostVisit(PostfixExpr* node)
+{
+    WriteToken(node->Operator());
+}
+
+void AstWriter::PostVisit(PrefixExpr* node)
+{
+    WriteToken(node->Operator());
+}
+
+std::string AstWriter::Release()
+{
+    return std::move(m_output);
+}
+
+void AstWriter::WriteU8(uint8_t value)
+{
+    m_output.push_back(static_cast<char>(value));
+}
+
+void AstWriter::WriteU32(uint32_t value)
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        WriteU8(static_cast<uint8_t>(value >> (i * 8)));
+    }
+}
+
+void AstWriter::WriteI32(int value)
+{
+    WriteU32(static_cast<uint32_t>(value));
+}
+
+void AstWriter::WriteBool(bool value)
+{
+    WriteU8(value ? 1 : 0);
+}
+
+void AstWriter::WriteString(std::string_view value)
+{
+    WriteU32(static_cast<uint32_t>(value.size()));
+    m_output.append(value);
+}
+
+void AstWriter::WriteToken(const Token& token)
+{
+    WriteU8(static_cast<uint8_t>(token.type));
+    WriteString(token.lexeme);
+    WriteI32(token.start_pos.line);
+    WriteI32(token.start_pos.column);
+    WriteI32(token.end_pos.line);
+    WriteI32(token.end_pos.column);
+}
+
+void AstWriter::WriteType(const Type& type)
+{
+    auto base_type = type.BaseType();
+    if (auto primitive_type = dynamic_cast<const PrimitiveType*>(base_type))
+    {
+        WriteU8(static_cast<uint8_t>(BaseTypeTag::Primitive));
+        WriteToken(primitive_type->TypeToken());
+    }
+    else if (auto struct_type = dynamic_cast<const StructType*>(base_type))
+    {
+        WriteU8(static_cast<uint8_t>(BaseTypeTag::Struct));
+        WriteToken(struct_type->TypeToken());
+    }
+    else if (auto func_type = dynamic_cast<const FuncType*>(base_type))
+    {
+        WriteU8(static_cast<uint8_t>(BaseTypeTag::Func));
+        WriteU32(static_cast<uint32_t>(func_type->ParamTypes().size()));
+        for (const auto& param_type : func_type->ParamTypes())
+        {
+            WriteParamType(param_type);
+        }
+        WriteType(func_type->ReturnType());
+    }
+    else
+    {
+        WriteU8(static_cast<uint8_t>(BaseTypeTag::Void));
+    }
+
+    WriteU32(static_cast<uint32_t>(type.ArraySize().size()));
+    for (auto size : type.ArraySize())
+    {
+        WriteI32(size);
+    }
+}
+
+void AstWriter::WriteParamType(const ParamType& param_type)
+{
+    WriteU8(static_cast<uint8_t>(param_type.usage));
+    WriteType(param_type.type);
+}
+
+AstReader::AstReader(std::string_view data, AstArena& arena)
+    : m_data(data)
+    , m_arena(arena)
+{}
+
+Module* AstReader::ReadModule()
+{
+    while (m_cursor < m_data.size())
+    {
+        m_finished_nodes.push_back(ReadNode(ReadKind()));
+    }
+
+    // Every other node should have been taken by its parent.
+    if (m_finished_nodes.size() != 1)
+    {
+        ThrowMalformedData();
+    }
+    return Pop<Module>();
+}
+
+uint8_t AstReader::ReadU8()
+{
+    if (m_cursor >= m_data.size())
+    {
+        ThrowMalformedData();
+    }
+    return static_cast<uint8_t>(m_data[m_cursor++]);
+}
+
+uint32_t AstReader::ReadU32()
+{
+    auto value = uint32_t{0};
+    for (int i = 0; i < 4; ++i)
+    {
+        value |= static_cast<uint32_t>(ReadU8()) << (i * 8);
+    }
+    return value;
+}
+
+int AstReader::ReadI32()
+{
+    return static_cast<int>(ReadU32());
+}
+
+bool AstReader::ReadBool()
+{
+    auto value = ReadU8();
+    if (value > 1)
+    {
+        ThrowMalformedData();
+    }
+    return value == 1;
+}
+
+std::string AstReader::ReadString()
+{
+    auto size = ReadCount();
+    auto value = std::string(m_data.substr(m_cursor, size));
+    m_cursor += size;
+    return value;
+}
+
+AstNodeKind AstReader::ReadKind()
+{
+    auto kind = ReadU8();
+    if (kind >= NumAstNodeKinds)
+    {
+        ThrowMalformedData();
+    }
+    return static_cast<AstNodeKind>(kind);
+}
+
+Token AstReader::ReadToken()
+{
+    auto token = Token{};
+    auto type = ReadU8();
+    if (type > static_cast<uint8_t>(TokenType::Error))
+    {
+        ThrowMalformedData();
+    }
+    token.type = static_cast<TokenType>(type);
+    token.lexeme = ReadString();
+    token.start_pos.line = ReadI32();
+    token.start_pos.column = ReadI32();
+    token.end_pos.line = ReadI32();
+    token.end_pos.column = ReadI32();
+    return token;
+}
+
+Type AstReader::ReadType()
+{
+    auto base_type = std::shared_ptr<IBaseType>();
+    switch (static_cast<BaseTypeTag>(ReadU8()))
+    {
+    case BaseTypeTag::Void:
+        base_type = std::make_shared<VoidType>();
+        break;
+    case BaseTypeTag::Primitive:
+        base_type = std::make_shared<PrimitiveType>(ReadToken());
+        break;
+    case BaseTypeTag::Struct:
+        base_type = std::make_shared<StructType>(ReadToken());
+        break;
+    case BaseTypeTag::Func:
+    {
+        auto param_types = std::vector<ParamType>{};
+        auto num_params = ReadCount();
+        for (uint32_t i = 0; i < num_params; ++i)
+        {
+            param_types.push_back(ReadParamType());
+        }
+        base_type = std::make_shared<FuncType>(param_types, ReadType());
+        break;
+    }
+    default:
+        ThrowMalformedData();
+    }
+
+    auto array_sizes = std::vector<int>(ReadCount());
+    for (auto& size : array_sizes)
+    {
+        size = ReadI32();
+    }
+    return Type(base_type, array_sizes);
+}
+
+ParamType AstReader::ReadParamType()
+{
+    auto usage = ReadU8();
+    if (usage > static_cast<uint8_t>(ParamUsage::InOut))
+    {
+        ThrowMalformedData();
+    }
+    auto type = ReadType();
+    return ParamType{type, static_cast<ParamUsage>(usage)};
+}
+
+// Note: children are taken from the stack in reverse order.
+IAbstractSyntaxTree* AstReader::ReadNode(AstNodeKind kind)
+{
+    switch (kind)
+    {
+    case AstNodeKind::Module:
+    {
+        auto module_name = ReadToken();
+
+        auto import_list = std::vector<ModuleImportInfo>(ReadCount());
+        for (auto& import_info : import_list)
+        {
+            import_info.should_export = ReadBool();
+            import_info.name = ReadToken();
+        }
+
+        auto global_declarations = PopList<GlobalDecl>(ReadU32());
+        return m_arena.Create<Module>(module_name, import_list, global_declarations);
+    }
+
+    case AstNodeKind::Parameter:
+    {
+        auto name = ReadToken();
+        return m_arena.Create<Parameter>(name, ReadParamType());
+    }
+    case AstNodeKind::FuncDecl:
+    {
+        auto should_export = ReadBool();
+        auto name = ReadToken();
+        auto return_type = ReadType();
+        auto num_params = ReadU32();
+
+        auto body = Pop<Stmt>();
+        auto parameters = PopList<Parameter>(num_params);
+        return m_arena.Create<FuncDecl>(should_export, name, return_type, parameters, body);
+    }
+    case AstNodeKind::StructDecl:
+    {
+        auto should_export = ReadBool();
+        auto name = ReadToken();
+
+        auto members = std::vector<MemberVariable>{};
+        auto num_members = ReadCount();
+        for (uint32_t i = 0; i < num_members; ++i)
+        {
+            auto member_name = ReadToken();
+            members.push_back({member_name, ReadType()});
+        }
+        return m_arena.Create<StructDecl>(should_export, name, members);
+    }
+
+    case AstNodeKind::CompoundStmt:
+        return m_arena.Create<CompoundStmt>(PopList<Stmt>(ReadU32()));
+    case AstNodeKind::IfStmt:
+    {
+        auto else_branch = PopIfPresent<Stmt>(ReadBool());
+        auto then_branch = Pop<Stmt>();
+        auto condition = Pop<Expr>();
+        return m_arena.Create<IfStmt>(condition, then_branch, else_branch);
+    }
+    case AstNodeKind::ForStmt:
+    {
+        auto has_initializer = ReadBool();
+        auto has_condition = ReadBool();
+        auto has_increment_expr = ReadBool();
+
+        auto body = Pop<Stmt>();
+        auto increment_expr = PopIfPresent<Expr>(has_increment_expr);
+        auto condition = PopIfPresent<Expr>(has_condition);
+        auto initializer = PopIfPresent<Stmt>(has_initializer);
+        return m_arena.Create<ForStmt>(initializer, condition, increment_expr, body);
+    }
+    case AstNodeKind::WhileStmt:
+    {
+        auto body = Pop<Stmt>();
+        auto condition = Pop<Expr>();
+        return m_arena.Create<WhileStmt>(condition, body);
+    }
+    case AstNodeKind::JumpStmt:
+    {
+        auto jump_type = ReadToken();
+        return m_arena.Create<JumpStmt>(jump_type, PopIfPresent<Expr>(ReadBool()));
+    }
+    case AstNodeKind::VarDeclStmt:
+    {
+        auto name = ReadToken();
+        auto type = ReadType();
+        auto var_decl = m_arena.Create<VarDeclStmt>(name, type, PopIfPresent<VarInit>(ReadBool()));
+
+        // The node is kept through its Stmt part, which is how it appears in a tree.
+        return static_cast<Stmt*>(var_decl);
+    }
+    case AstNodeKind::ExprStmt:
+        return m_arena.Create<ExprStmt>(Pop<Expr>());
+
+    case AstNodeKind::VarInitExpr:
+        return m_arena.Create<VarInitExpr>(Pop<Expr>());
+    case AstNodeKind::VarInitList:
+        return m_arena.Create<VarInitList>(PopList<VarInit>(ReadU32()));
+
+    case AstNodeKind::ArrayAccessExpr:
+    {
+        auto index = Pop<Expr>();
+        auto operand = Pop<Expr>();
+        return m_arena.Create<ArrayAccessExpr>(operand, index);
+    }
+    case AstNodeKind::BinaryExpr:
+    {
+        auto op = ReadToken();
+        auto rhs = Pop<Expr>();
+        auto lhs = Pop<Expr>();
+        return m_arena.Create<BinaryExpr>(op, lhs, rhs);
+    }
+    case AstNodeKind::FuncCallExpr:
+    {
+        auto arg_list = PopList<Expr>(ReadU32());
+        auto function = Pop<Expr>();
+        return m_arena.Create<FuncCallExpr>(function, arg_list);
+    }
+    case AstNodeKind::Identifier:
+        return m_arena.Create<Identifier>(ReadToken());
+    case AstNodeKind::Literal:
+        return m_arena.Create<Literal>(ReadToken());
+    case AstNodeKind::MemberAccessExpr:
+    {
+        auto member_name = ReadToken();
+        return m_arena.Create<MemberAccessExpr>(Pop<Expr>(), member_name);
+    }
+    case AstNodeKind::PostfixExpr:
+    {
+        auto op = ReadToken();
+        return m_arena.Create<PostfixExpr>(op, Pop<Expr>());
+    }
+    case AstNodeKind::PrefixExpr:
+    {
+        auto op = ReadToken();
+        return m_arena.Create<PrefixExpr>(op, Pop<Expr>());
+    }
+    }
+
+    ThrowMalformedData();
+}
+
+template<typename T>
+T* AstReader::Pop()
+{
+    auto node = m_finished_nodes.empty() ? nullptr : dynamic_cast<T*>(m_finished_nodes.back());
+    if (!node)
+    {
+        ThrowMalformedData();
+    }
+    m_finished_nodes.pop_back();
+    return node;
+}
+
+template<typename T>
+T* AstReader::PopIfPresent(bool is_present)
+{
+    return is_present ? Pop<T>() : nullptr;
+}
+
+template<typename T>
+std::vector<T*> AstReader::PopList(uint32_t count)
+{
+    if (count > m_finished_nodes.size())
+    {
+        ThrowMalformedData();
+    }
+
+    auto nodes = std::vector<T*>(count);
+    for (auto it = nodes.rbegin(); it != nodes.rend(); ++it)
+    {
+        *it = Pop<T>();
+    }
+    return nodes;
+}
+
+uint32_t AstReader::ReadCount()
+{
+    auto count = ReadU32();
+    if (count > m_data.size() - m_cursor)
+    {
+        ThrowMalformedData();
+    }
+    return count;
+}
+
+void AstReader::ThrowMalformedData() const
+{
+    throw std::runtime_error(std::format("[Cache Error] malformed AST data at offset {}", m_cursor));
+}
+
+std::string SerializeAst(IAbstractSyntaxTree* ast)
+{
+    auto writer = AstWriter();
+    writer.Walk(ast);
+    return writer.Release();
+}
+
+std::shared_ptr<IAbstractSyntaxTree> DeserializeAst(std::string_view data)
+{
+    auto arena = std::make_shared<AstArena>();
+    auto module = AstReader(data, *arena).ReadModule();
+    return std::shared_ptr<IAbstractSyntaxTree>(arena, module);
+}
+
+} // namespace mylang
@@ -0,0 +1,168 @@
+#include "parser/DeclBoundaryScanner.h"
+
+namespace mylang
+{
+
+void DeclBoundaryScanner::Feed(TokenType type)
+{
+    if (m_state == State::Invalid)
+    {
+        return;
+    }
+
+    if (m_state == State::ImportOrDecl && type != TokenType::Import)
+    {
+        m_header_end = m_num_tokens;
+        m_state = State::Declarations;
+    }
+
+    if (m_state == State::Declarations)
+    {
+        FeedDeclaration(type);
+    }
+    else
+    {
+        FeedHeader(type);
+    }
+
+    ++m_num_tokens;
+}
+
+bool DeclBoundaryScanner::IsValid() const
+{
+    if (m_state == State::Invalid)
+    {
+        return false;
+    }
+
+    // Any token after the header should belong to a declaration,
+    // so the first declaration should come right after the header.
+    if (m_state == State::Declarations &&
+        (m_decl_starts.empty() || m_decl_starts.front() != m_header_end))
+    {
+        return false;
+    }
+    return m_bracket_depth == 0;
+}
+
+size_t DeclBoundaryScanner::NumTokens() const
+{
+    return m_num_tokens;
+}
+
+size_t DeclBoundaryScanner::HeaderEnd() const
+{
+    // The header might be the whole module.
+    if (m_state != State::Declarations)
+    {
+        return m_num_tokens;
+    }
+    return m_header_end;
+}
+
+const std::vector<size_t>& DeclBoundaryScanner::DeclStarts() const
+{
+    return m_decl_starts;
+}
+
+// module-decl   ::= "module" identifier ";"
+// module-import ::= "import" "export"? identifier ";"
+void DeclBoundaryScanner::FeedHeader(TokenType type)
+{
+    auto expect = [&](TokenType expected, State next) {
+        m_state = (type == expected) ? next : State::Invalid;
+    };
+
+    switch (m_state)
+    {
+    case State::ModuleKeyword:
+        expect(TokenType::Module, State::ModuleName);
+        break;
+    case State::ModuleName:
+        expect(TokenType::Identifier, State::ModuleSemicolon);
+        break;
+    case State::ModuleSemicolon:
+        expect(TokenType::Semicolon, State::ImportOrDecl);
+        break;
+    case State::ImportOrDecl:
+        expect(TokenType::Import, State::ImportExport);
+        break;
+    case State::ImportExport:
+        if (type == TokenType::Export)
+        {
+            m_state = State::ImportName;
+        }
+        else
+        {
+            expect(TokenType::Identifier, State::ImportSemicolon);
+        }
+        break;
+    case State::ImportName:
+        expect(TokenType::Identifier, State::ImportSemicolon);
+        break;
+    case State::ImportSemicolon:
+        expect(TokenType::Semicolon, State::ImportOrDecl);
+        break;
+    default:
+        m_state = State::Invalid;
+        break;
+    }
+}
+
+void DeclBoundaryScanner::FeedDeclaration(TokenType type)
+{
+    // Closing brackets take effect before the token is examined,
+    // so that "}" itself is considered as part of the enclosing depth.
+    if (type == TokenType::RightBrace ||
+        type == TokenType::RightParen ||
+        type == TokenType::RightBracket)
+    {
+        if (--m_bracket_depth < 0)
+        {
+            m_state = State::Invalid;
+            return;
+        }
+    }
+
+    if (m_bracket_depth == 0)
+    {
+        auto& recent = m_recent_top_level_tokens;
+        recent.emplace_back(m_num_tokens, type);
+
+        // Case 1) "export" identifier ":" ...
+        if (type == TokenType::Export)
+        {
+            m_decl_starts.push_back(m_num_tokens);
+        }
+        // Case 2) identifier ":" ("func" | "struct"), without leading "export".
+        else if ((type == TokenType::Func || type == TokenType::Struct) && recent.size() >= 3)
+        {
+            const auto& [id_ind, id_type] = recent[recent.size() - 3];
+            const auto& [colon_ind, colon_type] = recent[recent.size() - 2];
+
+            auto is_adjacent = (id_ind + 2 == m_num_tokens) && (colon_ind + 1 == m_num_tokens);
+            auto is_exported = (recent.size() >= 4) &&
+                (recent[recent.size() - 4].first + 1 == id_ind) &&
+                (recent[recent.size() - 4].second == TokenType::Export);
+            if (is_adjacent && id_type == TokenType::Identifier && colon_type == TokenType::Colon && !is_exported)
+            {
+                m_decl_starts.push_back(id_ind);
+            }
+        }
+
+        // We never look back more than four tokens.
+        if (recent.size() > 4)
+        {
+            recent.erase(recent.begin());
+        }
+    }
+
+    if (type == TokenType::LeftBrace ||
+        type == TokenType::LeftParen ||
+        type == TokenType::LeftBracket)
+    {
+        ++m_bracket_depth;
+    }
+}
+
+} // namespace mylang
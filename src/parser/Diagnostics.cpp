@@ -0,0 +1,129 @@
+#include "parser/Diagnostics.h"
+#include <format>
+
+namespace mylang
+{
+
+std::string Diagnostic::Message() const
+{
+    switch (code)
+    {
+    case DiagnosticCode::InvalidType:
+        return std::format("{} tried to use invalid type \"{}\"", args[0], args[1]);
+    case DiagnosticCode::TypeMismatch:
+        return std::format("expected type of {} is \"{}\", but \"{}\" was given", args[0], args[1], args[2]);
+    case DiagnosticCode::ImplicitConversion:
+        return std::format("implicit conversion from base type \"{}\" to \"{}\" is not allowed", args[0], args[1]);
+    case DiagnosticCode::DimensionMismatch:
+        return std::format("number of dimensions differ between types \"{}\" and \"{}\"", args[0], args[1]);
+    case DiagnosticCode::InitializerTooLarge:
+        return std::format("array size of initializer's type \"{}\" exceeds variable's type \"{}\"", args[0], args[1]);
+    case DiagnosticCode::MixedInitializerTypes:
+        return std::format("trying to mix types \"{}\" and \"{}\" inside an initializer list", args[0], args[1]);
+    case DiagnosticCode::MixedInitializerDimensions:
+        return "every element in an initializer list should have same dimension";
+    case DiagnosticCode::NonArrayAccess:
+        return std::format("array access operator [] cannot be applied to non-array type \"{}\"", args[0]);
+    case DiagnosticCode::UnexpectedArray:
+        return std::format("expected a non-array type for {}, but \"{}\" was given", args[0], args[1]);
+    case DiagnosticCode::UnexpectedNonNumeric:
+        return std::format("expected numeric type for {}, but \"{}\" was given", args[0], args[1]);
+    case DiagnosticCode::InvalidOperation:
+        return std::format("operation \"{}\" {} \"{}\" is not allowed", args[0], args[1], args[2]);
+    case DiagnosticCode::AssignmentToRvalue:
+        return "assignment to an rvalue is not allowed";
+    case DiagnosticCode::ArgumentCount:
+        return std::format("the function only requires {} arguments, but {} was given", args[0], args[1]);
+    case DiagnosticCode::UnexpectedRvalue:
+        return std::format("expected an lvalue for {}, but an rvalue was given", args[0]);
+    case DiagnosticCode::NotCallable:
+        return std::format("\"{}\" is not a callable type", args[0]);
+    case DiagnosticCode::UndefinedSymbol:
+        return std::format("trying to use undefined symbol \"{}\" in an expression", args[0]);
+    case DiagnosticCode::TypeNameAsExpression:
+        return std::format("type name \"{}\" cannot be used as an expression", args[0]);
+    case DiagnosticCode::NotAStruct:
+        return std::format("\"{}\" is not a struct type", args[0]);
+    case DiagnosticCode::UnknownMember:
+        break;
+    }
+
+    // The last code is handled out of the switch,
+    // so that every path returns a value.
+    return std::format("struct type \"{}\" does not have member variable named \"{}\"", args[0], args[1]);
+}
+
+std::string Diagnostic::ToString() const
+{
+    return std::format("[Semantic Error][Ln {}, Col {}] {}",
+        where.line,
+        where.column,
+        Message()
+    );
+}
+
+LazyMessage::LazyMessage(const char* message)
+    : m_message(message)
+{}
+
+std::string LazyMessage::Build() const
+{
+    return m_build ? m_build(m_builder) : std::string(m_message);
+}
+
+DiagnosticSink::DiagnosticSink(size_t error_limit)
+    : m_error_limit(error_limit)
+{}
+
+void DiagnosticSink::Report(DiagnosticCode code, const SourcePos& where, std::vector<std::string> args)
+{
+    if (IsLimitReached())
+    {
+        ++m_num_dropped;
+        return;
+    }
+    m_diagnostics.push_back(Diagnostic{code, where, std::move(args)});
+}
+
+bool DiagnosticSink::HasErrors() const
+{
+    return !m_diagnostics.empty();
+}
+
+bool DiagnosticSink::IsLimitReached() const
+{
+    return m_error_limit != 0 && m_diagnostics.size() >= m_error_limit;
+}
+
+size_t DiagnosticSink::ErrorLimit() const
+{
+    return m_error_limit;
+}
+
+size_t DiagnosticSink::NumReported() const
+{
+    return m_diagnostics.size() + m_num_dropped;
+}
+
+const std::vector<Diagnostic>& DiagnosticSink::Diagnostics() const
+{
+    return m_diagnostics;
+}
+
+void DiagnosticSink::Merge(DiagnosticSink&& other)
+{
+    for (auto& diagnostic : other.m_diagnostics)
+    {
+        Report(diagnostic.code, diagnostic.where, std::move(diagnostic.args));
+    }
+    m_num_dropped += other.m_num_dropped;
+    other.Clear();
+}
+
+void DiagnosticSink::Clear()
+{
+    m_num_dropped = 0;
+    m_diagnostics.clear();
+}
+
+} // namespace mylang
@@ -0,0 +1,743 @@
+#include "parser/IncrementalChecker.h"
+#include "parser/ast/Module.h"
+#include "parser/ast/StructuralHash.h"
+#include "parser/ast/globdecl/FuncDecl.h"
+#include "parser/ast/globdecl/Parameter.h"
+#include "parser/ast/globdecl/StructDecl.h"
+#include "parser/ast/stmt/VarDeclStmt.h"
+#include "parser/ast/expr/Identifier.h"
+#include "parser/ast/expr/MemberAccessExpr.h"
+#include "parser/ast/visitor/FlatAstBuilder.h"
+#include "parser/ast/visitor/GlobalSymbolScanner.h"
+#include "parser/ast/visitor/NameBinder.h"
+#include "parser/type/base/StructType.h"
+#include "parser/type/base/FuncType.h"
+#include "parser/SemanticError.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace mylang
+{
+
+// Calls 'callback' with every struct type that the type mentions,
+// the same ones NameBinder binds.
+template<typename Callback>
+void ForEachStructType(const Type& type, const Callback& callback)
+{
+    if (auto struct_type = dynamic_cast<const StructType*>(type.BaseType()))
+    {
+        callback(struct_type);
+    }
+    else if (auto func_type = dynamic_cast<const FuncType*>(type.BaseType()))
+    {
+        for (const auto& param_type : func_type->ParamTypes())
+        {
+            ForEachStructType(param_type.type, callback);
+        }
+        ForEachStructType(func_type->ReturnType(), callback);
+    }
+}
+
+// Calls 'callback' with every type in the node that NameBinder resolves.
+// Note: the type of a struct declaration names the struct itself.
+template<typename Callback>
+void ForEachBoundType(IAbstractSyntaxTree* node, const Callback& callback)
+{
+    if (auto func_decl = dynamic_cast<FuncDecl*>(node))
+    {
+        callback(func_decl->ReturnType());
+    }
+    else if (auto parameter = dynamic_cast<Parameter*>(node))
+    {
+        callback(parameter->DeclType());
+    }
+    else if (auto struct_decl = dynamic_cast<StructDecl*>(node))
+    {
+        for (const auto& member : struct_decl->Members())
+        {
+            callback(member.type);
+        }
+    }
+    else if (auto var_decl = dynamic_cast<VarDeclStmt*>(node))
+    {
+        callback(var_decl->DeclType());
+    }
+}
+
+// Moves a position of a declaration that starts at 'old_start'
+// to the same position in a copy of it that starts at 'new_start',
+// the same way IncrementalParser shifts the declarations after an edit.
+// Note: an unknown position (0, 0), e.g., of CompoundStmt, is left as it is.
+SourcePos RelocatePos(SourcePos pos, SourcePos old_start, SourcePos new_start)
+{
+    if (pos.line == 0)
+    {
+        return pos;
+    }
+    if (pos.line == old_start.line)
+    {
+        return {new_start.line, pos.column - old_start.column + new_start.column};
+    }
+    return {pos.line + new_start.line - old_start.line, pos.column};
+}
+
+// Every struct type that NameBinder binds in the node, in order.
+std::vector<const StructType*> CollectBoundStructTypes(IAbstractSyntaxTree* node)
+{
+    auto struct_types = std::vector<const StructType*>();
+    ForEachBoundType(node, [&](const Type& type) {
+        ForEachStructType(type, [&](const StructType* struct_type) {
+            struct_types.push_back(struct_type);
+        });
+    });
+    return struct_types;
+}
+
+void IncrementalChecker::UpdateFile(size_t file_index, std::shared_ptr<IAbstractSyntaxTree> ast)
+{
+    if (file_index == m_files.size())
+    {
+        m_files.push_back(std::move(ast));
+    }
+    else
+    {
+        m_files.at(file_index) = std::move(ast);
+    }
+}
+
+size_t IncrementalChecker::NumFiles() const
+{
+    return m_files.size();
+}
+
+void IncrementalChecker::Check()
+{
+    // Step 1) scan the global symbols of every file into a new environment.
+    // Only top-level declarations are visited, and nothing is changed until it succeeds.
+    auto environment = std::make_unique<ProgramEnvironment>();
+    auto index = SymbolIndex();
+    ScanGlobalSymbols(*environment, index);
+
+    // Names of the declarations that were added, removed, parsed again or exported differently.
+    // Unless the imports changed as well, no other name can resolve differently.
+    auto changed_names = std::set<std::string>();
+    for (const auto& [key, entry] : index.symbols)
+    {
+        auto it = m_index.symbols.find(key);
+        if (it == m_index.symbols.end() || it->second.decl_id != entry.decl_id || it->second.is_public != entry.is_public)
+        {
+            changed_names.insert(key.name);
+        }
+    }
+    for (const auto& [key, entry] : m_index.symbols)
+    {
+        if (!index.symbols.contains(key))
+        {
+            changed_names.insert(key.name);
+        }
+    }
+    auto have_imports_changed = index.imports != m_index.imports;
+
+    // Step 2) keep the state of every declaration with the same module and name,
+    // unless it changed or failed to bind. The rest are bound from scratch.
+    auto decls = std::map<SymbolKey, DeclState>();
+    auto decls_in_order = std::vector<DeclState*>();
+    auto decls_to_bind = std::vector<DeclState*>();
+    for (const auto& file : m_files)
+    {
+        auto module = static_cast<Module*>(file.get());
+        for (auto decl : module->Declarations())
+        {
+            const auto& key = index.keys.at(decl);
+            auto it = m_decls.find(key);
+            auto is_kept = it != m_decls.end() && !it->second.binding_error &&
+                (it->second.decl == decl || Relocate(it->second, decl, file));
+            auto& state = is_kept ?
+                decls.emplace(key, std::move(it->second)).first->second :
+                decls.emplace(key, DeclState(decl, key, file)).first->second;
+            if (is_kept)
+            {
+                // The file may be a new tree that reuses the declaration.
+                state.file = file;
+                m_decls.erase(it);
+            }
+            else
+            {
+                decls_to_bind.push_back(&state);
+            }
+            decls_in_order.push_back(&state);
+        }
+    }
+
+    // What's left was removed or changed.
+    for (const auto& [key, state] : m_decls)
+    {
+        RemoveDependents(state);
+    }
+
+    // Only the kept declarations that looked up a changed name are looked at.
+    auto bound_decls = std::set<SymbolKey>();
+    for (auto state : decls_to_bind)
+    {
+        bound_decls.insert(state->key);
+    }
+    auto is_kept = [&](const SymbolKey& key) {
+        return decls.contains(key) && !bound_decls.contains(key);
+    };
+    auto affected_decls = std::vector<SymbolKey>();
+    if (have_imports_changed)
+    {
+        for (auto state : decls_in_order)
+        {
+            affected_decls.push_back(state->key);
+        }
+    }
+    else
+    {
+        affected_decls = FindDependents(changed_names);
+    }
+
+    // Step 3) a kept declaration is bound again if a name it looked up resolves differently.
+    // Otherwise, its bindings are moved to the declarations that were parsed again.
+    auto moved_decls = std::vector<DeclState*>();
+    for (const auto& key : affected_decls)
+    {
+        if (!is_kept(key))
+        {
+            continue;
+        }
+
+        auto& state = decls.at(key);
+        if (HasResolutionChanged(state, *environment, index))
+        {
+            decls_to_bind.push_back(&state);
+            bound_decls.insert(key);
+        }
+        else
+        {
+            moved_decls.push_back(&state);
+        }
+    }
+    for (auto state : decls_to_bind)
+    {
+        Bind(*state, *environment, index);
+    }
+    for (auto state : moved_decls)
+    {
+        MoveBindings(*state, index);
+    }
+
+    // Step 4) every declaration is bound by now, so its signature is known.
+    // The signature of a declaration only changes when it is bound again.
+    auto changed_signatures = changed_names;
+    for (auto& [key, entry] : index.symbols)
+    {
+        entry.signature = decls.at(key).signature;
+        auto it = m_index.symbols.find(key);
+        if (it != m_index.symbols.end() && it->second.signature != entry.signature)
+        {
+            changed_signatures.insert(key.name);
+        }
+    }
+
+    // Step 5) a kept declaration is checked again if a declaration it depends on has another signature.
+    // It is bound again as well, to drop the member accesses the last check bound.
+    auto decls_to_check = decls_to_bind;
+    for (const auto& key : FindDependents(changed_signatures))
+    {
+        if (!is_kept(key))
+        {
+            continue;
+        }
+
+        auto& state = decls.at(key);
+        auto has_dependency_changed = std::ranges::any_of(state.dependencies, [&](const auto& dependency) {
+            auto it = index.symbols.find(dependency.first);
+            return it == index.symbols.end() || it->second.signature != dependency.second;
+        });
+        if (has_dependency_changed)
+        {
+            Bind(state, *environment, index);
+            decls_to_check.push_back(&state);
+            bound_decls.insert(key);
+        }
+    }
+
+    auto num_checked_decls = size_t{0};
+    for (auto state : decls_to_check)
+    {
+        if (!state->binding_error)
+        {
+            TypeCheck(*state, *environment, index);
+            AddDependents(*state);
+            ++num_checked_decls;
+        }
+    }
+
+    m_environment = std::move(environment);
+    m_index = std::move(index);
+    m_decls = std::move(decls);
+    m_num_checked_decls = num_checked_decls;
+    m_num_reused_decls = decls_in_order.size() - decls_to_check.size();
+
+    // Step 6) the first declaration that failed to bind stops the analysis,
+    // as it would have when binding the files one after another.
+    for (auto state : decls_in_order)
+    {
+        if (state->binding_error)
+        {
+            std::rethrow_exception(state->binding_error);
+        }
+    }
+}
+
+std::vector<Diagnostic> IncrementalChecker::Diagnostics(size_t file_index) const
+{
+    auto diagnostics = std::vector<Diagnostic>();
+    for (auto decl : static_cast<Module*>(m_files.at(file_index).get())->Declarations())
+    {
+        auto key = m_index.keys.find(decl);
+        auto it = key != m_index.keys.end() ? m_decls.find(key->second) : m_decls.end();
+        if (it != m_decls.end() && it->second.decl == decl)
+        {
+            const auto& decl_diagnostics = it->second.diagnostics.Diagnostics();
+            diagnostics.insert(diagnostics.end(), decl_diagnostics.begin(), decl_diagnostics.end());
+        }
+    }
+    return diagnostics;
+}
+
+const NameBindings& IncrementalChecker::Bindings(const GlobalDecl* decl) const
+{
+    return FindDeclState(decl).bindings;
+}
+
+const SideTable<ExprTrait>& IncrementalChecker::ExprTraits(const GlobalDecl* decl) const
+{
+    return FindDeclState(decl).expr_traits;
+}
+
+size_t IncrementalChecker::NumCheckedDecls() const
+{
+    return m_num_checked_decls;
+}
+
+size_t IncrementalChecker::NumReusedDecls() const
+{
+    return m_num_reused_decls;
+}
+
+void IncrementalChecker::ScanGlobalSymbols(ProgramEnvironment& environment, SymbolIndex& index) const
+{
+    auto scanner = GlobalSymbolScanner(environment);
+    for (const auto& file : m_files)
+    {
+        file->Accept(&scanner);
+    }
+    environment.ValidateModuleDependency();
+    environment.Freeze();
+
+    for (const auto& file : m_files)
+    {
+        auto module = static_cast<Module*>(file.get());
+        auto module_name = std::string(module->ModuleName().lexeme);
+        for (auto decl : module->Declarations())
+        {
+            auto key = SymbolKey{module_name, std::string(decl->Name().lexeme)};
+            index.symbols.emplace(key, SymbolEntry{decl, decl->NodeId(), decl->ShouldExport()});
+            index.keys.emplace(decl, key);
+        }
+
+        // Files of the same module share their imports.
+        auto& imports = index.imports[module_name];
+        imports.clear();
+        for (const auto& import : environment.GetModuleInfo(module_name).import_list)
+        {
+            imports.emplace_back(import.name.lexeme, import.should_export);
+        }
+    }
+}
+
+const IncrementalChecker::DeclState& IncrementalChecker::FindDeclState(const GlobalDecl* decl) const
+{
+    const auto& state = m_decls.at(m_index.keys.at(decl));
+    if (state.decl != decl)
+    {
+        throw std::out_of_range("IncrementalChecker: the declaration wasn't checked");
+    }
+    return state;
+}
+
+std::vector<IncrementalChecker::SymbolKey> IncrementalChecker::FindDependents(const std::set<std::string>& names) const
+{
+    auto dependents = std::vector<SymbolKey>();
+    for (const auto& name : names)
+    {
+        if (auto it = m_dependents.find(name); it != m_dependents.end())
+        {
+            dependents.insert(dependents.end(), it->second.begin(), it->second.end());
+        }
+    }
+    std::ranges::sort(dependents);
+    auto [first, last] = std::ranges::unique(dependents);
+    dependents.erase(first, last);
+    return dependents;
+}
+
+bool IncrementalChecker::Relocate(DeclState& state, GlobalDecl* decl, std::shared_ptr<IAbstractSyntaxTree> file) const
+{
+    if (state.decl->StructuralHash() != decl->StructuralHash() || !IsStructurallyEqual(state.decl, decl))
+    {
+        return false;
+    }
+
+    // Diagnostics are reported at node positions and tokens, including the names of members.
+    // If any of them moved by another amount (e.g., whitespace within the declaration changed),
+    // the positions of the diagnostics can't be found without checking again.
+    auto old_flat_ast = CreateFlatAst(state.decl);
+    auto new_flat_ast = CreateFlatAst(decl);
+    auto old_start = state.decl->StartPos();
+    auto new_start = decl->StartPos();
+    auto is_relocated = [&](SourcePos old_pos, SourcePos new_pos) {
+        return RelocatePos(old_pos, old_start, new_start) == new_pos;
+    };
+    for (FlatNodeId id = 0; id < old_flat_ast.NumNodes(); ++id)
+    {
+        if (!is_relocated(old_flat_ast.SourceNode(id)->StartPos(), new_flat_ast.SourceNode(id)->StartPos()) ||
+            !is_relocated(old_flat_ast.NodeToken(id).start_pos, new_flat_ast.NodeToken(id).start_pos))
+        {
+            return false;
+        }
+        if (old_flat_ast.Kind(id) == FlatNodeKind::StructDecl)
+        {
+            auto old_members = old_flat_ast.Members(id);
+            auto new_members = new_flat_ast.Members(id);
+            for (size_t i = 0; i < old_members.size(); ++i)
+            {
+                if (!is_relocated(old_members[i].name.start_pos, new_members[i].name.start_pos))
+                {
+                    return false;
+                }
+            }
+        }
+    }
+
+    // Bindings to local declarations and to the declaration itself point to the copies.
+    auto nodes = std::unordered_map<const IAbstractSyntaxTree*, IAbstractSyntaxTree*>();
+    auto local_decls = std::unordered_map<const Decl*, const Decl*>();
+    for (FlatNodeId id = 0; id < old_flat_ast.NumNodes(); ++id)
+    {
+        auto old_node = old_flat_ast.SourceNode(id);
+        auto new_node = new_flat_ast.SourceNode(id);
+        nodes.emplace(old_node, new_node);
+        if (auto old_decl = dynamic_cast<const Decl*>(old_node))
+        {
+            local_decls.emplace(old_decl, dynamic_cast<const Decl*>(new_node));
+        }
+    }
+    auto relocate_decl = [&](const Decl* declaration) {
+        auto it = local_decls.find(declaration);
+        return it != local_decls.end() ? it->second : declaration;
+    };
+
+    auto bindings = NameBindings();
+    auto expr_traits = SideTable<ExprTrait>();
+    auto struct_types = std::unordered_map<const StructType*, const StructType*>();
+    if (auto struct_decl = dynamic_cast<StructDecl*>(decl))
+    {
+        static_cast<const StructType*>(struct_decl->DeclType().BaseType())->BindDeclaration(struct_decl);
+    }
+    for (FlatNodeId id = 0; id < old_flat_ast.NumNodes(); ++id)
+    {
+        auto old_node = old_flat_ast.SourceNode(id);
+        auto new_node = new_flat_ast.SourceNode(id);
+        if (auto identifier = dynamic_cast<const Identifier*>(old_node))
+        {
+            auto declaration = state.bindings.FindDeclaration(identifier);
+            bindings.BindIdentifier(static_cast<const Identifier*>(new_node), declaration ? relocate_decl(declaration) : nullptr);
+        }
+        else if (auto member_access = dynamic_cast<const MemberAccessExpr*>(old_node))
+        {
+            if (auto member = state.bindings.FindMember(member_access))
+            {
+                bindings.BindMember(static_cast<const MemberAccessExpr*>(new_node), *member);
+            }
+        }
+        if (auto trait = state.expr_traits.Find(old_node))
+        {
+            expr_traits.Set(new_node, *trait);
+        }
+
+        auto old_struct_types = CollectBoundStructTypes(old_node);
+        auto new_struct_types = CollectBoundStructTypes(new_node);
+        for (size_t i = 0; i < old_struct_types.size(); ++i)
+        {
+            auto declaration = old_struct_types[i]->Declaration();
+            new_struct_types[i]->BindDeclaration(declaration ? static_cast<const StructDecl*>(relocate_decl(declaration)) : nullptr);
+            struct_types.emplace(old_struct_types[i], new_struct_types[i]);
+        }
+    }
+
+    for (auto& [identifier, key] : state.identifier_sites)
+    {
+        identifier = static_cast<const Identifier*>(nodes.at(identifier));
+    }
+    for (auto& [struct_type, key] : state.struct_type_sites)
+    {
+        struct_type = struct_types.at(struct_type);
+    }
+    for (auto& [member_access, key] : state.member_sites)
+    {
+        member_access = static_cast<const MemberAccessExpr*>(nodes.at(member_access));
+    }
+
+    auto diagnostics = DiagnosticSink();
+    for (const auto& diagnostic : state.diagnostics.Diagnostics())
+    {
+        diagnostics.Report(diagnostic.code, RelocatePos(diagnostic.where, old_start, new_start), diagnostic.args);
+    }
+
+    state.decl = decl;
+    state.file = std::move(file);
+    state.bindings = std::move(bindings);
+    state.expr_traits = std::move(expr_traits);
+    state.diagnostics = std::move(diagnostics);
+    return true;
+}
+
+IncrementalChecker::Lookup IncrementalChecker::Resolve(
+    const ProgramEnvironment& environment,
+    const SymbolIndex& index,
+    std::string_view module_name,
+    std::string_view name
+) const
+{
+    auto lookup = Lookup{std::string(name), std::nullopt, false};
+    if (auto symbol = environment.TryFindSymbol(module_name, name))
+    {
+        lookup.symbol = index.keys.at(symbol->declaration);
+        lookup.is_struct = dynamic_cast<const StructDecl*>(symbol->declaration) != nullptr;
+    }
+    return lookup;
+}
+
+bool IncrementalChecker::HasResolutionChanged(
+    const DeclState& state,
+    const ProgramEnvironment& environment,
+    const SymbolIndex& index
+) const
+{
+    return std::ranges::any_of(state.lookups, [&](const Lookup& lookup) {
+        return Resolve(environment, index, state.key.module_name, lookup.name) != lookup;
+    });
+}
+
+void IncrementalChecker::MoveBindings(DeclState& state, const SymbolIndex& index) const
+{
+    // A symbol that is gone was looked up by a declaration that is bound again,
+    // or it is a dependency, which gets the declaration checked again.
+    for (const auto& [node, key] : state.identifier_sites)
+    {
+        auto it = index.symbols.find(key);
+        if (it != index.symbols.end() && state.bindings.FindDeclaration(node) != it->second.decl)
+        {
+            state.bindings.BindIdentifier(node, it->second.decl);
+        }
+    }
+    for (const auto& [struct_type, key] : state.struct_type_sites)
+    {
+        auto it = index.symbols.find(key);
+        if (it != index.symbols.end())
+        {
+            struct_type->BindDeclaration(dynamic_cast<const StructDecl*>(it->second.decl));
+        }
+    }
+    for (const auto& [node, key] : state.member_sites)
+    {
+        auto it = index.symbols.find(key);
+        auto struct_decl = it != index.symbols.end() ? dynamic_cast<const StructDecl*>(it->second.decl) : nullptr;
+        if (struct_decl)
+        {
+            state.bindings.BindMember(node, MemberBinding{struct_decl, state.bindings.FindMember(node)->member_index});
+        }
+    }
+}
+
+void IncrementalChecker::Bind(DeclState& state, const ProgramEnvironment& environment, const SymbolIndex& index)
+{
+    RemoveDependents(state);
+    state.bindings = NameBindings();
+    state.expr_traits.Clear();
+    state.diagnostics.Clear();
+    state.binding_error = nullptr;
+    state.lookups.clear();
+    state.dependencies.clear();
+    state.identifier_sites.clear();
+    state.struct_type_sites.clear();
+    state.member_sites.clear();
+
+    auto binder = NameBinder(environment, state.bindings);
+    try
+    {
+        binder.BindDeclaration(environment.GetModuleHandle(state.key.module_name), state.decl);
+    }
+    catch (const SemanticError&)
+    {
+        // The types after the error keep their last bindings, which may point to
+        // declarations that are gone. Nothing is bound until the error is fixed.
+        state.binding_error = std::current_exception();
+        auto flat_ast = CreateFlatAst(state.decl);
+        for (FlatNodeId id = 0; id < flat_ast.NumNodes(); ++id)
+        {
+            ForEachBoundType(flat_ast.SourceNode(id), [](const Type& type) {
+                ForEachStructType(type, [](const StructType* struct_type) {
+                    struct_type->BindDeclaration(nullptr);
+                });
+            });
+        }
+    }
+    state.signature = ComputeSignature(state, index);
+}
+
+void IncrementalChecker::TypeCheck(DeclState& state, const ProgramEnvironment& environment, const SymbolIndex& index)
+{
+    auto type_checker = TypeChecker(state.bindings, &state.diagnostics);
+    type_checker.CheckDeclaration(state.decl);
+    state.expr_traits = type_checker.TakeExprTraits();
+
+    // Record what the bindings and the check read from outside of the declaration.
+    // Names bound to a local symbol can't be hidden by a global one.
+    auto names = std::set<std::string_view>();
+    auto dependencies = std::set<SymbolKey>();
+    auto flat_ast = CreateFlatAst(state.decl);
+    for (FlatNodeId id = 0; id < flat_ast.NumNodes(); ++id)
+    {
+        auto node = flat_ast.SourceNode(id);
+        if (auto identifier = dynamic_cast<const Identifier*>(node))
+        {
+            auto declaration = state.bindings.FindDeclaration(identifier);
+            auto it = declaration ? index.keys.find(declaration) : index.keys.end();
+            if (!declaration || it != index.keys.end())
+            {
+                names.insert(identifier->Id().lexeme);
+            }
+            if (it != index.keys.end())
+            {
+                state.identifier_sites.emplace_back(identifier, it->second);
+                dependencies.insert(it->second);
+            }
+        }
+        else if (auto member_access = dynamic_cast<const MemberAccessExpr*>(node))
+        {
+            // The members of the struct were read even if the member wasn't found.
+            auto struct_trait = state.expr_traits.Find(member_access->Struct());
+            auto struct_type = struct_trait && !struct_trait->type.IsArray()
+                ? dynamic_cast<const StructType*>(struct_trait->type.BaseType())
+                : nullptr;
+            auto it = struct_type && struct_type->Declaration() ? index.keys.find(struct_type->Declaration()) : index.keys.end();
+            if (it != index.keys.end())
+            {
+                dependencies.insert(it->second);
+                if (state.bindings.FindMember(member_access))
+                {
+                    state.member_sites.emplace_back(member_access, it->second);
+                }
+            }
+        }
+
+        ForEachBoundType(node, [&](const Type& type) {
+            ForEachStructType(type, [&](const StructType* struct_type) {
+                names.insert(struct_type->TypeToken().lexeme);
+                auto it = struct_type->Declaration() ? index.keys.find(struct_type->Declaration()) : index.keys.end();
+                if (it != index.keys.end())
+                {
+                    state.struct_type_sites.emplace_back(struct_type, it->second);
+                }
+            });
+        });
+    }
+
+    for (auto name : names)
+    {
+        state.lookups.push_back(Resolve(environment, index, state.key.module_name, name));
+    }
+    for (const auto& key : dependencies)
+    {
+        state.dependencies.emplace_back(key, index.symbols.at(key).signature);
+    }
+}
+
+uint64_t IncrementalChecker::ComputeSignature(const DeclState& state, const SymbolIndex& index) const
+{
+    auto hasher = StructuralHasher("Signature");
+    hasher.Add(static_cast<uint64_t>(state.decl->NodeKind())).Add(state.decl->DeclType());
+
+    auto add_struct_types = [&](const Type& type) {
+        ForEachStructType(type, [&](const StructType* struct_type) {
+            auto it = struct_type->Declaration() ? index.keys.find(struct_type->Declaration()) : index.keys.end();
+            if (it == index.keys.end())
+            {
+                hasher.Add(uint64_t{0});
+            }
+            else
+            {
+                hasher.Add(uint64_t{1}).Add(it->second.module_name).Add(it->second.name);
+            }
+        });
+    };
+    if (auto struct_decl = dynamic_cast<const StructDecl*>(state.decl))
+    {
+        for (const auto& member : struct_decl->Members())
+        {
+            hasher.Add(member.name).Add(member.type);
+            add_struct_types(member.type);
+        }
+    }
+    else
+    {
+        add_struct_types(state.decl->DeclType());
+    }
+    return hasher.Hash();
+}
+
+void IncrementalChecker::AddDependents(const DeclState& state)
+{
+    auto names = std::set<std::string_view>();
+    for (const auto& lookup : state.lookups)
+    {
+        names.insert(lookup.name);
+    }
+    for (const auto& [key, signature] : state.dependencies)
+    {
+        names.insert(key.name);
+    }
+    for (auto name : names)
+    {
+        m_dependents[std::string(name)].push_back(state.key);
+    }
+}
+
+void IncrementalChecker::RemoveDependents(const DeclState& state)
+{
+    auto remove = [&](const std::string& name) {
+        auto it = m_dependents.find(name);
+        if (it != m_dependents.end())
+        {
+            std::erase(it->second, state.key);
+            if (it->second.empty())
+            {
+                m_dependents.erase(it);
+            }
+        }
+    };
+    for (const auto& lookup : state.lookups)
+    {
+        remove(lookup.name);
+    }
+    for (const auto& [key, signature] : state.dependencies)
+    {
+        remove(key.name);
+    }
+}
+
+} // namespace mylang
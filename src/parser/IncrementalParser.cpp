@@ -0,0 +1,716 @@
+#include "parser/IncrementalParser.h"
+#include "parser/SyntaxAnalyzer.h"
+#include "parser/DeclBoundaryScanner.h"
+#include "parser/ast/visitor/IAbstractSyntaxTreeVisitor.h"
+#include "parser/ast/Module.h"
+#include "parser/ast/globdecl/FuncDecl.h"
+#include "parser/ast/globdecl/StructDecl.h"
+
+#include "parser/ast/stmt/CompoundStmt.h"
+#include "parser/ast/stmt/IfStmt.h"
+#include "parser/ast/stmt/ForStmt.h"
+#include "parser/ast/stmt/WhileStmt.h"
+#include "parser/ast/stmt/JumpStmt.h"
+#include "parser/ast/stmt/VarDeclStmt.h"
+#include "parser/ast/stmt/ExprStmt.h"
+
+#include "parser/ast/varinit/VarInitExpr.h"
+#include "parser/ast/varinit/VarInitList.h"
+
+#include "parser/ast/expr/ArrayAccessExpr.h"
+#include "parser/ast/expr/BinaryExpr.h"
+#include "parser/ast/expr/FuncCallExpr.h"
+#include "parser/ast/expr/Identifier.h"
+#include "parser/ast/expr/Literal.h"
+#include "parser/ast/expr/MemberAccessExpr.h"
+#include "parser/ast/expr/PostfixExpr.h"
+#include "parser/ast/expr/PrefixExpr.h"
+
+#include "parser/type/base/PrimitiveType.h"
+#include "parser/type/base/StructType.h"
+#include "parser/type/base/FuncType.h"
+#include "parser/type/base/VoidType.h"
+
+#include "lexer/LexicalAnalyzer.h"
+#include "lexer/LexicalError.h"
+#include "file/DummySourceFile.h"
+#include <algorithm>
+#include <format>
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+
+namespace mylang
+{
+
+// Arenas of the incremental parser only hold a single declaration,
+// so a default-sized block would mostly be wasted.
+const size_t IncrementalArenaBlockSize = 4 * 1024;
+
+// The lexer reads at most this many characters past the end of a token
+// before deciding what the token is (e.g., "12." followed by a non-digit).
+const size_t LexerLookahead = 2;
+
+// Lexes the source code from 'begin_offset', which is located at 'begin_pos',
+// and reports every token as if the whole source code had been lexed.
+class RegionLexer
+{
+public:
+    RegionLexer(const std::string& source_code, size_t begin_offset, SourcePos begin_pos)
+        : m_source_code(source_code)
+        , m_lexer(std::make_unique<DummySourceFile>(source_code.substr(begin_offset)))
+        , m_begin_pos(begin_pos)
+        , m_line_offsets{begin_offset}
+    {}
+
+    // Also returns the offset of the token in the source code.
+    Token GetNext(size_t& offset)
+    {
+        auto token = m_lexer.GetNext();
+        offset = OffsetOf(token.start_pos);
+        token.start_pos = Translate(token.start_pos);
+        token.end_pos = Translate(token.end_pos);
+        return token;
+    }
+
+private:
+    SourcePos Translate(SourcePos pos) const
+    {
+        if (pos.line == 1)
+        {
+            return {m_begin_pos.line, m_begin_pos.column + pos.column - 1};
+        }
+        return {m_begin_pos.line + pos.line - 1, pos.column};
+    }
+
+    // Line offsets are found on demand, since lexing usually stops early.
+    size_t OffsetOf(SourcePos pos)
+    {
+        while (m_line_offsets.size() < static_cast<size_t>(pos.line))
+        {
+            auto newline = m_source_code.find('\n', m_line_offsets.back());
+            m_line_offsets.push_back(newline + 1);
+        }
+        return m_line_offsets[pos.line - 1] + pos.column - 1;
+    }
+
+    const std::string& m_source_code;
+    LexicalAnalyzer m_lexer;
+    SourcePos m_begin_pos;
+    std::vector<size_t> m_line_offsets;
+};
+
+// Returns the position of 'end_offset', counting characters from 'begin_offset' at 'begin_pos'.
+SourcePos AdvancePos(const std::string& source_code, size_t begin_offset, size_t end_offset, SourcePos begin_pos)
+{
+    auto pos = begin_pos;
+    for (auto i = begin_offset; i < end_offset; ++i)
+    {
+        if (source_code[i] == '\n')
+        {
+            pos = {pos.line + 1, 1};
+        }
+        else
+        {
+            ++pos.column;
+        }
+    }
+    return pos;
+}
+
+// Move a position after an edit from 'old_edit_end' to 'new_edit_end'.
+// The position should not be before 'old_edit_end'.
+SourcePos ShiftPos(SourcePos pos, SourcePos old_edit_end, SourcePos new_edit_end)
+{
+    if (pos.line == old_edit_end.line)
+    {
+        return {new_edit_end.line, pos.column - old_edit_end.column + new_edit_end.column};
+    }
+    return {pos.line + new_edit_end.line - old_edit_end.line, pos.column};
+}
+
+// Copies a declaration into another arena while shifting every source position,
+// which is much cheaper than parsing it again.
+class AstRelocator : public IAbstractSyntaxTreeVisitor
+{
+public:
+    AstRelocator(AstArena& arena, SourcePos old_edit_end, SourcePos new_edit_end);
+
+    GlobalDecl* CopyGlobalDecl(GlobalDecl* node);
+
+    //  traversal
+    virtual void Visit(FuncDecl* node) override;
+    virtual void Visit(StructDecl* node) override;
+
+    virtual void Visit(CompoundStmt* node) override;
+    virtual void Visit(IfStmt* node) override;
+    virtual void Visit(ForStmt* node) override;
+    virtual void Visit(WhileStmt* node) override;
+    virtual void Visit(JumpStmt* node) override;
+    virtual void Visit(VarDeclStmt* node) override;
+    virtual void Visit(ExprStmt* node) override;
+
+    virtual void Visit(VarInitExpr* node) override;
+    virtual void Visit(VarInitList* node) override;
+
+    virtual void Visit(ArrayAccessExpr* node) override;
+    virtual void Visit(BinaryExpr* node) override;
+    virtual void Visit(FuncCallExpr* node) override;
+    virtual void Visit(Identifier* node) override;
+    virtual void Visit(Literal* node) override;
+    virtual void Visit(MemberAccessExpr* node) override;
+    virtual void Visit(PostfixExpr* node) override;
+    virtual void Visit(PrefixExpr* node) override;
+
+private:
+    // Each of these returns nullptr for nullptr.
+    Stmt* CopyStmt(Stmt* node);
+    VarInit* CopyVarInit(VarInit* node);
+    Expr* CopyExpr(Expr* node);
+
+    Token ShiftToken(const Token& token) const;
+    Type ShiftType(const Type& type) const;
+    ParamType ShiftParamType(const ParamType& param_type) const;
+
+    AstArena& m_arena;
+    SourcePos m_old_edit_end;
+    SourcePos m_new_edit_end;
+
+    // Copy of the last visited node.
+    GlobalDecl* m_global_decl = nullptr;
+    Stmt* m_stmt = nullptr;
+    VarInit* m_var_init = nullptr;
+    Expr* m_expr = nullptr;
+};
+
+AstRelocator::AstRelocator(AstArena& arena, SourcePos old_edit_end, SourcePos new_edit_end)
+    : m_arena(arena)
+    , m_old_edit_end(old_edit_end)
+    , m_new_edit_end(new_edit_end)
+{}
+
+GlobalDecl* AstRelocator::CopyGlobalDecl(GlobalDecl* node)
+{
+    node->Accept(this);
+    return m_global_decl;
+}
+
+void AstRelocator::Visit(FuncDecl* node)
+{
+    auto parameters = std::vector<Parameter*>{};
+    for (const auto& param : node->Parameters())
+    {
+        parameters.push_back(m_arena.Create<Parameter>(ShiftToken(param->Name()), ShiftParamType(param->DeclParamType())));
+    }
+
+    auto body = CopyStmt(node->Body());
+    m_global_decl = m_arena.Create<FuncDecl>(
+        node->ShouldExport(), ShiftToken(node->Name()), ShiftType(node->ReturnType()), parameters, body
+    );
+}
+
+void AstRelocator::Visit(StructDecl* node)
+{
+    auto members = std::vector<MemberVariable>{};
+    for (const auto& member : node->Members())
+    {
+        members.push_back({ShiftToken(member.name), ShiftType(member.type)});
+    }
+    m_global_decl = m_arena.Create<StructDecl>(node->ShouldExport(), ShiftToken(node->Name()), members);
+}
+
+void AstRelocator::Visit(CompoundStmt* node)
+{
+    auto statements = std::vector<Stmt*>{};
+    for (auto stmt : node->Statements())
+    {
+        statements.push_back(CopyStmt(stmt));
+    }
+    m_stmt = m_arena.Create<CompoundStmt>(statements);
+}
+
+void AstRelocator::Visit(IfStmt* node)
+{
+    auto condition = CopyExpr(node->Condition());
+    auto then_branch = CopyStmt(node->ThenBranch());
+    auto else_branch = CopyStmt(node->ElseBranch());
+    m_stmt = m_arena.Create<IfStmt>(condition, then_branch, else_branch);
+}
+
+void AstRelocator::Visit(ForStmt* node)
+{
+    auto initializer = CopyStmt(node->Initializer());
+    auto condition = CopyExpr(node->Condition());
+    auto increment_expr = CopyExpr(node->IncrementExpr());
+    auto body = CopyStmt(node->Body());
+    m_stmt = m_arena.Create<ForStmt>(initializer, condition, increment_expr, body);
+}
+
+void AstRelocator::Visit(WhileStmt* node)
+{
+    auto condition = CopyExpr(node->Condition());
+    auto body = CopyStmt(node->Body());
+    m_stmt = m_arena.Create<WhileStmt>(condition, body);
+}
+
+void AstRelocator::Visit(JumpStmt* node)
+{
+    m_stmt = m_arena.Create<JumpStmt>(ShiftToken(node->JumpType()), CopyExpr(node->ReturnValueExpr()));
+}
+
+void AstRelocator::Visit(VarDeclStmt* node)
+{
+    auto initializer = CopyVarInit(node->Initializer());
+    m_stmt = m_arena.Create<VarDeclStmt>(ShiftToken(node->Name()), ShiftType(node->DeclType()), initializer);
+}
+
+void AstRelocator::Visit(ExprStmt* node)
+{
+    m_stmt = m_arena.Create<ExprStmt>(CopyExpr(node->Expression()));
+}
+
+void AstRelocator::Visit(VarInitExpr* node)
+{
+    m_var_init = m_arena.Create<VarInitExpr>(CopyExpr(node->Expression()));
+}
+
+void AstRelocator::Visit(VarInitList* node)
+{
+    auto initializer_list = std::vector<VarInit*>{};
+    for (auto list_elem : node->InitializerList())
+    {
+        initializer_list.push_back(CopyVarInit(list_elem));
+    }
+    m_var_init = m_arena.Create<VarInitList>(initializer_list);
+}
+
+void AstRelocator::Visit(ArrayAccessExpr* node)
+{
+    auto operand = CopyExpr(node->Operand());
+    m_expr = m_arena.Create<ArrayAccessExpr>(operand, CopyExpr(node->Index()));
+}
+
+void AstRelocator::Visit(BinaryExpr* node)
+{
+    auto lhs = CopyExpr(node->LeftHandOperand());
+    auto rhs = CopyExpr(node->RightHandOperand());
+    m_expr = m_arena.Create<BinaryExpr>(ShiftToken(node->Operator()), lhs, rhs);
+}
+
+void AstRelocator::Visit(FuncCallExpr* node)
+{
+    auto function = CopyExpr(node->Function());
+    auto arg_list = std::vector<Expr*>{};
+    for (auto arg : node->ArgumentList())
+    {
+        arg_list.push_back(CopyExpr(arg));
+    }
+    m_expr = m_arena.Create<FuncCallExpr>(function, arg_list);
+}
+
+void AstRelocator::Visit(Identifier* node)
+{
+    m_expr = m_arena.Create<Identifier>(ShiftToken(node->Id()));
+}
+
+void AstRelocator::Visit(Literal* node)
+{
+    m_expr = m_arena.Create<Literal>(ShiftToken(node->LiteralToken()));
+}
+
+void AstRelocator::Visit(MemberAccessExpr* node)
+{
+    auto operand = CopyExpr(node->Struct());
+    m_expr = m_arena.Create<MemberAccessExpr>(operand, ShiftToken(node->MemberName()));
+}
+
+void AstRelocator::Visit(PostfixExpr* node)
+{
+    m_expr = m_arena.Create<PostfixExpr>(ShiftToken(node->Operator()), CopyExpr(node->Operand()));
+}
+
+void AstRelocator::Visit(PrefixExpr* node)
+{
+    m_expr = m_arena.Create<PrefixExpr>(ShiftToken(node->Operator()), CopyExpr(node->Operand()));
+}
+
+Stmt* AstRelocator::CopyStmt(Stmt* node)
+{
+    if (!node)
+    {
+        return nullptr;
+    }
+    node->Accept(this);
+    return m_stmt;
+}
+
+VarInit* AstRelocator::CopyVarInit(VarInit* node)
+{
+    if (!node)
+    {
+        return nullptr;
+    }
+    node->Accept(this);
+    return m_var_init;
+}
+
+Expr* AstRelocator::CopyExpr(Expr* node)
+{
+    if (!node)
+    {
+        return nullptr;
+    }
+    node->Accept(this);
+    return m_expr;
+}
+
+Token AstRelocator::ShiftToken(const Token& token) const
+{
+    auto result = token;
+    result.start_pos = ShiftPos(token.start_pos, m_old_edit_end, m_new_edit_end);
+    result.end_pos = ShiftPos(token.end_pos, m_old_edit_end, m_new_edit_end);
+    return result;
+}
+
+Type AstRelocator::ShiftType(const Type& type) const
+{
+    auto base_type = std::shared_ptr<IBaseType>();
+    if (auto primitive_type = dynamic_cast<const PrimitiveType*>(type.BaseType()))
+    {
+        base_type = std::make_shared<PrimitiveType>(ShiftToken(primitive_type->TypeToken()));
+    }
+    else if (auto struct_type = dynamic_cast<const StructType*>(type.BaseType()))
+    {
+        base_type = std::make_shared<StructType>(ShiftToken(struct_type->TypeToken()));
+    }
+    else if (auto func_type = dynamic_cast<const FuncType*>(type.BaseType()))
+    {
+        auto param_types = std::vector<ParamType>{};
+        for (const auto& param_type : func_type->ParamTypes())
+        {
+            param_types.push_back(ShiftParamType(param_type));
+        }
+        base_type = std::make_shared<FuncType>(param_types, ShiftType(func_type->ReturnType()));
+    }
+    else
+    {
+        base_type = std::make_shared<VoidType>();
+    }
+    return Type(base_type, type.ArraySize());
+}
+
+ParamType AstRelocator::ShiftParamType(const ParamType& param_type) const
+{
+    return ParamType{ShiftType(param_type.type), param_type.usage};
+}
+
+IncrementalParser::IncrementalParser(std::string source_code, int max_nesting_depth)
+    : m_source_code(std::move(source_code))
+    , m_max_nesting_depth(max_nesting_depth)
+    , m_tokens(std::make_shared<std::vector<Token>>())
+{}
+
+std::shared_ptr<IAbstractSyntaxTree> IncrementalParser::Parse()
+{
+    m_is_up_to_date = false;
+    m_decls.clear();
+    m_tokens->clear();
+    m_token_offsets.clear();
+
+    try
+    {
+        auto lexer = RegionLexer(m_source_code, 0, {1, 1});
+        while (m_tokens->empty() || m_tokens->back().type != TokenType::EndOfFile)
+        {
+            auto offset = size_t{};
+            m_tokens->push_back(lexer.GetNext(offset));
+            m_token_offsets.push_back(offset);
+        }
+    }
+    catch(const LexicalError&)
+    {
+        return ParseFromScratch();
+    }
+
+    // Every token is new, so nothing can be reused.
+    auto window = TokenWindow{0, m_tokens->size(), 0, {1, 1}, {1, 1}};
+    if (auto ast = TryUpdateTree(window))
+    {
+        return ast;
+    }
+    return ParseFromScratch();
+}
+
+std::shared_ptr<IAbstractSyntaxTree> IncrementalParser::ApplyEdit(const TextEdit& edit)
+{
+    if (edit.offset > m_source_code.size() || edit.length > m_source_code.size() - edit.offset)
+    {
+        auto message = std::format("edit range [{}, {}) is out of the source code", edit.offset, edit.offset + edit.length);
+        throw std::out_of_range(message);
+    }
+
+    if (!m_is_up_to_date)
+    {
+        m_source_code.replace(edit.offset, edit.length, edit.replacement);
+        return Parse();
+    }
+
+    if (auto window = TryUpdateTokens(edit))
+    {
+        if (auto ast = TryUpdateTree(*window))
+        {
+            return ast;
+        }
+    }
+    return ParseFromScratch();
+}
+
+const std::string& IncrementalParser::SourceCode() const
+{
+    return m_source_code;
+}
+
+size_t IncrementalParser::NumReusedDecls() const
+{
+    return m_num_reused_decls;
+}
+
+size_t IncrementalParser::NumParsedDecls() const
+{
+    return m_num_parsed_decls;
+}
+
+std::optional<IncrementalParser::TokenWindow> IncrementalParser::TryUpdateTokens(const TextEdit& edit)
+{
+    auto& tokens = *m_tokens;
+    auto num_tokens = tokens.size();
+
+    // Find the first token whose lexing might have read the edited range.
+    // Note: a token never spans multiple lines.
+    auto indices = std::views::iota(size_t{0}, num_tokens);
+    auto first_affected = *std::ranges::partition_point(indices, [&](size_t i) {
+        auto end_offset = m_token_offsets[i] + (tokens[i].end_pos.column - tokens[i].start_pos.column);
+        return end_offset + LexerLookahead < edit.offset;
+    });
+
+    // Restart from the token before it, since whitespaces and comments
+    // between the two tokens might have been edited.
+    auto restart = size_t{0};
+    auto restart_offset = size_t{0};
+    auto restart_pos = SourcePos{1, 1};
+    if (first_affected > 0)
+    {
+        restart = first_affected - 1;
+        restart_offset = m_token_offsets[restart];
+        restart_pos = tokens[restart].start_pos;
+    }
+
+    auto old_edit_end = edit.offset + edit.length;
+    auto old_edit_end_pos = AdvancePos(m_source_code, restart_offset, old_edit_end, restart_pos);
+    m_source_code.replace(edit.offset, edit.length, edit.replacement);
+    auto new_edit_end = edit.offset + edit.replacement.size();
+    auto new_edit_end_pos = AdvancePos(m_source_code, restart_offset, new_edit_end, restart_pos);
+    auto offset_delta = static_cast<ptrdiff_t>(new_edit_end) - static_cast<ptrdiff_t>(old_edit_end);
+
+    // Lex until a new token is exactly the same as an old token after the edit.
+    // From there on, the lexer would produce the same tokens as before.
+    auto resume = *std::ranges::partition_point(std::views::iota(restart, num_tokens), [&](size_t i) {
+        return m_token_offsets[i] < old_edit_end;
+    });
+    auto new_tokens = std::vector<Token>{};
+    auto new_offsets = std::vector<size_t>{};
+    try
+    {
+        auto lexer = RegionLexer(m_source_code, restart_offset, restart_pos);
+        while (true)
+        {
+            auto offset = size_t{};
+            auto token = lexer.GetNext(offset);
+            if (offset >= new_edit_end)
+            {
+                while (resume < num_tokens && m_token_offsets[resume] + offset_delta < offset)
+                {
+                    ++resume;
+                }
+                if (resume < num_tokens && m_token_offsets[resume] + offset_delta == offset &&
+                    tokens[resume].type == token.type && tokens[resume].lexeme == token.lexeme)
+                {
+                    break;
+                }
+            }
+
+            auto is_eof = token.type == TokenType::EndOfFile;
+            new_tokens.push_back(std::move(token));
+            new_offsets.push_back(offset);
+            if (is_eof)
+            {
+                resume = num_tokens;
+                break;
+            }
+        }
+    }
+    catch(const LexicalError&)
+    {
+        m_is_up_to_date = false;
+        return {};
+    }
+
+    // Tokens before the edit are often lexed again as they were,
+    // and declarations ending with them can still be reused.
+    auto num_unchanged = size_t{0};
+    while (num_unchanged < new_tokens.size() && restart + num_unchanged < resume &&
+        new_tokens[num_unchanged] == tokens[restart + num_unchanged])
+    {
+        ++num_unchanged;
+    }
+
+    // Replace old tokens in [restart, resume) with the new tokens.
+    auto num_overwritten = std::min(resume - restart, new_tokens.size());
+    std::move(new_tokens.begin(), new_tokens.begin() + num_overwritten, tokens.begin() + restart);
+    std::copy(new_offsets.begin(), new_offsets.begin() + num_overwritten, m_token_offsets.begin() + restart);
+    auto splice_pos = restart + num_overwritten;
+    if (new_tokens.size() > num_overwritten)
+    {
+        tokens.insert(tokens.begin() + splice_pos,
+            std::make_move_iterator(new_tokens.begin() + num_overwritten), std::make_move_iterator(new_tokens.end()));
+        m_token_offsets.insert(m_token_offsets.begin() + splice_pos, new_offsets.begin() + num_overwritten, new_offsets.end());
+    }
+    else
+    {
+        tokens.erase(tokens.begin() + splice_pos, tokens.begin() + resume);
+        m_token_offsets.erase(m_token_offsets.begin() + splice_pos, m_token_offsets.begin() + resume);
+    }
+
+    // Shift the tokens after the edit.
+    auto window = TokenWindow{
+        restart + num_unchanged, restart + new_tokens.size(), resume, old_edit_end_pos, new_edit_end_pos
+    };
+    auto is_line_shifted = old_edit_end_pos.line != new_edit_end_pos.line;
+    for (auto i = window.end; i < tokens.size(); ++i)
+    {
+        m_token_offsets[i] += offset_delta;
+        if (is_line_shifted || tokens[i].start_pos.line == old_edit_end_pos.line)
+        {
+            tokens[i].start_pos = ShiftPos(tokens[i].start_pos, old_edit_end_pos, new_edit_end_pos);
+            tokens[i].end_pos = ShiftPos(tokens[i].end_pos, old_edit_end_pos, new_edit_end_pos);
+        }
+    }
+    return window;
+}
+
+std::shared_ptr<IAbstractSyntaxTree> IncrementalParser::TryUpdateTree(const TokenWindow& window)
+{
+    m_is_up_to_date = false;
+
+    const auto& tokens = *m_tokens;
+    auto scanner = DeclBoundaryScanner();
+    for (size_t i = 0; i + 1 < tokens.size(); ++i)
+    {
+        scanner.Feed(tokens[i].type);
+    }
+    if (!scanner.IsValid())
+    {
+        return nullptr;
+    }
+
+    auto arena = std::make_shared<AstArena>(IncrementalArenaBlockSize);
+    auto header = TryParseModuleHeader(m_tokens, 0, scanner.HeaderEnd(), arena, m_max_nesting_depth);
+    if (!header)
+    {
+        return nullptr;
+    }
+
+    // Note: the last token is EOF.
+    auto boundaries = scanner.DeclStarts();
+    boundaries.push_back(tokens.size() - 1);
+
+    auto decls = std::vector<DeclEntry>{};
+    auto global_declarations = std::vector<GlobalDecl*>{};
+    auto num_reused_decls = size_t{0};
+    auto num_parsed_decls = size_t{0};
+    for (size_t i = 0; i + 1 < boundaries.size(); ++i)
+    {
+        auto entry = DeclEntry{boundaries[i], boundaries[i + 1], nullptr, nullptr};
+
+        // A declaration is reused only if it was made of exactly the same tokens.
+        if (entry.end <= window.begin)
+        {
+            if (auto old_entry = FindDecl(entry.begin, entry.end))
+            {
+                entry.decl = old_entry->decl;
+                entry.arena = old_entry->arena;
+            }
+        }
+        else if (entry.begin >= window.end)
+        {
+            auto old_begin = entry.begin - window.end + window.old_end;
+            auto old_end = entry.end - window.end + window.old_end;
+            if (auto old_entry = FindDecl(old_begin, old_end))
+            {
+                auto is_moved = window.old_edit_end.line != window.new_edit_end.line ||
+                    tokens[entry.begin].start_pos.line == window.new_edit_end.line;
+                if (is_moved)
+                {
+                    entry.arena = std::make_shared<AstArena>(IncrementalArenaBlockSize);
+                    auto relocator = AstRelocator(*entry.arena, window.old_edit_end, window.new_edit_end);
+                    entry.decl = relocator.CopyGlobalDecl(old_entry->decl);
+                }
+                else
+                {
+                    entry.decl = old_entry->decl;
+                    entry.arena = old_entry->arena;
+                }
+            }
+        }
+
+        if (entry.decl)
+        {
+            ++num_reused_decls;
+        }
+        else
+        {
+            entry.arena = std::make_shared<AstArena>(IncrementalArenaBlockSize);
+            entry.decl = TryParseGlobalDecl(m_tokens, entry.begin, entry.end, entry.arena, m_max_nesting_depth);
+            if (!entry.decl)
+            {
+                return nullptr;
+            }
+            ++num_parsed_decls;
+        }
+
+        arena->Retain(entry.arena);
+        global_declarations.push_back(entry.decl);
+        decls.push_back(std::move(entry));
+    }
+
+    auto ast = arena->Create<Module>(header->ModuleName(), header->ImportList(), global_declarations);
+    m_decls = std::move(decls);
+    m_is_up_to_date = true;
+    m_num_reused_decls = num_reused_decls;
+    m_num_parsed_decls = num_parsed_decls;
+    return std::shared_ptr<IAbstractSyntaxTree>(arena, ast);
+}
+
+const IncrementalParser::DeclEntry* IncrementalParser::FindDecl(size_t begin, size_t end) const
+{
+    auto it = std::ranges::lower_bound(m_decls, begin, {}, &DeclEntry::begin);
+    if (it != m_decls.end() && it->begin == begin && it->end == end)
+    {
+        return &*it;
+    }
+    return nullptr;
+}
+
+std::shared_ptr<IAbstractSyntaxTree> IncrementalParser::ParseFromScratch()
+{
+    m_is_up_to_date = false;
+    m_decls.clear();
+    m_num_reused_decls = 0;
+    m_num_parsed_decls = 0;
+
+    auto lexer = std::make_unique<LexicalAnalyzer>(std::make_unique<DummySourceFile>(std::string(m_source_code)));
+    auto analyzer = SyntaxAnalyzer(std::move(lexer), m_max_nesting_depth);
+    return analyzer.GenerateAST();
+}
+
+} // namespace mylang
@@ -0,0 +1,59 @@
+#include "parser/NameBindings.h"
+#include "parser/ast/expr/Identifier.h"
+#include "parser/ast/expr/MemberAccessExpr.h"
+#include "parser/type/base/StructType.h"
+#include "parser/type/base/FuncType.h"
+
+namespace mylang
+{
+
+void NameBindings::BindIdentifier(const Identifier* node, const Decl* declaration)
+{
+    m_declarations.Set(node, declaration);
+}
+
+void NameBindings::BindMember(const MemberAccessExpr* node, const MemberBinding& binding)
+{
+    m_members.Set(node, binding);
+}
+
+const Decl* NameBindings::FindDeclaration(const Identifier* node) const
+{
+    auto declaration = m_declarations.Find(node);
+    return declaration ? *declaration : nullptr;
+}
+
+const MemberBinding* NameBindings::FindMember(const MemberAccessExpr* node) const
+{
+    return m_members.Find(node);
+}
+
+void NameBindings::Merge(NameBindings&& other)
+{
+    m_declarations.Merge(std::move(other.m_declarations));
+    m_members.Merge(std::move(other.m_members));
+}
+
+bool AreStructTypesBound(const Type& type)
+{
+    if (auto struct_type = dynamic_cast<const StructType*>(type.BaseType()))
+    {
+        return struct_type->Declaration() != nullptr;
+    }
+
+    if (auto func_type = dynamic_cast<const FuncType*>(type.BaseType()))
+    {
+        for (const auto& param_type : func_type->ParamTypes())
+        {
+            if (!AreStructTypesBound(param_type.type))
+            {
+                return false;
+            }
+        }
+        return AreStructTypesBound(func_type->ReturnType());
+    }
+
+    return true;
+}
+
+} // namespace mylang
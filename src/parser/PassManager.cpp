@@ -0,0 +1,393 @@
+#include "parser/PassManager.h"
+#include "parser/ast/visitor/AstWalker.h"
+#include <algorithm>
+#include <array>
+#include <format>
+#include <functional>
+#include <stdexcept>
+
+namespace mylang
+{
+
+using PassClock = std::chrono::steady_clock;
+
+// Kinds of nodes that can appear somewhere below a node of each kind.
+std::array<AstNodeKindSet, NumAstNodeKinds> BuildKindsBelowTable()
+{
+    using enum AstNodeKind;
+    auto exprs = MakeAstNodeKindSet({
+        ArrayAccessExpr, BinaryExpr, FuncCallExpr, Identifier, Literal, MemberAccessExpr, PostfixExpr, PrefixExpr
+    });
+    auto var_inits = MakeAstNodeKindSet({VarInitExpr, VarInitList});
+    auto stmts = MakeAstNodeKindSet({CompoundStmt, IfStmt, ForStmt, WhileStmt, JumpStmt, VarDeclStmt, ExprStmt});
+
+    auto table = std::array<AstNodeKindSet, NumAstNodeKinds>();
+    auto set = [&](AstNodeKind kind, AstNodeKindSet kinds_below) {
+        table[static_cast<size_t>(kind)] = kinds_below;
+    };
+
+    set(Module, ~MakeAstNodeKindSet({Module}));
+
+    set(Parameter, {});
+    set(FuncDecl, MakeAstNodeKindSet({Parameter}) | stmts | var_inits | exprs);
+    set(StructDecl, {});
+
+    for (auto stmt : {CompoundStmt, IfStmt, ForStmt, WhileStmt, JumpStmt, VarDeclStmt, ExprStmt})
+    {
+        set(stmt, stmts | var_inits | exprs);
+    }
+
+    set(VarInitExpr, exprs);
+    set(VarInitList, var_inits | exprs);
+
+    for (auto expr : {ArrayAccessExpr, BinaryExpr, FuncCallExpr, MemberAccessExpr, PostfixExpr, PrefixExpr})
+    {
+        set(expr, exprs);
+    }
+    set(Identifier, {});
+    set(Literal, {});
+
+    return table;
+}
+
+const AstNodeKindSet& KindsBelow(AstNodeKind kind)
+{
+    static const auto table = BuildKindsBelowTable();
+    return table[static_cast<size_t>(kind)];
+}
+
+// Calls each pass of a walk for the nodes it is interested in,
+// and keeps track of the time spent in each of them if 'should_time_passes' is set.
+class FusedWalk : public AstWalker<FusedWalk>, public IAstNodeHooks
+{
+public:
+    explicit FusedWalk(bool should_time_passes)
+        : m_should_time_passes(should_time_passes)
+    {}
+
+    void AddPass(AstPass* pass, std::chrono::nanoseconds& elapsed)
+    {
+        auto interests = pass->Interests();
+        m_interests |= interests;
+        for (size_t kind = 0; kind < NumAstNodeKinds; ++kind)
+        {
+            if (interests.test(kind))
+            {
+                m_passes[kind].push_back(PassEntry{pass, &elapsed});
+            }
+        }
+    }
+
+    // Children are skipped if no pass is interested in anything below the node.
+    bool PreVisitNode(IAbstractSyntaxTree* node)
+    {
+        Enter(node);
+        return (m_interests & KindsBelow(node->NodeKind())).any();
+    }
+
+    void PostVisitNode(IAbstractSyntaxTree* node)
+    {
+        Leave(node);
+    }
+
+    virtual void Enter(IAbstractSyntaxTree* node) override
+    {
+        for (const auto& entry : m_passes[static_cast<size_t>(node->NodeKind())])
+        {
+            if (!m_should_time_passes)
+            {
+                entry.pass->Enter(node);
+                continue;
+            }
+
+            auto start = PassClock::now();
+            entry.pass->Enter(node);
+            AddPassTime(entry, PassClock::now() - start);
+        }
+    }
+
+    // Passes leave a node in the reverse order of entering it.
+    virtual void Leave(IAbstractSyntaxTree* node) override
+    {
+        const auto& entries = m_passes[static_cast<size_t>(node->NodeKind())];
+        for (auto it = entries.rbegin(); it != entries.rend(); ++it)
+        {
+            if (!m_should_time_passes)
+            {
+                it->pass->Leave(node);
+                continue;
+            }
+
+            auto start = PassClock::now();
+            it->pass->Leave(node);
+            AddPassTime(*it, PassClock::now() - start);
+        }
+    }
+
+    // Total time spent in the passes since the last reset.
+    std::chrono::nanoseconds PassTime() const
+    {
+        return m_pass_time;
+    }
+
+    void ResetPassTime()
+    {
+        m_pass_time = std::chrono::nanoseconds(0);
+    }
+
+private:
+    struct PassEntry
+    {
+        AstPass* pass;
+        std::chrono::nanoseconds* elapsed;
+    };
+
+    void AddPassTime(const PassEntry& entry, std::chrono::nanoseconds elapsed)
+    {
+        *entry.elapsed += elapsed;
+        m_pass_time += elapsed;
+    }
+
+    std::array<std::vector<PassEntry>, NumAstNodeKinds> m_passes;
+    AstNodeKindSet m_interests;
+    bool m_should_time_passes;
+    std::chrono::nanoseconds m_pass_time = std::chrono::nanoseconds(0);
+};
+
+void PassManager::AddPass(AstPass& pass)
+{
+    for (auto other : m_passes)
+    {
+        if (other->Name() == pass.Name())
+        {
+            throw std::invalid_argument(std::format("[Pass Error] pass \"{}\" is added twice", pass.Name()));
+        }
+    }
+    m_passes.push_back(&pass);
+}
+
+void PassManager::AddFinishedPass(std::string_view name)
+{
+    m_finished_passes.push_back(name);
+}
+
+void PassManager::EnableTimings()
+{
+    m_should_time_passes = true;
+}
+
+void PassManager::Run(const std::vector<IAbstractSyntaxTree*>& modules, const std::function<void(size_t)>& on_error)
+{
+    auto walks = AssignWalks();
+    auto num_walks = walks.empty() ? size_t{0} : *std::max_element(walks.begin(), walks.end()) + 1;
+
+    m_timings.clear();
+    for (auto pass : m_passes)
+    {
+        m_timings.push_back(PassTiming{pass->Name(), std::chrono::nanoseconds(0)});
+    }
+    m_timings.push_back(PassTiming{"tree walk", std::chrono::nanoseconds(0)});
+    auto& tree_walk_time = m_timings.back().elapsed;
+
+    for (size_t walk = 0; walk < num_walks; ++walk)
+    {
+        auto fused_walk = FusedWalk(m_should_time_passes);
+        auto walker = static_cast<AstPass*>(nullptr);
+        auto walker_time = static_cast<std::chrono::nanoseconds*>(nullptr);
+        for (size_t i = 0; i < m_passes.size(); ++i)
+        {
+            if (walks[i] != walk)
+            {
+                continue;
+            }
+
+            if (m_passes[i]->IsWalker())
+            {
+                walker = m_passes[i];
+                walker_time = &m_timings[i].elapsed;
+            }
+            else
+            {
+                fused_walk.AddPass(m_passes[i], m_timings[i].elapsed);
+            }
+        }
+
+        for (size_t i = 0; i < modules.size(); ++i)
+        {
+            try
+            {
+                auto start = m_should_time_passes ? PassClock::now() : PassClock::time_point();
+                fused_walk.ResetPassTime();
+                if (walker)
+                {
+                    fused_walk.Enter(modules[i]);
+                    walker->Walk(modules[i], &fused_walk);
+                    fused_walk.Leave(modules[i]);
+                }
+                else
+                {
+                    fused_walk.Walk(modules[i]);
+                }
+
+                if (m_should_time_passes)
+                {
+                    auto& walk_time = walker ? *walker_time : tree_walk_time;
+                    walk_time += PassClock::now() - start - fused_walk.PassTime();
+                }
+            }
+            catch(...)
+            {
+                if (on_error)
+                {
+                    on_error(i);
+                }
+                throw;
+            }
+        }
+
+        for (size_t i = 0; i < m_passes.size(); ++i)
+        {
+            if (walks[i] != walk)
+            {
+                continue;
+            }
+
+            if (!m_should_time_passes)
+            {
+                m_passes[i]->Finish();
+                continue;
+            }
+
+            auto start = PassClock::now();
+            m_passes[i]->Finish();
+            m_timings[i].elapsed += PassClock::now() - start;
+        }
+    }
+}
+
+std::vector<std::vector<std::string_view>> PassManager::Schedule() const
+{
+    auto walks = AssignWalks();
+    auto schedule = std::vector<std::vector<std::string_view>>();
+    for (size_t i = 0; i < m_passes.size(); ++i)
+    {
+        if (walks[i] >= schedule.size())
+        {
+            schedule.resize(walks[i] + 1);
+        }
+        schedule[walks[i]].push_back(m_passes[i]->Name());
+    }
+    return schedule;
+}
+
+const std::vector<PassManager::PassTiming>& PassManager::Timings() const
+{
+    return m_timings;
+}
+
+std::vector<size_t> PassManager::AssignWalks() const
+{
+    // Look up the prerequisites of each pass.
+    auto prerequisites = std::vector<std::vector<size_t>>(m_passes.size());
+    auto dependents = std::vector<std::vector<size_t>>(m_passes.size());
+    for (size_t i = 0; i < m_passes.size(); ++i)
+    {
+        for (auto name : m_passes[i]->Prerequisites())
+        {
+            if (std::find(m_finished_passes.begin(), m_finished_passes.end(), name) != m_finished_passes.end())
+            {
+                continue;
+            }
+
+            auto it = std::find_if(m_passes.begin(), m_passes.end(), [&](AstPass* pass) {
+                return pass->Name() == name;
+            });
+            if (it == m_passes.end())
+            {
+                auto message = std::format("[Pass Error] pass \"{}\" requires missing pass \"{}\"",
+                    m_passes[i]->Name(),
+                    name
+                );
+                throw std::invalid_argument(message);
+            }
+
+            auto j = static_cast<size_t>(it - m_passes.begin());
+            prerequisites[i].push_back(j);
+            dependents[j].push_back(i);
+        }
+    }
+
+    // Sort the passes so that each one comes after its prerequisites.
+    enum class SortState { Unvisited, Visiting, Visited };
+    auto states = std::vector<SortState>(m_passes.size(), SortState::Unvisited);
+    auto order = std::vector<size_t>();
+    auto visit = std::function<void(size_t)>();
+    visit = [&](size_t i) {
+        if (states[i] == SortState::Visited)
+        {
+            return;
+        }
+        if (states[i] == SortState::Visiting)
+        {
+            throw std::invalid_argument(std::format("[Pass Error] pass \"{}\" has circular prerequisites", m_passes[i]->Name()));
+        }
+
+        states[i] = SortState::Visiting;
+        for (auto j : prerequisites[i])
+        {
+            visit(j);
+        }
+        states[i] = SortState::Visited;
+        order.push_back(i);
+    };
+    for (size_t i = 0; i < m_passes.size(); ++i)
+    {
+        visit(i);
+    }
+
+    // Run each pass as early as possible, with at most one walker per walk.
+    auto walks = std::vector<size_t>(m_passes.size(), 0);
+    auto walker_walks = std::vector<bool>();
+    for (auto i : order)
+    {
+        auto walk = size_t{0};
+        for (auto j : prerequisites[i])
+        {
+            walk = std::max(walk, walks[j] + 1);
+        }
+
+        if (m_passes[i]->IsWalker())
+        {
+            while (walk < walker_walks.size() && walker_walks[walk])
+            {
+                ++walk;
+            }
+            walker_walks.resize(std::max(walker_walks.size(), walk + 1));
+            walker_walks[walk] = true;
+        }
+        walks[i] = walk;
+    }
+
+    // Then delay the other passes as much as their dependents allow.
+    // Walkers stay where they are, so the number of walks doesn't change.
+    auto last_walk = walks.empty() ? size_t{0} : *std::max_element(walks.begin(), walks.end());
+    for (auto it = order.rbegin(); it != order.rend(); ++it)
+    {
+        auto i = *it;
+        if (m_passes[i]->IsWalker())
+        {
+            continue;
+        }
+
+        auto walk = last_walk;
+        for (auto j : dependents[i])
+        {
+            walk = std::min(walk, walks[j] - 1);
+        }
+        walks[i] = walk;
+    }
+
+    return walks;
+}
+
+} // namespace mylang
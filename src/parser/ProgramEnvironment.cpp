@@ -5,98 +5,290 @@
 namespace mylang
 {
 
-void ProgramEnvironment::AddModuleDeclaration(const Module* module)
+ModuleHandle ProgramEnvironment::AddModuleDeclaration(const Module* module)
 {
+    ValidateNotFrozen();
+
     auto module_name = std::string_view(module->ModuleName().lexeme);
 
     // If this was the first module implementation file,
     // create a new entry for module information.
-    if (m_modules.find(module_name) == m_modules.end())
+    auto [entry, is_new_module] = m_module_handles.try_emplace(module_name, static_cast<ModuleHandle>(m_modules.size()));
+    if (is_new_module)
     {
-        m_modules.insert({module_name, {}});
+        m_modules.push_back(ModuleInfo{module_name});
     }
+    m_has_export_index = false;
 
     // Collect module import directives.
     // It is okay, until now, to have duplicate entries.
-    auto& module_info = GetModuleInfo(module_name);
+    auto& module_info = GetModuleInfo(entry->second);
     for (const auto& import_info : module->ImportList())
     {
         module_info.import_list.insert(import_info);
     }
+    return entry->second;
+}
+
+ModuleHandle ProgramEnvironment::GetModuleHandle(std::string_view name) const
+{
+    auto handle = TryGetModuleHandle(name);
+    if (!handle)
+    {
+        throw std::exception("trying to access non-existing module");
+    }
+    return handle.value();
+}
+
+std::optional<ModuleHandle> ProgramEnvironment::TryGetModuleHandle(std::string_view name) const
+{
+    auto entry = m_module_handles.find(name);
+    if (entry == m_module_handles.end())
+    {
+        return {};
+    }
+    return entry->second;
 }
 
 void ProgramEnvironment::ValidateModuleDependency()
 {
-    for (const auto& [name, info] : m_modules)
+    // Every import directive is checked while resolving the imports.
+    BuildExportIndex();
+}
+
+void ProgramEnvironment::BuildExportIndex()
+{
+    ValidateNotFrozen();
+    m_has_export_index = false;
+
+    ResolveImports();
+
+    for (size_t i = 0; i < m_modules.size(); ++i)
     {
-        // Make sure that every imported modules do exist.
-        for (const auto& imported : info.import_list)
+        auto& info = m_modules[i];
+        info.imported_symbols.clear();
+
+        // Same as FindSymbol(), the module itself is never searched as an imported one.
+        auto visited_modules = std::vector<bool>(m_modules.size(), false);
+        visited_modules[i] = true;
+        for (const auto& imported : info.resolved_imports)
         {
-            try
-            {
-                GetModuleInfo(imported.name.lexeme);
-            }
-            catch(const std::exception&)
+            CollectImportedSymbols(imported.module, visited_modules, info.imported_symbols);
+        }
+    }
+    m_has_export_index = true;
+}
+
+void ProgramEnvironment::ResolveImports()
+{
+    // Resolve every module before storing any of them,
+    // so that a missing module leaves the previous imports as they were.
+    auto resolved_imports = std::vector<std::vector<ResolvedImport>>(m_modules.size());
+    for (size_t i = 0; i < m_modules.size(); ++i)
+    {
+        for (const auto& imported : m_modules[i].import_list)
+        {
+            auto entry = m_module_handles.find(imported.name.lexeme);
+            if (entry == m_module_handles.end())
             {
                 auto message = std::format("trying to import a non-existing module: \"{}\"", imported.name.lexeme);
                 throw SemanticError(imported.name.start_pos, message);
             }
+            resolved_imports[i].push_back(ResolvedImport{entry->second, imported.should_export});
         }
     }
+
+    for (size_t i = 0; i < m_modules.size(); ++i)
+    {
+        m_modules[i].resolved_imports = std::move(resolved_imports[i]);
+    }
 }
 
-void ProgramEnvironment::OpenScope(std::string_view context_module_name)
+void ProgramEnvironment::CollectImportedSymbols(
+    ModuleHandle imported_module,
+    std::vector<bool>& visited_modules,
+    std::unordered_map<std::string_view, Symbol>& imported_symbols
+) const
+{
+    // Walk the exported imports depth-first with a stack,
+    // since chains of "import export" can be arbitrarily long.
+    auto pending_modules = std::vector<ModuleHandle>{imported_module};
+    while (!pending_modules.empty())
+    {
+        auto handle = pending_modules.back();
+        pending_modules.pop_back();
+        if (visited_modules[handle])
+        {
+            continue;
+        }
+        visited_modules[handle] = true;
+
+        const auto& module_info = m_modules[handle];
+        for (const auto& symbol : module_info.local_symbol_table.GlobalSymbols())
+        {
+            imported_symbols.try_emplace(symbol.declaration->Name().lexeme, symbol);
+        }
+
+        // Push in reverse, so that the imports are visited in order.
+        const auto& imports = module_info.resolved_imports;
+        for (auto it = imports.rbegin(); it != imports.rend(); ++it)
+        {
+            // Do NOT propagate module dependency for private import directives!
+            if (it->should_export)
+            {
+                pending_modules.push_back(it->module);
+            }
+        }
+    }
+}
+
+void ProgramEnvironment::Freeze()
+{
+    m_is_frozen = true;
+}
+
+bool ProgramEnvironment::IsFrozen() const
+{
+    return m_is_frozen;
+}
+
+void ProgramEnvironment::ValidateNotFrozen() const
+{
+    if (m_is_frozen)
+    {
+        throw std::exception("trying to modify a frozen program environment");
+    }
+}
+
+void ProgramEnvironment::OpenScope(ModuleHandle context_module)
 {
-    auto& module_info = GetModuleInfo(context_module_name);
+    ValidateNotFrozen();
+    auto& module_info = GetModuleInfo(context_module);
     module_info.local_symbol_table.OpenScope();
 }
 
-void ProgramEnvironment::CloseScope(std::string_view context_module_name)
+void ProgramEnvironment::CloseScope(ModuleHandle context_module)
 {
-    auto& module_info = GetModuleInfo(context_module_name);
+    ValidateNotFrozen();
+    auto& module_info = GetModuleInfo(context_module);
     module_info.local_symbol_table.CloseScope();
 }
 
+void ProgramEnvironment::OpenScope(std::string_view context_module_name)
+{
+    OpenScope(GetModuleHandle(context_module_name));
+}
+
+void ProgramEnvironment::CloseScope(std::string_view context_module_name)
+{
+    CloseScope(GetModuleHandle(context_module_name));
+}
+
 void ProgramEnvironment::AddSymbol(
     std::string_view context_module_name,
     Decl* declaration,
     bool is_public
 )
 {
-    auto& module_info = GetModuleInfo(context_module_name);
+    AddSymbol(GetModuleHandle(context_module_name), declaration, is_public);
+}
+
+void ProgramEnvironment::AddSymbol(
+    ModuleHandle context_module,
+    Decl* declaration,
+    bool is_public
+)
+{
+    ValidateNotFrozen();
+    auto& module_info = GetModuleInfo(context_module);
     module_info.local_symbol_table.AddSymbol(declaration, is_public);
+
+    // Only public symbols can be seen from other modules.
+    if (is_public)
+    {
+        m_has_export_index = false;
+    }
+}
+
+Symbol ProgramEnvironment::FindSymbol(
+    std::string_view context_module_name,
+    std::string_view symbol_name
+) const
+{
+    return FindSymbol(GetModuleHandle(context_module_name), symbol_name);
 }
 
 Symbol ProgramEnvironment::FindSymbol(
+    ModuleHandle context_module,
+    std::string_view symbol_name
+) const
+{
+    // Make sure the module exists, so that a missing module is reported as such.
+    GetModuleInfo(context_module);
+
+    auto symbol = TryFindSymbol(context_module, symbol_name);
+    if (!symbol)
+    {
+        // The symbol we want to find doesn't exist!
+        throw std::exception("trying to find a symbol that doesn't exist");
+    }
+    return symbol.value();
+}
+
+std::optional<Symbol> ProgramEnvironment::TryFindSymbol(
     std::string_view context_module_name,
     std::string_view symbol_name
 ) const
 {
-    auto& module_info = GetModuleInfo(context_module_name);
+    auto context_module = TryGetModuleHandle(context_module_name);
+    if (!context_module)
+    {
+        return {};
+    }
+    return TryFindSymbol(context_module.value(), symbol_name);
+}
+
+std::optional<Symbol> ProgramEnvironment::TryFindSymbol(
+    ModuleHandle context_module,
+    std::string_view symbol_name
+) const
+{
+    if (context_module >= m_modules.size())
+    {
+        return {};
+    }
+    const auto& module_info = m_modules[context_module];
 
     // Look for local symbol.
     if (auto symbol = module_info.local_symbol_table.FindSymbol(symbol_name))
     {
-        return symbol.value();
+        return symbol;
     }
     // If we failed to find one, look for public symbols in the imported modules.
+    else if (m_has_export_index)
+    {
+        auto symbol = module_info.imported_symbols.find(symbol_name);
+        if (symbol == module_info.imported_symbols.end())
+        {
+            return {};
+        }
+        return symbol->second;
+    }
     else
     {
         // This variable is used to prevent infinite search loop
         // when two modules have circular dependency.
-        auto visited_modules = std::set<std::string_view>{context_module_name};
+        auto visited_modules = std::set<std::string_view>{module_info.name};
 
         // Recursively search for a public symbol with the specified name.
         for (const auto& import_info : module_info.import_list)
         {
             if (auto symbol = FindImportedSymbol(import_info.name.lexeme, symbol_name, visited_modules))
             {
-                return symbol.value();
+                return symbol;
             }
         }
-
-        // The symbol we want to find doesn't exist!
-        throw std::exception("trying to find a symbol that doesn't exist");
+        return {};
     }
 }
 
@@ -109,7 +301,11 @@ std::optional<Symbol> ProgramEnvironment::FindImportedSymbol(
     // Do not search for module symbols more than once.
     if (visited_modules.count(context_module_name) > 0) return {};
 
-    auto& module_info = GetModuleInfo(context_module_name);
+    // Nothing can be found in a module that doesn't exist.
+    auto context_module = TryGetModuleHandle(context_module_name);
+    if (!context_module) return {};
+
+    const auto& module_info = m_modules[context_module.value()];
 
     // Look for local public symbol.
     auto symbol = module_info.local_symbol_table.FindSymbol(symbol_name);
@@ -138,22 +334,32 @@ std::optional<Symbol> ProgramEnvironment::FindImportedSymbol(
     }
 }
 
-ModuleInfo& ProgramEnvironment::GetModuleInfo(std::string_view name)
+ModuleInfo& ProgramEnvironment::GetModuleInfo(ModuleHandle handle)
 {
-    if (m_modules.find(name) == m_modules.end())
+    if (handle >= m_modules.size())
     {
         throw std::exception("trying to access non-existing module");
     }
-    return m_modules.at(name);
+    return m_modules[handle];
 }
 
-const ModuleInfo& ProgramEnvironment::GetModuleInfo(std::string_view name) const
+const ModuleInfo& ProgramEnvironment::GetModuleInfo(ModuleHandle handle) const
 {
-    if (m_modules.find(name) == m_modules.end())
+    if (handle >= m_modules.size())
     {
         throw std::exception("trying to access non-existing module");
     }
-    return m_modules.at(name);
+    return m_modules[handle];
+}
+
+ModuleInfo& ProgramEnvironment::GetModuleInfo(std::string_view name)
+{
+    return GetModuleInfo(GetModuleHandle(name));
+}
+
+const ModuleInfo& ProgramEnvironment::GetModuleInfo(std::string_view name) const
+{
+    return GetModuleInfo(GetModuleHandle(name));
 }
 
 } // namespace mylang
@@ -0,0 +1,202 @@
+#include "parser/ResumableParser.h"
+#include "parser/SyntaxAnalyzer.h"
+#include "parser/DeclBoundaryScanner.h"
+#include <stdexcept>
+#include <utility>
+
+namespace mylang
+{
+
+ResumableParser::Routine ResumableParser::Routine::promise_type::get_return_object()
+{
+    return Routine(std::coroutine_handle<promise_type>::from_promise(*this));
+}
+
+std::suspend_always ResumableParser::Routine::promise_type::initial_suspend() noexcept
+{
+    return {};
+}
+
+std::suspend_always ResumableParser::Routine::promise_type::final_suspend() noexcept
+{
+    return {};
+}
+
+void ResumableParser::Routine::promise_type::return_void()
+{}
+
+void ResumableParser::Routine::promise_type::unhandled_exception()
+{
+    exception = std::current_exception();
+}
+
+ResumableParser::Routine::Routine(std::coroutine_handle<promise_type> handle)
+    : m_handle(handle)
+{}
+
+ResumableParser::Routine::Routine(Routine&& other) noexcept
+    : m_handle(std::exchange(other.m_handle, nullptr))
+{}
+
+ResumableParser::Routine::~Routine()
+{
+    if (m_handle)
+    {
+        m_handle.destroy();
+    }
+}
+
+void ResumableParser::Routine::Resume()
+{
+    if (!m_handle.done())
+    {
+        m_handle.resume();
+    }
+}
+
+void ResumableParser::Routine::RethrowIfFailed() const
+{
+    if (m_handle.promise().exception)
+    {
+        std::rethrow_exception(m_handle.promise().exception);
+    }
+}
+
+ResumableParser::ResumableParser(int max_nesting_depth)
+    : m_max_nesting_depth(max_nesting_depth)
+    , m_arena(std::make_shared<AstArena>())
+    , m_tokens(std::make_shared<std::vector<Token>>())
+    , m_routine(Run())
+{}
+
+void ResumableParser::Feed(Token token)
+{
+    if (token.type == TokenType::EndOfFile)
+    {
+        m_is_input_over = true;
+    }
+    m_tokens->push_back(std::move(token));
+    m_routine.Resume();
+}
+
+void ResumableParser::Fail(std::exception_ptr error)
+{
+    m_pending_error = error;
+    m_is_input_over = true;
+    m_routine.Resume();
+}
+
+bool ResumableParser::IsFinished() const
+{
+    return m_is_input_over;
+}
+
+size_t ResumableParser::NumParsedDecls() const
+{
+    return m_declarations.size();
+}
+
+std::shared_ptr<IAbstractSyntaxTree> ResumableParser::Result()
+{
+    if (!m_is_input_over)
+    {
+        throw std::logic_error("ResumableParser::Result() is called before the input is over");
+    }
+
+    m_routine.RethrowIfFailed();
+    if (m_ast)
+    {
+        return std::shared_ptr<IAbstractSyntaxTree>(m_arena, m_ast);
+    }
+
+    // Something went wrong, so let the sequential parser find out what it was.
+    return ParseSequentially(m_tokens, m_pending_error, m_max_nesting_depth);
+}
+
+ResumableParser::Routine ResumableParser::Run()
+{
+    auto scanner = DeclBoundaryScanner();
+    auto num_read_tokens = size_t{0};
+    while (true)
+    {
+        // Wait for the next token.
+        while (num_read_tokens == m_tokens->size() && !m_is_input_over)
+        {
+            co_await std::suspend_always{};
+        }
+
+        // The input might have been ended by an error.
+        if (num_read_tokens == m_tokens->size())
+        {
+            co_return;
+        }
+
+        auto type = (*m_tokens)[num_read_tokens++].type;
+        if (type == TokenType::EndOfFile)
+        {
+            break;
+        }
+        scanner.Feed(type);
+
+        // The start of a declaration marks the end of the previous one.
+        const auto& decl_starts = scanner.DeclStarts();
+        while (m_declarations.size() + 1 < decl_starts.size())
+        {
+            auto i = m_declarations.size();
+            if (!TryParseDecl(decl_starts[i], decl_starts[i + 1], scanner.HeaderEnd()))
+            {
+                co_return;
+            }
+        }
+    }
+
+    if (!scanner.IsValid())
+    {
+        co_return;
+    }
+
+    // Note: the last token is EOF.
+    auto decl_starts = scanner.DeclStarts();
+    decl_starts.push_back(m_tokens->size() - 1);
+    for (auto i = m_declarations.size(); i + 1 < decl_starts.size(); ++i)
+    {
+        if (!TryParseDecl(decl_starts[i], decl_starts[i + 1], scanner.HeaderEnd()))
+        {
+            co_return;
+        }
+    }
+
+    // The header might be the whole module.
+    if (!m_header)
+    {
+        m_header = TryParseModuleHeader(m_tokens, 0, scanner.HeaderEnd(), m_arena, m_max_nesting_depth);
+        if (!m_header)
+        {
+            co_return;
+        }
+    }
+    m_ast = m_arena->Create<Module>(m_header->ModuleName(), m_header->ImportList(), m_declarations);
+}
+
+// The header is parsed along with the first declaration.
+bool ResumableParser::TryParseDecl(size_t begin, size_t end, size_t header_end)
+{
+    if (!m_header)
+    {
+        m_header = TryParseModuleHeader(m_tokens, 0, header_end, m_arena, m_max_nesting_depth);
+        if (!m_header)
+        {
+            return false;
+        }
+    }
+
+    auto decl = TryParseGlobalDecl(m_tokens, begin, end, m_arena, m_max_nesting_depth);
+    if (!decl)
+    {
+        return false;
+    }
+    m_declarations.push_back(decl);
+    return true;
+}
+
+} // namespace mylang
@@ -21,6 +21,13 @@ void SymbolTable::CloseScope()
     };
     while (!m_symbols.empty() && is_out_of_scope(m_symbols.back()))
     {
+        // The symbol is the latest one with its name, so it's at the back of its entry.
+        auto entry = m_symbol_index.find(m_symbols.back().declaration->Name().lexeme);
+        entry->second.pop_back();
+        if (entry->second.empty())
+        {
+            m_symbol_index.erase(entry);
+        }
         m_symbols.pop_back();
     }
 }
@@ -35,22 +42,20 @@ void SymbolTable::AddSymbol(Decl* declaration, bool is_public)
         throw SemanticError(declaration->Name().start_pos, message);
     }
 
+    m_symbol_index[declaration->Name().lexeme].push_back(m_symbols.size());
     m_symbols.emplace_back(declaration, is_public, m_current_scope_level);
 }
 
 std::optional<Symbol> SymbolTable::FindSymbol(std::string_view name) const
 {
-    // Search for the symbol with matching name and the highest scope level.
-    for (auto it = m_symbols.rbegin(); it != m_symbols.rend(); ++it)
+    // The latest symbol with matching name has the highest scope level.
+    auto entry = m_symbol_index.find(name);
+    if (entry == m_symbol_index.end())
     {
-        if (it->declaration->Name().lexeme == name)
-        {
-            return *it;
-        }
+        // Found nothing...
+        return {};
     }
-
-    // Found nothing...
-    return {};
+    return m_symbols[entry->second.back()];
 }
 
 std::vector<Symbol> SymbolTable::GlobalSymbols() const
@@ -1,33 +1,105 @@
 #include "parser/SyntaxAnalyzer.h"
+#include "parser/DeclBoundaryScanner.h"
+#include "parser/ResumableParser.h"
 #include "parser/routine/ExprParser.h"
 #include "parser/routine/TypeParser.h"
 #include "parser/routine/StmtParser.h"
 #include "parser/routine/GlobalDeclParser.h"
+#include "lexer/TokenBufferCursor.h"
+#include <optional>
 
 namespace mylang
 {
 
-SyntaxAnalyzer::SyntaxAnalyzer(std::unique_ptr<IStream<Token>>&& lexer)
-    :m_lexer(std::make_shared<BufferedStream<Token>>(move(lexer)))
+std::shared_ptr<GlobalDeclParser> CreateGlobalDeclParser(
+    std::shared_ptr<BufferedStream<Token>> token_stream,
+    std::shared_ptr<AstArena> arena,
+    int max_nesting_depth
+)
 {
-    // Create program parser from given token stream.
-    auto expr_parser = std::make_shared<ExprParser>(m_lexer);
-    auto type_parser = std::make_shared<TypeParser>(m_lexer);
-    auto stmt_parser = std::make_shared<StmtParser>(m_lexer, expr_parser, type_parser);
-    auto global_decl_parser = std::make_shared<GlobalDeclParser>(m_lexer, stmt_parser, type_parser);
-    m_parser = std::make_unique<ModuleParser>(m_lexer, global_decl_parser);
+    auto expr_parser = std::make_shared<ExprParser>(token_stream, arena, max_nesting_depth);
+    auto type_parser = std::make_shared<TypeParser>(token_stream);
+    auto stmt_parser = std::make_shared<StmtParser>(token_stream, arena, expr_parser, type_parser, max_nesting_depth);
+    return std::make_shared<GlobalDeclParser>(token_stream, arena, stmt_parser, type_parser);
 }
 
+SyntaxAnalyzer::SyntaxAnalyzer(std::unique_ptr<IStream<Token>>&& lexer, int max_nesting_depth)
+    :m_lexer(std::make_shared<BufferedStream<Token>>(move(lexer)))
+    , m_arena(std::make_shared<AstArena>())
+    , m_max_nesting_depth(max_nesting_depth)
+{}
+
 std::shared_ptr<IAbstractSyntaxTree> SyntaxAnalyzer::GenerateAST()
 {
+    auto parser = ResumableParser(m_max_nesting_depth);
+    try
+    {
+        while (!parser.IsFinished())
+        {
+            parser.Feed(m_lexer->GetNext());
+        }
+    }
+    catch(...)
+    {
+        parser.Fail(std::current_exception());
+    }
+    return parser.Result();
+}
+
+// Replays tokens that were read in advance, and then
+// rethrows the error that stopped the read-ahead (if any).
+// This lets the sequential parser observe a lexical error
+// at exactly the same point as if it had read the lexer directly.
+class TokenReplayStream : public IStream<Token>
+{
+public:
+    TokenReplayStream(std::shared_ptr<const std::vector<Token>> tokens, std::exception_ptr pending_error)
+        : m_cursor(tokens, 0, tokens->size())
+        , m_num_tokens(tokens->size())
+        , m_pending_error(pending_error)
+    {}
+
+    virtual bool IsFinished() const override
+    {
+        return m_cursor.IsFinished();
+    }
+
+    virtual Token GetNext() override
+    {
+        if (m_num_replayed == m_num_tokens && m_pending_error)
+        {
+            std::rethrow_exception(m_pending_error);
+        }
+        ++m_num_replayed;
+        return m_cursor.GetNext();
+    }
+
+private:
+    TokenBufferCursor m_cursor;
+    size_t m_num_tokens;
+    size_t m_num_replayed = 0;
+    std::exception_ptr m_pending_error;
+};
+
+std::shared_ptr<IAbstractSyntaxTree> ParseSequentially(
+    std::shared_ptr<const std::vector<Token>> tokens,
+    std::exception_ptr pending_error,
+    int max_nesting_depth
+)
+{
+    auto token_stream = std::make_shared<BufferedStream<Token>>(std::make_unique<TokenReplayStream>(tokens, pending_error));
+    auto arena = std::make_shared<AstArena>();
+    auto parser = ModuleParser(token_stream, arena, CreateGlobalDeclParser(token_stream, arena, max_nesting_depth));
     try
     {
-        auto ast = m_parser->Parse();
-        if (m_lexer->Peek().type != TokenType::EndOfFile)
+        auto ast = parser.Parse();
+        if (token_stream->Peek().type != TokenType::EndOfFile)
         {
-            throw LeftoverTokenError(m_lexer->GetNext());
+            throw LeftoverTokenError(token_stream->GetNext());
         }
-        return ast;
+
+        // The tree shares ownership of the arena instead of each node.
+        return std::shared_ptr<IAbstractSyntaxTree>(arena, ast);
     }
     catch(const ParseRoutineError& e)
     {
@@ -35,4 +107,166 @@ std::shared_ptr<IAbstractSyntaxTree> SyntaxAnalyzer::GenerateAST()
     }
 }
 
+Module* TryParseModuleHeader(
+    std::shared_ptr<const std::vector<Token>> tokens,
+    size_t begin,
+    size_t end,
+    std::shared_ptr<AstArena> arena,
+    int max_nesting_depth
+)
+{
+    try
+    {
+        auto token_stream = std::make_shared<BufferedStream<Token>>(std::make_unique<TokenBufferCursor>(tokens, begin, end));
+        auto parser = ModuleParser(token_stream, arena, CreateGlobalDeclParser(token_stream, arena, max_nesting_depth));
+        auto header = parser.Parse();
+        if (token_stream->Peek().type == TokenType::EndOfFile)
+        {
+            return header;
+        }
+    }
+    catch(...)
+    {
+        // The sequential parser will report this error.
+    }
+    return nullptr;
+}
+
+GlobalDecl* TryParseGlobalDecl(
+    std::shared_ptr<const std::vector<Token>> tokens,
+    size_t begin,
+    size_t end,
+    std::shared_ptr<AstArena> arena,
+    int max_nesting_depth
+)
+{
+    try
+    {
+        auto token_stream = std::make_shared<BufferedStream<Token>>(std::make_unique<TokenBufferCursor>(tokens, begin, end));
+        auto decl = CreateGlobalDeclParser(token_stream, arena, max_nesting_depth)->Parse();
+        if (token_stream->Peek().type == TokenType::EndOfFile)
+        {
+            return decl;
+        }
+    }
+    catch(...)
+    {
+        // The sequential parser will report this error.
+    }
+    return nullptr;
+}
+
+// Declarations parsed by a single task.
+// Each task has its own arena since AstArena is not thread-safe.
+struct ParsedDeclChunk
+{
+    std::shared_ptr<AstArena> arena;
+    std::vector<GlobalDecl*> declarations;
+};
+
+// Parse declarations in the given token buffer on the thread pool.
+// Returns nullptr if any part of the buffer failed to parse.
+Module* TryParseConcurrently(
+    std::shared_ptr<const std::vector<Token>> tokens,
+    const DeclBoundaryScanner& scanner,
+    ThreadPool& thread_pool,
+    std::shared_ptr<AstArena> arena,
+    int max_nesting_depth
+)
+{
+    // Note: the last token is EOF.
+    auto boundaries = scanner.DeclStarts();
+    boundaries.push_back(tokens->size() - 1);
+
+    auto header = TryParseModuleHeader(tokens, 0, scanner.HeaderEnd(), arena, max_nesting_depth);
+    if (!header)
+    {
+        return nullptr;
+    }
+
+    // Each task handles a contiguous chunk of declarations,
+    // so that a module with tons of tiny functions doesn't flood the queue.
+    auto num_decls = boundaries.size() - 1;
+    auto num_chunks = std::min<size_t>(num_decls, thread_pool.NumThreads() * 4);
+    auto chunks = std::vector<std::future<std::optional<ParsedDeclChunk>>>{};
+    for (size_t chunk = 0; chunk < num_chunks; ++chunk)
+    {
+        auto first_decl = num_decls * chunk / num_chunks;
+        auto last_decl = num_decls * (chunk + 1) / num_chunks;
+
+        chunks.push_back(thread_pool.Submit([=]() -> std::optional<ParsedDeclChunk> {
+            auto result = ParsedDeclChunk{.arena = std::make_shared<AstArena>(), .declarations = {}};
+            for (auto i = first_decl; i < last_decl; ++i)
+            {
+                auto decl = TryParseGlobalDecl(tokens, boundaries[i], boundaries[i + 1], result.arena, max_nesting_depth);
+                if (!decl)
+                {
+                    return {};
+                }
+                result.declarations.push_back(decl);
+            }
+            return result;
+        }));
+    }
+
+    // Merge the results in source order.
+    // Every chunk should be waited, even after a failure,
+    // because the tasks capture the token buffer.
+    auto global_declarations = std::vector<GlobalDecl*>{};
+    auto is_successful = true;
+    for (auto& chunk : chunks)
+    {
+        if (auto result = thread_pool.Wait(chunk))
+        {
+            arena->Retain(result->arena);
+            global_declarations.insert(global_declarations.end(), result->declarations.begin(), result->declarations.end());
+        }
+        else
+        {
+            is_successful = false;
+        }
+    }
+
+    if (!is_successful)
+    {
+        return nullptr;
+    }
+    return arena->Create<Module>(header->ModuleName(), header->ImportList(), global_declarations);
+}
+
+std::shared_ptr<IAbstractSyntaxTree> SyntaxAnalyzer::GenerateAST(ThreadPool& thread_pool)
+{
+    // Read every token in advance while locating declaration boundaries.
+    auto tokens = std::make_shared<std::vector<Token>>();
+    auto scanner = DeclBoundaryScanner();
+    auto pending_error = std::exception_ptr{};
+    try
+    {
+        while (true)
+        {
+            tokens->push_back(m_lexer->GetNext());
+            if (tokens->back().type == TokenType::EndOfFile)
+            {
+                break;
+            }
+            scanner.Feed(tokens->back().type);
+        }
+    }
+    catch(...)
+    {
+        pending_error = std::current_exception();
+    }
+
+    if (!pending_error && scanner.IsValid())
+    {
+        if (auto ast = TryParseConcurrently(tokens, scanner, thread_pool, m_arena, m_max_nesting_depth))
+        {
+            return std::shared_ptr<IAbstractSyntaxTree>(m_arena, ast);
+        }
+    }
+
+    // Something went wrong, so let the sequential parser find out what it was.
+    return ParseSequentially(tokens, pending_error, m_max_nesting_depth);
+}
+
 } // namespace mylang
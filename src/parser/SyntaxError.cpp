@@ -65,6 +65,7 @@ std::string UnexpectedTokenError::ExpectedTypeDescriptor() const
             }
 
             output << TokenTypeName(*it);
+            ++it;
         }
 
         return output.str();
@@ -110,6 +111,21 @@ std::string_view PatternMismatchError::Description() const
     return m_message;
 }
 
+NestingLimitError::NestingLimitError(const Token& token, int max_nesting_depth)
+    : m_location(token.start_pos)
+    , m_message(std::format("nesting depth exceeded the limit of {} at \"{}\"", max_nesting_depth, token.lexeme))
+{}
+
+const SourcePos& NestingLimitError::Location() const
+{
+    return m_location;
+}
+
+std::string_view NestingLimitError::Description() const
+{
+    return m_message;
+}
+
 LeftoverTokenError::LeftoverTokenError(const Token& token)
     : m_location(token.start_pos)
     , m_message(std::format("there were leftover tokens after parsing completed: \"{}\" ...", token.lexeme))
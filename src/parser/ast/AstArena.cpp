@@ -0,0 +1,55 @@
+#include "parser/ast/AstArena.h"
+#include <algorithm>
+
+namespace mylang
+{
+
+AstArena::AstArena(size_t block_size)
+    : m_block_size(block_size)
+{}
+
+AstArena::~AstArena()
+{
+    // Nodes only refer to their children with raw pointers,
+    // so they can be destroyed in any order without recursion.
+    // Reverse order is used to mimic automatic storage.
+    for (auto it = m_destructors.rbegin(); it != m_destructors.rend(); ++it)
+    {
+        auto [node, destructor] = *it;
+        destructor(node);
+    }
+}
+
+void AstArena::Retain(std::shared_ptr<AstArena> other)
+{
+    m_retained_arenas.push_back(other);
+}
+
+size_t AstArena::NumBytesUsed() const
+{
+    return m_num_bytes_used;
+}
+
+void* AstArena::Allocate(size_t size, size_t alignment)
+{
+    // Try the current block first.
+    void* memory = m_current;
+    if (!memory || !std::align(alignment, size, memory, m_num_bytes_left))
+    {
+        // Start a new block, with enough padding for the alignment.
+        // Note: the memory is not zero-initialized unlike std::make_unique.
+        auto block_size = std::max(size + alignment, m_block_size);
+        m_blocks.emplace_back(new std::byte[block_size]);
+        memory = m_blocks.back().get();
+        m_num_bytes_left = block_size;
+        std::align(alignment, size, memory, m_num_bytes_left);
+    }
+
+    m_current = static_cast<std::byte*>(memory) + size;
+    m_num_bytes_left -= size;
+    m_num_bytes_used += size;
+
+    return memory;
+}
+
+} // namespace mylang
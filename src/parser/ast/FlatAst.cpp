@@ -0,0 +1,215 @@
+#include "parser/ast/FlatAst.h"
+
+namespace mylang
+{
+
+std::string_view FlatNodeKindName(FlatNodeKind kind)
+{
+    switch (kind)
+    {
+    case FlatNodeKind::Module:
+        return "Module";
+    case FlatNodeKind::Parameter:
+        return "Parameter";
+    case FlatNodeKind::FuncDecl:
+        return "FuncDecl";
+    case FlatNodeKind::StructDecl:
+        return "StructDecl";
+    case FlatNodeKind::CompoundStmt:
+        return "CompoundStmt";
+    case FlatNodeKind::IfStmt:
+        return "IfStmt";
+    case FlatNodeKind::ForStmt:
+        return "ForStmt";
+    case FlatNodeKind::WhileStmt:
+        return "WhileStmt";
+    case FlatNodeKind::JumpStmt:
+        return "JumpStmt";
+    case FlatNodeKind::VarDeclStmt:
+        return "VarDeclStmt";
+    case FlatNodeKind::ExprStmt:
+        return "ExprStmt";
+    case FlatNodeKind::VarInitExpr:
+        return "VarInitExpr";
+    case FlatNodeKind::VarInitList:
+        return "VarInitList";
+    case FlatNodeKind::ArrayAccessExpr:
+        return "ArrayAccessExpr";
+    case FlatNodeKind::BinaryExpr:
+        return "BinaryExpr";
+    case FlatNodeKind::FuncCallExpr:
+        return "FuncCallExpr";
+    case FlatNodeKind::Identifier:
+        return "Identifier";
+    case FlatNodeKind::Literal:
+        return "Literal";
+    case FlatNodeKind::MemberAccessExpr:
+        return "MemberAccessExpr";
+    case FlatNodeKind::PostfixExpr:
+        return "PostfixExpr";
+    case FlatNodeKind::PrefixExpr:
+        return "PrefixExpr";
+    default:
+        throw std::exception("Unexpected node kind");
+    }
+}
+
+FlatNodeId FlatAst::AddNode(
+    FlatNodeKind kind,
+    FlatNodeId parent,
+    FlatNodeId previous_sibling,
+    IAbstractSyntaxTree* source
+)
+{
+    auto node = static_cast<FlatNodeId>(m_kinds.size());
+
+    m_kinds.push_back(kind);
+    m_flags.push_back(FlatNodeNoFlag);
+    m_parents.push_back(parent);
+    m_first_children.push_back(InvalidFlatNodeId);
+    m_next_siblings.push_back(InvalidFlatNodeId);
+    m_token_indices.push_back(0);
+    m_payloads.push_back(0);
+    m_source_nodes.push_back(source);
+
+    // Link to the parent or the previous sibling.
+    if (previous_sibling != InvalidFlatNodeId)
+    {
+        m_next_siblings[previous_sibling] = node;
+    }
+    else if (parent != InvalidFlatNodeId)
+    {
+        m_first_children[parent] = node;
+    }
+
+    return node;
+}
+
+void FlatAst::AddFlags(FlatNodeId node, uint8_t flags)
+{
+    m_flags[node] |= flags;
+}
+
+void FlatAst::SetToken(FlatNodeId node, const Token& token)
+{
+    m_token_indices[node] = static_cast<uint32_t>(m_tokens.size());
+    m_tokens.push_back(token);
+}
+
+void FlatAst::SetType(FlatNodeId node, const Type& type)
+{
+    m_payloads[node] = static_cast<uint32_t>(m_types.size());
+    m_types.push_back(type);
+}
+
+void FlatAst::SetParamType(FlatNodeId node, const ParamType& param_type)
+{
+    m_payloads[node] = static_cast<uint32_t>(m_param_types.size());
+    m_param_types.push_back(param_type);
+}
+
+void FlatAst::SetMembers(FlatNodeId node, const std::vector<MemberVariable>& members)
+{
+    auto range = Range{};
+    range.begin = static_cast<uint32_t>(m_members.size());
+    m_members.insert(m_members.end(), members.begin(), members.end());
+    range.end = static_cast<uint32_t>(m_members.size());
+
+    m_payloads[node] = static_cast<uint32_t>(m_ranges.size());
+    m_ranges.push_back(range);
+}
+
+void FlatAst::SetImportList(FlatNodeId node, const std::vector<ModuleImportInfo>& import_list)
+{
+    auto range = Range{};
+    range.begin = static_cast<uint32_t>(m_imports.size());
+    m_imports.insert(m_imports.end(), import_list.begin(), import_list.end());
+    range.end = static_cast<uint32_t>(m_imports.size());
+
+    m_payloads[node] = static_cast<uint32_t>(m_ranges.size());
+    m_ranges.push_back(range);
+}
+
+size_t FlatAst::NumNodes() const
+{
+    return m_kinds.size();
+}
+
+FlatNodeKind FlatAst::Kind(FlatNodeId node) const
+{
+    return m_kinds[node];
+}
+
+bool FlatAst::HasFlags(FlatNodeId node, uint8_t flags) const
+{
+    return (m_flags[node] & flags) == flags;
+}
+
+FlatNodeId FlatAst::Parent(FlatNodeId node) const
+{
+    return m_parents[node];
+}
+
+FlatNodeId FlatAst::FirstChild(FlatNodeId node) const
+{
+    return m_first_children[node];
+}
+
+FlatNodeId FlatAst::NextSibling(FlatNodeId node) const
+{
+    return m_next_siblings[node];
+}
+
+FlatNodeId FlatAst::Child(FlatNodeId node, size_t n) const
+{
+    auto child = m_first_children[node];
+    for (size_t i = 0; i < n && child != InvalidFlatNodeId; ++i)
+    {
+        child = m_next_siblings[child];
+    }
+    return child;
+}
+
+size_t FlatAst::NumChildren(FlatNodeId node) const
+{
+    auto num_children = size_t{0};
+    for (auto child = m_first_children[node]; child != InvalidFlatNodeId; child = m_next_siblings[child])
+    {
+        ++num_children;
+    }
+    return num_children;
+}
+
+IAbstractSyntaxTree* FlatAst::SourceNode(FlatNodeId node) const
+{
+    return m_source_nodes[node];
+}
+
+const Token& FlatAst::NodeToken(FlatNodeId node) const
+{
+    return m_tokens[m_token_indices[node]];
+}
+
+const Type& FlatAst::NodeType(FlatNodeId node) const
+{
+    return m_types[m_payloads[node]];
+}
+
+const ParamType& FlatAst::NodeParamType(FlatNodeId node) const
+{
+    return m_param_types[m_payloads[node]];
+}
+
+std::span<const MemberVariable> FlatAst::Members(FlatNodeId node) const
+{
+    auto range = m_ranges[m_payloads[node]];
+    return std::span<const MemberVariable>(m_members.data() + range.begin, m_members.data() + range.end);
+}
+
+std::span<const ModuleImportInfo> FlatAst::ImportList(FlatNodeId node) const
+{
+    auto range = m_ranges[m_payloads[node]];
+    return std::span<const ModuleImportInfo>(m_imports.data() + range.begin, m_imports.data() + range.end);
+}
+
+} // namespace mylang
@@ -0,0 +1,60 @@
+#include "parser/ast/FlatAstCursor.h"
+
+namespace mylang
+{
+
+FlatAstCursor::FlatAstCursor(const FlatAst& ast, FlatNodeId root)
+    : m_ast(ast)
+    , m_root(root)
+    , m_node(root < ast.NumNodes() ? root : InvalidFlatNodeId)
+{}
+
+bool FlatAstCursor::IsValid() const
+{
+    return m_node != InvalidFlatNodeId;
+}
+
+FlatNodeId FlatAstCursor::Node() const
+{
+    return m_node;
+}
+
+FlatNodeKind FlatAstCursor::Kind() const
+{
+    return m_ast.Kind(m_node);
+}
+
+int FlatAstCursor::Depth() const
+{
+    return m_depth;
+}
+
+void FlatAstCursor::Next()
+{
+    if (auto child = m_ast.FirstChild(m_node); child != InvalidFlatNodeId)
+    {
+        m_node = child;
+        ++m_depth;
+        return;
+    }
+    SkipChildren();
+}
+
+void FlatAstCursor::SkipChildren()
+{
+    // Find the closest ancestor (including itself) which has a next sibling,
+    // but never leave the subtree of the root.
+    while (m_node != m_root)
+    {
+        if (auto sibling = m_ast.NextSibling(m_node); sibling != InvalidFlatNodeId)
+        {
+            m_node = sibling;
+            return;
+        }
+        m_node = m_ast.Parent(m_node);
+        --m_depth;
+    }
+    m_node = InvalidFlatNodeId;
+}
+
+} // namespace mylang
@@ -0,0 +1,68 @@
+#include "parser/ast/IAbstractSyntaxTree.h"
+#include <array>
+#include <atomic>
+
+namespace mylang
+{
+
+// Number of IDs a thread takes at once.
+const AstNodeId AstNodeIdBlockSize = 4096;
+
+// Nodes are created concurrently when files or declarations are parsed in parallel.
+std::atomic<AstNodeId> NextAstNodeIdBlock = 0;
+
+// Takes the next ID of the calling thread's block, or of a new block once it runs out.
+AstNodeId AllocateAstNodeId()
+{
+    thread_local auto next_id = AstNodeId{0};
+    thread_local auto block_end = AstNodeId{0};
+    if (next_id == block_end)
+    {
+        next_id = NextAstNodeIdBlock.fetch_add(AstNodeIdBlockSize, std::memory_order_relaxed);
+        block_end = next_id + AstNodeIdBlockSize;
+    }
+    return next_id++;
+}
+
+std::string_view AstNodeKindName(AstNodeKind kind)
+{
+    static const auto names = std::array<std::string_view, NumAstNodeKinds>{
+        "Module",
+        "Parameter", "FuncDecl", "StructDecl",
+        "CompoundStmt", "IfStmt", "ForStmt", "WhileStmt", "JumpStmt", "VarDeclStmt", "ExprStmt",
+        "VarInitExpr", "VarInitList",
+        "ArrayAccessExpr", "BinaryExpr", "FuncCallExpr", "Identifier", "Literal", "MemberAccessExpr", "PostfixExpr", "PrefixExpr",
+    };
+    return names[static_cast<size_t>(kind)];
+}
+
+IAbstractSyntaxTree::IAbstractSyntaxTree()
+    : m_node_id(AllocateAstNodeId())
+{}
+
+AstNodeId IAbstractSyntaxTree::NodeId() const
+{
+    return m_node_id;
+}
+
+uint64_t IAbstractSyntaxTree::StructuralHash() const
+{
+    return m_structural_hash;
+}
+
+void IAbstractSyntaxTree::SetStructuralHash(uint64_t hash)
+{
+    m_structural_hash = hash;
+}
+
+void IAbstractSyntaxTree::SetNodeKind(AstNodeKind kind)
+{
+    m_node_kind = kind;
+}
+
+void IAbstractSyntaxTree::SetNodeId(AstNodeId id)
+{
+    m_node_id = id;
+}
+
+} // namespace mylang
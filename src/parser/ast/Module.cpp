@@ -1,6 +1,7 @@
 #include "parser/ast/Module.h"
 #include "parser/ast/globdecl/GlobalDecl.h"
 #include "parser/ast/visitor/IAbstractSyntaxTreeVisitor.h"
+#include "parser/ast/StructuralHash.h"
 
 namespace mylang
 {
@@ -10,11 +11,20 @@ bool ModuleImportInfo::operator<(const ModuleImportInfo& other) const
     return name.lexeme < other.name.lexeme;
 }
 
-Module::Module(const Token& module_name, const std::vector<ModuleImportInfo>& import_list, const std::vector<std::shared_ptr<GlobalDecl>>& global_declarations)
+Module::Module(const Token& module_name, const std::vector<ModuleImportInfo>& import_list, const std::vector<GlobalDecl*>& global_declarations)
     : m_module_name(module_name)
     , m_import_list(import_list)
     , m_global_declarations(global_declarations)
-{}
+{
+    SetNodeKind(AstNodeKind::Module);
+    auto hasher = StructuralHasher("Module");
+    hasher.Add(module_name).Add(static_cast<uint64_t>(import_list.size()));
+    for (const auto& import_info : import_list)
+    {
+        hasher.Add(static_cast<uint64_t>(import_info.should_export)).Add(import_info.name);
+    }
+    SetStructuralHash(hasher.Add(global_declarations).Hash());
+}
 
 void Module::Accept(IAbstractSyntaxTreeVisitor* visitor)
 {
@@ -36,7 +46,7 @@ const std::vector<ModuleImportInfo>& Module::ImportList() const
     return m_import_list;
 }
 
-const std::vector<std::shared_ptr<GlobalDecl>>& Module::Declarations() const
+const std::vector<GlobalDecl*>& Module::Declarations() const
 {
     return m_global_declarations;
 }
@@ -0,0 +1,342 @@
+#include "parser/ast/StructuralHash.h"
+#include "parser/ast/visitor/IAbstractSyntaxTreeVisitor.h"
+#include "parser/ast/Module.h"
+#include "parser/ast/globdecl/Parameter.h"
+#include "parser/ast/globdecl/FuncDecl.h"
+#include "parser/ast/globdecl/StructDecl.h"
+
+#include "parser/ast/stmt/CompoundStmt.h"
+#include "parser/ast/stmt/IfStmt.h"
+#include "parser/ast/stmt/ForStmt.h"
+#include "parser/ast/stmt/WhileStmt.h"
+#include "parser/ast/stmt/JumpStmt.h"
+#include "parser/ast/stmt/VarDeclStmt.h"
+#include "parser/ast/stmt/ExprStmt.h"
+
+#include "parser/ast/varinit/VarInitExpr.h"
+#include "parser/ast/varinit/VarInitList.h"
+
+#include "parser/ast/expr/ArrayAccessExpr.h"
+#include "parser/ast/expr/BinaryExpr.h"
+#include "parser/ast/expr/FuncCallExpr.h"
+#include "parser/ast/expr/Identifier.h"
+#include "parser/ast/expr/Literal.h"
+#include "parser/ast/expr/MemberAccessExpr.h"
+#include "parser/ast/expr/PostfixExpr.h"
+#include "parser/ast/expr/PrefixExpr.h"
+#include <string>
+
+namespace mylang
+{
+
+const uint64_t FnvOffsetBasis = 14695981039346656037ull;
+const uint64_t FnvPrime = 1099511628211ull;
+
+// Stands for a missing optional child.
+const uint64_t NullNodeHash = 0;
+
+StructuralHasher::StructuralHasher(std::string_view node_kind)
+    : m_hash(FnvOffsetBasis)
+{
+    Add(node_kind);
+}
+
+StructuralHasher& StructuralHasher::Add(uint64_t value)
+{
+    // Byte order is fixed, so that the hash is the same on every platform.
+    unsigned char bytes[sizeof(value)];
+    for (auto& byte : bytes)
+    {
+        byte = static_cast<unsigned char>(value & 0xFF);
+        value >>= 8;
+    }
+    AddBytes(bytes, sizeof(bytes));
+    return *this;
+}
+
+StructuralHasher& StructuralHasher::Add(std::string_view value)
+{
+    // The length keeps adjacent strings apart (e.g., "ab" + "c" and "a" + "bc").
+    Add(static_cast<uint64_t>(value.size()));
+    AddBytes(value.data(), value.size());
+    return *this;
+}
+
+StructuralHasher& StructuralHasher::Add(const Token& token)
+{
+    return Add(static_cast<uint64_t>(token.type)).Add(std::string_view(token.lexeme));
+}
+
+StructuralHasher& StructuralHasher::Add(const Type& type)
+{
+    return Add(std::string_view(type.ToString()));
+}
+
+StructuralHasher& StructuralHasher::Add(const IAbstractSyntaxTree* node)
+{
+    return Add(node ? node->StructuralHash() : NullNodeHash);
+}
+
+uint64_t StructuralHasher::Hash() const
+{
+    return m_hash;
+}
+
+void StructuralHasher::AddBytes(const void* data, size_t size)
+{
+    auto bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        m_hash ^= bytes[i];
+        m_hash *= FnvPrime;
+    }
+}
+
+// Writes every field that the structural hash of each node is made of,
+// with children written in place instead of their hashes.
+// Two trees are structurally equal iff their encodings are equal.
+class StructureEncoder : public IAbstractSyntaxTreeVisitor
+{
+public:
+    const std::string& Encoding() const
+    {
+        return m_encoding;
+    }
+
+    void Write(IAbstractSyntaxTree* node)
+    {
+        if (node)
+        {
+            node->Accept(this);
+        }
+        else
+        {
+            m_encoding.push_back('\0');
+        }
+    }
+
+    template<typename T>
+    void Write(const std::vector<T*>& nodes)
+    {
+        Write(static_cast<uint64_t>(nodes.size()));
+        for (auto node : nodes)
+        {
+            Write(static_cast<IAbstractSyntaxTree*>(node));
+        }
+    }
+
+    virtual void Visit(Module* node) override
+    {
+        WriteKind("Module");
+        Write(node->ModuleName());
+        Write(static_cast<uint64_t>(node->ImportList().size()));
+        for (const auto& import_info : node->ImportList())
+        {
+            Write(static_cast<uint64_t>(import_info.should_export));
+            Write(import_info.name);
+        }
+        Write(node->Declarations());
+    }
+
+    virtual void Visit(Parameter* node) override
+    {
+        WriteKind("Parameter");
+        Write(node->Name());
+        Write(static_cast<uint64_t>(node->DeclParamType().usage));
+        Write(node->DeclParamType().type);
+    }
+
+    virtual void Visit(FuncDecl* node) override
+    {
+        WriteKind("FuncDecl");
+        Write(static_cast<uint64_t>(node->ShouldExport()));
+        Write(node->Name());
+        Write(node->ReturnType());
+        Write(node->Parameters());
+        Write(node->Body());
+    }
+
+    virtual void Visit(StructDecl* node) override
+    {
+        WriteKind("StructDecl");
+        Write(static_cast<uint64_t>(node->ShouldExport()));
+        Write(node->Name());
+        Write(static_cast<uint64_t>(node->Members().size()));
+        for (const auto& member : node->Members())
+        {
+            Write(member.name);
+            Write(member.type);
+        }
+    }
+
+    virtual void Visit(CompoundStmt* node) override
+    {
+        WriteKind("CompoundStmt");
+        Write(node->Statements());
+    }
+
+    virtual void Visit(IfStmt* node) override
+    {
+        WriteKind("IfStmt");
+        Write(node->Condition());
+        Write(node->ThenBranch());
+        Write(node->ElseBranch());
+    }
+
+    virtual void Visit(ForStmt* node) override
+    {
+        WriteKind("ForStmt");
+        Write(node->Initializer());
+        Write(node->Condition());
+        Write(node->IncrementExpr());
+        Write(node->Body());
+    }
+
+    virtual void Visit(WhileStmt* node) override
+    {
+        WriteKind("WhileStmt");
+        Write(node->Condition());
+        Write(node->Body());
+    }
+
+    virtual void Visit(JumpStmt* node) override
+    {
+        WriteKind("JumpStmt");
+        Write(node->JumpType());
+        Write(node->ReturnValueExpr());
+    }
+
+    virtual void Visit(VarDeclStmt* node) override
+    {
+        WriteKind("VarDeclStmt");
+        Write(node->Name());
+        Write(node->DeclType());
+        Write(node->Initializer());
+    }
+
+    virtual void Visit(ExprStmt* node) override
+    {
+        WriteKind("ExprStmt");
+        Write(node->Expression());
+    }
+
+    virtual void Visit(VarInitExpr* node) override
+    {
+        WriteKind("VarInitExpr");
+        Write(node->Expression());
+    }
+
+    virtual void Visit(VarInitList* node) override
+    {
+        WriteKind("VarInitList");
+        Write(node->InitializerList());
+    }
+
+    virtual void Visit(ArrayAccessExpr* node) override
+    {
+        WriteKind("ArrayAccessExpr");
+        Write(node->Operand());
+        Write(node->Index());
+    }
+
+    virtual void Visit(BinaryExpr* node) override
+    {
+        WriteKind("BinaryExpr");
+        Write(node->Operator());
+        Write(node->LeftHandOperand());
+        Write(node->RightHandOperand());
+    }
+
+    virtual void Visit(FuncCallExpr* node) override
+    {
+        WriteKind("FuncCallExpr");
+        Write(node->Function());
+        Write(node->ArgumentList());
+    }
+
+    virtual void Visit(Identifier* node) override
+    {
+        WriteKind("Identifier");
+        Write(node->Id());
+    }
+
+    virtual void Visit(Literal* node) override
+    {
+        WriteKind("Literal");
+        Write(node->LiteralToken());
+    }
+
+    virtual void Visit(MemberAccessExpr* node) override
+    {
+        WriteKind("MemberAccessExpr");
+        Write(node->Struct());
+        Write(node->MemberName());
+    }
+
+    virtual void Visit(PostfixExpr* node) override
+    {
+        WriteKind("PostfixExpr");
+        Write(node->Operator());
+        Write(node->Operand());
+    }
+
+    virtual void Visit(PrefixExpr* node) override
+    {
+        WriteKind("PrefixExpr");
+        Write(node->Operator());
+        Write(node->Operand());
+    }
+
+private:
+    // Every node starts with a non-zero byte, unlike a missing child.
+    void WriteKind(std::string_view kind)
+    {
+        m_encoding.push_back('\1');
+        WriteString(kind);
+    }
+
+    void Write(uint64_t value)
+    {
+        m_encoding.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void Write(const Token& token)
+    {
+        Write(static_cast<uint64_t>(token.type));
+        WriteString(token.lexeme);
+    }
+
+    void Write(const Type& type)
+    {
+        WriteString(type.ToString());
+    }
+
+    void WriteString(std::string_view value)
+    {
+        Write(static_cast<uint64_t>(value.size()));
+        m_encoding.append(value);
+    }
+
+    std::string m_encoding;
+};
+
+bool IsStructurallyEqual(IAbstractSyntaxTree* lhs, IAbstractSyntaxTree* rhs)
+{
+    if (lhs == rhs)
+    {
+        return true;
+    }
+    if (!lhs || !rhs || lhs->StructuralHash() != rhs->StructuralHash())
+    {
+        return false;
+    }
+
+    // Rule out a hash collision.
+    auto lhs_encoder = StructureEncoder();
+    auto rhs_encoder = StructureEncoder();
+    lhs_encoder.Write(lhs);
+    rhs_encoder.Write(rhs);
+    return lhs_encoder.Encoding() == rhs_encoder.Encoding();
+}
+
+} // namespace mylang
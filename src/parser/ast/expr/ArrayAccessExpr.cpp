@@ -1,13 +1,16 @@
 #include "parser/ast/expr/ArrayAccessExpr.h"
 #include "parser/ast/visitor/IAbstractSyntaxTreeVisitor.h"
-#include <format>
+#include "parser/ast/StructuralHash.h"
 
 namespace mylang
 {
 
-ArrayAccessExpr::ArrayAccessExpr(std::shared_ptr<Expr> expr, std::shared_ptr<Expr> index)
+ArrayAccessExpr::ArrayAccessExpr(Expr* expr, Expr* index)
     : m_expr(expr), m_index(index)
-{}
+{
+    SetNodeKind(AstNodeKind::ArrayAccessExpr);
+    SetStructuralHash(StructuralHasher("ArrayAccessExpr").Add(expr).Add(index).Hash());
+}
 
 void ArrayAccessExpr::Accept(IAbstractSyntaxTreeVisitor* visitor)
 {
@@ -19,22 +22,14 @@ const SourcePos& ArrayAccessExpr::StartPos() const
     return m_expr->StartPos();
 }
 
-std::string ArrayAccessExpr::ToString() const
-{
-    return std::format("{}[{}]",
-        m_expr->ToString(),
-        m_index->ToString()
-    );
-}
-
 Expr* ArrayAccessExpr::Operand()
 {
-    return m_expr.get();
+    return m_expr;
 }
 
 Expr* ArrayAccessExpr::Index()
 {
-    return m_index.get();
+    return m_index;
 }
 
 } // namespace mylang
@@ -1,13 +1,16 @@
 #include "parser/ast/expr/BinaryExpr.h"
 #include "parser/ast/visitor/IAbstractSyntaxTreeVisitor.h"
-#include <format>
+#include "parser/ast/StructuralHash.h"
 
 namespace mylang
 {
 
-BinaryExpr::BinaryExpr(const Token& op, std::shared_ptr<Expr> lhs, std::shared_ptr<Expr> rhs)
+BinaryExpr::BinaryExpr(const Token& op, Expr* lhs, Expr* rhs)
     : m_op(op), m_lhs(lhs), m_rhs(rhs)
-{}
+{
+    SetNodeKind(AstNodeKind::BinaryExpr);
+    SetStructuralHash(StructuralHasher("BinaryExpr").Add(op).Add(lhs).Add(rhs).Hash());
+}
 
 void BinaryExpr::Accept(IAbstractSyntaxTreeVisitor* visitor)
 {
@@ -19,15 +22,6 @@ const SourcePos& BinaryExpr::StartPos() const
     return m_lhs->StartPos();
 }
 
-std::string BinaryExpr::ToString() const
-{
-    return std::format("({} {} {})",
-        m_lhs->ToString(),
-        m_op.lexeme,
-        m_rhs->ToString()
-    );
-}
-
 const Token& BinaryExpr::Operator() const
 {
     return m_op;
@@ -35,12 +29,12 @@ const Token& BinaryExpr::Operator() const
 
 Expr* BinaryExpr::LeftHandOperand()
 {
-    return m_lhs.get();
+    return m_lhs;
 }
 
 Expr* BinaryExpr::RightHandOperand()
 {
-    return m_rhs.get();
+    return m_rhs;
 }
 
 } // namespace mylang
@@ -0,0 +1,127 @@
+#include "parser/ast/expr/Expr.h"
+#include "parser/ast/visitor/AstWalker.h"
+#include <sstream>
+
+namespace mylang
+{
+
+// Prints each node around its operands, e.g., "(" before the lhs of a BinaryExpr,
+// the operator after it, and ")" after the rhs.
+class ExprPrinter : public AstWalker<ExprPrinter>
+{
+public:
+    using AstWalker<ExprPrinter>::PreVisit;
+    using AstWalker<ExprPrinter>::PostVisit;
+    using AstWalker<ExprPrinter>::BeforeChild;
+    using AstWalker<ExprPrinter>::AfterChild;
+
+    std::string Print(Expr* expr)
+    {
+        Walk(expr);
+        return m_str_builder.str();
+    }
+
+    // "{}[{}]"
+    void AfterChild(ArrayAccessExpr* node, IAbstractSyntaxTree* child)
+    {
+        m_str_builder << (child == node->Operand() ? "[" : "]");
+    }
+
+    // "({} {} {})"
+    bool PreVisit(BinaryExpr* node)
+    {
+        m_str_builder << "(";
+        return true;
+    }
+
+    void AfterChild(BinaryExpr* node, IAbstractSyntaxTree* child)
+    {
+        if (child == node->LeftHandOperand())
+        {
+            m_str_builder << " " << node->Operator().lexeme << " ";
+        }
+    }
+
+    void PostVisit(BinaryExpr* node)
+    {
+        m_str_builder << ")";
+    }
+
+    // "{}({}, {}, ...)"
+    bool BeforeChild(FuncCallExpr* node, IAbstractSyntaxTree* child)
+    {
+        // Add seperator for second to last arguments.
+        if (child != node->Function() && child != node->ArgumentList().front())
+        {
+            m_str_builder << ", ";
+        }
+        return true;
+    }
+
+    void AfterChild(FuncCallExpr* node, IAbstractSyntaxTree* child)
+    {
+        if (child == node->Function())
+        {
+            m_str_builder << "(";
+        }
+    }
+
+    void PostVisit(FuncCallExpr* node)
+    {
+        m_str_builder << ")";
+    }
+
+    bool PreVisit(Identifier* node)
+    {
+        m_str_builder << node->Id().lexeme;
+        return true;
+    }
+
+    bool PreVisit(Literal* node)
+    {
+        m_str_builder << node->LiteralToken().lexeme;
+        return true;
+    }
+
+    // "{}.{}"
+    void PostVisit(MemberAccessExpr* node)
+    {
+        m_str_builder << "." << node->MemberName().lexeme;
+    }
+
+    // "({}{})"
+    bool PreVisit(PostfixExpr* node)
+    {
+        m_str_builder << "(";
+        return true;
+    }
+
+    void PostVisit(PostfixExpr* node)
+    {
+        m_str_builder << node->Operator().lexeme << ")";
+    }
+
+    // "({}{})"
+    bool PreVisit(PrefixExpr* node)
+    {
+        m_str_builder << "(" << node->Operator().lexeme;
+        return true;
+    }
+
+    void PostVisit(PrefixExpr* node)
+    {
+        m_str_builder << ")";
+    }
+
+private:
+    std::ostringstream m_str_builder;
+};
+
+std::string Expr::ToString() const
+{
+    // Printing doesn't modify the tree,
+    // but the accessors of the children are not const.
+    return ExprPrinter().Print(const_cast<Expr*>(this));
+}
+
+} // namespace mylang
@@ -1,12 +1,16 @@
 #include "parser/ast/expr/Identifier.h"
 #include "parser/ast/visitor/IAbstractSyntaxTreeVisitor.h"
+#include "parser/ast/StructuralHash.h"
 
 namespace mylang
 {
 
 Identifier::Identifier(const Token& id)
     : m_id(id)
-{}
+{
+    SetNodeKind(AstNodeKind::Identifier);
+    SetStructuralHash(StructuralHasher("Identifier").Add(id).Hash());
+}
 
 void Identifier::Accept(IAbstractSyntaxTreeVisitor* visitor)
 {
@@ -18,9 +22,9 @@ const SourcePos& Identifier::StartPos() const
     return m_id.start_pos;
 }
 
-std::string Identifier::ToString() const
+const Token& Identifier::Id() const
 {
-    return m_id.lexeme;
+    return m_id;
 }
 
 } // namespace mylang
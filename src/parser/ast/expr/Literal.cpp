@@ -1,5 +1,6 @@
 #include "parser/ast/expr/Literal.h"
 #include "parser/ast/visitor/IAbstractSyntaxTreeVisitor.h"
+#include "parser/ast/StructuralHash.h"
 #include "parser/type/base/PrimitiveType.h"
 
 namespace mylang
@@ -25,7 +26,10 @@ TokenType LiteralToTokenType(const Token& literal)
 Literal::Literal(const Token& literal)
     : m_literal(literal)
     , m_decl_type(CreatePrimiveType(LiteralToTokenType(literal)))
-{}
+{
+    SetNodeKind(AstNodeKind::Literal);
+    SetStructuralHash(StructuralHasher("Literal").Add(literal).Hash());
+}
 
 void Literal::Accept(IAbstractSyntaxTreeVisitor* visitor)
 {
@@ -37,9 +41,9 @@ const SourcePos& Literal::StartPos() const
     return m_literal.start_pos;
 }
 
-std::string Literal::ToString() const
+const Token& Literal::LiteralToken() const
 {
-    return m_literal.lexeme;
+    return m_literal;
 }
 
 const Type& Literal::DeclType() const
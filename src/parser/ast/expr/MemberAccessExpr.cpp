@@ -1,13 +1,16 @@
 #include "parser/ast/expr/MemberAccessExpr.h"
 #include "parser/ast/visitor/IAbstractSyntaxTreeVisitor.h"
-#include <format>
+#include "parser/ast/StructuralHash.h"
 
 namespace mylang
 {
 
-MemberAccessExpr::MemberAccessExpr(std::shared_ptr<Expr> expr, const Token& id)
+MemberAccessExpr::MemberAccessExpr(Expr* expr, const Token& id)
     : m_expr(expr), m_id(id)
-{}
+{
+    SetNodeKind(AstNodeKind::MemberAccessExpr);
+    SetStructuralHash(StructuralHasher("MemberAccessExpr").Add(expr).Add(id).Hash());
+}
 
 void MemberAccessExpr::Accept(IAbstractSyntaxTreeVisitor* visitor)
 {
@@ -19,17 +22,14 @@ const SourcePos& MemberAccessExpr::StartPos() const
     return m_expr->StartPos();
 }
 
-std::string MemberAccessExpr::ToString() const
+Expr* MemberAccessExpr::Struct()
 {
-    return std::format("{}.{}",
-        m_expr->ToString(),
-        m_id.lexeme
-    );
+    return m_expr;
 }
 
-Expr* MemberAccessExpr::Struct()
+const Expr* MemberAccessExpr::Struct() const
 {
-    return m_expr.get();
+    return m_expr;
 }
 
 const Token& MemberAccessExpr::MemberName() const
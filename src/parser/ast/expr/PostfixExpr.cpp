@@ -1,13 +1,16 @@
 #include "parser/ast/expr/PostfixExpr.h"
 #include "parser/ast/visitor/IAbstractSyntaxTreeVisitor.h"
-#include <format>
+#include "parser/ast/StructuralHash.h"
 
 namespace mylang
 {
 
-PostfixExpr::PostfixExpr(const Token& op, std::shared_ptr<Expr> expr)
+PostfixExpr::PostfixExpr(const Token& op, Expr* expr)
     : m_op(op), m_expr(expr)
-{}
+{
+    SetNodeKind(AstNodeKind::PostfixExpr);
+    SetStructuralHash(StructuralHasher("PostfixExpr").Add(op).Add(expr).Hash());
+}
 
 void PostfixExpr::Accept(IAbstractSyntaxTreeVisitor* visitor)
 {
@@ -19,14 +22,6 @@ const SourcePos& PostfixExpr::StartPos() const
     return m_expr->StartPos();
 }
 
-std::string PostfixExpr::ToString() const
-{
-    return std::format("({}{})",
-        m_expr->ToString(),
-        m_op.lexeme
-    );
-}
-
 const Token& PostfixExpr::Operator() const
 {
     return m_op;
@@ -34,7 +29,7 @@ const Token& PostfixExpr::Operator() const
 
 Expr* PostfixExpr::Operand()
 {
-    return m_expr.get();
+    return m_expr;
 }
 
 } // namespace mylang
@@ -1,13 +1,16 @@
 #include "parser/ast/expr/PrefixExpr.h"
 #include "parser/ast/visitor/IAbstractSyntaxTreeVisitor.h"
-#include <format>
+#include "parser/ast/StructuralHash.h"
 
 namespace mylang
 {
 
-PrefixExpr::PrefixExpr(const Token& op, std::shared_ptr<Expr> expr)
+PrefixExpr::PrefixExpr(const Token& op, Expr* expr)
     : m_op(op), m_expr(expr)
-{}
+{
+    SetNodeKind(AstNodeKind::PrefixExpr);
+    SetStructuralHash(StructuralHasher("PrefixExpr").Add(op).Add(expr).Hash());
+}
 
 void PrefixExpr::Accept(IAbstractSyntaxTreeVisitor* visitor)
 {
@@ -19,14 +22,6 @@ const SourcePos& PrefixExpr::StartPos() const
     return m_op.start_pos;
 }
 
-std::string PrefixExpr::ToString() const
-{
-    return std::format("({}{})",
-        m_op.lexeme,
-        m_expr->ToString()
-    );
-}
-
 const Token& PrefixExpr::Operator() const
 {
     return m_op;
@@ -34,7 +29,7 @@ const Token& PrefixExpr::Operator() const
 
 Expr* PrefixExpr::Operand()
 {
-    return m_expr.get();
+    return m_expr;
 }
 
 } // namespace mylang
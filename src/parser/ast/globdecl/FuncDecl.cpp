@@ -1,14 +1,15 @@
 #include "parser/ast/globdecl/FuncDecl.h"
 #include "parser/ast/visitor/IAbstractSyntaxTreeVisitor.h"
+#include "parser/ast/StructuralHash.h"
 #include <ranges>
 
 namespace mylang
 {
 
-std::shared_ptr<FuncType> ConstructFuncType(const Type& return_type, const std::vector<std::shared_ptr<Parameter>>& parameters)
+std::shared_ptr<FuncType> ConstructFuncType(const Type& return_type, const std::vector<Parameter*>& parameters)
 {
     // Callback function that extracts Parameter::type
-    auto extract_type = [](const std::shared_ptr<Parameter>& param){
+    auto extract_type = [](const Parameter* param){
         return param->DeclParamType();
     };
 
@@ -19,14 +20,24 @@ std::shared_ptr<FuncType> ConstructFuncType(const Type& return_type, const std::
     return std::make_shared<FuncType>(param_types, return_type);
 }
 
-FuncDecl::FuncDecl(bool should_export, const Token& name, std::optional<Type> return_type, const std::vector<std::shared_ptr<Parameter>>& parameters, std::shared_ptr<Stmt> body)
+FuncDecl::FuncDecl(bool should_export, const Token& name, std::optional<Type> return_type, const std::vector<Parameter*>& parameters, Stmt* body)
     : m_should_export(should_export)
     , m_name(name)
     , m_return_type(return_type.value_or(CreateVoidType()))
     , m_parameters(parameters)
     , m_body(body)
     , m_type(ConstructFuncType(m_return_type, parameters))
-{}
+{
+    SetNodeKind(AstNodeKind::FuncDecl);
+    SetStructuralHash(StructuralHasher("FuncDecl")
+        .Add(static_cast<uint64_t>(should_export))
+        .Add(name)
+        .Add(m_return_type)
+        .Add(parameters)
+        .Add(body)
+        .Hash()
+    );
+}
 
 void FuncDecl::Accept(IAbstractSyntaxTreeVisitor* visitor)
 {
@@ -58,14 +69,14 @@ const Type& FuncDecl::ReturnType() const
     return m_return_type;
 }
 
-const std::vector<std::shared_ptr<Parameter>>& FuncDecl::Parameters() const
+const std::vector<Parameter*>& FuncDecl::Parameters() const
 {
     return m_parameters;
 }
 
 Stmt* FuncDecl::Body()
 {
-    return m_body.get();
+    return m_body;
 }
 
 } // namespace mylang
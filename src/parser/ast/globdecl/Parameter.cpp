@@ -1,12 +1,16 @@
 #include "parser/ast/globdecl/Parameter.h"
 #include "parser/ast/visitor/IAbstractSyntaxTreeVisitor.h"
+#include "parser/ast/StructuralHash.h"
 
 namespace mylang
 {
 
 Parameter::Parameter(const Token& name, const ParamType& param_type)
     : m_name(name), m_param_type(param_type)
-{}
+{
+    SetNodeKind(AstNodeKind::Parameter);
+    SetStructuralHash(StructuralHasher("Parameter").Add(name).Add(static_cast<uint64_t>(param_type.usage)).Add(param_type.type).Hash());
+}
 
 void Parameter::Accept(IAbstractSyntaxTreeVisitor* visitor)
 {
@@ -1,5 +1,6 @@
 #include "parser/ast/globdecl/StructDecl.h"
 #include "parser/ast/visitor/IAbstractSyntaxTreeVisitor.h"
+#include "parser/ast/StructuralHash.h"
 #include "parser/type/base/StructType.h"
 
 namespace mylang
@@ -10,7 +11,22 @@ StructDecl::StructDecl(bool should_export, const Token& name, const std::vector<
     , m_name(name)
     , m_members(members)
     , m_type(std::make_shared<StructType>(name))
-{}
+{
+    SetNodeKind(AstNodeKind::StructDecl);
+    auto hasher = StructuralHasher("StructDecl");
+    hasher.Add(static_cast<uint64_t>(should_export)).Add(name).Add(static_cast<uint64_t>(members.size()));
+    for (const auto& member : members)
+    {
+        hasher.Add(member.name).Add(member.type);
+    }
+    SetStructuralHash(hasher.Hash());
+
+    m_member_index.reserve(m_members.size());
+    for (size_t i = 0; i < m_members.size(); ++i)
+    {
+        m_member_index.try_emplace(m_members[i].name.lexeme, i);
+    }
+}
 
 void StructDecl::Accept(IAbstractSyntaxTreeVisitor* visitor)
 {
@@ -42,4 +58,14 @@ const std::vector<MemberVariable>& StructDecl::Members() const
     return m_members;
 }
 
+std::optional<size_t> StructDecl::FindMember(std::string_view name) const
+{
+    auto it = m_member_index.find(name);
+    if (it == m_member_index.end())
+    {
+        return {};
+    }
+    return it->second;
+}
+
 } // namespace mylang
@@ -1,12 +1,16 @@
 #include "parser/ast/stmt/CompoundStmt.h"
 #include "parser/ast/visitor/IAbstractSyntaxTreeVisitor.h"
+#include "parser/ast/StructuralHash.h"
 
 namespace mylang
 {
 
-CompoundStmt::CompoundStmt(const std::vector<std::shared_ptr<Stmt>>& statements)
+CompoundStmt::CompoundStmt(const std::vector<Stmt*>& statements)
     : m_statements(statements)
-{}
+{
+    SetNodeKind(AstNodeKind::CompoundStmt);
+    SetStructuralHash(StructuralHasher("CompoundStmt").Add(statements).Hash());
+}
 
 void CompoundStmt::Accept(IAbstractSyntaxTreeVisitor* visitor)
 {
@@ -16,10 +20,12 @@ void CompoundStmt::Accept(IAbstractSyntaxTreeVisitor* visitor)
 const SourcePos& CompoundStmt::StartPos() const
 {
     // TODO: decide which value to return...
-    return {};
+    // Until then, it is an unknown position (0, 0).
+    static const auto unknown_pos = SourcePos{};
+    return unknown_pos;
 }
 
-const std::vector<std::shared_ptr<Stmt>>& CompoundStmt::Statements() const
+const std::vector<Stmt*>& CompoundStmt::Statements() const
 {
     return m_statements;
 }
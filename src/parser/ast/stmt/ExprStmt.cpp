@@ -1,12 +1,16 @@
 #include "parser/ast/stmt/ExprStmt.h"
 #include "parser/ast/visitor/IAbstractSyntaxTreeVisitor.h"
+#include "parser/ast/StructuralHash.h"
 
 namespace mylang
 {
 
-ExprStmt::ExprStmt(std::shared_ptr<Expr> expr)
+ExprStmt::ExprStmt(Expr* expr)
     : m_expr(expr)
-{}
+{
+    SetNodeKind(AstNodeKind::ExprStmt);
+    SetStructuralHash(StructuralHasher("ExprStmt").Add(expr).Hash());
+}
 
 void ExprStmt::Accept(IAbstractSyntaxTreeVisitor* visitor)
 {
@@ -20,7 +24,7 @@ const SourcePos& ExprStmt::StartPos() const
 
 Expr* ExprStmt::Expression()
 {
-    return m_expr.get();
+    return m_expr;
 }
 
 } // namespace mylang
@@ -1,20 +1,24 @@
 #include "parser/ast/stmt/ForStmt.h"
 #include "parser/ast/visitor/IAbstractSyntaxTreeVisitor.h"
+#include "parser/ast/StructuralHash.h"
 
 namespace mylang
 {
 
 ForStmt::ForStmt(
-    std::shared_ptr<Stmt> initializer,
-    std::shared_ptr<Expr> condition,
-    std::shared_ptr<Expr> increment_expr,
-    std::shared_ptr<Stmt> body
+    Stmt* initializer,
+    Expr* condition,
+    Expr* increment_expr,
+    Stmt* body
 )
     : m_initializer(initializer)
     , m_condition(condition)
     , m_increment_expr(increment_expr)
     , m_body(body)
-{}
+{
+    SetNodeKind(AstNodeKind::ForStmt);
+    SetStructuralHash(StructuralHasher("ForStmt").Add(initializer).Add(condition).Add(increment_expr).Add(body).Hash());
+}
 
 void ForStmt::Accept(IAbstractSyntaxTreeVisitor* visitor)
 {
@@ -24,27 +28,29 @@ void ForStmt::Accept(IAbstractSyntaxTreeVisitor* visitor)
 const SourcePos& ForStmt::StartPos() const
 {
     // TODO: decide which value to return
-    return {};
+    // Until then, it is an unknown position (0, 0).
+    static const auto unknown_pos = SourcePos{};
+    return unknown_pos;
 }
 
 Stmt* ForStmt::Initializer()
 {
-    return m_initializer.get();
+    return m_initializer;
 }
 
 Expr* ForStmt::Condition()
 {
-    return m_condition.get();
+    return m_condition;
 }
 
 Expr* ForStmt::IncrementExpr()
 {
-    return m_increment_expr.get();
+    return m_increment_expr;
 }
 
 Stmt* ForStmt::Body()
 {
-    return m_body.get();
+    return m_body;
 }
 
 } // namespace mylang
@@ -1,18 +1,22 @@
 #include "parser/ast/stmt/IfStmt.h"
 #include "parser/ast/visitor/IAbstractSyntaxTreeVisitor.h"
+#include "parser/ast/StructuralHash.h"
 
 namespace mylang
 {
 
 IfStmt::IfStmt(
-    std::shared_ptr<Expr> condition,
-    std::shared_ptr<Stmt> then_branch,
-    std::shared_ptr<Stmt> else_branch
+    Expr* condition,
+    Stmt* then_branch,
+    Stmt* else_branch
 )
     : m_condition(condition)
     , m_then_branch(then_branch)
     , m_else_branch(else_branch)
-{}
+{
+    SetNodeKind(AstNodeKind::IfStmt);
+    SetStructuralHash(StructuralHasher("IfStmt").Add(condition).Add(then_branch).Add(else_branch).Hash());
+}
 
 void IfStmt::Accept(IAbstractSyntaxTreeVisitor* visitor)
 {
@@ -26,17 +30,17 @@ const SourcePos& IfStmt::StartPos() const
 
 Expr* IfStmt::Condition()
 {
-    return m_condition.get();
+    return m_condition;
 }
 
 Stmt* IfStmt::ThenBranch()
 {
-    return m_then_branch.get();
+    return m_then_branch;
 }
 
 Stmt* IfStmt::ElseBranch()
 {
-    return m_else_branch.get();
+    return m_else_branch;
 }
 
 } // namespace mylang
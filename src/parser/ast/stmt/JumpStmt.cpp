@@ -1,13 +1,17 @@
 #include "parser/ast/stmt/JumpStmt.h"
 #include "parser/ast/visitor/IAbstractSyntaxTreeVisitor.h"
+#include "parser/ast/StructuralHash.h"
 
 namespace mylang
 {
 
-JumpStmt::JumpStmt(const Token& instruction, std::shared_ptr<Expr> expr)
+JumpStmt::JumpStmt(const Token& instruction, Expr* expr)
     : m_jump_type(instruction)
     , m_expr(expr)
-{}
+{
+    SetNodeKind(AstNodeKind::JumpStmt);
+    SetStructuralHash(StructuralHasher("JumpStmt").Add(instruction).Add(expr).Hash());
+}
 
 void JumpStmt::Accept(IAbstractSyntaxTreeVisitor* visitor)
 {
@@ -26,7 +30,7 @@ const Token& JumpStmt::JumpType() const
 
 Expr* JumpStmt::ReturnValueExpr()
 {
-    return m_expr.get();
+    return m_expr;
 }
 
 } // namespace mylang
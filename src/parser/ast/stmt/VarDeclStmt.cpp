@@ -1,14 +1,24 @@
 #include "parser/ast/stmt/VarDeclStmt.h"
 #include "parser/ast/visitor/IAbstractSyntaxTreeVisitor.h"
+#include "parser/ast/StructuralHash.h"
 
 namespace mylang
 {
 
-VarDeclStmt::VarDeclStmt(const Token& name, const Type& type, std::shared_ptr<VarInit> initializer)
+VarDeclStmt::VarDeclStmt(const Token& name, const Type& type, VarInit* initializer)
     : m_name(name)
     , m_type(type)
     , m_initializer(initializer)
-{}
+{
+    // Both parts of the node share the same ID, kind and hash,
+    // so that a side table finds the same value through either of them.
+    auto hash = StructuralHasher("VarDeclStmt").Add(name).Add(type).Add(initializer).Hash();
+    Stmt::SetNodeKind(AstNodeKind::VarDeclStmt);
+    Stmt::SetStructuralHash(hash);
+    Decl::SetNodeId(Stmt::NodeId());
+    Decl::SetNodeKind(AstNodeKind::VarDeclStmt);
+    Decl::SetStructuralHash(hash);
+}
 
 void VarDeclStmt::Accept(IAbstractSyntaxTreeVisitor* visitor)
 {
@@ -32,7 +42,7 @@ const Type& VarDeclStmt::DeclType() const
 
 VarInit* VarDeclStmt::Initializer()
 {
-    return m_initializer.get();
+    return m_initializer;
 }
 
 } // namespace mylang
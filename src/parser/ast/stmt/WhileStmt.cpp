@@ -1,13 +1,17 @@
 #include "parser/ast/stmt/WhileStmt.h"
 #include "parser/ast/visitor/IAbstractSyntaxTreeVisitor.h"
+#include "parser/ast/StructuralHash.h"
 
 namespace mylang
 {
 
-WhileStmt::WhileStmt(std::shared_ptr<Expr> condition, std::shared_ptr<Stmt> body)
+WhileStmt::WhileStmt(Expr* condition, Stmt* body)
     : m_condition(condition)
     , m_body(body)
-{}
+{
+    SetNodeKind(AstNodeKind::WhileStmt);
+    SetStructuralHash(StructuralHasher("WhileStmt").Add(condition).Add(body).Hash());
+}
 
 void WhileStmt::Accept(IAbstractSyntaxTreeVisitor* visitor)
 {
@@ -21,12 +25,12 @@ const SourcePos& WhileStmt::StartPos() const
 
 Expr* WhileStmt::Condition()
 {
-    return m_condition.get();
+    return m_condition;
 }
 
 Stmt* WhileStmt::Body()
 {
-    return m_body.get();
+    return m_body;
 }
 
 } // namespace mylang
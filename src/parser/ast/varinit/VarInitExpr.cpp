@@ -1,12 +1,16 @@
 #include "parser/ast/varinit/VarInitExpr.h"
 #include "parser/ast/visitor/IAbstractSyntaxTreeVisitor.h"
+#include "parser/ast/StructuralHash.h"
 
 namespace mylang
 {
 
-VarInitExpr::VarInitExpr(std::shared_ptr<Expr> expr)
+VarInitExpr::VarInitExpr(Expr* expr)
     : m_expr(expr)
-{}
+{
+    SetNodeKind(AstNodeKind::VarInitExpr);
+    SetStructuralHash(StructuralHasher("VarInitExpr").Add(expr).Hash());
+}
 
 void VarInitExpr::Accept(IAbstractSyntaxTreeVisitor* visitor)
 {
@@ -20,7 +24,7 @@ const SourcePos& VarInitExpr::StartPos() const
 
 Expr* VarInitExpr::Expression()
 {
-    return m_expr.get();
+    return m_expr;
 }
 
 } // namespace mylang
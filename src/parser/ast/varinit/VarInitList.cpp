@@ -1,12 +1,16 @@
 #include "parser/ast/varinit/VarInitList.h"
 #include "parser/ast/visitor/IAbstractSyntaxTreeVisitor.h"
+#include "parser/ast/StructuralHash.h"
 
 namespace mylang
 {
 
-VarInitList::VarInitList(const std::vector<std::shared_ptr<VarInit>>& initializer_list)
+VarInitList::VarInitList(const std::vector<VarInit*>& initializer_list)
     : m_initializer_list(initializer_list)
-{}
+{
+    SetNodeKind(AstNodeKind::VarInitList);
+    SetStructuralHash(StructuralHasher("VarInitList").Add(initializer_list).Hash());
+}
 
 void VarInitList::Accept(IAbstractSyntaxTreeVisitor* visitor)
 {
@@ -18,7 +22,7 @@ const SourcePos& VarInitList::StartPos() const
     return m_initializer_list.front()->StartPos();
 }
 
-const std::vector<std::shared_ptr<VarInit>>& VarInitList::InitializerList() const
+const std::vector<VarInit*>& VarInitList::InitializerList() const
 {
     return m_initializer_list;
 }
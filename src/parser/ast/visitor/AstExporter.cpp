@@ -0,0 +1,463 @@
+#include "parser/ast/visitor/AstExporter.h"
+#include "parser/ast/visitor/AstWalker.h"
+#include <charconv>
+#include <streambuf>
+#include <vector>
+
+namespace mylang
+{
+
+std::optional<AstExportFormat> ParseAstExportFormat(std::string_view name)
+{
+    if (name == "json")
+    {
+        return AstExportFormat::JsonLines;
+    }
+    if (name == "bin")
+    {
+        return AstExportFormat::Binary;
+    }
+    return std::nullopt;
+}
+
+// Receives each node and its fields in the order they are written,
+// and encodes them into a stream buffer.
+class AstNodeEncoder
+{
+public:
+    AstNodeEncoder(std::streambuf* buffer)
+        : m_buffer(buffer)
+    {}
+
+    virtual ~AstNodeEncoder() = default;
+
+    // Called at the start of each tree.
+    virtual void BeginTree()
+    {}
+
+    // A node at 'depth' below the root starts, followed by its fields.
+    virtual void BeginNode(AstNodeKind kind, size_t depth, const SourcePos& pos) = 0;
+    virtual void EndFields() = 0;
+
+    // Called after the children of the node.
+    virtual void EndNode() = 0;
+
+    virtual void StringField(std::string_view key, std::string_view value) = 0;
+    virtual void BoolField(std::string_view key, bool value) = 0;
+
+    // A list of 'size' records, each of which is made of fields.
+    virtual void BeginList(std::string_view key, size_t size) = 0;
+    virtual void BeginRecord() = 0;
+    virtual void EndRecord() = 0;
+    virtual void EndList() = 0;
+
+    bool HasFailed() const
+    {
+        return m_has_failed;
+    }
+
+protected:
+    void Put(char c)
+    {
+        if (m_buffer->sputc(c) == std::streambuf::traits_type::eof())
+        {
+            m_has_failed = true;
+        }
+    }
+
+    void Put(std::string_view str)
+    {
+        auto size = static_cast<std::streamsize>(str.size());
+        if (m_buffer->sputn(str.data(), size) != size)
+        {
+            m_has_failed = true;
+        }
+    }
+
+private:
+    std::streambuf* m_buffer;
+    bool m_has_failed = false;
+};
+
+class JsonLinesEncoder : public AstNodeEncoder
+{
+public:
+    using AstNodeEncoder::AstNodeEncoder;
+
+    virtual void BeginTree() override
+    {
+        m_next_id = 0;
+        m_ancestor_ids.clear();
+    }
+
+    virtual void BeginNode(AstNodeKind kind, size_t depth, const SourcePos& pos) override
+    {
+        auto id = m_next_id++;
+        m_ancestor_ids.resize(depth);
+
+        Put("{\"id\":");
+        PutNumber(id);
+        if (depth > 0)
+        {
+            Put(",\"parent\":");
+            PutNumber(m_ancestor_ids.back());
+        }
+        Put(",\"kind\":\"");
+        Put(AstNodeKindName(kind));
+        Put("\",\"line\":");
+        PutNumber(pos.line);
+        Put(",\"col\":");
+        PutNumber(pos.column);
+
+        m_ancestor_ids.push_back(id);
+    }
+
+    virtual void EndFields() override
+    {
+        Put("}\n");
+    }
+
+    virtual void EndNode() override
+    {}
+
+    virtual void StringField(std::string_view key, std::string_view value) override
+    {
+        PutKey(key);
+        PutString(value);
+    }
+
+    virtual void BoolField(std::string_view key, bool value) override
+    {
+        PutKey(key);
+        Put(value ? "true" : "false");
+    }
+
+    virtual void BeginList(std::string_view key, size_t size) override
+    {
+        PutKey(key);
+        Put('[');
+        m_is_first_record = true;
+    }
+
+    virtual void BeginRecord() override
+    {
+        if (!m_is_first_record)
+        {
+            Put(',');
+        }
+        m_is_first_record = false;
+        m_is_first_field = true;
+        Put('{');
+    }
+
+    virtual void EndRecord() override
+    {
+        Put('}');
+        m_is_first_field = false;
+    }
+
+    virtual void EndList() override
+    {
+        Put(']');
+    }
+
+private:
+    // Fields of a node follow "col", but the first field of a record doesn't need a comma.
+    void PutKey(std::string_view key)
+    {
+        if (!m_is_first_field)
+        {
+            Put(',');
+        }
+        m_is_first_field = false;
+
+        Put('"');
+        Put(key);
+        Put("\":");
+    }
+
+    void PutNumber(long long value)
+    {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        Put(std::string_view(digits, result.ptr - digits));
+    }
+
+    // Escapes quotes, backslashes, and control characters.
+    // Other bytes are written as they are, so UTF-8 stays intact.
+    void PutString(std::string_view value)
+    {
+        static const char hex_digits[] = "0123456789abcdef";
+
+        Put('"');
+        auto run_start = size_t{0};
+        for (size_t i = 0; i < value.size(); ++i)
+        {
+            auto c = static_cast<unsigned char>(value[i]);
+            if (c != '"' && c != '\\' && c >= 0x20)
+            {
+                continue;
+            }
+
+            Put(value.substr(run_start, i - run_start));
+            run_start = i + 1;
+            switch (c)
+            {
+            case '"': Put("\\\""); break;
+            case '\\': Put("\\\\"); break;
+            case '\n': Put("\\n"); break;
+            case '\r': Put("\\r"); break;
+            case '\t': Put("\\t"); break;
+            default:
+                Put("\\u00");
+                Put(hex_digits[c >> 4]);
+                Put(hex_digits[c & 0xF]);
+                break;
+            }
+        }
+        Put(value.substr(run_start));
+        Put('"');
+    }
+
+    uint32_t m_next_id = 0;
+
+    // IDs of the nodes on the path from the root.
+    std::vector<uint32_t> m_ancestor_ids;
+
+    bool m_is_first_field = false;
+    bool m_is_first_record = false;
+};
+
+class BinaryEncoder : public AstNodeEncoder
+{
+public:
+    using AstNodeEncoder::AstNodeEncoder;
+
+    static const uint8_t FormatVersion = 1;
+
+    virtual void BeginTree() override
+    {
+        if (!m_has_header)
+        {
+            Put("MYAST");
+            Put(static_cast<char>(FormatVersion));
+            m_has_header = true;
+        }
+    }
+
+    virtual void BeginNode(AstNodeKind kind, size_t depth, const SourcePos& pos) override
+    {
+        Put(static_cast<char>(static_cast<uint8_t>(kind) + 1));
+        PutNumber(static_cast<uint32_t>(pos.line));
+        PutNumber(static_cast<uint32_t>(pos.column));
+    }
+
+    virtual void EndFields() override
+    {}
+
+    virtual void EndNode() override
+    {
+        Put('\0');
+    }
+
+    virtual void StringField(std::string_view key, std::string_view value) override
+    {
+        PutNumber(value.size());
+        Put(value);
+    }
+
+    virtual void BoolField(std::string_view key, bool value) override
+    {
+        Put(static_cast<char>(value));
+    }
+
+    virtual void BeginList(std::string_view key, size_t size) override
+    {
+        PutNumber(size);
+    }
+
+    virtual void BeginRecord() override
+    {}
+
+    virtual void EndRecord() override
+    {}
+
+    virtual void EndList() override
+    {}
+
+private:
+    // Unsigned LEB128: 7 bits at a time from the lowest,
+    // with the high bit set on every byte but the last.
+    void PutNumber(uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            Put(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        Put(static_cast<char>(value));
+    }
+
+    bool m_has_header = false;
+};
+
+// Hands every node and its fields over to the encoder.
+class AstExportWalker : public AstWalker<AstExportWalker>
+{
+public:
+    using AstWalker<AstExportWalker>::PreVisit;
+
+    AstExportWalker(AstNodeEncoder& encoder)
+        : m_encoder(encoder)
+    {}
+
+    bool PreVisitNode(IAbstractSyntaxTree* node)
+    {
+        m_encoder.BeginNode(node->NodeKind(), Depth(), node->StartPos());
+        AstWalker<AstExportWalker>::PreVisitNode(node);
+        m_encoder.EndFields();
+        return true;
+    }
+
+    void PostVisitNode(IAbstractSyntaxTree*)
+    {
+        m_encoder.EndNode();
+    }
+
+    bool PreVisit(Module* node)
+    {
+        m_encoder.StringField("name", node->ModuleName().lexeme);
+        m_encoder.BeginList("imports", node->ImportList().size());
+        for (const auto& import_info : node->ImportList())
+        {
+            m_encoder.BeginRecord();
+            m_encoder.StringField("name", import_info.name.lexeme);
+            m_encoder.BoolField("export", import_info.should_export);
+            m_encoder.EndRecord();
+        }
+        m_encoder.EndList();
+        return true;
+    }
+
+    bool PreVisit(Parameter* node)
+    {
+        m_encoder.StringField("name", node->Name().lexeme);
+        m_encoder.StringField("type", node->DeclParamType().ToString());
+        return true;
+    }
+
+    bool PreVisit(FuncDecl* node)
+    {
+        m_encoder.StringField("name", node->Name().lexeme);
+        m_encoder.BoolField("export", node->ShouldExport());
+        m_encoder.StringField("return_type", node->ReturnType().ToString());
+        return true;
+    }
+
+    bool PreVisit(StructDecl* node)
+    {
+        m_encoder.StringField("name", node->Name().lexeme);
+        m_encoder.BoolField("export", node->ShouldExport());
+        m_encoder.BeginList("members", node->Members().size());
+        for (const auto& member : node->Members())
+        {
+            m_encoder.BeginRecord();
+            m_encoder.StringField("name", member.name.lexeme);
+            m_encoder.StringField("type", member.type.ToString());
+            m_encoder.EndRecord();
+        }
+        m_encoder.EndList();
+        return true;
+    }
+
+    // Every child but the body is optional.
+    bool PreVisit(ForStmt* node)
+    {
+        m_encoder.BoolField("has_initializer", node->Initializer() != nullptr);
+        m_encoder.BoolField("has_condition", node->Condition() != nullptr);
+        m_encoder.BoolField("has_increment", node->IncrementExpr() != nullptr);
+        return true;
+    }
+
+    bool PreVisit(JumpStmt* node)
+    {
+        m_encoder.StringField("jump", node->JumpType().lexeme);
+        return true;
+    }
+
+    bool PreVisit(VarDeclStmt* node)
+    {
+        m_encoder.StringField("name", node->Name().lexeme);
+        m_encoder.StringField("type", node->DeclType().ToString());
+        return true;
+    }
+
+    bool PreVisit(BinaryExpr* node)
+    {
+        m_encoder.StringField("op", node->Operator().lexeme);
+        return true;
+    }
+
+    bool PreVisit(Identifier* node)
+    {
+        m_encoder.StringField("name", node->Id().lexeme);
+        return true;
+    }
+
+    bool PreVisit(Literal* node)
+    {
+        m_encoder.StringField("value", node->LiteralToken().lexeme);
+        m_encoder.StringField("type", node->DeclType().ToString());
+        return true;
+    }
+
+    bool PreVisit(MemberAccessExpr* node)
+    {
+        m_encoder.StringField("member", node->MemberName().lexeme);
+        return true;
+    }
+
+    bool PreVisit(PostfixExpr* node)
+    {
+        m_encoder.StringField("op", node->Operator().lexeme);
+        return true;
+    }
+
+    bool PreVisit(PrefixExpr* node)
+    {
+        m_encoder.StringField("op", node->Operator().lexeme);
+        return true;
+    }
+
+private:
+    AstNodeEncoder& m_encoder;
+};
+
+std::unique_ptr<AstNodeEncoder> CreateEncoder(std::streambuf* buffer, AstExportFormat format)
+{
+    if (format == AstExportFormat::Binary)
+    {
+        return std::make_unique<BinaryEncoder>(buffer);
+    }
+    return std::make_unique<JsonLinesEncoder>(buffer);
+}
+
+AstExporter::AstExporter(std::ostream& output_stream, AstExportFormat format)
+    : m_output_stream(output_stream)
+    , m_encoder(CreateEncoder(output_stream.rdbuf(), format))
+{}
+
+AstExporter::~AstExporter() = default;
+
+void AstExporter::Export(IAbstractSyntaxTree* ast)
+{
+    m_encoder->BeginTree();
+    AstExportWalker(*m_encoder).Walk(ast);
+
+    if (m_encoder->HasFailed())
+    {
+        m_output_stream.setstate(std::ios::badbit);
+    }
+}
+
+} // namespace mylang
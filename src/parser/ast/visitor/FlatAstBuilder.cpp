@@ -0,0 +1,289 @@
+#include "parser/ast/visitor/FlatAstBuilder.h"
+#include "parser/ast/Module.h"
+#include "parser/ast/globdecl/FuncDecl.h"
+#include "parser/ast/globdecl/StructDecl.h"
+
+#include "parser/ast/stmt/CompoundStmt.h"
+#include "parser/ast/stmt/IfStmt.h"
+#include "parser/ast/stmt/ForStmt.h"
+#include "parser/ast/stmt/WhileStmt.h"
+#include "parser/ast/stmt/JumpStmt.h"
+#include "parser/ast/stmt/VarDeclStmt.h"
+#include "parser/ast/stmt/ExprStmt.h"
+
+#include "parser/ast/varinit/VarInitExpr.h"
+#include "parser/ast/varinit/VarInitList.h"
+
+#include "parser/ast/expr/ArrayAccessExpr.h"
+#include "parser/ast/expr/BinaryExpr.h"
+#include "parser/ast/expr/FuncCallExpr.h"
+#include "parser/ast/expr/Identifier.h"
+#include "parser/ast/expr/Literal.h"
+#include "parser/ast/expr/MemberAccessExpr.h"
+#include "parser/ast/expr/PostfixExpr.h"
+#include "parser/ast/expr/PrefixExpr.h"
+#include <utility>
+
+namespace mylang
+{
+
+void FlatAstBuilder::Visit(Module* node)
+{
+    auto id = BeginNode(FlatNodeKind::Module, node);
+    m_ast.SetToken(id, node->ModuleName());
+    m_ast.SetImportList(id, node->ImportList());
+
+    for (const auto& decl : node->Declarations())
+    {
+        decl->Accept(this);
+    }
+    EndNode();
+}
+
+void FlatAstBuilder::Visit(Parameter* node)
+{
+    auto id = BeginNode(FlatNodeKind::Parameter, node);
+    m_ast.SetToken(id, node->Name());
+    m_ast.SetParamType(id, node->DeclParamType());
+    EndNode();
+}
+
+void FlatAstBuilder::Visit(FuncDecl* node)
+{
+    auto id = BeginNode(FlatNodeKind::FuncDecl, node);
+    m_ast.SetToken(id, node->Name());
+    m_ast.SetType(id, node->ReturnType());
+    if (node->ShouldExport())
+    {
+        m_ast.AddFlags(id, FlatNodeExport);
+    }
+
+    for (const auto& param : node->Parameters())
+    {
+        param->Accept(this);
+    }
+    node->Body()->Accept(this);
+    EndNode();
+}
+
+void FlatAstBuilder::Visit(StructDecl* node)
+{
+    auto id = BeginNode(FlatNodeKind::StructDecl, node);
+    m_ast.SetToken(id, node->Name());
+    m_ast.SetMembers(id, node->Members());
+    if (node->ShouldExport())
+    {
+        m_ast.AddFlags(id, FlatNodeExport);
+    }
+    EndNode();
+}
+
+void FlatAstBuilder::Visit(CompoundStmt* node)
+{
+    BeginNode(FlatNodeKind::CompoundStmt, node);
+    for (const auto& stmt : node->Statements())
+    {
+        stmt->Accept(this);
+    }
+    EndNode();
+}
+
+void FlatAstBuilder::Visit(IfStmt* node)
+{
+    auto id = BeginNode(FlatNodeKind::IfStmt, node);
+    node->Condition()->Accept(this);
+    node->ThenBranch()->Accept(this);
+    if (auto else_branch = node->ElseBranch())
+    {
+        m_ast.AddFlags(id, FlatNodeHasElse);
+        else_branch->Accept(this);
+    }
+    EndNode();
+}
+
+void FlatAstBuilder::Visit(ForStmt* node)
+{
+    auto id = BeginNode(FlatNodeKind::ForStmt, node);
+    if (auto initializer = node->Initializer())
+    {
+        m_ast.AddFlags(id, FlatNodeHasInitializer);
+        initializer->Accept(this);
+    }
+    if (auto condition = node->Condition())
+    {
+        m_ast.AddFlags(id, FlatNodeHasCondition);
+        condition->Accept(this);
+    }
+    if (auto increment = node->IncrementExpr())
+    {
+        m_ast.AddFlags(id, FlatNodeHasIncrement);
+        increment->Accept(this);
+    }
+    node->Body()->Accept(this);
+    EndNode();
+}
+
+void FlatAstBuilder::Visit(WhileStmt* node)
+{
+    BeginNode(FlatNodeKind::WhileStmt, node);
+    node->Condition()->Accept(this);
+    node->Body()->Accept(this);
+    EndNode();
+}
+
+void FlatAstBuilder::Visit(JumpStmt* node)
+{
+    auto id = BeginNode(FlatNodeKind::JumpStmt, node);
+    m_ast.SetToken(id, node->JumpType());
+    if (auto ret = node->ReturnValueExpr())
+    {
+        m_ast.AddFlags(id, FlatNodeHasReturnValue);
+        ret->Accept(this);
+    }
+    EndNode();
+}
+
+void FlatAstBuilder::Visit(VarDeclStmt* node)
+{
+    // NOTE: VarDeclStmt is both Stmt and Decl, so its Stmt part is recorded.
+    auto id = BeginNode(FlatNodeKind::VarDeclStmt, static_cast<Stmt*>(node));
+    m_ast.SetToken(id, node->Name());
+    m_ast.SetType(id, node->DeclType());
+    if (auto initializer = node->Initializer())
+    {
+        m_ast.AddFlags(id, FlatNodeHasInitializer);
+        initializer->Accept(this);
+    }
+    EndNode();
+}
+
+void FlatAstBuilder::Visit(ExprStmt* node)
+{
+    BeginNode(FlatNodeKind::ExprStmt, node);
+    node->Expression()->Accept(this);
+    EndNode();
+}
+
+void FlatAstBuilder::Visit(VarInitExpr* node)
+{
+    BeginNode(FlatNodeKind::VarInitExpr, node);
+    node->Expression()->Accept(this);
+    EndNode();
+}
+
+void FlatAstBuilder::Visit(VarInitList* node)
+{
+    BeginNode(FlatNodeKind::VarInitList, node);
+    for (auto list_elem : node->InitializerList())
+    {
+        list_elem->Accept(this);
+    }
+    EndNode();
+}
+
+void FlatAstBuilder::Visit(ArrayAccessExpr* node)
+{
+    BeginNode(FlatNodeKind::ArrayAccessExpr, node);
+    node->Operand()->Accept(this);
+    node->Index()->Accept(this);
+    EndNode();
+}
+
+void FlatAstBuilder::Visit(BinaryExpr* node)
+{
+    auto id = BeginNode(FlatNodeKind::BinaryExpr, node);
+    m_ast.SetToken(id, node->Operator());
+    node->LeftHandOperand()->Accept(this);
+    node->RightHandOperand()->Accept(this);
+    EndNode();
+}
+
+void FlatAstBuilder::Visit(FuncCallExpr* node)
+{
+    BeginNode(FlatNodeKind::FuncCallExpr, node);
+    node->Function()->Accept(this);
+    for (const auto& arg : node->ArgumentList())
+    {
+        arg->Accept(this);
+    }
+    EndNode();
+}
+
+void FlatAstBuilder::Visit(Identifier* node)
+{
+    auto id = BeginNode(FlatNodeKind::Identifier, node);
+    m_ast.SetToken(id, node->Id());
+    EndNode();
+}
+
+void FlatAstBuilder::Visit(Literal* node)
+{
+    auto id = BeginNode(FlatNodeKind::Literal, node);
+    m_ast.SetToken(id, node->LiteralToken());
+    m_ast.SetType(id, node->DeclType());
+    EndNode();
+}
+
+void FlatAstBuilder::Visit(MemberAccessExpr* node)
+{
+    auto id = BeginNode(FlatNodeKind::MemberAccessExpr, node);
+    m_ast.SetToken(id, node->MemberName());
+    node->Struct()->Accept(this);
+    EndNode();
+}
+
+void FlatAstBuilder::Visit(PostfixExpr* node)
+{
+    auto id = BeginNode(FlatNodeKind::PostfixExpr, node);
+    m_ast.SetToken(id, node->Operator());
+    node->Operand()->Accept(this);
+    EndNode();
+}
+
+void FlatAstBuilder::Visit(PrefixExpr* node)
+{
+    auto id = BeginNode(FlatNodeKind::PrefixExpr, node);
+    m_ast.SetToken(id, node->Operator());
+    node->Operand()->Accept(this);
+    EndNode();
+}
+
+FlatAst FlatAstBuilder::Release()
+{
+    m_open_nodes.clear();
+    return std::exchange(m_ast, FlatAst{});
+}
+
+FlatNodeId FlatAstBuilder::BeginNode(FlatNodeKind kind, IAbstractSyntaxTree* source)
+{
+    auto parent = InvalidFlatNodeId;
+    auto previous_sibling = InvalidFlatNodeId;
+    if (!m_open_nodes.empty())
+    {
+        parent = m_open_nodes.back().node;
+        previous_sibling = m_open_nodes.back().last_child;
+    }
+
+    auto id = m_ast.AddNode(kind, parent, previous_sibling, source);
+    if (!m_open_nodes.empty())
+    {
+        m_open_nodes.back().last_child = id;
+    }
+    m_open_nodes.push_back({id, InvalidFlatNodeId});
+
+    return id;
+}
+
+void FlatAstBuilder::EndNode()
+{
+    m_open_nodes.pop_back();
+}
+
+FlatAst CreateFlatAst(IAbstractSyntaxTree* ast)
+{
+    auto builder = FlatAstBuilder();
+    ast->Accept(&builder);
+    return builder.Release();
+}
+
+} // namespace mylang
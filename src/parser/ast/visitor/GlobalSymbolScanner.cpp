@@ -9,10 +9,32 @@ GlobalSymbolScanner::GlobalSymbolScanner(ProgramEnvironment& environment)
     : m_environment(environment)
 {}
 
+std::string_view GlobalSymbolScanner::Name() const
+{
+    return "global-symbol-scan";
+}
+
+AstNodeKindSet GlobalSymbolScanner::Interests() const
+{
+    return MakeAstNodeKindSet({AstNodeKind::Module});
+}
+
+void GlobalSymbolScanner::Enter(IAbstractSyntaxTree* node)
+{
+    node->Accept(this);
+}
+
+void GlobalSymbolScanner::Finish()
+{
+    // Global symbols don't change from here on,
+    // so a module that imports a missing one can be reported.
+    m_environment.ValidateModuleDependency();
+    m_environment.Freeze();
+}
+
 void GlobalSymbolScanner::Visit(Module* node)
 {
-    m_module_name = node->ModuleName().lexeme;
-    m_environment.AddModuleDeclaration(node);
+    m_module = m_environment.AddModuleDeclaration(node);
 
     for (const auto& decl : node->Declarations())
     {
@@ -22,12 +44,12 @@ void GlobalSymbolScanner::Visit(Module* node)
 
 void GlobalSymbolScanner::Visit(FuncDecl* node)
 {
-    m_environment.AddSymbol(m_module_name, node, node->ShouldExport());
+    m_environment.AddSymbol(m_module, node, node->ShouldExport());
 }
 
 void GlobalSymbolScanner::Visit(StructDecl* node)
 {
-    m_environment.AddSymbol(m_module_name, node, node->ShouldExport());
+    m_environment.AddSymbol(m_module, node, node->ShouldExport());
 }
 
 } // namespace mylang
@@ -1,8 +1,4 @@
 #include "parser/ast/visitor/JumpStmtUsageChecker.h"
-#include "parser/ast/Module.h"
-#include "parser/ast/globdecl/FuncDecl.h"
-#include "parser/ast/stmt/IfStmt.h"
-#include "parser/ast/stmt/CompoundStmt.h"
 #include "parser/ast/stmt/JumpStmt.h"
 #include "parser/SemanticError.h"
 #include <format>
@@ -10,42 +6,28 @@
 namespace mylang
 {
 
-void JumpStmtUsageChecker::Visit(Module* node)
+std::string_view JumpStmtUsageChecker::Name() const
 {
-    for (const auto& decl : node->Declarations())
-    {
-        decl->Accept(this);
-    }
+    return "jump-stmt-usage";
 }
 
-void JumpStmtUsageChecker::Visit(FuncDecl* node)
+AstNodeKindSet JumpStmtUsageChecker::Interests() const
 {
-    node->Body()->Accept(this);
-}
-
-void JumpStmtUsageChecker::Visit(IfStmt* node)
-{
-    node->ThenBranch()->Accept(this);
-    if (auto else_branch = node->ElseBranch())
-    {
-        else_branch->Accept(this);
-    }
+    return MakeAstNodeKindSet({AstNodeKind::ForStmt, AstNodeKind::WhileStmt, AstNodeKind::JumpStmt});
 }
 
-void JumpStmtUsageChecker::Visit(CompoundStmt* node)
+void JumpStmtUsageChecker::Enter(IAbstractSyntaxTree* node)
 {
-    for (const auto& stmt : node->Statements())
+    if (node->NodeKind() != AstNodeKind::JumpStmt)
     {
-        stmt->Accept(this);
+        ++m_loop_depth;
+        return;
     }
-}
 
-void JumpStmtUsageChecker::Visit(JumpStmt* node)
-{
     // We only need to check "break" and "continue".
     // Return statements can be used everywhere...
-    auto jump_token = node->JumpType();
-    if (jump_token.type != TokenType::Return)
+    const auto& jump_token = static_cast<JumpStmt*>(node)->JumpType();
+    if (jump_token.type != TokenType::Return && m_loop_depth == 0)
     {
         // Generate exception if "break" or "continue" is used outside a loop.
         auto message = std::format("jump statement \"{}\" cannot be used outside a loop",
@@ -55,4 +37,12 @@ void JumpStmtUsageChecker::Visit(JumpStmt* node)
     }
 }
 
-} // namespace mylang
\ No newline at end of file
+void JumpStmtUsageChecker::Leave(IAbstractSyntaxTree* node)
+{
+    if (node->NodeKind() != AstNodeKind::JumpStmt)
+    {
+        --m_loop_depth;
+    }
+}
+
+} // namespace mylang
@@ -0,0 +1,205 @@
+#include "parser/ast/visitor/NameBinder.h"
+#include "parser/type/base/StructType.h"
+#include "parser/type/base/FuncType.h"
+
+namespace mylang
+{
+
+NameBinder::NameBinder(const ProgramEnvironment& environment, NameBindings& bindings)
+    : m_environment(environment)
+    , m_bindings(bindings)
+{}
+
+std::string_view NameBinder::Name() const
+{
+    return "name-binding";
+}
+
+std::vector<std::string_view> NameBinder::Prerequisites() const
+{
+    return {"global-symbol-scan"};
+}
+
+bool NameBinder::IsWalker() const
+{
+    return true;
+}
+
+void NameBinder::Walk(IAbstractSyntaxTree* root, IAstNodeHooks* hooks)
+{
+    m_hooks = hooks;
+    try
+    {
+        AstWalker<NameBinder>::Walk(root);
+    }
+    catch(...)
+    {
+        m_hooks = nullptr;
+        throw;
+    }
+    m_hooks = nullptr;
+}
+
+void NameBinder::Visit(Module* node)
+{
+    AstWalker<NameBinder>::Walk(node);
+}
+
+void NameBinder::BindDeclaration(ModuleHandle module, GlobalDecl* decl)
+{
+    // Same as entering the module, without binding the other declarations.
+    m_context_module = module;
+    m_local_scopes = SymbolTable();
+    AstWalker<NameBinder>::Walk(decl);
+}
+
+bool NameBinder::PreVisitNode(IAbstractSyntaxTree* node)
+{
+    if (m_hooks && Depth() > 0)
+    {
+        m_hooks->Enter(node);
+    }
+    return AstWalker<NameBinder>::PreVisitNode(node);
+}
+
+void NameBinder::PostVisitNode(IAbstractSyntaxTree* node)
+{
+    AstWalker<NameBinder>::PostVisitNode(node);
+    if (m_hooks && Depth() > 0)
+    {
+        m_hooks->Leave(node);
+    }
+}
+
+bool NameBinder::PreVisit(Module* node)
+{
+    m_context_module = m_environment.GetModuleHandle(node->ModuleName().lexeme);
+
+    // Start over, in case the last walk was left in a scope by an error.
+    m_local_scopes = SymbolTable();
+    return true;
+}
+
+std::optional<Symbol> NameBinder::FindVisibleSymbol(std::string_view name) const
+{
+    if (auto symbol = m_local_scopes.FindSymbol(name))
+    {
+        return symbol;
+    }
+    return m_environment.TryFindSymbol(m_context_module, name);
+}
+
+void NameBinder::BindStructTypes(const Type& type)
+{
+    if (auto struct_type = dynamic_cast<const StructType*>(type.BaseType()))
+    {
+        // The name may refer to something other than a struct, which leaves the type unbound.
+        auto symbol = FindVisibleSymbol(struct_type->TypeToken().lexeme);
+        auto declaration = symbol ? dynamic_cast<const StructDecl*>(symbol->declaration) : nullptr;
+        struct_type->BindDeclaration(declaration);
+    }
+    else if (auto func_type = dynamic_cast<const FuncType*>(type.BaseType()))
+    {
+        for (const auto& param_type : func_type->ParamTypes())
+        {
+            BindStructTypes(param_type.type);
+        }
+        BindStructTypes(func_type->ReturnType());
+    }
+}
+
+bool NameBinder::PreVisit(FuncDecl* node)
+{
+    // The return type is resolved in the module's scope.
+    // Note: parameter types are bound on child nodes.
+    BindStructTypes(node->ReturnType());
+
+    // Parameters and the body are visited in the function's scope.
+    m_local_scopes.OpenScope();
+    return true;
+}
+
+void NameBinder::PostVisit(FuncDecl* node)
+{
+    m_local_scopes.CloseScope();
+}
+
+bool NameBinder::PreVisit(Parameter* node)
+{
+    BindStructTypes(node->DeclType());
+    m_local_scopes.AddSymbol(node, false);
+    return true;
+}
+
+bool NameBinder::PreVisit(StructDecl* node)
+{
+    // A struct type declared here names this struct.
+    static_cast<const StructType*>(node->DeclType().BaseType())->BindDeclaration(node);
+
+    for (const auto& member : node->Members())
+    {
+        BindStructTypes(member.type);
+    }
+    return true;
+}
+
+bool NameBinder::PreVisit(CompoundStmt* node)
+{
+    m_local_scopes.OpenScope();
+    return true;
+}
+
+void NameBinder::PostVisit(CompoundStmt* node)
+{
+    m_local_scopes.CloseScope();
+}
+
+// Each branch is visited in its own scope.
+bool NameBinder::BeforeChild(IfStmt* node, IAbstractSyntaxTree* child)
+{
+    if (child != node->Condition())
+    {
+        m_local_scopes.OpenScope();
+    }
+    return true;
+}
+
+void NameBinder::AfterChild(IfStmt* node, IAbstractSyntaxTree* child)
+{
+    if (child != node->Condition())
+    {
+        m_local_scopes.CloseScope();
+    }
+}
+
+bool NameBinder::PreVisit(ForStmt* node)
+{
+    m_local_scopes.OpenScope();
+    return true;
+}
+
+void NameBinder::PostVisit(ForStmt* node)
+{
+    m_local_scopes.CloseScope();
+}
+
+bool NameBinder::PreVisit(VarDeclStmt* node)
+{
+    // The type is resolved before the variable itself can hide a struct with the same name.
+    BindStructTypes(node->DeclType());
+    return true;
+}
+
+void NameBinder::PostVisit(VarDeclStmt* node)
+{
+    // The variable is visible only after its initializer.
+    m_local_scopes.AddSymbol(node, false);
+}
+
+void NameBinder::PostVisit(Identifier* node)
+{
+    auto symbol = FindVisibleSymbol(node->Id().lexeme);
+    m_bindings.BindIdentifier(node, symbol ? symbol->declaration : nullptr);
+}
+
+} // namespace mylang
@@ -31,37 +31,228 @@
 #include "parser/SemanticError.h"
 
 #include <format>
+#include <optional>
+#include <utility>
 
 namespace mylang
 {
 
-TypeChecker::TypeChecker(ProgramEnvironment& environment)
-    : m_environment(environment)
+TypeChecker::TypeChecker(NameBindings& bindings, DiagnosticSink* diagnostics)
+    : m_bindings(bindings)
+    , m_member_bindings(&bindings)
+    , m_diagnostics(diagnostics)
 {}
 
+std::string_view TypeChecker::Name() const
+{
+    return "type-check";
+}
+
+std::vector<std::string_view> TypeChecker::Prerequisites() const
+{
+    return {"name-binding"};
+}
+
+bool TypeChecker::IsWalker() const
+{
+    return true;
+}
+
+void TypeChecker::Walk(IAbstractSyntaxTree* root, IAstNodeHooks* hooks)
+{
+    m_hooks = hooks;
+    try
+    {
+        m_failures_on_entry.clear();
+        AstWalker<TypeChecker>::Walk(root);
+    }
+    catch(...)
+    {
+        m_hooks = nullptr;
+        throw;
+    }
+    m_hooks = nullptr;
+    ThrowFirstError();
+}
+
 void TypeChecker::Visit(Module* node)
 {
-    m_context_module_name = node->ModuleName().lexeme;
+    m_failures_on_entry.clear();
+    AstWalker<TypeChecker>::Walk(node);
+    ThrowFirstError();
+}
+
+void TypeChecker::CheckDeclaration(GlobalDecl* decl)
+{
+    m_failures_on_entry.clear();
+    AstWalker<TypeChecker>::Walk(decl);
+    ThrowFirstError();
+}
+
+DiagnosticSink& TypeChecker::Diagnostics()
+{
+    return m_diagnostics ? *m_diagnostics : m_own_diagnostics;
+}
+
+void TypeChecker::ThrowFirstError()
+{
+    if (m_diagnostics || !m_own_diagnostics.HasErrors())
+    {
+        return;
+    }
+
+    auto first_error = m_own_diagnostics.Diagnostics().front();
+    m_own_diagnostics.Clear();
+    throw SemanticError(first_error.where, first_error.Message());
+}
+
+size_t TypeChecker::NumFailures() const
+{
+    const auto& diagnostics = m_diagnostics ? *m_diagnostics : m_own_diagnostics;
+    return diagnostics.NumReported() + m_num_silent_failures;
+}
+
+// A top-level declaration, along with the index of its module.
+struct PendingDecl
+{
+    size_t module_index;
+    GlobalDecl* decl;
+};
+
+// What a task of TypeChecker::CheckConcurrently() found.
+struct CheckedDeclChunk
+{
+    SideTable<ExprTrait> expr_traits;
+    NameBindings member_bindings;
+    DiagnosticSink diagnostics;
+
+    // The first declaration of the chunk that failed, if any.
+    std::optional<size_t> failed_decl;
+};
+
+void TypeChecker::CheckConcurrently(
+    const std::vector<IAbstractSyntaxTree*>& modules,
+    ThreadPool& thread_pool,
+    const std::function<void(size_t)>& on_error
+)
+{
+    auto decls = std::vector<PendingDecl>{};
+    for (size_t i = 0; i < modules.size(); ++i)
+    {
+        for (auto decl : static_cast<Module*>(modules[i])->Declarations())
+        {
+            decls.push_back(PendingDecl{i, decl});
+        }
+    }
+    if (decls.empty())
+    {
+        return;
+    }
+
+    // A few chunks per thread, so that a chunk of large functions doesn't hold up the others.
+    auto num_chunks = std::min<size_t>(decls.size(), thread_pool.NumThreads() * 4);
+    auto futures = std::vector<std::future<CheckedDeclChunk>>{};
+    for (size_t c = 0; c < num_chunks; ++c)
+    {
+        auto begin = decls.size() * c / num_chunks;
+        auto end = decls.size() * (c + 1) / num_chunks;
+        futures.push_back(thread_pool.Submit([this, &decls, begin, end]() {
+            // Without a sink, only the first error is needed.
+            auto chunk = CheckedDeclChunk{
+                .expr_traits = SideTable<ExprTrait>(),
+                .member_bindings = NameBindings(),
+                .diagnostics = DiagnosticSink(m_diagnostics ? m_diagnostics->ErrorLimit() : 1),
+                .failed_decl = std::nullopt,
+            };
+            auto checker = TypeChecker(*m_member_bindings, &chunk.diagnostics);
+            checker.m_member_bindings = &chunk.member_bindings;
+            for (auto i = begin; i < end && !chunk.diagnostics.IsLimitReached(); ++i)
+            {
+                checker.CheckDeclaration(decls[i].decl);
+                if (!chunk.failed_decl && chunk.diagnostics.HasErrors())
+                {
+                    chunk.failed_decl = i;
+                }
+            }
+            chunk.expr_traits = checker.TakeExprTraits();
+            return chunk;
+        }));
+    }
+
+    // Every task refers to 'decls', so all of them should finish before anything is reported.
+    auto chunks = std::vector<CheckedDeclChunk>{};
+    for (auto& future : futures)
+    {
+        chunks.push_back(thread_pool.Wait(future));
+    }
+
+    for (auto& chunk : chunks)
+    {
+        m_expr_traits.Merge(std::move(chunk.expr_traits));
+        m_member_bindings->Merge(std::move(chunk.member_bindings));
+        if (m_diagnostics)
+        {
+            m_diagnostics->Merge(std::move(chunk.diagnostics));
+        }
+        else if (chunk.failed_decl)
+        {
+            if (on_error)
+            {
+                on_error(decls[*chunk.failed_decl].module_index);
+            }
+            const auto& first_error = chunk.diagnostics.Diagnostics().front();
+            throw SemanticError(first_error.where, first_error.Message());
+        }
+    }
+}
+
+bool TypeChecker::PreVisitNode(IAbstractSyntaxTree* node)
+{
+    if (m_hooks && Depth() > 0)
+    {
+        m_hooks->Enter(node);
+    }
+    m_failures_on_entry.push_back(NumFailures());
+    return AstWalker<TypeChecker>::PreVisitNode(node);
+}
+
+void TypeChecker::PostVisitNode(IAbstractSyntaxTree* node)
+{
+    // A node can't be checked once something below it failed (e.g., an operand has no type),
+    // so it fails along with it, without reporting the same mistake again.
+    auto num_failures_on_entry = m_failures_on_entry.back();
+    m_failures_on_entry.pop_back();
+    if (NumFailures() == num_failures_on_entry)
+    {
+        AstWalker<TypeChecker>::PostVisitNode(node);
+    }
+
+    // Includes the failure of the node itself, for the parent to see in AfterChild().
+    m_has_left_node_failed = NumFailures() > num_failures_on_entry;
 
-    for (const auto& decl : node->Declarations())
+    if (m_hooks && Depth() > 0)
     {
-        decl->Accept(this);
+        m_hooks->Leave(node);
     }
 }
 
-void TypeChecker::ValidateTypeExistence(const Type& type, std::string_view who, const SourcePos& where)
+// Struct types were bound where they were used, only if their names referred to a struct.
+bool IsTypeValid(const Type& type)
+{
+    return type.Validity() != TypeValidity::Invalid && AreStructTypesBound(type);
+}
+
+bool TypeChecker::ValidateTypeExistence(const Type& type, LazyMessage who, const SourcePos& where)
 {
-    if (!type.IsValid(m_environment, m_context_module_name))
+    if (!IsTypeValid(type))
     {
-        auto message = std::format("{} tried to use invalid type \"{}\"",
-            who,
-            type.ToString()
-        );
-        throw SemanticError(where, message);
+        Diagnostics().Report(DiagnosticCode::InvalidType, where, {who.Build(), type.ToString()});
+        return false;
     }
+    return true;
 }
 
-void TypeChecker::Visit(FuncDecl* node)
+bool TypeChecker::PreVisit(FuncDecl* node)
 {
     // Record that all of the following statements are
     // executed within this function's context.
@@ -71,129 +262,84 @@ void TypeChecker::Visit(FuncDecl* node)
 
     // Check if the return type is valid.
     // Note: parameter types will be validated on child nodes.
-    auto who = std::format("return type of function \"{}\"", node->Name().lexeme);
+    // The body is checked either way.
+    auto who = [&]() { return std::format("return type of function \"{}\"", node->Name().lexeme); };
     ValidateTypeExistence(node->ReturnType(), who, node->StartPos());
-
-    // Visit child node
-    m_environment.OpenScope(m_context_module_name);
-    for (const auto& param : node->Parameters())
-    {
-        param->Accept(this);
-    }
-    node->Body()->Accept(this);
-    m_environment.CloseScope(m_context_module_name);
+    return true;
 }
 
-void TypeChecker::Visit(Parameter* node)
+bool TypeChecker::PreVisit(Parameter* node)
 {
-    // Throw an error if the type is invalid in this module's context.
-    auto who = std::format("parameter \"{}\"", node->Name().lexeme);
+    // Report an error if the type is invalid in this module's context.
+    auto who = [&]() { return std::format("parameter \"{}\"", node->Name().lexeme); };
     ValidateTypeExistence(node->DeclType(), who, node->StartPos());
-
-    // If the type was valid, add it to the local symbol table.
-    // Note: parameters belong to the function's local scope.
-    m_environment.AddSymbol(m_context_module_name, node, false);
+    return true;
 }
 
-void TypeChecker::Visit(StructDecl* node)
+bool TypeChecker::PreVisit(StructDecl* node)
 {
     // Make sure that all member variables with struct type are valid.
+    // Every member is checked, even after one of them failed.
     for (const auto& member : node->Members())
     {
-        auto who = std::format("member variable \"{}\" of struct \"{}\"",
-            member.name.lexeme,
-            node->Name().lexeme
-        );
+        auto who = [&]() {
+            return std::format("member variable \"{}\" of struct \"{}\"",
+                member.name.lexeme,
+                node->Name().lexeme
+            );
+        };
         ValidateTypeExistence(member.type, who, member.name.start_pos);
     }
+    return true;
 }
 
-void TypeChecker::Visit(CompoundStmt* node)
-{
-    m_environment.OpenScope(m_context_module_name);
-    for (const auto& stmt : node->Statements())
-    {
-        stmt->Accept(this);
-    }
-    m_environment.CloseScope(m_context_module_name);
-}
-
-// Throws an exception if 'type' is different from 'expected'.
-// 'who' and 'where' are used to provide information to the SemanticError.
-void ValidateTypeEquality(const Type& type, const Type& expected, std::string_view who, const SourcePos& where)
+// Reports an error if 'type' is different from 'expected'.
+// 'who' and 'where' are used to provide information to the diagnostic.
+bool ValidateTypeEquality(DiagnosticSink& diagnostics, const Type& type, const Type& expected, LazyMessage who, const SourcePos& where)
 {
     if (type != expected)
     {
-        auto message = std::format("expected type of {} is \"{}\", but \"{}\" was given",
-            who,
-            expected.ToString(),
-            type.ToString()
-        );
-        throw SemanticError(where, message);
+        diagnostics.Report(DiagnosticCode::TypeMismatch, where, {who.Build(), expected.ToString(), type.ToString()});
+        return false;
     }
+    return true;
 }
 
-void TypeChecker::ValidateConditionExprType(const Expr* condition_expr)
+bool TypeChecker::ValidateConditionExprType(const Expr* condition_expr)
 {
     const auto& type = GetExprTrait(condition_expr).type;
     const auto& expected = CreatePrimiveType(TokenType::BoolType);
-    ValidateTypeEquality(type, expected, "a condition expression", condition_expr->StartPos());
+    return ValidateTypeEquality(Diagnostics(), type, expected, "a condition expression", condition_expr->StartPos());
 }
 
-void TypeChecker::Visit(IfStmt* node)
+void TypeChecker::AfterChild(IfStmt* node, IAbstractSyntaxTree* child)
 {
     // Check if the condition has bool type.
-    node->Condition()->Accept(this);
-    ValidateConditionExprType(node->Condition());
-
-    // Visit then branch
-    m_environment.OpenScope(m_context_module_name);
-    node->ThenBranch()->Accept(this);
-    m_environment.CloseScope(m_context_module_name);
-
-    // Visit else branch
-    if (auto else_branch = node->ElseBranch())
+    // A condition that failed by itself has already been reported.
+    if (child == node->Condition() && !m_has_left_node_failed)
     {
-        m_environment.OpenScope(m_context_module_name);
-        else_branch->Accept(this);
-        m_environment.CloseScope(m_context_module_name);
+        ValidateConditionExprType(node->Condition());
     }
 }
 
-void TypeChecker::Visit(ForStmt* node)
+void TypeChecker::AfterChild(ForStmt* node, IAbstractSyntaxTree* child)
 {
-    m_environment.OpenScope(m_context_module_name);
-
-    if (auto initializer = node->Initializer())
+    if (child == node->Condition() && !m_has_left_node_failed)
     {
-        initializer->Accept(this);
+        ValidateConditionExprType(node->Condition());
     }
-    if (auto condition = node->Condition())
-    {
-        condition->Accept(this);
-        ValidateConditionExprType(condition);
-    }
-    if (auto increment = node->IncrementExpr())
-    {
-        increment->Accept(this);
-    }
-    node->Body()->Accept(this);
-
-    m_environment.CloseScope(m_context_module_name);
 }
 
-void TypeChecker::Visit(WhileStmt* node)
+void TypeChecker::AfterChild(WhileStmt* node, IAbstractSyntaxTree* child)
 {
     // Condition should have bool type
-    auto condition = node->Condition();
-    condition->Accept(this);
-    ValidateConditionExprType(condition);
-
-    // Visit child node
-    node->Body()->Accept(this);
+    if (child == node->Condition() && !m_has_left_node_failed)
+    {
+        ValidateConditionExprType(node->Condition());
+    }
 }
 
-void TypeChecker::Visit(JumpStmt* node)
+void TypeChecker::PostVisit(JumpStmt* node)
 {
     if (node->JumpType().type == TokenType::Return)
     {
@@ -203,31 +349,28 @@ void TypeChecker::Visit(JumpStmt* node)
         auto ret_type = CreateVoidType();
         if (ret_expr)
         {
-            ret_expr->Accept(this);
             ret_type = GetExprTrait(ret_expr).type;
         }
 
         // Check if the return type matches the function signature.
-        auto who = std::format("return statement inside function \"{}\"",
-            m_current_function->Name().lexeme
-        );
-        ValidateTypeEquality(ret_type, m_current_function->ReturnType(), who, node->StartPos());
+        auto who = [&]() {
+            return std::format("return statement inside function \"{}\"",
+                m_current_function->Name().lexeme
+            );
+        };
+        ValidateTypeEquality(Diagnostics(), ret_type, m_current_function->ReturnType(), who, node->StartPos());
     }
 }
 
-void TypeChecker::Visit(ExprStmt* node)
-{
-    node->Expression()->Accept(this);
-}
-
 // Returns true if assigning source type value to dest type variable is possible.
-bool IsBasetypeAssignmentCompatible(const IBaseType* dest, const IBaseType* source)
+// Only the base types are considered, so both should be element types.
+bool IsBasetypeAssignmentCompatible(const Type& dest, const Type& source)
 {
     // Identical types are obviously valid.
-    if (dest->ToString() == source->ToString()) return true;
+    if (dest == source) return true;
 
     // Check if type coercion is possible.
-    if (dest->ToString() == "f32" && source->ToString() == "i32") return true;
+    if (dest == CreatePrimiveType(TokenType::FloatType) && source == CreatePrimiveType(TokenType::IntType)) return true;
 
     // Otherwise, source and dest are incompatible types.
     return false;
@@ -239,7 +382,7 @@ bool IsBasetypeAssignmentCompatible(const IBaseType* dest, const IBaseType* sour
 //     {2, 2} <- {5, 1} => false (2 > 5 on the first dimension!)
 bool IsArraySizeContainable(const std::vector<int>& container_arr_size, const std::vector<int>& value_arr_size)
 {
-    for (int i=0;i<container_arr_size.size();++i)
+    for (size_t i = 0; i < container_arr_size.size(); ++i)
     {
         if (container_arr_size[i] < value_arr_size[i])
         {
@@ -250,91 +393,77 @@ bool IsArraySizeContainable(const std::vector<int>& container_arr_size, const st
     return true;
 }
 
-void ValidateBasetypeAssignmentCompatibility(const IBaseType* dest, const IBaseType* source, const SourcePos& where)
+bool ValidateBasetypeAssignmentCompatibility(DiagnosticSink& diagnostics, const Type& dest, const Type& source, const SourcePos& where)
 {
-    if (!IsBasetypeAssignmentCompatible(dest, source))
+    auto dest_base_type = dest.ElementType();
+    auto source_base_type = source.ElementType();
+    if (!IsBasetypeAssignmentCompatible(dest_base_type, source_base_type))
     {
-        auto message = std::format("implicit conversion from base type \"{}\" to \"{}\" is not allowed",
-            source->ToString(),
-            dest->ToString()
-        );
-        throw SemanticError(where, message);
+        diagnostics.Report(DiagnosticCode::ImplicitConversion, where, {source_base_type.ToString(), dest_base_type.ToString()});
+        return false;
     }
+    return true;
 }
 
-void ValidateNumDimensionEquality(const Type& lhs, const Type& rhs, const SourcePos& where)
+bool ValidateNumDimensionEquality(DiagnosticSink& diagnostics, const Type& lhs, const Type& rhs, const SourcePos& where)
 {
     if (lhs.NumDimensions() != rhs.NumDimensions())
     {
-        auto message = std::format("number of dimensions differ between types \"{}\" and \"{}\"",
-            lhs.ToString(),
-            rhs.ToString()
-        );
-        throw SemanticError(where, message);
+        diagnostics.Report(DiagnosticCode::DimensionMismatch, where, {lhs.ToString(), rhs.ToString()});
+        return false;
     }
+    return true;
 }
 
-void ValidateInitializerListSize(const Type& var_type, const Type& init_type, const SourcePos& where)
+bool ValidateInitializerListSize(DiagnosticSink& diagnostics, const Type& var_type, const Type& init_type, const SourcePos& where)
 {
     if (!IsArraySizeContainable(var_type.ArraySize(), init_type.ArraySize()))
     {
-        auto message = std::format("array size of initializer's type \"{}\" exceeds variable's type \"{}\"",
-            init_type.ToString(),
-            var_type.ToString()
-        );
-        throw SemanticError(where, message);
+        diagnostics.Report(DiagnosticCode::InitializerTooLarge, where, {init_type.ToString(), var_type.ToString()});
+        return false;
     }
+    return true;
 }
 
 // Check if we can initialize variable of var_type with value of init_type.
-// If not, semantic error will be thrown.
-// 'decl_source_location' is used on the exception message,
-// to show where the error happened.
-void ValidateVarDeclType(const Type& var_type, const Type& init_type, const SourcePos& where)
+// If not, the first problem is reported.
+// 'where' is used on the diagnostic, to show where the error happened.
+bool ValidateVarDeclType(DiagnosticSink& diagnostics, const Type& var_type, const Type& init_type, const SourcePos& where)
 {
     // Check if we can assign initializer to variable,
     // while only considering the base type.
-    ValidateBasetypeAssignmentCompatibility(var_type.BaseType(), init_type.BaseType(), where);
-
-    // Check if initializer list has same number of dimensions.
+    // Then check if initializer list has same number of dimensions.
     // ex) arr: i32[100] = {{1}, {2}} (invalid: dimension mismatch)
-    ValidateNumDimensionEquality(var_type, init_type, where);
-
-    // Check if initializer list has less-or-equal size compared to the variable type.
+    // Then check if initializer list has less-or-equal size compared to the variable type.
     // ex) arr: i32[100] = {0}; (valid: partial initialization)
-    ValidateInitializerListSize(var_type, init_type, where);
+    return ValidateBasetypeAssignmentCompatibility(diagnostics, var_type, init_type, where) &&
+        ValidateNumDimensionEquality(diagnostics, var_type, init_type, where) &&
+        ValidateInitializerListSize(diagnostics, var_type, init_type, where);
 }
 
-void TypeChecker::Visit(VarDeclStmt* node)
+bool TypeChecker::PreVisit(VarDeclStmt* node)
 {
     // Make sure a valid type is used.
-    auto who = std::format("local variable \"{}\"", node->Name().lexeme);
-    auto where = node->StartPos();
-    auto var_type = node->DeclType();
-    ValidateTypeExistence(var_type, who, where);
+    // If not, the initializer is still checked, but not against the type.
+    auto who = [&]() { return std::format("local variable \"{}\"", node->Name().lexeme); };
+    ValidateTypeExistence(node->DeclType(), who, node->StartPos());
+    return true;
+}
 
+void TypeChecker::PostVisit(VarDeclStmt* node)
+{
     // If we have the optional initializer, make sure the type is compatible.
+    // Note: its type attribute has been synthesized by now.
     if (auto initializer = node->Initializer())
     {
-        // Synthesize type attribute.
-        initializer->Accept(this);
-
-        // Check if the type is compatible.
         auto init_type = GetExprTrait(initializer).type;
-        ValidateVarDeclType(var_type, init_type, where);
+        ValidateVarDeclType(Diagnostics(), node->DeclType(), init_type, node->StartPos());
     }
-
-    // If we reached here without any exception,
-    // the variable declaration and initializer is semantically valid.
-    // Add it to the module's local symbol table.
-    m_environment.AddSymbol(m_context_module_name, node, false);
 }
 
-void TypeChecker::Visit(VarInitExpr* node)
+void TypeChecker::PostVisit(VarInitExpr* node)
 {
-    // Synthesize type attribute.
     auto expr = node->Expression();
-    expr->Accept(this);
 
     // VarInitExpr has same type as its internal Expr node.
     SetExprTrait(node, GetExprTrait(expr).type);
@@ -357,14 +486,8 @@ void TypeChecker::Visit(VarInitExpr* node)
 // After iteration is done, append extra dimension on the left
 // to note that this is an array of elements
 // => i32[3][2]
-void TypeChecker::Visit(VarInitList* node)
+void TypeChecker::PostVisit(VarInitList* node)
 {
-    // Synthesize type attributes.
-    for (const auto& init_elem : node->InitializerList())
-    {
-        init_elem->Accept(this);
-    }
-
     // Find an array type which is large enough to store all elements.
     // We will start from the first element's type and increment array size
     // whenever we encounter a bigger array as next list element.
@@ -372,27 +495,24 @@ void TypeChecker::Visit(VarInitList* node)
     // Note:
     // nested elements of an initializer list can have different array size!
     // ex) arr: i32[10][10] = {{1, 2}, {3}, {4, 5, 6}};
-    auto first_elem = node->InitializerList().begin()->get();
+    auto first_elem = node->InitializerList().front();
     auto list_type = GetExprTrait(first_elem).type;
 
     for (const auto& elem : node->InitializerList())
     {
-        auto elem_type = GetExprTrait(elem.get()).type;
+        auto elem_type = GetExprTrait(elem).type;
 
         // Do not allow mixing types inside a single initializer list.
-        auto expected_base_type_name = list_type.BaseType()->ToString();
-        auto elem_base_type_name = elem_type.BaseType()->ToString();
-        if (expected_base_type_name != elem_base_type_name)
+        auto expected_base_type = list_type.ElementType();
+        auto elem_base_type = elem_type.ElementType();
+        if (expected_base_type != elem_base_type)
         {
-            auto message = std::format("trying to mix types \"{}\" and \"{}\" inside an initializer list",
-                expected_base_type_name,
-                elem_base_type_name
-            );
-            throw SemanticError(elem->StartPos(), message);
+            Diagnostics().Report(DiagnosticCode::MixedInitializerTypes, elem->StartPos(), {expected_base_type.ToString(), elem_base_type.ToString()});
+            return;
         }
 
         // Update list type to a bigger array which can store all elements in this list.
-        // When number of dimensions differ between elements, an exception will be thrown.
+        // When number of dimensions differ between elements, an error is reported.
         //
         // ex) {1} and {2,3} => i32[2]
         // ex) {1} and {{2}, {3}} => error! we cannot mix i32[] and i32[][]...
@@ -402,7 +522,8 @@ void TypeChecker::Visit(VarInitList* node)
         }
         catch(const std::exception&)
         {
-            throw SemanticError(elem->StartPos(), "every element in an initializer list should have same dimension");
+            Diagnostics().Report(DiagnosticCode::MixedInitializerDimensions, elem->StartPos());
+            return;
         }
     }
 
@@ -411,29 +532,26 @@ void TypeChecker::Visit(VarInitList* node)
     SetExprTrait(node, list_type);
 }
 
-void TypeChecker::Visit(ArrayAccessExpr* node)
+void TypeChecker::PostVisit(ArrayAccessExpr* node)
 {
-    // Synthesize type attributes.
     auto operand_expr = node->Operand();
-    operand_expr->Accept(this);
-
     auto index_expr = node->Index();
-    index_expr->Accept(this);
 
     // Index should have int type.
     const auto& index_type = GetExprTrait(index_expr).type;
     auto expected = CreatePrimiveType(TokenType::IntType);
     auto where = index_expr->StartPos();
-    ValidateTypeEquality(index_type, expected, "an array index", where);
+    if (!ValidateTypeEquality(Diagnostics(), index_type, expected, "an array index", where))
+    {
+        return;
+    }
 
     // Operand should be an array type.
     const auto& [is_operand_lvalue, operand_type] = GetExprTrait(operand_expr);
     if (!operand_type.IsArray())
     {
-        auto message = std::format("array access operator [] cannot be applied to non-array type \"{}\"",
-            operand_type.ToString()
-        );
-        throw SemanticError(where, message);
+        Diagnostics().Report(DiagnosticCode::NonArrayAccess, where, {operand_type.ToString()});
+        return;
     }
 
     // Record the result type.
@@ -443,59 +561,45 @@ void TypeChecker::Visit(ArrayAccessExpr* node)
     SetExprTrait(node, result_type, is_operand_lvalue);
 }
 
-// Throws exception if the type was an array.
-void ValidateTypeIsNotArray(const Type& type, std::string_view who, const SourcePos& where)
+// Reports an error if the type was an array.
+bool ValidateTypeIsNotArray(DiagnosticSink& diagnostics, const Type& type, LazyMessage who, const SourcePos& where)
 {
     if (type.IsArray())
     {
-        auto message = std::format("expected a non-array type for {}, but \"{}\" was given",
-            who,
-            type.ToString()
-        );
-        throw SemanticError(where, message);
+        diagnostics.Report(DiagnosticCode::UnexpectedArray, where, {who.Build(), type.ToString()});
+        return false;
     }
+    return true;
 }
 
-bool IsTypeNumeric(const Type& type)
-{
-    if (type == CreatePrimiveType(TokenType::IntType)) return true;
-    if (type == CreatePrimiveType(TokenType::FloatType)) return true;
-
-    return false;
-}
-
-// Throws exception if given type is not a numeric type (i32 or f32)·
-void ValidateTypeIsNumeric(const Type& type, std::string_view who, const SourcePos& where)
+// Reports an error if given type is not a numeric type (i32 or f32)·
+bool ValidateTypeIsNumeric(DiagnosticSink& diagnostics, const Type& type, LazyMessage who, const SourcePos& where)
 {
-    if (!IsTypeNumeric(type))
+    if (!type.IsNumeric())
     {
-        const auto message = std::format("expected numeric type for {}, but \"{}\" was given",
-            who,
-            type.ToString()
-        );
-        throw SemanticError(where, message);
+        diagnostics.Report(DiagnosticCode::UnexpectedNonNumeric, where, {who.Build(), type.ToString()});
+        return false;
     }
+    return true;
 }
 
-[[noreturn]] void ThrowInvalidOperationError(const Type& lhs_type, const Type& rhs_type, const Token& op_token)
+void ReportInvalidOperation(DiagnosticSink& diagnostics, const Type& lhs_type, const Type& rhs_type, const Token& op_token)
 {
-    auto message = std::format("operation \"{}\" {} \"{}\" is not allowed",
-        lhs_type.ToString(),
-        op_token.lexeme,
-        rhs_type.ToString()
-    );
-    throw SemanticError(op_token.start_pos, message);
+    diagnostics.Report(DiagnosticCode::InvalidOperation, op_token.start_pos, {lhs_type.ToString(), op_token.lexeme, rhs_type.ToString()});
 }
 
 // If the operation is valid, return the result type.
-// If not, throw a semantic exception.
-Type FindArithmeticResultType(const Type& lhs_type, const Type& rhs_type, const Token& op_token)
+// If not, report an error and return nothing.
+std::optional<Type> FindArithmeticResultType(DiagnosticSink& diagnostics, const Type& lhs_type, const Type& rhs_type, const Token& op_token)
 {
     // Arithmetic operators are not applicable to array types.
-    auto who = std::format("arithmetic operator {}", op_token.lexeme);
+    auto who = [&]() { return std::format("arithmetic operator {}", op_token.lexeme); };
     auto where = op_token.start_pos;
-    ValidateTypeIsNotArray(lhs_type, who, where);
-    ValidateTypeIsNotArray(rhs_type, who, where);
+    if (!ValidateTypeIsNotArray(diagnostics, lhs_type, who, where) ||
+        !ValidateTypeIsNotArray(diagnostics, rhs_type, who, where))
+    {
+        return std::nullopt;
+    }
 
     // Arithmetic assignment operators require assignment compatibility
     if (op_token.type == TokenType::Assign ||
@@ -504,7 +608,10 @@ Type FindArithmeticResultType(const Type& lhs_type, const Type& rhs_type, const
         op_token.type == TokenType::MultiplyAssign ||
         op_token.type == TokenType::DivideAssign)
     {
-        ValidateBasetypeAssignmentCompatibility(lhs_type.BaseType(), rhs_type.BaseType(), where);
+        if (!ValidateBasetypeAssignmentCompatibility(diagnostics, lhs_type, rhs_type, where))
+        {
+            return std::nullopt;
+        }
     }
     
     // Now find if there exists a type pair for this operation.
@@ -519,10 +626,13 @@ Type FindArithmeticResultType(const Type& lhs_type, const Type& rhs_type, const
         return str_type;
     }
     // Operation between float or int.
-    else if (IsTypeNumeric(lhs_type))
+    else if (lhs_type.IsNumeric())
     {
-        auto who = std::format("right hand operand of arithmetic operator {}", op_token.lexeme);
-        ValidateTypeIsNumeric(rhs_type, who, where);
+        auto who = [&]() { return std::format("right hand operand of arithmetic operator {}", op_token.lexeme); };
+        if (!ValidateTypeIsNumeric(diagnostics, rhs_type, who, where))
+        {
+            return std::nullopt;
+        }
 
         // Take type coercion into account.
         if (lhs_type == int_type && rhs_type == int_type)
@@ -537,23 +647,25 @@ Type FindArithmeticResultType(const Type& lhs_type, const Type& rhs_type, const
     // All other operations are invalid.
     else
     {
-        ThrowInvalidOperationError(lhs_type, rhs_type, op_token);
+        ReportInvalidOperation(diagnostics, lhs_type, rhs_type, op_token);
+        return std::nullopt;
     }
 }
 
-// Throws exception if inequality operator (>, >=, <, <=)
+// Reports an error if inequality operator (>, >=, <, <=)
 // cannot be applied between two types.
-void ValidateBaseTypeInequalityComparable(const Type& lhs_type, const Type& rhs_type, const Token& op_token)
+bool ValidateBaseTypeInequalityComparable(DiagnosticSink& diagnostics, const Type& lhs_type, const Type& rhs_type, const Token& op_token)
 {
     // Comparision between float and int is possible.
-    if (IsTypeNumeric(lhs_type) && IsTypeNumeric(rhs_type)) return;
+    if (lhs_type.IsNumeric() && rhs_type.IsNumeric()) return true;
 
     // Comparison between two strings is also allowed (dictionary order!)
     auto str_type = CreatePrimiveType(TokenType::StringType);
-    if (lhs_type == str_type && rhs_type == str_type) return;
+    if (lhs_type == str_type && rhs_type == str_type) return true;
 
     // Otherwise, we cannot compare two types using inequality operators.
-    ThrowInvalidOperationError(lhs_type, rhs_type, op_token);
+    ReportInvalidOperation(diagnostics, lhs_type, rhs_type, op_token);
+    return false;
 }
 
 // Allowed operations:
@@ -562,14 +674,10 @@ void ValidateBaseTypeInequalityComparable(const Type& lhs_type, const Type& rhs_
 // {==, !=} between strictly identical types
 // {>, <, >=, <=} between primitive types
 // {&&, ||} between bool types
-void TypeChecker::Visit(BinaryExpr* node)
+void TypeChecker::PostVisit(BinaryExpr* node)
 {
-    // Synthesize type attributes.
     auto lhs_expr = node->LeftHandOperand();
-    lhs_expr->Accept(this);
-
     auto rhs_expr = node->RightHandOperand();
-    rhs_expr->Accept(this);
 
     // From here, we will check if the operation between to types is possible.
     const auto& op_token = node->Operator();
@@ -580,6 +688,7 @@ void TypeChecker::Visit(BinaryExpr* node)
     // These instances frequently appear within this function,
     // so why not prepare them in advance!
     // Note: 'where' is used to report source location when semantic error occurs
+    auto& diagnostics = Diagnostics();
     const auto& bool_type = CreatePrimiveType(TokenType::BoolType);
     const auto& where = op_token.start_pos;
 
@@ -587,10 +696,13 @@ void TypeChecker::Visit(BinaryExpr* node)
     if (op_type == TokenType::And ||
         op_type == TokenType::Or)
     {
-        auto who = std::format("operand of logical operator {}", op_token.lexeme);
-        ValidateTypeEquality(lhs_type, bool_type, who, where);
-        ValidateTypeEquality(rhs_type, bool_type, who, where);
-        
+        auto who = [&]() { return std::format("operand of logical operator {}", op_token.lexeme); };
+        if (!ValidateTypeEquality(diagnostics, lhs_type, bool_type, who, where) ||
+            !ValidateTypeEquality(diagnostics, rhs_type, bool_type, who, where))
+        {
+            return;
+        }
+
         SetExprTrait(node, bool_type);
     }
 
@@ -598,8 +710,11 @@ void TypeChecker::Visit(BinaryExpr* node)
     if (op_type == TokenType::Equal ||
         op_type == TokenType::NotEqual)
     {
-        auto who = std::format("right hand operand of equality operator {}", op_token.lexeme);
-        ValidateTypeEquality(rhs_type, lhs_type, who, where);
+        auto who = [&]() { return std::format("right hand operand of equality operator {}", op_token.lexeme); };
+        if (!ValidateTypeEquality(diagnostics, rhs_type, lhs_type, who, where))
+        {
+            return;
+        }
 
         SetExprTrait(node, bool_type);
     }
@@ -610,10 +725,13 @@ void TypeChecker::Visit(BinaryExpr* node)
         op_type == TokenType::Less ||
         op_type == TokenType::LessEqual)
     {
-        auto who = std::format("operand of inequality operator {}", op_token.lexeme);
-        ValidateTypeIsNotArray(lhs_type, who, where);
-        ValidateTypeIsNotArray(rhs_type, who, where);
-        ValidateBaseTypeInequalityComparable(lhs_type, rhs_type, op_token);
+        auto who = [&]() { return std::format("operand of inequality operator {}", op_token.lexeme); };
+        if (!ValidateTypeIsNotArray(diagnostics, lhs_type, who, where) ||
+            !ValidateTypeIsNotArray(diagnostics, rhs_type, who, where) ||
+            !ValidateBaseTypeInequalityComparable(diagnostics, lhs_type, rhs_type, op_token))
+        {
+            return;
+        }
 
         SetExprTrait(node, bool_type);
     }
@@ -626,10 +744,14 @@ void TypeChecker::Visit(BinaryExpr* node)
 
         // Not all operands have corresponding arithmetic operator.
         // For example, we cannot add an a number to a string.
-        // This will throw an exception in case of invalid operation.
-        auto result_type = FindArithmeticResultType(lhs_type, rhs_type, op_token);
+        // This will report an error in case of invalid operation.
+        auto result_type = FindArithmeticResultType(diagnostics, lhs_type, rhs_type, op_token);
+        if (!result_type)
+        {
+            return;
+        }
 
-        SetExprTrait(node, result_type);
+        SetExprTrait(node, *result_type);
     }
 
     if (op_type == TokenType::Assign ||
@@ -641,49 +763,50 @@ void TypeChecker::Visit(BinaryExpr* node)
         // Assignment requires lhs to be an lvalue.
         if (!is_lhs_lvalue)
         {
-            throw SemanticError(op_token.start_pos, "assignment to an rvalue is not allowed");
+            diagnostics.Report(DiagnosticCode::AssignmentToRvalue, op_token.start_pos);
+            return;
         }
 
         // Simple assignment "="
         if (op_type == TokenType::Assign)
         {
             // Array assignment requires strict type identity.
-            if (lhs_type.IsArray())
-            {
-                auto who = "right hand operand of array assignment operator";
-                ValidateTypeEquality(rhs_type, lhs_type, who, where);
-            }
             // For non-array types, we need to check if implicit conversion is possible.
-            else
+            auto is_assignable = lhs_type.IsArray()
+                ? ValidateTypeEquality(diagnostics, rhs_type, lhs_type, "right hand operand of array assignment operator", where)
+                : ValidateBasetypeAssignmentCompatibility(diagnostics, lhs_type, rhs_type, op_token.start_pos);
+            if (!is_assignable)
             {
-                ValidateBasetypeAssignmentCompatibility(lhs_type.BaseType(), rhs_type.BaseType(), op_token.start_pos);
+                return;
             }
             SetExprTrait(node, lhs_type, true);
         }
         // Arithmetic assignments like "+="
         else
         {
-            auto result_type = FindArithmeticResultType(lhs_type, rhs_type, op_token);
+            if (!FindArithmeticResultType(diagnostics, lhs_type, rhs_type, op_token))
+            {
+                return;
+            }
             SetExprTrait(node, lhs_type);
         }
     }
 }
 
-// Throws exception if number of arguments differ from requires parameters.
-void ValidateArgumentNumber(
+// Reports an error if number of arguments differ from requires parameters.
+bool ValidateArgumentNumber(
+    DiagnosticSink& diagnostics,
     const std::vector<ParamType>& param_types,
-    const std::vector<std::shared_ptr<Expr>>& args,
+    const std::vector<Expr*>& args,
     const SourcePos& where
 )
 {
     if (param_types.size() != args.size())
     {
-        const auto message = std::format("the function only requires {} arguments, but {} was given",
-            param_types.size(),
-            args.size()
-        );
-        throw SemanticError(where, message);
+        diagnostics.Report(DiagnosticCode::ArgumentCount, where, {std::to_string(param_types.size()), std::to_string(args.size())});
+        return false;
     }
+    return true;
 }
 
 bool IsLValueRequired(const ParamUsage& usage)
@@ -691,75 +814,82 @@ bool IsLValueRequired(const ParamUsage& usage)
     return (usage == ParamUsage::InOut) || (usage == ParamUsage::Out);
 }
 
-// Throws exception if the expression is an rvalue.
-void TypeChecker::ValidateLValueQualifier(const Expr* expr, std::string_view who, const SourcePos& where)
+// Reports an error if the expression is an rvalue.
+bool TypeChecker::ValidateLValueQualifier(const Expr* expr, LazyMessage who, const SourcePos& where)
 {
     if (!GetExprTrait(expr).is_lvalue)
     {
-        const auto message = std::format("expected an lvalue for {}, but an rvalue was given", who);
-        throw SemanticError(where, message);
+        Diagnostics().Report(DiagnosticCode::UnexpectedRvalue, where, {who.Build()});
+        return false;
     }
+    return true;
 }
 
 // Try to cast the type to a non-array FuncType.
-// Throws exception if the type was not a callable type.
-const FuncType* TryTypecastToFuncType(const Type& type, const SourcePos& where)
+// Reports an error and returns nullptr if the type was not a callable type.
+const FuncType* TryTypecastToFuncType(DiagnosticSink& diagnostics, const Type& type, const SourcePos& where)
 {
     // An array type, regardless of its base type, is not callable.
-    ValidateTypeIsNotArray(type, "a callee expression", where);
+    if (!ValidateTypeIsNotArray(diagnostics, type, "a callee expression", where))
+    {
+        return nullptr;
+    }
 
     // Make sure the base type is FuncType.
     auto base_type = dynamic_cast<const FuncType*>(type.BaseType());
     if (base_type == nullptr)
     {
-        const auto message = std::format("\"{}\" is not a callable type",
-            type.ToString()
-        );
-        throw SemanticError(where, message);
+        diagnostics.Report(DiagnosticCode::NotCallable, where, {type.ToString()});
     }
     return base_type;
 }
 
-void TypeChecker::Visit(FuncCallExpr* node)
+void TypeChecker::PostVisit(FuncCallExpr* node)
 {
-    // Synthesize type attributes.
     auto callee_node_expr = node->Function();
-    callee_node_expr->Accept(this);
-
     const auto& arg_list = node->ArgumentList();
-    for (const auto& arg : arg_list)
-    {
-        arg->Accept(this);
-    }
 
     // Check if the callee has a callable type.
     auto where = node->StartPos();
     const Type& callee_node_type = GetExprTrait(callee_node_expr).type;
-    const FuncType* func_type = TryTypecastToFuncType(callee_node_type, where);
+    const FuncType* func_type = TryTypecastToFuncType(Diagnostics(), callee_node_type, where);
+    if (!func_type)
+    {
+        return;
+    }
 
     // Check if the number of arguments is valid.
     const auto& param_types = func_type->ParamTypes();
-    ValidateArgumentNumber(param_types, arg_list, where);
+    if (!ValidateArgumentNumber(Diagnostics(), param_types, arg_list, where))
+    {
+        return;
+    }
 
     // Check if each argument has a valid type.
-    for (int i = 0; i < arg_list.size(); ++i)
+    for (size_t i = 0; i < arg_list.size(); ++i)
     {
         // Alias for frequently used variables.
         const auto& param = param_types[i];
-        auto arg_expr = arg_list[i].get();
+        auto arg_expr = arg_list[i];
 
         // Make sure the types match.
-        auto who = std::format("argument {}", i);
+        auto who = [&]() { return std::format("argument {}", i); };
         auto where = arg_expr->StartPos();
         const auto& type = GetExprTrait(arg_expr).type;
-        ValidateTypeEquality(type, param.type, who, where);
+        if (!ValidateTypeEquality(Diagnostics(), type, param.type, who, where))
+        {
+            return;
+        }
 
         // Make sure the argument is an lvalue
         // if the parameter usage is 'out' or 'inout'.
         if (IsLValueRequired(param.usage))
         {
-            auto who = std::format("parameter type \"{}\"", param.ToString());
-            ValidateLValueQualifier(arg_expr, who, where);
+            auto who = [&]() { return std::format("parameter type \"{}\"", param.ToString()); };
+            if (!ValidateLValueQualifier(arg_expr, who, where))
+            {
+                return;
+            }
         }
     }
 
@@ -767,185 +897,178 @@ void TypeChecker::Visit(FuncCallExpr* node)
     SetExprTrait(node, func_type->ReturnType());
 }
 
-bool IsSymbolTypeName(const Symbol& symbol)
+void TypeChecker::PostVisit(Identifier* node)
 {
-    // Struct declarations only appear at level 0.
-    if (symbol.scope_level > 0) return false;
-
-    // Only a struct declaration can have a name identical to its type name,
-    // since global symbols on scope level 0 are either a function or a struct
-    // and a function type starts with "[", not the function's name.
-    return symbol.declaration->Name().lexeme == symbol.declaration->DeclType().ToString();
-}
-
-void TypeChecker::Visit(Identifier* node)
-{
-    auto symbol_name = node->ToString();
+    const auto& symbol_name = node->Id().lexeme;
 
     // We are doing symbol reference!
-    // Make sure it exists, and find the declaration to check the type.
-    try
+    // Make sure it exists, and use the declaration it was bound to for the type.
+    auto declaration = m_bindings.FindDeclaration(node);
+    if (!declaration)
     {
-        // This will throw exception if we try to access undefined/invisible symbol.
-        auto symbol = m_environment.FindSymbol(m_context_module_name, symbol_name);
-        auto type = symbol.declaration->DeclType();
-
-        // There is a chance that a struct name appears as an identifier node.
-        // We should prevent a type name from begin interpreted as a variable.
-        //
-        // Note: it is okay to have a local variable with name identical to its type,
-        //       but it will invalidate usage of the type until the end of its scope.
-        //
-        //       ex) foo: func = () {
-        //               vector: vector;
-        //               // cannot declare variables with struct type "vector"
-        //               // until the scope of local variable "vector" ends...
-        //           }
-        if (IsSymbolTypeName(symbol))
-        {
-            auto message = std::format("type name \"{}\" cannot be used as an expression",
-                symbol_name
-            );
-            throw SemanticError(node->StartPos(), message);
-        }
-
-        // Note: the third parameter denotes that this is an lvalue.
-        SetExprTrait(node, type, true);
+        Diagnostics().Report(DiagnosticCode::UndefinedSymbol, node->StartPos(), {symbol_name});
+        return;
     }
-    catch(const SemanticError&)
+
+    // There is a chance that a struct name appears as an identifier node.
+    // We should prevent a type name from begin interpreted as a variable.
+    //
+    // Note: it is okay to have a local variable with name identical to its type,
+    //       but it will invalidate usage of the type until the end of its scope.
+    //
+    //       ex) foo: func = () {
+    //               vector: vector;
+    //               // cannot declare variables with struct type "vector"
+    //               // until the scope of local variable "vector" ends...
+    //           }
+    if (dynamic_cast<const StructDecl*>(declaration))
     {
-        throw;
+        Diagnostics().Report(DiagnosticCode::TypeNameAsExpression, node->StartPos(), {symbol_name});
+        return;
     }
-    catch(const std::exception&)
+
+    // A local variable or a parameter with an invalid type was reported where it was declared,
+    // so its uses fail without reporting it again.
+    auto is_local = dynamic_cast<const VarDeclStmt*>(declaration) || dynamic_cast<const Parameter*>(declaration);
+    if (is_local && !IsTypeValid(declaration->DeclType()))
     {
-        auto message = std::format("trying to use undefined symbol \"{}\" in an expression",
-            symbol_name
-        );
-        throw SemanticError(node->StartPos(), message);
+        ++m_num_silent_failures;
+        return;
     }
+
+    // Note: the third parameter denotes that this is an lvalue.
+    SetExprTrait(node, declaration->DeclType(), true);
 }
 
-void TypeChecker::Visit(Literal* node)
+void TypeChecker::PostVisit(Literal* node)
 {
     SetExprTrait(node, node->DeclType());
 }
 
 const StructDecl* TypeChecker::TryToFindStructTypeDecl(const Type& type, const SourcePos& where)
 {
-    try
-    {
-        // There are three possible cases:
-        // 1. 'type' is a non-struct type, such as primitives and functions.
-        // 2. 'type' is a struct type.
-        // Note that invalid struct types cannot reach here,
-        // because all variable types are validated while visiting VarDeclStmt.
-        const auto& struct_decl_symbol = m_environment.FindSymbol(m_context_module_name, type.ToString());
-        return dynamic_cast<const StructDecl*>(struct_decl_symbol.declaration);
-    }
-    catch(const std::exception&)
+    // There are three possible cases:
+    // 1. 'type' is a non-struct type, such as primitives, arrays and functions.
+    // 2. 'type' is a struct type, which was bound where it was used.
+    // Note that invalid struct types cannot reach here,
+    // because all variable types are validated while visiting VarDeclStmt.
+    auto struct_type = type.IsArray() ? nullptr : dynamic_cast<const StructType*>(type.BaseType());
+    if (!struct_type || !struct_type->Declaration())
     {
-        auto message = std::format("\"{}\" is not a struct type",
-            type.ToString()
-        );
-        throw SemanticError(where, message);
+        Diagnostics().Report(DiagnosticCode::NotAStruct, where, {type.ToString()});
+        return nullptr;
     }
+    return struct_type->Declaration();
 }
 
-void TypeChecker::Visit(MemberAccessExpr* node)
+void TypeChecker::PostVisit(MemberAccessExpr* node)
 {
-    // Synthesize type attributes.
     auto struct_expr = node->Struct();
-    struct_expr->Accept(this);
 
     // Check if the operand is really a struct type.
     const auto& [is_struct_lvalue, struct_type] = GetExprTrait(struct_expr);
     const StructDecl* struct_decl = TryToFindStructTypeDecl(struct_type, node->StartPos());
+    if (!struct_decl)
+    {
+        return;
+    }
 
     // Check if the struct has a member with matching name.
+    // If so, bind the access to the member for later passes.
     const auto& member_name = node->MemberName();
-    for (const MemberVariable& member : struct_decl->Members())
+    if (auto member_index = struct_decl->FindMember(member_name.lexeme))
     {
-        if (member.name.lexeme == member_name.lexeme)
-        {
-            // Note: if the operand is an lvalue, the member variable is also an lvalue.
-            SetExprTrait(node, member.type, is_struct_lvalue);
-            return;
-        }
+        m_member_bindings->BindMember(node, MemberBinding{struct_decl, *member_index});
+
+        // Note: if the operand is an lvalue, the member variable is also an lvalue.
+        SetExprTrait(node, struct_decl->Members()[*member_index].type, is_struct_lvalue);
+        return;
     }
 
     // Reaching this line implies that we failed to find a matching member name.
-    auto message = std::format("struct type \"{}\" does not have member variable named \"{}\"",
-        struct_type.ToString(),
-        member_name.lexeme
-    );
-    throw SemanticError(member_name.start_pos, message);
+    Diagnostics().Report(DiagnosticCode::UnknownMember, member_name.start_pos, {struct_type.ToString(), member_name.lexeme});
 }
 
-void TypeChecker::Visit(PrefixExpr* node)
+void TypeChecker::PostVisit(PrefixExpr* node)
 {
-    // Synthesize type attribute.
     auto operand_expr = node->Operand();
-    operand_expr->Accept(this);
     auto operand_type = GetExprTrait(operand_expr).type;
 
     // Commonly used information on error reports.
+    auto& diagnostics = Diagnostics();
     auto op = node->Operator();
-    auto who = std::format("operand of unary operator {}", op.lexeme);
+    auto who = [&]() { return std::format("operand of unary operator {}", op.lexeme); };
     auto where = node->StartPos();
 
     // Unary +/- is only allowed on numeric types.
+    // Unary ! is only allowed on bool type.
+    // Prefix ++/-- is only allowed on lvalue int type
+    auto is_valid = false;
     if (op.type == TokenType::Plus ||
         op.type == TokenType::Minus)
     {
-        ValidateTypeIsNumeric(operand_type, who, where);
+        is_valid = ValidateTypeIsNumeric(diagnostics, operand_type, who, where);
     }
-    // Unary ! is only allowed on bool type.
     else if (op.type == TokenType::Not)
     {
         auto bool_type = CreatePrimiveType(TokenType::BoolType);
-        ValidateTypeEquality(operand_type, bool_type, who, where);
+        is_valid = ValidateTypeEquality(diagnostics, operand_type, bool_type, who, where);
     }
-    // Prefix ++/-- is only allowed on lvalue int type
     else
     {
         auto int_type = CreatePrimiveType(TokenType::IntType);
-        ValidateTypeEquality(operand_type, int_type, who, where);
-        ValidateLValueQualifier(operand_expr, who, where);
+        is_valid = ValidateTypeEquality(diagnostics, operand_type, int_type, who, where) &&
+            ValidateLValueQualifier(operand_expr, who, where);
+    }
+    if (!is_valid)
+    {
+        return;
     }
 
     // Prefix operators do not change the type.
     SetExprTrait(node, operand_type);
 }
 
-void TypeChecker::Visit(PostfixExpr* node)
+void TypeChecker::PostVisit(PostfixExpr* node)
 {
-    // Synthesize type attribute.
     auto operand_expr = node->Operand();
-    operand_expr->Accept(this);
     auto operand_type = GetExprTrait(operand_expr).type;
 
     // Commonly used values.
     auto int_type = CreatePrimiveType(TokenType::IntType);
     auto op = node->Operator();
-    auto who = std::format("operand of unary operator {}", op.lexeme);
+    auto who = [&]() { return std::format("operand of unary operator {}", op.lexeme); };
     auto where = op.start_pos;
     
     // Postfix ++/-- is only allowed on lvalue int type
-    ValidateTypeEquality(operand_type, int_type, who, where);
-    ValidateLValueQualifier(operand_expr, who, where);
+    if (!ValidateTypeEquality(Diagnostics(), operand_type, int_type, who, where) ||
+        !ValidateLValueQualifier(operand_expr, who, where))
+    {
+        return;
+    }
 
     // Postfix operators do not change the type.
     SetExprTrait(node, operand_type);
 }
 
+const SideTable<ExprTrait>& TypeChecker::ExprTraits() const
+{
+    return m_expr_traits;
+}
+
+SideTable<ExprTrait> TypeChecker::TakeExprTraits()
+{
+    return std::exchange(m_expr_traits, {});
+}
+
 void TypeChecker::SetExprTrait(const IAbstractSyntaxTree* node, const Type& type, bool is_lvalue)
 {
-    m_expr_trait_dict.insert({node, ExprTrait{is_lvalue, type}});
+    m_expr_traits.Set(node, ExprTrait{is_lvalue, type});
 }
 
 const ExprTrait& TypeChecker::GetExprTrait(const IAbstractSyntaxTree* node) const
 {
-    return m_expr_trait_dict.at(node);
+    return m_expr_traits.At(node);
 }
 
 } // namespace mylang
@@ -58,20 +58,98 @@ bool IsAssignmentOperator(TokenType type)
     return AssignmentOps().count(type) > 0;
 }
 
-std::set<TokenType> ComparisonOps()
+// Precedence of binary operators, or zero for other tokens.
+// Note: assignment operators are not included since they are right-associative.
+int BinaryOpPrecedence(TokenType type)
 {
-    return {
-        TokenType::Equal,
-        TokenType::NotEqual,
-        TokenType::Less,
-        TokenType::LessEqual,
-        TokenType::Greater,
-        TokenType::GreaterEqual
-    };
+    switch (type)
+    {
+    case TokenType::Or:
+        return 1;
+    case TokenType::And:
+        return 2;
+    case TokenType::Equal:
+    case TokenType::NotEqual:
+    case TokenType::Less:
+    case TokenType::LessEqual:
+    case TokenType::Greater:
+    case TokenType::GreaterEqual:
+        return 3;
+    case TokenType::Plus:
+    case TokenType::Minus:
+        return 4;
+    case TokenType::Multiply:
+    case TokenType::Divide:
+        return 5;
+    default:
+        return 0;
+    }
 }
 
-ExprParser::ExprParser(std::shared_ptr<BufferedStream<Token>> token_stream)
+// Replace the top two operands with a BinaryExpr of the top operator.
+void ReduceBinaryExpr(AstArena& arena, std::vector<Expr*>& operands, std::vector<Token>& binary_ops)
+{
+    auto rhs = operands.back();
+    operands.pop_back();
+    auto lhs = operands.back();
+    operands.pop_back();
+
+    operands.push_back(arena.Create<BinaryExpr>(binary_ops.back(), lhs, rhs));
+    binary_ops.pop_back();
+}
+
+enum class ExprParser::Step
+{
+    Operand, // prefix-op* primary-expr
+    PostfixOp, // postfix-op* after primary-expr
+    BinaryOp, // operator after a complete prefix-expr
+    Complete // the current frame has nothing more to parse
+};
+
+// How the result of a nested expr is used by the parent frame.
+enum class ExprParser::FrameContext
+{
+    Root, // the expr requested by Parse()
+    Parenthesis, // "(" expr ")"
+    ArrayIndex, // "[" expr "]"
+    FuncCallArg, // an element of arg-list
+    AssignmentRhs // or-expr assign-op expr
+};
+
+// State of a single expr, which would have been
+// the local variables of a recursive descent parser.
+struct ExprParser::Frame
+{
+    FrameContext context = FrameContext::Root;
+
+    // Operands and binary operators waiting for their right-hand side.
+    // Precedence of the operators strictly increases toward the top.
+    std::vector<Expr*> operands = {};
+    std::vector<Token> binary_ops = {};
+
+    // The operand currently being parsed.
+    std::vector<Token> prefix_ops = {};
+    Expr* postfix_expr = nullptr;
+
+    // Arguments given to postfix_expr so far.
+    std::vector<Expr*> arg_list = {};
+
+    // The operator waiting for its right-hand side in a child frame.
+    Token assign_op = {};
+};
+
+struct ExprParser::ParseState
+{
+    std::vector<Frame> frames;
+
+    // Number of unfinished nested exprs and prefix operators.
+    int nesting_depth = 0;
+};
+
+ExprParser::ExprParser(std::shared_ptr<BufferedStream<Token>> token_stream, std::shared_ptr<AstArena> arena, int max_nesting_depth)
     : IParseRoutine(token_stream)
+    , m_arena(arena)
+    , m_max_nesting_depth(max_nesting_depth)
 {}
 
 bool ExprParser::CanStartParsing()
@@ -86,103 +164,93 @@ bool ExprParser::CanStartParsing()
 
 // expr      ::= (or-expr assign-op)* or-expr
 // assign-op ::= "=" | "+=" | "-=" | "*=" | "/="
-std::shared_ptr<Expr> ExprParser::Parse()
+//
+// or-expr      ::= and-expr ("||" and-expr)*
+// and-expr     ::= compare-expr ("&&" compare-expr)*
+// compare-expr ::= add-expr (compare-op add-expr)*
+// add-expr     ::= mult-expr (("+" | "-") mult-expr)*
+// mult-expr    ::= prefix-expr (("*" | "/") prefix-expr)*
+Expr* ExprParser::Parse()
 {
+    auto state = ParseState{};
+    state.frames.push_back(Frame{.context = FrameContext::Root});
+
     try
     {
-        auto expr = ParseOrExpr();
-        if (auto op = OptionalAcceptOneOf(AssignmentOps()))
+        auto step = Step::Operand;
+        while (true)
         {
-            expr = std::make_shared<BinaryExpr>(op.value(), expr, Parse());
+            switch (step)
+            {
+            case Step::Operand:
+                step = ParseOperand(state);
+                break;
+            case Step::PostfixOp:
+                step = ParsePostfixOps(state);
+                break;
+            case Step::BinaryOp:
+                step = ParseBinaryOp(state);
+                break;
+            case Step::Complete:
+                if (state.frames.size() == 1)
+                {
+                    return state.frames.back().operands.back();
+                }
+                step = CompleteFrame(state);
+                break;
+            }
         }
-        return expr;
     }
-    catch(const ParseRoutineError& e)
-    {
-        throw PatternMismatchError(e, "expr");
-    }
-}
-
-// or-expr ::= and-expr ("||" and-expr)*
-std::shared_ptr<Expr> ExprParser::ParseOrExpr()
-{
-    auto expr = ParseAndExpr();
-    while (auto op = OptionalAccept(TokenType::Or))
+    catch(const NestingLimitError&)
     {
-        auto rhs = ParseAndExpr();
-        expr = std::make_shared<BinaryExpr>(op.value(), expr, rhs);
+        throw;
     }
-    return expr;
-}
-
-// and-expr ::= compare-expr ("&&" compare-expr)*
-std::shared_ptr<Expr> ExprParser::ParseAndExpr()
-{
-    auto expr = ParseCompareExpr();
-    while (auto op = OptionalAccept(TokenType::And))
-    {
-        auto rhs = ParseCompareExpr();
-        expr = std::make_shared<BinaryExpr>(op.value(), expr, rhs);
-    }
-    return expr;
-}
-
-// compare-expr ::= add-expr (compare-op add-expr)*
-std::shared_ptr<Expr> ExprParser::ParseCompareExpr()
-{
-    auto expr = ParseAddExpr();
-    while (auto op = OptionalAcceptOneOf(ComparisonOps()))
+    catch(const ParseRoutineError& e)
     {
-        auto rhs = ParseAddExpr();
-        expr = std::make_shared<BinaryExpr>(op.value(), expr, rhs);
+        // Each unfinished frame corresponds to a nested "expr" in the grammar.
+        auto error = PatternMismatchError(e, "expr");
+        for (size_t i = 1; i < state.frames.size(); ++i)
+        {
+            error = PatternMismatchError(error, "expr");
+        }
+        throw error;
     }
-    return expr;
 }
 
-// add-expr ::= mult-expr (("+" | "-") mult-expr)*
-std::shared_ptr<Expr> ExprParser::ParseAddExpr()
+// prefix-expr  ::= prefix-op* postfix-expr
+// primary-expr ::= literal | identifier | "(" expr ")"
+ExprParser::Step ExprParser::ParseOperand(ParseState& state)
 {
-    auto expr = ParseMultExpr();
-    while (auto op = OptionalAcceptOneOf({TokenType::Plus, TokenType::Minus}))
+    while (auto op = OptionalAcceptOneOf(PrefixOps()))
     {
-        auto rhs = ParseMultExpr();
-        expr = std::make_shared<BinaryExpr>(op.value(), expr, rhs);
+        EnterNesting(state, op.value());
+        state.frames.back().prefix_ops.push_back(op.value());
     }
-    return expr;
-}
 
-// mult-expr ::= prefix-expr (("*" | "/") prefix-expr)*
-std::shared_ptr<Expr> ExprParser::ParseMultExpr()
-{
-    auto expr = ParsePrefixExpr();
-    while (auto op = OptionalAcceptOneOf({TokenType::Multiply, TokenType::Divide}))
+    auto& frame = state.frames.back();
+    if (auto literal = OptionalAcceptOneOf(LiteralTypes()))
     {
-        auto rhs = ParsePrefixExpr();
-        expr = std::make_shared<BinaryExpr>(op.value(), expr, rhs);
+        frame.postfix_expr = m_arena->Create<Literal>(literal.value());
+        return Step::PostfixOp;
     }
-    return expr;
-}
-
-// prefix-expr ::= prefix-op* postfix-expr
-std::shared_ptr<Expr> ExprParser::ParsePrefixExpr()
-{
-    if (auto op = OptionalAcceptOneOf(PrefixOps()))
+    else if (auto id = OptionalAccept(TokenType::Identifier))
     {
-        auto expr = ParsePrefixExpr();
-        return std::make_shared<PrefixExpr>(op.value(), expr);
+        frame.postfix_expr = m_arena->Create<Identifier>(id.value());
+        return Step::PostfixOp;
     }
     else
     {
-        return ParsePostfixExpr();
+        // The parenthesized expr will become postfix_expr of this frame.
+        PushFrame(state, FrameContext::Parenthesis, Accept(TokenType::LeftParen));
+        return Step::Operand;
     }
 }
 
 // postfix-expr ::= primary-expr postfix-op*
 // postfix-op   ::= "++" | "--" | member-access | func-call | array-index
-std::shared_ptr<Expr> ExprParser::ParsePostfixExpr()
+ExprParser::Step ExprParser::ParsePostfixOps(ParseState& state)
 {
-    // Parse primary-expr first.
-    auto expr = ParsePrimaryExpr();
+    auto& frame = state.frames.back();
 
     // Parse following postfix-op by nesting expr.
     while (true)
@@ -190,65 +258,135 @@ std::shared_ptr<Expr> ExprParser::ParsePostfixExpr()
         // "++"" | "--"
         if (auto op = OptionalAcceptOneOf({TokenType::Increment, TokenType::Decrement}))
         {
-            expr = std::make_shared<PostfixExpr>(op.value(), expr);
+            frame.postfix_expr = m_arena->Create<PostfixExpr>(op.value(), frame.postfix_expr);
         }
         // member-access ::= "." identifier
         else if (OptionalAccept(TokenType::Period))
         {
             auto id = Accept(TokenType::Identifier);
-            expr = std::make_shared<MemberAccessExpr>(expr, id);
+            frame.postfix_expr = m_arena->Create<MemberAccessExpr>(frame.postfix_expr, id);
         }
         // array-index :: "[" expr "]"
-        else if (OptionalAccept(TokenType::LeftBracket))
+        else if (auto bracket = OptionalAccept(TokenType::LeftBracket))
         {
-            auto index = Parse();
-            Accept(TokenType::RightBracket);
-            expr = std::make_shared<ArrayAccessExpr>(expr, index);
+            PushFrame(state, FrameContext::ArrayIndex, bracket.value());
+            return Step::Operand;
         }
         // func-call ::= "(" arg-list? ")"
         // arg-list  ::= expr ("," expr)*
-        else if(OptionalAccept(TokenType::LeftParen))
+        //
+        // Note: a function call terminates the postfix-expr.
+        else if (auto paren = OptionalAccept(TokenType::LeftParen))
         {
-            auto arg_list = std::vector<std::shared_ptr<Expr>>{};
             if (CanStartParsing())
             {
-                arg_list.push_back(Parse());
-                while (OptionalAccept(TokenType::Comma))
-                {
-                    arg_list.push_back(Parse());
-                }
+                PushFrame(state, FrameContext::FuncCallArg, paren.value());
+                return Step::Operand;
             }
             Accept(TokenType::RightParen);
-            return std::make_shared<FuncCallExpr>(expr, arg_list);
+            frame.postfix_expr = m_arena->Create<FuncCallExpr>(frame.postfix_expr, frame.arg_list);
+            return Step::BinaryOp;
         }
         // Finished parsing postfix expressions!
         else
         {
-            break;
+            return Step::BinaryOp;
         }
     }
-
-    return expr;
 }
 
-// primary-expr ::= literal | identifier | "(" expr ")"
-std::shared_ptr<Expr> ExprParser::ParsePrimaryExpr()
+ExprParser::Step ExprParser::ParseBinaryOp(ParseState& state)
 {
-    if (auto literal = OptionalAcceptOneOf(LiteralTypes()))
+    auto& frame = state.frames.back();
+
+    // Prefix operators bind tighter than any binary operator,
+    // so the current operand is complete.
+    auto operand = frame.postfix_expr;
+    while (!frame.prefix_ops.empty())
     {
-        return std::make_shared<Literal>(literal.value());
+        operand = m_arena->Create<PrefixExpr>(frame.prefix_ops.back(), operand);
+        frame.prefix_ops.pop_back();
+        --state.nesting_depth;
     }
-    else if (auto id = OptionalAccept(TokenType::Identifier))
+    frame.operands.push_back(operand);
+    frame.postfix_expr = nullptr;
+
+    // Operators with higher or equal precedence already have their
+    // right-hand side, since binary operators are left-associative.
+    auto precedence = BinaryOpPrecedence(Peek());
+    while (!frame.binary_ops.empty() && BinaryOpPrecedence(frame.binary_ops.back().type) >= precedence)
+    {
+        ReduceBinaryExpr(*m_arena, frame.operands, frame.binary_ops);
+    }
+
+    if (precedence > 0)
     {
-        return std::make_shared<Identifier>(id.value());
+        frame.binary_ops.push_back(m_token_stream->GetNext());
+        return Step::Operand;
+    }
+    // At this point, the operands are reduced to a single or-expr.
+    else if (auto op = OptionalAcceptOneOf(AssignmentOps()))
+    {
+        frame.assign_op = op.value();
+        PushFrame(state, FrameContext::AssignmentRhs, op.value());
+        return Step::Operand;
     }
     else
     {
-        Accept(TokenType::LeftParen);
-        auto expr = Parse();
+        return Step::Complete;
+    }
+}
+
+ExprParser::Step ExprParser::CompleteFrame(ParseState& state)
+{
+    auto context = state.frames.back().context;
+    auto result = state.frames.back().operands.back();
+    state.frames.pop_back();
+    --state.nesting_depth;
+
+    auto& frame = state.frames.back();
+    switch (context)
+    {
+    case FrameContext::Parenthesis:
         Accept(TokenType::RightParen);
+        frame.postfix_expr = result;
+        return Step::PostfixOp;
+
+    case FrameContext::ArrayIndex:
+        Accept(TokenType::RightBracket);
+        frame.postfix_expr = m_arena->Create<ArrayAccessExpr>(frame.postfix_expr, result);
+        return Step::PostfixOp;
 
-        return expr;
+    case FrameContext::FuncCallArg:
+        frame.arg_list.push_back(result);
+        if (auto comma = OptionalAccept(TokenType::Comma))
+        {
+            PushFrame(state, FrameContext::FuncCallArg, comma.value());
+            return Step::Operand;
+        }
+        Accept(TokenType::RightParen);
+        frame.postfix_expr = m_arena->Create<FuncCallExpr>(frame.postfix_expr, frame.arg_list);
+        frame.arg_list.clear();
+        return Step::BinaryOp;
+
+    default:
+        // The right-hand side of an assignment is the last part of an expr.
+        frame.operands.back() = m_arena->Create<BinaryExpr>(frame.assign_op, frame.operands.back(), result);
+        return Step::Complete;
+    }
+}
+
+void ExprParser::PushFrame(ParseState& state, FrameContext context, const Token& token)
+{
+    EnterNesting(state, token);
+    state.frames.push_back(Frame{.context = context});
+}
+
+void ExprParser::EnterNesting(ParseState& state, const Token& token)
+{
+    if (++state.nesting_depth > m_max_nesting_depth)
+    {
+        throw NestingLimitError(token, m_max_nesting_depth);
     }
 }
 
@@ -7,10 +7,12 @@ namespace mylang
 
 GlobalDeclParser::GlobalDeclParser(
     std::shared_ptr<BufferedStream<Token>> token_stream,
-    std::shared_ptr<IParseRoutine<std::shared_ptr<Stmt>>> stmt_parser,
+    std::shared_ptr<AstArena> arena,
+    std::shared_ptr<IParseRoutine<Stmt*>> stmt_parser,
     std::shared_ptr<IParseRoutine<Type>> type_parser
 )
     : IParseRoutine(token_stream)
+    , m_arena(arena)
     , m_stmt_parser(stmt_parser)
     , m_type_parser(type_parser)
 {}
@@ -21,7 +23,7 @@ bool GlobalDeclParser::CanStartParsing()
 }
 
 // global-decl ::= "export"? identifier ":" (func-decl | struct-decl)
-std::shared_ptr<GlobalDecl> GlobalDeclParser::Parse()
+GlobalDecl* GlobalDeclParser::Parse()
 {
     try
     {
@@ -45,14 +47,14 @@ std::shared_ptr<GlobalDecl> GlobalDeclParser::Parse()
 }
 
 // func-decl ::= "func" "=" "(" param-list? ")" ("->" type)? stmt
-std::shared_ptr<GlobalDecl> GlobalDeclParser::ParseFuncDecl(bool should_export, const Token& name)
+GlobalDecl* GlobalDeclParser::ParseFuncDecl(bool should_export, const Token& name)
 {
     try
     {
         Accept(TokenType::Func);
         Accept(TokenType::Assign);
         Accept(TokenType::LeftParen);
-        auto parameters = std::vector<std::shared_ptr<Parameter>>{};
+        auto parameters = std::vector<Parameter*>{};
         if (Peek() == TokenType::Identifier)
         {
             parameters = ParseParamList();
@@ -67,7 +69,7 @@ std::shared_ptr<GlobalDecl> GlobalDeclParser::ParseFuncDecl(bool should_export,
 
         auto body = m_stmt_parser->Parse();
 
-        return std::make_shared<FuncDecl>(
+        return m_arena->Create<FuncDecl>(
             should_export,
             name,
             return_type,
@@ -82,11 +84,11 @@ std::shared_ptr<GlobalDecl> GlobalDeclParser::ParseFuncDecl(bool should_export,
 }
 
 // param-list ::= param ("," param)*
-std::vector<std::shared_ptr<Parameter>> GlobalDeclParser::ParseParamList()
+std::vector<Parameter*> GlobalDeclParser::ParseParamList()
 {
     try
     {
-        auto parameters = std::vector<std::shared_ptr<Parameter>>{};
+        auto parameters = std::vector<Parameter*>{};
 
         // First parameter comes immediately.
         parameters.push_back(ParseParam());
@@ -106,7 +108,7 @@ std::vector<std::shared_ptr<Parameter>> GlobalDeclParser::ParseParamList()
 }
 
 // param ::= identifier ":" param-type
-std::shared_ptr<Parameter> GlobalDeclParser::ParseParam()
+Parameter* GlobalDeclParser::ParseParam()
 {
     try
     {
@@ -116,7 +118,7 @@ std::shared_ptr<Parameter> GlobalDeclParser::ParseParam()
         auto usage = ParseParamUsage();
         auto type = m_type_parser->Parse();
 
-        return std::make_shared<Parameter>(name, ParamType{type, usage});
+        return m_arena->Create<Parameter>(name, ParamType{type, usage});
     }
     catch(const ParseRoutineError& e)
     {
@@ -148,7 +150,7 @@ ParamUsage GlobalDeclParser::ParseParamUsage()
 }
 
 // struct-decl ::= "struct" "=" "{" member-decl* "}"
-std::shared_ptr<GlobalDecl> GlobalDeclParser::ParseStructDecl(bool should_export, const Token& name)
+GlobalDecl* GlobalDeclParser::ParseStructDecl(bool should_export, const Token& name)
 {
     try
     {
@@ -165,7 +167,7 @@ std::shared_ptr<GlobalDecl> GlobalDeclParser::ParseStructDecl(bool should_export
 
         Accept(TokenType::RightBrace);
 
-        return std::make_shared<StructDecl>(should_export, name, members);
+        return m_arena->Create<StructDecl>(should_export, name, members);
     }
     catch(const ParseRoutineError& e)
     {
@@ -5,9 +5,11 @@ namespace mylang
 
 ModuleParser::ModuleParser(
     std::shared_ptr<BufferedStream<Token>> token_stream,
-    std::shared_ptr<IParseRoutine<std::shared_ptr<GlobalDecl>>> global_decl_parser
+    std::shared_ptr<AstArena> arena,
+    std::shared_ptr<IParseRoutine<GlobalDecl*>> global_decl_parser
 )
     : IParseRoutine(token_stream)
+    , m_arena(arena)
     , m_global_decl_parser(global_decl_parser)
 {}
 
@@ -17,7 +19,7 @@ bool ModuleParser::CanStartParsing()
 }
 
 // program ::= module-decl module-import* global-decl*
-std::shared_ptr<Module> ModuleParser::Parse()
+Module* ModuleParser::Parse()
 {
     try
     {
@@ -29,13 +31,13 @@ std::shared_ptr<Module> ModuleParser::Parse()
             import_list.push_back(ParseModuleImport());
         }
 
-        auto global_declarations = std::vector<std::shared_ptr<GlobalDecl>>{};
+        auto global_declarations = std::vector<GlobalDecl*>{};
         while (m_global_decl_parser->CanStartParsing())
         {
             global_declarations.push_back(m_global_decl_parser->Parse());
         }
 
-        return std::make_shared<Module>(
+        return m_arena->Create<Module>(
             module_name, import_list, global_declarations
         );
     }
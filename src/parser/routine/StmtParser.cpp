@@ -26,14 +26,49 @@ bool IsFirstOfJumpStmt(TokenType type)
     return JumpTypes().count(type) > 0;
 }
 
+enum class StmtParser::FrameType
+{
+    Stmt,
+    CompoundStmt,
+    IfStmt,
+    ForStmt,
+    WhileStmt
+};
+
+// State of a statement waiting for a nested statement,
+// which would have been the local variables of a recursive descent parser.
+struct StmtParser::Frame
+{
+    FrameType type;
+
+    // Grammar of the statement, used to describe errors.
+    std::string_view pattern = {};
+
+    // Number of compound-stmt enclosing this frame (including itself).
+    int block_depth = 0;
+
+    // compound-stmt
+    std::vector<Stmt*> statements = {};
+
+    // if-stmt, for-stmt, while-stmt
+    Expr* condition = nullptr;
+    Stmt* then_branch = nullptr;
+    Stmt* initializer = nullptr;
+    Expr* increment_expr = nullptr;
+};
+
 StmtParser::StmtParser(
     std::shared_ptr<BufferedStream<Token>> token_stream,
-    std::shared_ptr<IParseRoutine<std::shared_ptr<Expr>>> expr_parser,
-    std::shared_ptr<IParseRoutine<Type>> type_parser
+    std::shared_ptr<AstArena> arena,
+    std::shared_ptr<IParseRoutine<Expr*>> expr_parser,
+    std::shared_ptr<IParseRoutine<Type>> type_parser,
+    int max_nesting_depth
 )
     : IParseRoutine(token_stream)
+    , m_arena(arena)
     , m_expr_parser(expr_parser)
     , m_type_parser(type_parser)
+    , m_max_nesting_depth(max_nesting_depth)
 {}
 
 bool StmtParser::CanStartParsing()
@@ -56,189 +91,232 @@ bool StmtParser::CanStartParsingVarDecl()
     return Peek(0) == TokenType::Identifier && Peek(1) == TokenType::Colon;
 }
 
-// stmt ::= expr-stmt
-//       | var-decl-stmt
-//       | compound-stmt
-//       | if-stmt
-//       | for-stmt
-//       | while-stmt
-//       | jump-stmt
-std::shared_ptr<Stmt> StmtParser::Parse()
+Stmt* StmtParser::Parse()
 {
+    auto frames = std::vector<Frame>{};
     try
     {
-        switch(Peek())
+        auto stmt = BeginStmt(frames);
+        while (!frames.empty())
         {
-        case TokenType::LeftBrace:
-            return ParseCompoundStmt();
-        case TokenType::If:
-            return ParseIfStmt();
-        case TokenType::For:
-            return ParseForStmt();
-        case TokenType::While:
-            return ParseWhileStmt();
-        default:
-            if (CanStartParsingVarDecl())
-            {
-                return ParseVarDeclStmt();
-            }
-            else if (m_expr_parser->CanStartParsing())
-            {
-                return ParseExprStmt();
-            }
-            else
-            {
-                return ParseJumpStmt();
-            }
+            stmt = ResumeStmt(frames, stmt);
         }
+        return stmt;
+    }
+    catch(const NestingLimitError&)
+    {
+        throw;
     }
     catch(const ParseRoutineError& e)
     {
-        throw PatternMismatchError(e, "stmt ::= expr-stmt | var-decl-stmt | if-stmt | for-stmt | while-stmt | jump-stmt");
+        // Describe the unfinished statements from the innermost one,
+        // as if each of them was a nested function call.
+        auto error = PatternMismatchError(e, frames.back().pattern);
+        for (auto frame = std::next(frames.rbegin()); frame != frames.rend(); ++frame)
+        {
+            error = PatternMismatchError(error, frame->pattern);
+        }
+        throw error;
     }
-    
 }
 
-// compound-stmt ::= "{" stmt* "}"
-std::shared_ptr<Stmt> StmtParser::ParseCompoundStmt()
+// stmt ::= expr-stmt
+//       | var-decl-stmt
+//       | compound-stmt
+//       | if-stmt
+//       | for-stmt
+//       | while-stmt
+//       | jump-stmt
+Stmt* StmtParser::BeginStmt(std::vector<Frame>& frames)
 {
-    try
+    PushFrame(frames, FrameType::Stmt, "stmt ::= expr-stmt | var-decl-stmt | if-stmt | for-stmt | while-stmt | jump-stmt");
+    switch(Peek())
     {
-        auto statements = std::vector<std::shared_ptr<Stmt>>{};
-        Accept(TokenType::LeftBrace);
-        while (CanStartParsing())
+    case TokenType::LeftBrace:
+        return BeginCompoundStmt(frames);
+    case TokenType::If:
+        return BeginIfStmt(frames);
+    case TokenType::For:
+        return BeginForStmt(frames);
+    case TokenType::While:
+        return BeginWhileStmt(frames);
+    default:
+        if (CanStartParsingVarDecl())
         {
-            statements.push_back(Parse());
+            return ParseVarDeclStmt();
+        }
+        else if (m_expr_parser->CanStartParsing())
+        {
+            return ParseExprStmt();
+        }
+        else
+        {
+            return ParseJumpStmt();
         }
-        Accept(TokenType::RightBrace);
-        return std::make_shared<CompoundStmt>(statements);
     }
-    catch(const ParseRoutineError& e)
+}
+
+// compound-stmt ::= "{" stmt* "}"
+Stmt* StmtParser::BeginCompoundStmt(std::vector<Frame>& frames)
+{
+    PushFrame(frames, FrameType::CompoundStmt, "compound-stmt ::= \"{\" stmt* \"}\"");
+    auto left_brace = Accept(TokenType::LeftBrace);
+    if (frames.back().block_depth > m_max_nesting_depth)
     {
-        throw PatternMismatchError(e, "compound-stmt ::= \"{\" stmt* \"}\"");
+        throw NestingLimitError(left_brace, m_max_nesting_depth);
     }
+    return nullptr;
 }
 
 // if-stmt ::= "if" "(" expr ")" compound-stmt ("else" (if-stmt | compound-stmt))?
-std::shared_ptr<Stmt> StmtParser::ParseIfStmt()
+Stmt* StmtParser::BeginIfStmt(std::vector<Frame>& frames)
 {
-    try
+    PushFrame(frames, FrameType::IfStmt, "if-stmt ::= \"if\" \"(\" expr \")\" compound-stmt (\"else\" (if-stmt | compound-stmt))?");
+    Accept(TokenType::If);
+    Accept(TokenType::LeftParen);
+    frames.back().condition = m_expr_parser->Parse();
+    Accept(TokenType::RightParen);
+    return BeginCompoundStmt(frames);
+}
+
+// for-stmt ::= "for" "(" (var-decl | expr)? ";" expr? ";" expr? ")" compound-stmt
+Stmt* StmtParser::BeginForStmt(std::vector<Frame>& frames)
+{
+    PushFrame(frames, FrameType::ForStmt, "for-stmt ::= \"for\" \"(\" (var-decl | expr)? \";\" expr? \";\" expr? \")\" compound-stmt");
+    auto& frame = frames.back();
+
+    Accept(TokenType::For);
+    Accept(TokenType::LeftParen);
+
+    // Optional initializer ::= (var-decl | expr)? ";"
+    if (CanStartParsingVarDecl())
     {
-        Accept(TokenType::If);
-        Accept(TokenType::LeftParen);
-        auto condition = m_expr_parser->Parse();
-        Accept(TokenType::RightParen);
-        auto then_branch = ParseCompoundStmt();
-
-        // Parse optional 'else' or 'else-if' branch.
-        auto else_branch = std::shared_ptr<Stmt>{};
-        if (OptionalAccept(TokenType::Else))
-        {
-            // Case 1) else if (...) {...}
-            if (Peek() == TokenType::If)
-            {
-                else_branch = ParseIfStmt();
-            }
-            // Case 2) else {...}
-            else
-            {
-                else_branch = ParseCompoundStmt();
-            }
-        }
+        frame.initializer = ParseVarDeclStmt();
+    }
+    else if (m_expr_parser->CanStartParsing())
+    {
+        frame.initializer = ParseExprStmt();
+    }
+    else
+    {
+        // Note: ParseVarDeclStmt() and ParseExprStmt() accept ";"
+        // at the end, so we should only accept ";" if neither existed.
+        Accept(TokenType::Semicolon);
+    }
 
-        return std::make_shared<IfStmt>(condition, then_branch, else_branch);
+    // Optional condition expr
+    if (m_expr_parser->CanStartParsing())
+    {
+        frame.condition = m_expr_parser->Parse();
     }
-    catch(const ParseRoutineError& e)
+    Accept(TokenType::Semicolon);
+
+    // Optional increment expr
+    if (m_expr_parser->CanStartParsing())
     {
-        throw PatternMismatchError(e, "if-stmt ::= \"if\" \"(\" expr \")\" compound-stmt (\"else\" (if-stmt | compound-stmt))?");
+        frame.increment_expr = m_expr_parser->Parse();
     }
+
+    Accept(TokenType::RightParen);
+
+    return BeginCompoundStmt(frames);
 }
 
-// for-stmt ::= "for" "(" (var-decl | expr)? ";" expr? ";" expr? ")" compound-stmt
-std::shared_ptr<Stmt> StmtParser::ParseForStmt()
+// while-stmt ::= "while" "(" expr ")" compound-stmt
+Stmt* StmtParser::BeginWhileStmt(std::vector<Frame>& frames)
 {
-    try
+    PushFrame(frames, FrameType::WhileStmt, "while-stmt ::= \"while\" \"(\" expr \")\" compound-stmt");
+    Accept(TokenType::While);
+    Accept(TokenType::LeftParen);
+    frames.back().condition = m_expr_parser->Parse();
+    Accept(TokenType::RightParen);
+    return BeginCompoundStmt(frames);
+}
+
+Stmt* StmtParser::ResumeStmt(std::vector<Frame>& frames, Stmt* nested_stmt)
+{
+    auto& frame = frames.back();
+    Stmt* stmt = nullptr;
+    switch (frame.type)
     {
-        Accept(TokenType::For);
-        Accept(TokenType::LeftParen);
+    case FrameType::Stmt:
+        stmt = nested_stmt;
+        break;
 
-        // Optional initializer ::= (var-decl | expr)? ";"
-        auto initializer = std::shared_ptr<Stmt>{};
-        if (CanStartParsingVarDecl())
+    case FrameType::CompoundStmt:
+        if (nested_stmt)
         {
-            initializer = ParseVarDeclStmt();
+            frame.statements.push_back(nested_stmt);
         }
-        else if (m_expr_parser->CanStartParsing())
-        {
-            initializer = ParseExprStmt();
-        }
-        else
+        if (CanStartParsing())
         {
-            // Note: ParseVarDeclStmt() and ParseExprStmt() accept ";"
-            // at the end, so we should only accept ";" if neither existed.
-            Accept(TokenType::Semicolon);
+            return BeginStmt(frames);
         }
+        Accept(TokenType::RightBrace);
+        stmt = m_arena->Create<CompoundStmt>(frame.statements);
+        break;
 
-        // Optional condition expr
-        auto condition = std::shared_ptr<Expr>{};
-        if (m_expr_parser->CanStartParsing())
-        {
-            condition = m_expr_parser->Parse();
-        }
-        Accept(TokenType::Semicolon);
-
-        // Optional increment expr
-        auto increment_expr = std::shared_ptr<Expr>{};
-        if (m_expr_parser->CanStartParsing())
+    case FrameType::IfStmt:
+        // Parse optional 'else' or 'else-if' branch after the 'then' branch.
+        if (!frame.then_branch)
         {
-            increment_expr = m_expr_parser->Parse();
+            frame.then_branch = nested_stmt;
+            if (OptionalAccept(TokenType::Else))
+            {
+                // Case 1) else if (...) {...}
+                if (Peek() == TokenType::If)
+                {
+                    return BeginIfStmt(frames);
+                }
+                // Case 2) else {...}
+                else
+                {
+                    return BeginCompoundStmt(frames);
+                }
+            }
+            nested_stmt = nullptr;
         }
+        stmt = m_arena->Create<IfStmt>(frame.condition, frame.then_branch, nested_stmt);
+        break;
 
-        Accept(TokenType::RightParen);
-
-        auto body = ParseCompoundStmt();
-
-        return std::make_shared<ForStmt>(
-            initializer,
-            condition,
-            increment_expr,
-            body
+    case FrameType::ForStmt:
+        stmt = m_arena->Create<ForStmt>(
+            frame.initializer,
+            frame.condition,
+            frame.increment_expr,
+            nested_stmt
         );
+        break;
+
+    case FrameType::WhileStmt:
+        stmt = m_arena->Create<WhileStmt>(frame.condition, nested_stmt);
+        break;
     }
-    catch(const ParseRoutineError& e)
-    {
-        throw PatternMismatchError(e, "for-stmt ::= \"for\" \"(\" (var-decl | expr)? \";\" expr? \";\" expr? \")\" compound-stmt");
-    }
+
+    frames.pop_back();
+    return stmt;
 }
 
-// while-stmt ::= "while" "(" expr ")" compound-stmt
-std::shared_ptr<Stmt> StmtParser::ParseWhileStmt()
+void StmtParser::PushFrame(std::vector<Frame>& frames, FrameType type, std::string_view pattern)
 {
-    try
+    // Note: an "else if" inherits the depth of the enclosing if-stmt.
+    auto block_depth = frames.empty() ? 0 : frames.back().block_depth;
+    if (type == FrameType::CompoundStmt)
     {
-        Accept(TokenType::While);
-        Accept(TokenType::LeftParen);
-        auto condition = m_expr_parser->Parse();
-        Accept(TokenType::RightParen);
-        auto body = ParseCompoundStmt();
-
-        return std::make_shared<WhileStmt>(condition, body);
-    }
-    catch(const ParseRoutineError& e)
-    {
-        throw PatternMismatchError(e, "while-stmt ::= \"while\" \"(\" expr \")\" compound-stmt");
+        ++block_depth;
     }
+    frames.push_back(Frame{.type = type, .pattern = pattern, .block_depth = block_depth});
 }
 
 // jump-stmt ::= ("return" expr? | "break" | "continue") ";"
-std::shared_ptr<Stmt> StmtParser::ParseJumpStmt()
+Stmt* StmtParser::ParseJumpStmt()
 {
     try
     {
         auto jump_type = AcceptOneOf(JumpTypes());
 
         // Optional return value expr
-        auto expr = std::shared_ptr<Expr>{};
+        Expr* expr = nullptr;
         if (jump_type.type == TokenType::Return && m_expr_parser->CanStartParsing())
         {
             expr = m_expr_parser->Parse();
@@ -246,7 +324,7 @@ std::shared_ptr<Stmt> StmtParser::ParseJumpStmt()
 
         Accept(TokenType::Semicolon);
 
-        return std::make_shared<JumpStmt>(jump_type, expr);
+        return m_arena->Create<JumpStmt>(jump_type, expr);
     }
     catch(const ParseRoutineError& e)
     {
@@ -256,7 +334,7 @@ std::shared_ptr<Stmt> StmtParser::ParseJumpStmt()
 
 // var-decl-stmt ::= var-decl ";"
 // var-decl      ::= identifier ":" type ("=" var-init)?
-std::shared_ptr<Stmt> StmtParser::ParseVarDeclStmt()
+Stmt* StmtParser::ParseVarDeclStmt()
 {
     try
     {
@@ -265,14 +343,14 @@ std::shared_ptr<Stmt> StmtParser::ParseVarDeclStmt()
         auto type = m_type_parser->Parse();
 
         // Optional initializer
-        auto initializer = std::shared_ptr<VarInit>{};
+        VarInit* initializer = nullptr;
         if (OptionalAccept(TokenType::Assign))
         {
             initializer = ParseVarInit();
         }
         Accept(TokenType::Semicolon);
         
-        return std::make_shared<VarDeclStmt>(id, type, initializer);
+        return m_arena->Create<VarDeclStmt>(id, type, initializer);
     }
     catch(const ParseRoutineError& e)
     {
@@ -281,43 +359,82 @@ std::shared_ptr<Stmt> StmtParser::ParseVarDeclStmt()
 }
 
 // var-init ::= expr | "{" var-init ("," var-init)* "}"
-std::shared_ptr<VarInit> StmtParser::ParseVarInit()
+VarInit* StmtParser::ParseVarInit()
 {
+    // Elements of each unclosed initializer list, from the outermost one.
+    auto lists = std::vector<std::vector<VarInit*>>{};
+
+    // Whether a var-init is being parsed as an element of the innermost list
+    // (or as the whole var-init, if there is no list).
+    auto is_parsing_element = true;
     try
     {
-        // "{" var-init ("," var-init)* "}"
-        if (OptionalAccept(TokenType::LeftBrace))
+        while (true)
         {
-            auto initializer_list = std::vector<std::shared_ptr<VarInit>>{};
-            initializer_list.push_back(ParseVarInit());
-            while (OptionalAccept(TokenType::Comma))
+            // "{" var-init ("," var-init)* "}"
+            if (auto left_brace = OptionalAccept(TokenType::LeftBrace))
             {
-                initializer_list.push_back(ParseVarInit());
+                lists.emplace_back();
+                if (static_cast<int>(lists.size()) > m_max_nesting_depth)
+                {
+                    throw NestingLimitError(left_brace.value(), m_max_nesting_depth);
+                }
+                continue;
             }
-            Accept(TokenType::RightBrace);
 
-            return std::make_shared<VarInitList>(initializer_list);
-        }
-        // expr
-        else
-        {
-            return std::make_shared<VarInitExpr>(m_expr_parser->Parse());
+            // expr
+            VarInit* initializer = m_arena->Create<VarInitExpr>(m_expr_parser->Parse());
+            is_parsing_element = false;
+
+            // Close every list that has no more elements.
+            while (!lists.empty())
+            {
+                lists.back().push_back(initializer);
+                if (OptionalAccept(TokenType::Comma))
+                {
+                    is_parsing_element = true;
+                    break;
+                }
+                Accept(TokenType::RightBrace);
+
+                initializer = m_arena->Create<VarInitList>(lists.back());
+                lists.pop_back();
+            }
+
+            if (!is_parsing_element)
+            {
+                return initializer;
+            }
         }
     }
+    catch(const NestingLimitError&)
+    {
+        throw;
+    }
     catch(const ParseRoutineError& e)
     {
-        throw PatternMismatchError(e, "var-init ::= expr | \"{\" var-init (\",\" var-init)* \"}\"");
+        // Each unclosed list and the element being parsed
+        // correspond to a nested var-init in the grammar.
+        auto pattern = "var-init ::= expr | \"{\" var-init (\",\" var-init)* \"}\"";
+        auto num_nested_var_init = lists.size() + (is_parsing_element ? 1 : 0);
+
+        auto error = PatternMismatchError(e, pattern);
+        for (size_t i = 1; i < num_nested_var_init; ++i)
+        {
+            error = PatternMismatchError(error, pattern);
+        }
+        throw error;
     }
 }
 
 // expr-stmt ::= expr ";"
-std::shared_ptr<Stmt> StmtParser::ParseExprStmt()
+Stmt* StmtParser::ParseExprStmt()
 {
     try
     {
         auto expr = m_expr_parser->Parse();
         Accept(TokenType::Semicolon);
-        return std::make_shared<ExprStmt>(expr);
+        return m_arena->Create<ExprStmt>(expr);
     }
     catch(const ParseRoutineError& e)
     {
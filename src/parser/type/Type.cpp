@@ -9,14 +9,16 @@ namespace mylang
 
 Type CreatePrimiveType(TokenType type)
 {
-    if (type != TokenType::IntType &&
-        type != TokenType::FloatType &&
-        type != TokenType::BoolType &&
-        type != TokenType::StringType)
+    auto primitive_type = TryCreatePrimiveType(type);
+    if (!primitive_type)
     {
         throw std::exception("valid primitive types are f32, i32, bool, and str");
     }
+    return primitive_type.value();
+}
 
+Type MakePrimitiveType(TokenType type)
+{
     auto token = Token{
         .type = type,
         .lexeme = TokenTypeName(type)
@@ -24,13 +26,38 @@ Type CreatePrimiveType(TokenType type)
     return Type(std::make_shared<PrimitiveType>(token));
 }
 
+std::optional<Type> TryCreatePrimiveType(TokenType type)
+{
+    // Each primitive type is created only once, and shared from then on.
+    static const auto int_type = MakePrimitiveType(TokenType::IntType);
+    static const auto float_type = MakePrimitiveType(TokenType::FloatType);
+    static const auto bool_type = MakePrimitiveType(TokenType::BoolType);
+    static const auto string_type = MakePrimitiveType(TokenType::StringType);
+
+    switch (type)
+    {
+    case TokenType::IntType:
+        return int_type;
+    case TokenType::FloatType:
+        return float_type;
+    case TokenType::BoolType:
+        return bool_type;
+    case TokenType::StringType:
+        return string_type;
+    default:
+        return {};
+    }
+}
+
 Type CreateVoidType()
 {
-    return Type(std::make_shared<VoidType>());
+    static const auto void_type = Type(std::make_shared<VoidType>());
+    return void_type;
 }
 
 Type::Type(std::shared_ptr<IBaseType> base_type, const std::vector<int>& array_sizes)
-    : m_base_type(base_type), m_array_sizes(array_sizes)
+    : m_base_type(base_type)
+    , m_entry(TypeTable::Global().Intern(m_base_type, array_sizes))
 {}
 
 const IBaseType* Type::BaseType() const
@@ -40,47 +67,39 @@ const IBaseType* Type::BaseType() const
 
 const std::vector<int>& Type::ArraySize() const
 {
-    return m_array_sizes;
+    return m_entry->array_sizes;
 }
 
 bool Type::IsArray() const
 {
-    return !m_array_sizes.empty();
+    return !m_entry->array_sizes.empty();
 }
 
 int Type::NumDimensions() const
 {
-    return static_cast<int>(m_array_sizes.size());
+    return static_cast<int>(m_entry->array_sizes.size());
 }
 
-std::string Type::ToString() const
+Type Type::ElementType() const
 {
-    // Get the base type description.
-    auto type_str = m_base_type->ToString();
+    auto element_type = *this;
+    element_type.m_entry = m_entry->element_entry;
+    return element_type;
+}
 
-    // Append array size information.
-    for (auto size : m_array_sizes)
-    {
-        type_str.append(std::format("[{}]", size));
-    }
-    
-    return type_str;
+bool Type::IsNumeric() const
+{
+    return m_entry->is_numeric;
 }
 
-std::string Type::ToCppString() const
+const std::string& Type::ToString() const
 {
-    // Get the base type description.
-    auto type_str = m_base_type->ToCppString();
+    return m_entry->name;
+}
 
-    // Nest std::array type for multi dimensional array.
-    // ex) i32[dim1][dim2] ==> std::array<std::array<int, dim2>, dim1>
-    for (auto it = m_array_sizes.rbegin(); it != m_array_sizes.rend(); ++it)
-    {
-        auto current_dim_size = *it;
-        type_str = std::format("std::array<{}, {}>", type_str, current_dim_size);
-    }
-    
-    return type_str;
+const std::string& Type::ToCppString() const
+{
+    return m_entry->cpp_name;
 }
 
 bool Type::IsValid(
@@ -88,52 +107,58 @@ bool Type::IsValid(
     std::string_view context_module_name
 ) const
 {
-    // Make sure base type is good.
-    if (!m_base_type->IsValid(environment, context_module_name))
+    // Only struct types need to be looked up.
+    // Note: the result isn't cached for them, since a local variable
+    // can hide a struct type with the same name until the end of its scope.
+    switch (m_entry->validity)
     {
+    case TypeValidity::Valid:
+        return true;
+    case TypeValidity::Invalid:
         return false;
+    default:
+        return m_base_type->IsValid(environment, context_module_name);
     }
+}
 
-    // Now check the array sizes, which should be greater than 0.
-    for (auto size : m_array_sizes)
-    {
-        if (size <= 0)
-        {
-            return false;
-        }
-    }
-
-    // Everything is valid!
-    return true;
+TypeValidity Type::Validity() const
+{
+    return m_entry->validity;
 }
 
 void Type::RemoveLeftmostArrayDim()
 {
-    m_array_sizes.erase(m_array_sizes.begin());
+    auto array_sizes = m_entry->array_sizes;
+    array_sizes.erase(array_sizes.begin());
+    m_entry = TypeTable::Global().InternArray(m_entry->element_entry, array_sizes);
 }
 
 void Type::AddLeftmostArrayDim(int dimension_size)
 {
-    m_array_sizes.insert(m_array_sizes.begin(), dimension_size);
+    auto array_sizes = m_entry->array_sizes;
+    array_sizes.insert(array_sizes.begin(), dimension_size);
+    m_entry = TypeTable::Global().InternArray(m_entry->element_entry, array_sizes);
 }
 
 void Type::MergeArrayDim(const Type& other)
 {
     // Do not allow mixing arrays with different number of dimensions.
-    if (m_array_sizes.size() != other.m_array_sizes.size())
+    if (NumDimensions() != other.NumDimensions())
     {
         throw std::exception("MergeArrayDim() is only allowed on two arrays with same number of dimensions");
     }
 
-    for (int i = 0; i < m_array_sizes.size(); ++i)
+    auto array_sizes = m_entry->array_sizes;
+    for (int i = 0; i < array_sizes.size(); ++i)
     {
-        m_array_sizes[i] = std::max(m_array_sizes[i], other.m_array_sizes[i]);
+        array_sizes[i] = std::max(array_sizes[i], other.ArraySize()[i]);
     }
+    m_entry = TypeTable::Global().InternArray(m_entry->element_entry, array_sizes);
 }
 
 bool Type::operator==(const Type& other) const
 {
-    return ToString() == other.ToString();
+    return m_entry == other.m_entry;
 }
 
 bool Type::operator!=(const Type& other) const
@@ -0,0 +1,229 @@
+#include "parser/type/TypeTable.h"
+#include "parser/type/base/PrimitiveType.h"
+#include "parser/type/base/StructType.h"
+#include "parser/type/base/FuncType.h"
+#include "parser/type/base/VoidType.h"
+#include <format>
+#include <mutex>
+#include <optional>
+
+namespace mylang
+{
+
+// A type is as bad as the worst type it is made of.
+TypeValidity CombineValidity(TypeValidity lhs, TypeValidity rhs)
+{
+    if (lhs == TypeValidity::Invalid || rhs == TypeValidity::Invalid)
+    {
+        return TypeValidity::Invalid;
+    }
+    if (lhs == TypeValidity::DependsOnContext || rhs == TypeValidity::DependsOnContext)
+    {
+        return TypeValidity::DependsOnContext;
+    }
+    return TypeValidity::Valid;
+}
+
+TypeValidity BaseTypeValidity(const IBaseType* base_type)
+{
+    if (dynamic_cast<const StructType*>(base_type))
+    {
+        return TypeValidity::DependsOnContext;
+    }
+
+    if (auto func_type = dynamic_cast<const FuncType*>(base_type))
+    {
+        auto validity = func_type->ReturnType().Validity();
+        for (const auto& param_type : func_type->ParamTypes())
+        {
+            validity = CombineValidity(validity, param_type.type.Validity());
+        }
+        return validity;
+    }
+
+    // Primitive types and void are always valid.
+    return TypeValidity::Valid;
+}
+
+bool IsNumericBaseType(const IBaseType* base_type)
+{
+    auto primitive_type = dynamic_cast<const PrimitiveType*>(base_type);
+    if (!primitive_type)
+    {
+        return false;
+    }
+
+    auto token_type = primitive_type->TypeToken().type;
+    return token_type == TokenType::IntType || token_type == TokenType::FloatType;
+}
+
+// Index of a primitive type in TypeTable::m_primitive_entries, if it is one.
+std::optional<size_t> PrimitiveTypeIndex(TokenType type)
+{
+    switch (type)
+    {
+    case TokenType::IntType:
+        return 0;
+    case TokenType::FloatType:
+        return 1;
+    case TokenType::BoolType:
+        return 2;
+    case TokenType::StringType:
+        return 3;
+    default:
+        return {};
+    }
+}
+
+TypeTable::TypeTable()
+{
+    for (auto type : {TokenType::IntType, TokenType::FloatType, TokenType::BoolType, TokenType::StringType})
+    {
+        auto token = Token{
+            .type = type,
+            .lexeme = TokenTypeName(type),
+            .start_pos = SourcePos{0, 0},
+            .end_pos = SourcePos{0, 0},
+        };
+        auto primitive_type = PrimitiveType(token);
+        m_primitive_entries[*PrimitiveTypeIndex(type)] = InternElement(&primitive_type);
+    }
+
+    auto void_type = VoidType();
+    m_void_entry = InternElement(&void_type);
+}
+
+TypeTable& TypeTable::Global()
+{
+    static auto table = TypeTable();
+    return table;
+}
+
+const TypeEntry* TypeTable::Intern(const std::shared_ptr<IBaseType>& base_type, const std::vector<int>& array_sizes)
+{
+    auto element_entry = FindPredefinedEntry(base_type.get());
+    if (!element_entry)
+    {
+        element_entry = InternElement(base_type.get());
+    }
+    return InternArray(element_entry, array_sizes);
+}
+
+const TypeEntry* TypeTable::InternArray(const TypeEntry* element_entry, const std::vector<int>& array_sizes)
+{
+    if (array_sizes.empty())
+    {
+        return element_entry;
+    }
+
+    auto key = ArrayTypeKey{element_entry, array_sizes};
+    {
+        auto lock = std::shared_lock(m_mutex);
+        if (auto it = m_array_entries.find(key); it != m_array_entries.end())
+        {
+            return it->second;
+        }
+    }
+
+    // Append array size information.
+    // Array sizes should be greater than 0.
+    auto name = element_entry->name;
+    auto validity = element_entry->validity;
+    for (auto size : array_sizes)
+    {
+        name.append(std::format("[{}]", size));
+        if (size <= 0)
+        {
+            validity = TypeValidity::Invalid;
+        }
+    }
+
+    // Nest std::array type for multi dimensional array.
+    // ex) i32[dim1][dim2] ==> std::array<std::array<int, dim2>, dim1>
+    auto cpp_name = element_entry->cpp_name;
+    for (auto it = array_sizes.rbegin(); it != array_sizes.rend(); ++it)
+    {
+        cpp_name = std::format("std::array<{}, {}>", cpp_name, *it);
+    }
+
+    // Another thread may have interned the same type in the meantime.
+    auto lock = std::unique_lock(m_mutex);
+    auto [slot, is_new_entry] = m_array_entries.try_emplace(std::move(key), nullptr);
+    if (is_new_entry)
+    {
+        slot->second = &m_entries.emplace_back(TypeEntry{
+            .element_entry = element_entry,
+            .array_sizes = array_sizes,
+            .name = std::move(name),
+            .cpp_name = std::move(cpp_name),
+            .is_numeric = false,
+            .validity = validity,
+        });
+    }
+    return slot->second;
+}
+
+const TypeEntry* TypeTable::FindPredefinedEntry(const IBaseType* base_type) const
+{
+    if (auto primitive_type = dynamic_cast<const PrimitiveType*>(base_type))
+    {
+        // The spelling is compared in case the token was made up.
+        auto index = PrimitiveTypeIndex(primitive_type->TypeToken().type);
+        if (index && primitive_type->TypeToken().lexeme == m_primitive_entries[*index]->name)
+        {
+            return m_primitive_entries[*index];
+        }
+        return nullptr;
+    }
+
+    if (dynamic_cast<const VoidType*>(base_type))
+    {
+        return m_void_entry;
+    }
+    return nullptr;
+}
+
+const TypeEntry* TypeTable::InternElement(const IBaseType* base_type)
+{
+    // Spelling a function type creates other types, so it is done before locking.
+    auto name = base_type->ToString();
+    {
+        auto lock = std::shared_lock(m_mutex);
+        if (auto it = m_element_entries.find(name); it != m_element_entries.end())
+        {
+            return it->second;
+        }
+    }
+
+    auto entry = TypeEntry{
+        .element_entry = nullptr,
+        .array_sizes = {},
+        .name = name,
+        .cpp_name = base_type->ToCppString(),
+        .is_numeric = IsNumericBaseType(base_type),
+        .validity = BaseTypeValidity(base_type),
+    };
+
+    // Another thread may have interned the same type in the meantime.
+    auto lock = std::unique_lock(m_mutex);
+    auto [slot, is_new_entry] = m_element_entries.try_emplace(std::move(name), nullptr);
+    if (is_new_entry)
+    {
+        auto& new_entry = m_entries.emplace_back(std::move(entry));
+        new_entry.element_entry = &new_entry;
+        slot->second = &new_entry;
+    }
+    return slot->second;
+}
+
+size_t TypeTable::ArrayTypeKeyHash::operator()(const ArrayTypeKey& key) const
+{
+    auto hash = std::hash<const TypeEntry*>()(key.element_entry);
+    for (auto size : key.array_sizes)
+    {
+        hash = hash * 31 + std::hash<int>()(size);
+    }
+    return hash;
+}
+
+} // namespace mylang
@@ -36,4 +36,9 @@ bool PrimitiveType::IsValid(
     return true;
 }
 
+const Token& PrimitiveType::TypeToken() const
+{
+    return m_type;
+}
+
 } // namespace mylang
@@ -24,29 +24,40 @@ bool StructType::IsValid(
     std::string_view context_module_name
 ) const
 {
-    try
-    {
-        // Check if the base type's name exists in a symbol table.
-        // If not, an exception will be thrown.
-        auto symbol = environment.FindSymbol(context_module_name, m_type.lexeme); 
-
-        // If the symbol exists, make sure it was declared as a struct type.
-        //
-        // Since syntax analyzer doesn't care
-        // whether an identifier is a struct or not,
-        // the test below can actually fail!
-        //
-        // example)
-        // foo: func = (){}
-        // main: func = ()->int {
-        //     i: foo = 1; // ERROR: foo is not a struct type!
-        // }
-        return dynamic_cast<StructDecl*>(symbol.declaration) != nullptr;
-    }
-    catch(const std::exception&)
+    // Check if the base type's name exists in a symbol table.
+    auto symbol = environment.TryFindSymbol(context_module_name, m_type.lexeme);
+    if (!symbol)
     {
         return false;
     }
+
+    // If the symbol exists, make sure it was declared as a struct type.
+    //
+    // Since syntax analyzer doesn't care
+    // whether an identifier is a struct or not,
+    // the test below can actually fail!
+    //
+    // example)
+    // foo: func = (){}
+    // main: func = ()->int {
+    //     i: foo = 1; // ERROR: foo is not a struct type!
+    // }
+    return dynamic_cast<StructDecl*>(symbol->declaration) != nullptr;
+}
+
+const Token& StructType::TypeToken() const
+{
+    return m_type;
+}
+
+const StructDecl* StructType::Declaration() const
+{
+    return m_declaration;
+}
+
+void StructType::BindDeclaration(const StructDecl* declaration) const
+{
+    m_declaration = declaration;
 }
 
 } // namespace mylang
@@ -647,4 +647,47 @@ TEST(CodeGenerator, CallableVariable)
             "}\n";
         ExpectOutputEquality(generator->GetFile("a.cpp"), expected);
     }
-}
\ No newline at end of file
+}
+std::string Repeat(std::string_view pattern, int count)
+{
+    auto output = std::string{};
+    for (int i = 0; i < count; ++i)
+    {
+        output += pattern;
+    }
+    return output;
+}
+
+TEST(CodeGenerator, DeepTrees)
+{
+    // Generating either of these recursively would overflow the stack.
+    auto depth = 50000;
+    auto source =
+        "module a;\n"
+        "foo: func = (){\n"
+        "    i: i32 = 0;\n"
+        "    i = i" + Repeat(" + 1", depth) + ";\n"
+        "    if (true) {}" + Repeat(" else if (true) {}", depth) + "\n"
+        "}\n";
+
+    auto environment = ProgramEnvironment();
+    auto ast_list = std::vector{
+        GenerateAST(std::move(source))
+    };
+    auto generator = GenerateOutput(environment, ast_list);
+
+    // a.cpp
+    {
+        auto expected =
+            "#include \"a.h\"\n"
+            "void foo();\n"
+            "void foo() {\n"
+            "    int i = 0;\n"
+            "    (i = " + Repeat("(", depth) + "i" + Repeat(" + 1)", depth) + ");\n"
+            "    if (true) {\n"
+            "    }\n" +
+            Repeat("    else if (true) {\n    }\n", depth) +
+            "}\n";
+        ExpectOutputEquality(generator->GetFile("a.cpp"), expected);
+    }
+}
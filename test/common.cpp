@@ -1,5 +1,7 @@
 #include "file/DummySourceFile.h"
 #include "common/BufferedStream.h"
+#include "common/ThreadPool.h"
+#include "common/TaskGraph.h"
 #include <gtest/gtest.h>
 
 using namespace mylang;
@@ -106,4 +108,159 @@ TEST(BufferedStream, RewindCheckpoint)
     ASSERT_EQ(stream.GetNext().ch, '4');
     ASSERT_EQ(stream.GetNext().ch, '$');
     ASSERT_TRUE(stream.IsFinished());
-}
\ No newline at end of file
+}
+TEST(ThreadPool, SubmitAndWait)
+{
+    auto thread_pool = ThreadPool(4);
+
+    auto futures = std::vector<std::future<int>>{};
+    for (int i = 0; i < 100; ++i)
+    {
+        futures.push_back(thread_pool.Submit([i]() { return i * i; }));
+    }
+
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_EQ(thread_pool.Wait(futures[i]), i * i);
+    }
+}
+
+TEST(ThreadPool, NestedWaitSingleThread)
+{
+    // The only worker waits for a subtask,
+    // which should be executed instead of blocking forever.
+    auto thread_pool = ThreadPool(1);
+    auto outer = thread_pool.Submit([&]() {
+        auto inner = thread_pool.Submit([]() { return 42; });
+        return thread_pool.Wait(inner) + 1;
+    });
+
+    ASSERT_EQ(thread_pool.Wait(outer), 43);
+}
+
+TEST(ThreadPool, WaitOnlyRunsSubtasks)
+{
+    // Each task waits for a subtask queued behind the other tasks.
+    // The tasks shouldn't pile up on the stack of the worker while it waits,
+    // so at most two of them run at once: one on the worker and one on this thread.
+    auto thread_pool = ThreadPool(1);
+    auto num_running = std::atomic<int>(0);
+    auto max_running = std::atomic<int>(0);
+    auto futures = std::vector<std::future<int>>{};
+    for (int i = 0; i < 50; ++i)
+    {
+        futures.push_back(thread_pool.Submit([&, i]() {
+            auto running = ++num_running;
+            max_running = std::max(max_running.load(), running);
+            auto inner = thread_pool.Submit([i]() { return i * 2; });
+            auto result = thread_pool.Wait(inner) + 1;
+            --num_running;
+            return result;
+        }));
+    }
+
+    for (int i = 0; i < 50; ++i)
+    {
+        ASSERT_EQ(thread_pool.Wait(futures[i]), i * 2 + 1);
+    }
+    ASSERT_LE(max_running, 2);
+}
+
+TEST(ThreadPool, WaitRunsTasksOfSubtasks)
+{
+    // The task waits for a task that its subtask submitted and didn't wait for.
+    auto thread_pool = ThreadPool(1);
+    auto future = thread_pool.Submit([&]() {
+        auto subtask = thread_pool.Submit([&]() {
+            return thread_pool.Submit([]() { return 7; });
+        });
+        auto inner = thread_pool.Wait(subtask);
+        return thread_pool.Wait(inner) + 1;
+    });
+
+    ASSERT_EQ(thread_pool.Wait(future), 8);
+}
+
+TEST(ThreadPool, ExceptionPropagation)
+{
+    auto thread_pool = ThreadPool(2);
+    auto future = thread_pool.Submit([]() -> int { throw std::runtime_error("failed"); });
+
+    ASSERT_THROW(thread_pool.Wait(future), std::runtime_error);
+}
+
+TEST(TaskGraph, RunsTasksAfterTheirDependencies)
+{
+    // A single thread still runs every task, since Run() helps while it waits.
+    for (auto num_threads : {1u, 4u})
+    {
+        auto thread_pool = ThreadPool(num_threads);
+        auto mutex = std::mutex();
+        auto order = std::vector<int>{};
+        auto record = [&](int task) {
+            return [&, task]() {
+                auto lock = std::lock_guard(mutex);
+                order.push_back(task);
+            };
+        };
+
+        // 0 -> {1, 2} -> 3
+        auto graph = TaskGraph();
+        auto a = graph.AddTask(record(0));
+        auto b = graph.AddTask(record(1), {a});
+        auto c = graph.AddTask(record(2), {a});
+        graph.AddTask(record(3), {b, c});
+        graph.Run(thread_pool);
+
+        ASSERT_EQ(order.size(), 4);
+        ASSERT_EQ(order.front(), 0);
+        ASSERT_EQ(order.back(), 3);
+    }
+}
+
+TEST(TaskGraph, SkipsDependentsOfFailedTask)
+{
+    auto thread_pool = ThreadPool(2);
+    auto has_run = std::vector<std::atomic<bool>>(4);
+
+    auto graph = TaskGraph();
+    auto failed = graph.AddTask([]() { throw std::runtime_error("failed"); });
+    auto dependent = graph.AddTask([&]() { has_run[1] = true; }, {failed});
+    graph.AddTask([&]() { has_run[2] = true; }, {dependent});
+    graph.AddTask([&]() { has_run[3] = true; });
+
+    auto failed_task = std::optional<TaskGraph::TaskId>();
+    ASSERT_THROW(graph.Run(thread_pool, [&](TaskGraph::TaskId id) { failed_task = id; }), std::runtime_error);
+    ASSERT_EQ(failed_task, failed);
+    ASSERT_FALSE(has_run[1]);
+    ASSERT_FALSE(has_run[2]);
+    ASSERT_TRUE(has_run[3]);
+}
+
+TEST(TaskGraph, ReportsFirstFailedTaskInOrder)
+{
+    using namespace std::chrono_literals;
+
+    // The first task fails last, but it is still the one reported.
+    auto thread_pool = ThreadPool(2);
+    auto graph = TaskGraph();
+    graph.AddTask([]() {
+        std::this_thread::sleep_for(20ms);
+        throw std::runtime_error("first");
+    });
+    graph.AddTask([]() { throw std::runtime_error("second"); });
+
+    auto failed_task = std::optional<TaskGraph::TaskId>();
+    try
+    {
+        graph.Run(thread_pool, [&](TaskGraph::TaskId id) { failed_task = id; });
+        FAIL();
+    }
+    catch(const std::runtime_error& e)
+    {
+        ASSERT_STREQ(e.what(), "first");
+    }
+    ASSERT_EQ(failed_task, 0);
+
+    ASSERT_THROW(graph.AddTask([]() {}, {2}), std::invalid_argument);
+}
@@ -7,15 +7,44 @@
 #include "parser/routine/GlobalDeclParser.h"
 #include "parser/routine/ModuleParser.h"
 #include "parser/SyntaxAnalyzer.h"
+#include "parser/AstCache.h"
+#include "parser/AstSerializer.h"
+#include "parser/PassManager.h"
+#include "parser/IncrementalChecker.h"
+#include "parser/IncrementalParser.h"
+#include "parser/ResumableParser.h"
+#include "parser/ast/AstArena.h"
+#include "parser/ast/SideTable.h"
+#include "parser/ast/StructuralHash.h"
+#include "parser/ast/stmt/CompoundStmt.h"
+#include "parser/ast/stmt/ForStmt.h"
+#include "parser/ast/stmt/VarDeclStmt.h"
+#include "parser/ast/expr/Identifier.h"
+#include "parser/ast/FlatAstCursor.h"
+#include "parser/ast/visitor/FlatAstBuilder.h"
 #include "parser/ast/visitor/TreePrinter.h"
+#include "parser/ast/visitor/StaticAstVisitor.h"
+#include "parser/ast/visitor/AstWalker.h"
+#include "parser/ast/visitor/AstExporter.h"
 #include "parser/ast/visitor/GlobalSymbolScanner.h"
+#include "parser/ast/visitor/NameBinder.h"
 #include "parser/ast/visitor/TypeChecker.h"
 #include "parser/ast/visitor/JumpStmtUsageChecker.h"
 #include "parser/SemanticError.h"
+#include "parser/Diagnostics.h"
 #include "parser/type/Type.h"
 #include "parser/type/base/PrimitiveType.h"
+#include "parser/type/base/StructType.h"
+#include "parser/type/base/FuncType.h"
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <set>
 #include <sstream>
+#include <thread>
 
 using namespace mylang;
 
@@ -69,6 +98,79 @@ TEST(Type, MergeArraySizeDifferentDimension)
     EXPECT_THROW(type1.MergeArrayDim(type2), std::exception);
 }
 
+TEST(Type, Interning)
+{
+    auto type1 = CreateDummyIntArrayType({5, 3});
+    auto type2 = CreateDummyIntArrayType({2});
+    type2.AddLeftmostArrayDim(5);
+    type2.MergeArrayDim(CreateDummyIntArrayType({2, 3}));
+
+    // Equal types share their spelling and properties, but each keeps its own base type.
+    ASSERT_EQ(type1, type2);
+    ASSERT_EQ(&type1.ToString(), &type2.ToString());
+    ASSERT_NE(type1.BaseType(), type2.BaseType());
+    ASSERT_EQ(type2.ToString(), "i32[5][3]");
+    ASSERT_EQ(type2.ToCppString(), "std::array<std::array<int, 3>, 5>");
+
+    ASSERT_EQ(type1.ElementType(), CreatePrimiveType(TokenType::IntType));
+    ASSERT_FALSE(type1.IsNumeric());
+    ASSERT_TRUE(type1.ElementType().IsNumeric());
+    ASSERT_FALSE(CreatePrimiveType(TokenType::BoolType).IsNumeric());
+
+    ASSERT_EQ(type1.Validity(), TypeValidity::Valid);
+    ASSERT_EQ(CreateDummyIntArrayType({0}).Validity(), TypeValidity::Invalid);
+    auto struct_type = Type(std::make_shared<StructType>(Token{.type = TokenType::Identifier, .lexeme = "vec"}), {2});
+    ASSERT_EQ(struct_type.Validity(), TypeValidity::DependsOnContext);
+}
+
+TEST(Type, ConcurrentInterning)
+{
+    // Every thread creates the same types, which should end up in the same entries.
+    auto create_types = [](int thread_index) {
+        auto types = std::vector<Type>{};
+        for (int i = 0; i < 200; ++i)
+        {
+            // Each thread starts at a different type.
+            auto k = (i + thread_index) % 200;
+            auto name = std::format("s{}", k % 50);
+            auto struct_type = Type(std::make_shared<StructType>(Token{.type = TokenType::Identifier, .lexeme = name}), {k % 3 + 1});
+            auto param_types = std::vector<ParamType>{{struct_type, ParamUsage::In}};
+            types.push_back(struct_type);
+            types.push_back(Type(std::make_shared<FuncType>(param_types, CreateDummyIntArrayType({k % 5 + 1}))));
+        }
+        std::sort(types.begin(), types.end(), [](const Type& lhs, const Type& rhs) { return lhs.ToString() < rhs.ToString(); });
+        return types;
+    };
+
+    auto thread_pool = ThreadPool(4);
+    auto futures = std::vector<std::future<std::vector<Type>>>{};
+    for (int i = 0; i < 8; ++i)
+    {
+        futures.push_back(thread_pool.Submit([=]() { return create_types(i * 10); }));
+    }
+
+    auto expected = futures[0].get();
+    for (size_t i = 1; i < futures.size(); ++i)
+    {
+        auto types = futures[i].get();
+        ASSERT_EQ(types.size(), expected.size());
+        for (size_t j = 0; j < types.size(); ++j)
+        {
+            ASSERT_EQ(types[j], expected[j]);
+            ASSERT_EQ(&types[j].ToString(), &expected[j].ToString());
+        }
+    }
+}
+
+TEST(Type, CreatePrimitiveType)
+{
+    ASSERT_EQ(TryCreatePrimiveType(TokenType::FloatType)->ToString(), "f32");
+    ASSERT_EQ(CreatePrimiveType(TokenType::StringType).ToString(), "str");
+
+    ASSERT_FALSE(TryCreatePrimiveType(TokenType::Identifier).has_value());
+    EXPECT_THROW(CreatePrimiveType(TokenType::Identifier), std::exception);
+}
+
 void TestTypeParser(const std::vector<Token>& tokens, std::string_view expected)
 {
     auto lexer = std::make_unique<DummyLexicalAnalyzer>(tokens);
@@ -172,7 +274,8 @@ void TestExprParser(const std::vector<Token>& tokens, std::string_view expected)
 {
     auto lexer = std::make_unique<DummyLexicalAnalyzer>(tokens);
     auto token_stream = std::make_shared<BufferedStream<Token>>(std::move(lexer));
-    auto parser = ExprParser(token_stream);
+    auto arena = std::make_shared<AstArena>();
+    auto parser = ExprParser(token_stream, arena);
     auto type = parser.Parse();
 
     ASSERT_EQ(type->ToString(), expected);
@@ -386,9 +489,10 @@ void TestStmtParser(const std::vector<Token>& tokens, std::string_view expected)
 {
     auto lexer = std::make_unique<DummyLexicalAnalyzer>(tokens);
     auto token_stream = std::make_shared<BufferedStream<Token>>(std::move(lexer));
-    auto expr_parser = std::make_shared<ExprParser>(token_stream);
+    auto arena = std::make_shared<AstArena>();
+    auto expr_parser = std::make_shared<ExprParser>(token_stream, arena);
     auto type_parser = std::make_shared<TypeParser>(token_stream);
-    auto parser = StmtParser(token_stream, expr_parser, type_parser);
+    auto parser = StmtParser(token_stream, arena, expr_parser, type_parser);
     auto ast = parser.Parse();
 
     auto output = std::ostringstream();
@@ -643,10 +747,11 @@ void TestGlobalDeclParser(const std::vector<Token>& tokens, std::string_view exp
 {
     auto lexer = std::make_unique<DummyLexicalAnalyzer>(tokens);
     auto token_stream = std::make_shared<BufferedStream<Token>>(std::move(lexer));
-    auto expr_parser = std::make_shared<ExprParser>(token_stream);
+    auto arena = std::make_shared<AstArena>();
+    auto expr_parser = std::make_shared<ExprParser>(token_stream, arena);
     auto type_parser = std::make_shared<TypeParser>(token_stream);
-    auto stmt_parser = std::make_shared<StmtParser>(token_stream, expr_parser, type_parser);
-    auto parser = GlobalDeclParser(token_stream, stmt_parser, type_parser);
+    auto stmt_parser = std::make_shared<StmtParser>(token_stream, arena, expr_parser, type_parser);
+    auto parser = GlobalDeclParser(token_stream, arena, stmt_parser, type_parser);
     auto ast = parser.Parse();
 
     auto output = std::ostringstream();
@@ -779,11 +884,12 @@ void TestModuleParser(const std::vector<Token>& tokens, std::string_view expecte
 {
     auto lexer = std::make_unique<DummyLexicalAnalyzer>(tokens);
     auto token_stream = std::make_shared<BufferedStream<Token>>(std::move(lexer));
-    auto expr_parser = std::make_shared<ExprParser>(token_stream);
+    auto arena = std::make_shared<AstArena>();
+    auto expr_parser = std::make_shared<ExprParser>(token_stream, arena);
     auto type_parser = std::make_shared<TypeParser>(token_stream);
-    auto stmt_parser = std::make_shared<StmtParser>(token_stream, expr_parser, type_parser);
-    auto global_decl_parser = std::make_shared<GlobalDeclParser>(token_stream, stmt_parser, type_parser);
-    auto parser = ModuleParser(token_stream, global_decl_parser);
+    auto stmt_parser = std::make_shared<StmtParser>(token_stream, arena, expr_parser, type_parser);
+    auto global_decl_parser = std::make_shared<GlobalDeclParser>(token_stream, arena, stmt_parser, type_parser);
+    auto parser = ModuleParser(token_stream, arena, global_decl_parser);
     auto ast = parser.Parse();
 
     auto output = std::ostringstream();
@@ -841,250 +947,1500 @@ std::shared_ptr<IAbstractSyntaxTree> GenerateAST(std::string&& source_code)
     return syntax_analyzer.GenerateAST();
 }
 
-TEST(GlobalSymbolScanner, SingleFile)
+std::string PrintTree(IAbstractSyntaxTree* ast)
 {
-    auto environment = ProgramEnvironment();
-    auto scanner = GlobalSymbolScanner(environment);
-
-    auto ast = GenerateAST("module a; foo: func = (){}");
-    ast->Accept(&scanner);
+    auto output = std::ostringstream();
+    auto printer = TreePrinter(output);
+    ast->Accept(&printer);
 
-    auto symbol = environment.FindSymbol("a", "foo");
-    ASSERT_FALSE(symbol.is_public);
-    ASSERT_EQ(symbol.scope_level, 0);
-    ASSERT_EQ(symbol.declaration->DeclType().ToString(), "[()]");
+    return output.str();
 }
 
-TEST(GlobalSymbolScanner, SingleFileMultipleDecl)
+std::shared_ptr<IAbstractSyntaxTree> GenerateASTConcurrently(std::string&& source_code, ThreadPool& thread_pool)
 {
-    auto environment = ProgramEnvironment();
-    auto scanner = GlobalSymbolScanner(environment);
+    auto source_file = std::make_unique<DummySourceFile>(std::move(source_code));
+    auto lexer = std::make_unique<LexicalAnalyzer>(std::move(source_file));
+    auto syntax_analyzer = SyntaxAnalyzer(std::move(lexer));
 
-    auto ast = GenerateAST("module a; A: struct = {} export B: struct = {}");
-    ast->Accept(&scanner);
+    return syntax_analyzer.GenerateAST(thread_pool);
+}
 
-    auto symbol_a = environment.FindSymbol("a", "A");
-    ASSERT_FALSE(symbol_a.is_public);
-    ASSERT_EQ(symbol_a.scope_level, 0);
-    ASSERT_EQ(symbol_a.declaration->DeclType().ToString(), "A");
+// Returns the error message reported while parsing the source code.
+template<typename Generator>
+std::string GetSyntaxErrorMessage(Generator&& generate_ast)
+{
+    try
+    {
+        generate_ast();
+    }
+    catch(const std::exception& e)
+    {
+        return e.what();
+    }
+    return "";
+}
 
-    auto symbol_b = environment.FindSymbol("a", "B");
-    ASSERT_TRUE(symbol_b.is_public);
-    ASSERT_EQ(symbol_b.scope_level, 0);
-    ASSERT_EQ(symbol_b.declaration->DeclType().ToString(), "B");
+TEST(SyntaxAnalyzer, ConcurrentParsingSameAsSequential)
+{
+    auto source =
+        "module a;\n"
+        "import b;\n"
+        "import export c;\n"
+        "export vec2: struct = {\n"
+        "    x: f32;\n"
+        "    y: f32;\n"
+        "}\n"
+        "foo: func = (x: i32[3], y: out f32) -> i32 {\n"
+        "    if (x == 1) { return x; } else { y = 2.0; }\n"
+        "    for (i: i32 = 0; i < 10; ++i) { while (true) { break; } }\n"
+        "    arr: i32[2][2] = {{1, 2}, {3, 4}};\n"
+        "    return 0;\n"
+        "}\n"
+        "export bar: func = () {\n"
+        "    f: [(i32[3], out f32) -> i32] = foo;\n"
+        "}\n"
+        "baz: struct = { v: vec2; }\n";
+
+    auto thread_pool = ThreadPool(4);
+    auto expected = PrintTree(GenerateAST(source).get());
+    for (int i = 0; i < 10; ++i)
+    {
+        ASSERT_EQ(PrintTree(GenerateASTConcurrently(source, thread_pool).get()), expected);
+    }
 }
 
-TEST(GlobalSymbolScanner, TwoFiles)
+TEST(SyntaxAnalyzer, ConcurrentParsingManyDecls)
 {
-    auto environment = ProgramEnvironment();
-    auto scanner = GlobalSymbolScanner(environment);
+    auto source = std::string("module a;\n");
+    for (int i = 0; i < 200; ++i)
+    {
+        source += std::format("func{}: func = () -> i32 {{ return {}; }}\n", i, i);
+    }
 
-    auto ast1 = GenerateAST("module a; import b; foo: func = (){}");
-    auto ast2 = GenerateAST("module b; export goo: func = (a:i32){}");
-    ast1->Accept(&scanner);
-    ast2->Accept(&scanner);
+    auto thread_pool = ThreadPool(4);
+    auto expected = PrintTree(GenerateAST(std::string(source)).get());
+    ASSERT_EQ(PrintTree(GenerateASTConcurrently(std::string(source), thread_pool).get()), expected);
+}
 
-    auto foo = environment.FindSymbol("a", "foo");
-    ASSERT_FALSE(foo.is_public);
-    ASSERT_EQ(foo.scope_level, 0);
-    ASSERT_EQ(foo.declaration->DeclType().ToString(), "[()]");
+TEST(SyntaxAnalyzer, ConcurrentParsingSameError)
+{
+    auto invalid_sources = std::vector<std::string>{
+        "module a; foo: func = () { x = 1 } bar: func = () {}",
+        "module a; foo: func = () {} bar: func = () { return }",
+        "module a; foo: func = () {}} bar: func = () {}",
+        "module a; foo: func = () {} bar: func = ( {}",
+        "module a; import b; foo: func = () {} 1;",
+        "module a; foo: func = () {} export export bar: func = () {}",
+        "module a; foo: func = () {} bar: struct = { x: i32; } y",
+        "module a; foo: func = () { s: str = \"unterminated; }",
+        "a; foo: func = () {}",
+    };
 
-    auto goo = environment.FindSymbol("a", "goo");
-    ASSERT_TRUE(goo.is_public);
-    ASSERT_EQ(goo.scope_level, 0);
-    ASSERT_EQ(goo.declaration->DeclType().ToString(), "[(in i32)]");
+    auto thread_pool = ThreadPool(4);
+    for (const auto& source : invalid_sources)
+    {
+        auto expected = GetSyntaxErrorMessage([&]() { GenerateAST(std::string(source)); });
+        auto actual = GetSyntaxErrorMessage([&]() { GenerateASTConcurrently(std::string(source), thread_pool); });
+        ASSERT_NE(expected, "");
+        ASSERT_EQ(actual, expected);
+    }
 }
 
-TEST(GlobalSymbolScanner, ThreeFilesPrivateImport)
+std::string Repeat(std::string_view pattern, int count)
 {
-    auto environment = ProgramEnvironment();
-    auto scanner = GlobalSymbolScanner(environment);
+    auto output = std::string{};
+    for (int i = 0; i < count; ++i)
+    {
+        output += pattern;
+    }
+    return output;
+}
 
-    auto ast1 = GenerateAST("module a; import b;");
-    auto ast2 = GenerateAST("module b; import c;");
-    auto ast3 = GenerateAST("module c; foo: func = (){}");
-    ast1->Accept(&scanner);
-    ast2->Accept(&scanner);
-    ast3->Accept(&scanner);
+void ExpectNestingLimitError(std::string&& source_code, int max_nesting_depth)
+{
+    auto source_file = std::make_unique<DummySourceFile>(std::move(source_code));
+    auto lexer = std::make_unique<LexicalAnalyzer>(std::move(source_file));
+    auto syntax_analyzer = SyntaxAnalyzer(std::move(lexer), max_nesting_depth);
 
-    // "foo" should not be visible outside module "c".
-    EXPECT_THROW(environment.FindSymbol("a", "foo"), std::exception);
-    EXPECT_THROW(environment.FindSymbol("b", "foo"), std::exception);
+    auto message = GetSyntaxErrorMessage([&]() { syntax_analyzer.GenerateAST(); });
+    auto expected = std::format("nesting depth exceeded the limit of {}", max_nesting_depth);
+    ASSERT_NE(message.find(expected), std::string::npos) << message;
 }
 
-TEST(GlobalSymbolScanner, TwoFilesOneModule)
+TEST(SyntaxAnalyzer, DeepParenthesis)
 {
-    auto environment = ProgramEnvironment();
-    auto scanner = GlobalSymbolScanner(environment);
+    // Parentheses don't create a node, so the tree stays shallow.
+    auto source = "module a; foo: func = () { x = " + Repeat("(", 10000) + "1" + Repeat(")", 10000) + "; }";
+    auto source_file = std::make_unique<DummySourceFile>(std::move(source));
+    auto lexer = std::make_unique<LexicalAnalyzer>(std::move(source_file));
+    auto syntax_analyzer = SyntaxAnalyzer(std::move(lexer), 20000);
 
-    auto ast1 = GenerateAST("module a; foo: func = (){}");
-    auto ast2 = GenerateAST("module a; goo: func = (a: i32){}");
-    ast1->Accept(&scanner);
-    ast2->Accept(&scanner);
+    auto expected =
+        "[Module]\n"
+        "- module: a\n"
+        "    [FuncDecl]\n"
+        "    - name: foo\n"
+        "    - export: false\n"
+        "    - return type: void\n"
+        "        [CompoundStmt]\n"
+        "            [ExprStmt]\n"
+        "                [BinaryExpr]\n"
+        "                - (x = 1)\n"
+        "                    [Identifier]\n"
+        "                    - x\n"
+        "                    [Literal]\n"
+        "                    - 1\n";
+    ASSERT_EQ(PrintTree(syntax_analyzer.GenerateAST().get()), expected);
+}
+
+TEST(SyntaxAnalyzer, DeepBlocks)
+{
+    auto source = "module a; foo: func = () " + Repeat("{", 5000) + Repeat("}", 5000);
+    auto source_file = std::make_unique<DummySourceFile>(std::move(source));
+    auto lexer = std::make_unique<LexicalAnalyzer>(std::move(source_file));
+    auto syntax_analyzer = SyntaxAnalyzer(std::move(lexer), 5000);
 
-    // "foo" should not be visible outside module "c".
-    EXPECT_EQ(environment.FindSymbol("a", "foo").declaration->DeclType().ToString(), "[()]");
-    EXPECT_EQ(environment.FindSymbol("a", "goo").declaration->DeclType().ToString(), "[(in i32)]");
+    ASSERT_NO_THROW(syntax_analyzer.GenerateAST());
 }
 
-TEST(GlobalSymbolScanner, InvalidImport)
+TEST(SyntaxAnalyzer, NestingLimitExceeded)
 {
-    auto environment = ProgramEnvironment();
-    auto scanner = GlobalSymbolScanner(environment);
+    ExpectNestingLimitError("module a; foo: func = () { x = " + Repeat("(", 300) + "1" + Repeat(")", 300) + "; }", 256);
+    ExpectNestingLimitError("module a; foo: func = () { x = " + Repeat("!", 300) + "true; }", 256);
+    ExpectNestingLimitError("module a; foo: func = () { x = " + Repeat("a[", 300) + "1" + Repeat("]", 300) + "; }", 256);
+    ExpectNestingLimitError("module a; foo: func = () { x = " + Repeat("f(1, ", 300) + "1" + Repeat(")", 300) + "; }", 256);
+    ExpectNestingLimitError("module a; foo: func = () { " + Repeat("x = ", 300) + "1; }", 256);
+    ExpectNestingLimitError("module a; foo: func = () " + Repeat("{", 300) + Repeat("}", 300), 256);
+    ExpectNestingLimitError("module a; foo: func = () { " + Repeat("while (true) {", 300) + Repeat("}", 301), 256);
+    ExpectNestingLimitError("module a; foo: func = () { x: i32 = " + Repeat("{", 300) + "1" + Repeat("}", 300) + "; }", 256);
 
-    auto ast = GenerateAST("module a; import b;");
-    ast->Accept(&scanner);
+    // Without any limit, this would have crashed with stack overflow.
+    ExpectNestingLimitError("module a; foo: func = () { x = " + Repeat("(", 1000000) + "; }", 256);
+}
 
-    EXPECT_THROW(environment.ValidateModuleDependency(), SemanticError);
+TEST(SyntaxAnalyzer, ElseIfIsNotNesting)
+{
+    auto source = "module a; foo: func = () { if (a) {}" + Repeat(" else if (a) {}", 300) + " }";
+    auto source_file = std::make_unique<DummySourceFile>(std::move(source));
+    auto lexer = std::make_unique<LexicalAnalyzer>(std::move(source_file));
+    auto syntax_analyzer = SyntaxAnalyzer(std::move(lexer), 256);
+
+    ASSERT_NO_THROW(syntax_analyzer.GenerateAST());
 }
 
-TEST(GlobalSymbolScanner, ODRViolation)
+// Records the order in which objects are destroyed.
+struct DestructionLogger
 {
-    auto environment = ProgramEnvironment();
-    auto scanner = GlobalSymbolScanner(environment);
+    DestructionLogger(std::vector<int>& log, int id)
+        :log(log), id(id)
+    {}
 
-    auto ast = GenerateAST("module a; foo: func = (){} foo: struct = { x: str; }");
+    ~DestructionLogger()
+    {
+        log.push_back(id);
+    }
 
-    EXPECT_THROW(ast->Accept(&scanner), SemanticError);
+    std::vector<int>& log;
+    int id;
+};
+
+TEST(AstArena, DestroyInReverseOrder)
+{
+    auto log = std::vector<int>{};
+    {
+        auto arena = AstArena();
+        for (int i = 0; i < 5; ++i)
+        {
+            arena.Create<DestructionLogger>(log, i);
+        }
+        ASSERT_TRUE(log.empty());
+    }
+
+    ASSERT_EQ(log, (std::vector<int>{4, 3, 2, 1, 0}));
 }
 
-void ExpectTypeCheckSuccess(std::string&& source_file)
+TEST(AstArena, Alignment)
 {
-    auto environment = ProgramEnvironment();
-    auto scanner = GlobalSymbolScanner(environment);
-    auto type_checker = TypeChecker(environment);
+    struct alignas(32) Overaligned { char data[40]; };
+    struct Huge { char data[100 * 1024]; };
 
-    auto ast = GenerateAST(std::move(source_file));
-    ast->Accept(&scanner);
+    auto arena = AstArena();
+    for (int i = 0; i < 3000; ++i)
+    {
+        auto c = arena.Create<char>('a');
+        auto d = arena.Create<double>(1.0);
+        auto o = arena.Create<Overaligned>();
+        ASSERT_EQ(*c, 'a');
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(d) % alignof(double), 0);
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(o) % alignof(Overaligned), 0);
+    }
 
-    EXPECT_NO_THROW(ast->Accept(&type_checker));
+    // Larger than a single block.
+    auto huge = arena.Create<Huge>();
+    huge->data[sizeof(Huge) - 1] = 'x';
+    ASSERT_GE(arena.NumBytesUsed(), 3000 * (1 + sizeof(double) + sizeof(Overaligned)) + sizeof(Huge));
 }
 
-void ExpectTypeCheckFailure(std::string&& source_file, std::string_view expected_error_message)
+TEST(AstArena, RetainOtherArena)
 {
-    auto environment = ProgramEnvironment();
-    auto scanner = GlobalSymbolScanner(environment);
-    auto type_checker = TypeChecker(environment);
+    auto log = std::vector<int>{};
+    {
+        auto arena = std::make_shared<AstArena>();
+        {
+            auto other = std::make_shared<AstArena>();
+            other->Create<DestructionLogger>(log, 1);
+            arena->Retain(other);
+        }
+        ASSERT_TRUE(log.empty());
+    }
 
-    auto ast = GenerateAST(std::move(source_file));
-    ast->Accept(&scanner);
+    ASSERT_EQ(log, std::vector<int>{1});
+}
 
-    EXPECT_THROW(
-        try
+TEST(AstArena, ConstructorThrows)
+{
+    // Creates another node in the same arena, then fails.
+    struct Failing
+    {
+        Failing(AstArena& arena, std::vector<int>& log)
         {
-            ast->Accept(&type_checker);
+            arena.Create<DestructionLogger>(log, 1);
+            throw std::runtime_error("failed");
         }
-        catch (const SemanticError& e)
-        {
-            ASSERT_EQ(std::string_view(e.what()), expected_error_message);
-            throw;
-        },
-        SemanticError
-    );
+    };
+
+    auto log = std::vector<int>{};
+    {
+        auto arena = AstArena();
+        arena.Create<DestructionLogger>(log, 0);
+        ASSERT_THROW(arena.Create<Failing>(arena, log), std::runtime_error);
+        arena.Create<DestructionLogger>(log, 2);
+    }
+
+    ASSERT_EQ(log, (std::vector<int>{2, 1, 0}));
+}
+
+TEST(SideTable, SetAndFind)
+{
+    auto arena = AstArena();
+    auto nodes = std::vector<Identifier*>{};
+    for (int i = 0; i < 100; ++i)
+    {
+        nodes.push_back(arena.Create<Identifier>(Token{.type = TokenType::Identifier, .lexeme = std::format("x{}", i)}));
+    }
+
+    // IDs of the nodes a thread creates increase in order of construction.
+    for (size_t i = 1; i < nodes.size(); ++i)
+    {
+        ASSERT_LT(nodes[i - 1]->NodeId(), nodes[i]->NodeId());
+    }
+
+    // Set values out of order, so that the table grows in both directions.
+    auto table = SideTable<std::string>();
+    for (auto i : {50, 99, 0, 51, 7})
+    {
+        table.Set(nodes[i], nodes[i]->Id().lexeme);
+    }
+    table.Set(nodes[7], "overwritten");
+
+    ASSERT_EQ(table.Size(), 5);
+    ASSERT_EQ(table.At(nodes[0]), "x0");
+    ASSERT_EQ(table.At(nodes[7]), "overwritten");
+    ASSERT_EQ(table.At(nodes[99]), "x99");
+    ASSERT_TRUE(table.Contains(nodes[51]));
+    ASSERT_FALSE(table.Contains(nodes[52]));
+    ASSERT_EQ(table.Find(nodes[1]), nullptr);
+    ASSERT_THROW(table.At(nodes[98]), std::out_of_range);
+
+    *table.Find(nodes[50]) += "!";
+    ASSERT_EQ(table.At(nodes[50]), "x50!");
+
+    table.Clear();
+    ASSERT_EQ(table.Size(), 0);
+    ASSERT_FALSE(table.Contains(nodes[0]));
+}
+
+TEST(SideTable, FarApartIds)
+{
+    auto arena = AstArena();
+    auto create_identifier = [&](AstArena& arena, int i) {
+        return arena.Create<Identifier>(Token{.type = TokenType::Identifier, .lexeme = std::format("x{}", i)});
+    };
+    auto nodes = std::vector<Identifier*>{};
+    for (int i = 0; i < 20000; ++i)
+    {
+        nodes.push_back(create_identifier(arena, i));
+    }
+
+    // Another thread takes its IDs from a block of its own.
+    auto other_arena = AstArena();
+    auto other_node = static_cast<Identifier*>(nullptr);
+    std::thread([&]() { other_node = create_identifier(other_arena, -1); }).join();
+
+    // The last node is too far away from the first one to share a vector with it,
+    // until the nodes in between are given values.
+    auto table = SideTable<std::string>();
+    table.Set(nodes[0], "first");
+    table.Set(nodes[19999], "last");
+    table.Set(other_node, "other");
+    for (int i = 1; i < 19999; i += 2)
+    {
+        table.Set(nodes[i], nodes[i]->Id().lexeme);
+    }
+    table.Set(nodes[19999], "overwritten");
+
+    ASSERT_EQ(table.Size(), 10002);
+    ASSERT_EQ(table.At(nodes[0]), "first");
+    ASSERT_EQ(table.At(nodes[19999]), "overwritten");
+    ASSERT_EQ(table.At(other_node), "other");
+    ASSERT_EQ(table.At(nodes[9999]), "x9999");
+    ASSERT_FALSE(table.Contains(nodes[9998]));
+
+    // Values merged in decreasing order of IDs are all kept as well.
+    auto merged = SideTable<std::string>();
+    for (int i = 19998; i >= 0; i -= 2)
+    {
+        auto other = SideTable<std::string>();
+        other.Set(nodes[i], nodes[i]->Id().lexeme);
+        merged.Merge(std::move(other));
+    }
+    merged.Merge(std::move(table));
+    ASSERT_EQ(table.Size(), 0);
+    ASSERT_EQ(merged.Size(), 20001);
+    ASSERT_EQ(merged.At(nodes[9998]), "x9998");
+    ASSERT_EQ(merged.At(nodes[19999]), "overwritten");
+    ASSERT_EQ(merged.At(other_node), "other");
+}
+
+TEST(SideTable, VarDeclStmtHasOneId)
+{
+    auto arena = AstArena();
+    auto type = CreateDummyIntArrayType({});
+    auto node = arena.Create<VarDeclStmt>(Token{.type = TokenType::Identifier, .lexeme = "x"}, type, nullptr);
+
+    // The value is found through either part of the node.
+    auto table = SideTable<int>();
+    table.Set(static_cast<Stmt*>(node), 1);
+    ASSERT_EQ(static_cast<Stmt*>(node)->NodeId(), static_cast<Decl*>(node)->NodeId());
+    ASSERT_EQ(table.At(static_cast<Decl*>(node)), 1);
 }
 
-TEST(TypeChecker, ValidMemberTypes)
+TEST(StructuralHash, IgnoresSourcePositions)
 {
-    auto source = 
-        "module a;\n"
-        "A: struct = {\n"
-        "    m1: i32;\n"
-        "    m2: B[2][3];\n"
+    auto decls = std::string(
+        "struct_a: struct = { x: i32; y: f32[3]; }\n"
+        "func_b: func = (a: i32, b: out i32) -> i32 {\n"
+        "    for (i: i32 = 0; i < a; ++i) { b += arr[i].x * 2; }\n"
+        "    if (a == 0) { return -1; } else { return b; }\n"
         "}\n"
-        "B: struct = {\n"
-        "    m1: str;\n"
-        "    m2: bool;\n"
-        "}\n";
-    ExpectTypeCheckSuccess(source);
+    );
+    auto lhs = GenerateAST("module a;\n" + decls);
+    auto rhs = GenerateAST("module a;\n\n  // comment\n" + decls);
+
+    ASSERT_EQ(lhs->StructuralHash(), rhs->StructuralHash());
+    ASSERT_TRUE(IsStructurallyEqual(lhs.get(), rhs.get()));
+
+    // Each declaration matches its counterpart only.
+    auto& lhs_decls = static_cast<Module*>(lhs.get())->Declarations();
+    auto& rhs_decls = static_cast<Module*>(rhs.get())->Declarations();
+    ASSERT_TRUE(IsStructurallyEqual(lhs_decls[0], rhs_decls[0]));
+    ASSERT_TRUE(IsStructurallyEqual(lhs_decls[1], rhs_decls[1]));
+    ASSERT_FALSE(IsStructurallyEqual(lhs_decls[0], rhs_decls[1]));
+    ASSERT_NE(lhs_decls[0]->StructuralHash(), lhs_decls[1]->StructuralHash());
+}
+
+TEST(StructuralHash, DistinguishesStructure)
+{
+    auto base = GenerateAST("module a; f: func = () -> i32 { x: i32 = 1 + 2 * 3; return x; }");
+    auto variants = std::vector<std::string>{
+        "module b; f: func = () -> i32 { x: i32 = 1 + 2 * 3; return x; }",
+        "module a; g: func = () -> i32 { x: i32 = 1 + 2 * 3; return x; }",
+        "module a; f: func = () -> f32 { x: i32 = 1 + 2 * 3; return x; }",
+        "module a; f: func = () -> i32 { x: i32[1] = 1 + 2 * 3; return x; }",
+        "module a; f: func = () -> i32 { x: i32 = (1 + 2) * 3; return x; }",
+        "module a; f: func = () -> i32 { x: i32 = 1 - 2 * 3; return x; }",
+        "module a; f: func = () -> i32 { x: i32 = 1 + 2 * 4; return x; }",
+        "module a; f: func = () -> i32 { x: i32; return x; }",
+        "module a; f: func = () -> i32 { x: i32 = 1 + 2 * 3; return; }",
+        "module a; f: func = () -> i32 { x: i32 = 1 + 2 * 3; return x; x; }",
+        "module a; import b; f: func = () -> i32 { x: i32 = 1 + 2 * 3; return x; }",
+        "module a; export f: func = () -> i32 { x: i32 = 1 + 2 * 3; return x; }",
+    };
+
+    auto hashes = std::set<uint64_t>{base->StructuralHash()};
+    for (const auto& variant : variants)
+    {
+        auto ast = GenerateAST(std::string(variant));
+        ASSERT_FALSE(IsStructurallyEqual(base.get(), ast.get())) << variant;
+        hashes.insert(ast->StructuralHash());
+    }
+    ASSERT_EQ(hashes.size(), variants.size() + 1);
 }
 
-TEST(TypeChecker, InvalidMemberType)
+TEST(StructuralHash, MissingChildren)
 {
-    auto source =
-        "module a;\n"
-        "A: struct = {\n"
-        "    m1: i32;\n"
-        "    m2: B;\n"
-        "}\n";
-    auto expected_error =
-        "[Semantic Error][Ln 4, Col 5] member variable \"m2\" of struct \"A\" tried to use invalid type \"B\"";
-    ExpectTypeCheckFailure(source, expected_error);
+    auto arena = AstArena();
+    auto x = arena.Create<Identifier>(Token{.type = TokenType::Identifier, .lexeme = "x"});
+    auto other_x = arena.Create<Identifier>(Token{.type = TokenType::Identifier, .lexeme = "x", .start_pos = {3, 4}});
+    auto body = arena.Create<CompoundStmt>(std::vector<Stmt*>{});
+
+    auto with_condition = arena.Create<ForStmt>(nullptr, x, nullptr, body);
+    auto with_increment = arena.Create<ForStmt>(nullptr, nullptr, other_x, body);
+    auto with_other_condition = arena.Create<ForStmt>(nullptr, other_x, nullptr, body);
+
+    ASSERT_FALSE(IsStructurallyEqual(with_condition, with_increment));
+    ASSERT_TRUE(IsStructurallyEqual(with_condition, with_other_condition));
+    ASSERT_FALSE(IsStructurallyEqual(with_condition, nullptr));
+    ASSERT_TRUE(IsStructurallyEqual(nullptr, nullptr));
 }
 
-TEST(TypeChecker, InvalidMemberTypeZeroArraySize)
+std::string_view KindName(IAbstractSyntaxTree* node)
 {
-    auto source =
-        "module a;\n"
-        "A: struct = {\n"
-        "    m: i32[0];\n"
-        "}\n";
-    auto expected_error =
-        "[Semantic Error][Ln 3, Col 5] member variable \"m\" of struct \"A\" tried to use invalid type \"i32[0]\"";
-    ExpectTypeCheckFailure(source, expected_error);
+    static const char* kind_names[] = {
+        "Module",
+        "Parameter", "FuncDecl", "StructDecl",
+        "CompoundStmt", "IfStmt", "ForStmt", "WhileStmt", "JumpStmt", "VarDeclStmt", "ExprStmt",
+        "VarInitExpr", "VarInitList",
+        "ArrayAccessExpr", "BinaryExpr", "FuncCallExpr", "Identifier", "Literal", "MemberAccessExpr", "PostfixExpr", "PrefixExpr",
+    };
+    return kind_names[static_cast<int>(node->NodeKind())];
 }
 
-TEST(TypeChecker, InvalidLocalVarType)
+// Prints a tree in the same format as non-verbose TreePrinter.
+class StaticTreePrinter : public StaticAstVisitor<StaticTreePrinter>
 {
-    auto source =
-        "module a;\n"
-        "main: func =() {\n"
-        "    i: error_type = 0;\n"
-        "}\n";
-    auto expected_error =
-        "[Semantic Error][Ln 3, Col 5] local variable \"i\" tried to use invalid type \"error_type\"";
-    ExpectTypeCheckFailure(source, expected_error);
-}
+public:
+    void Dispatch(IAbstractSyntaxTree* node)
+    {
+        output << std::string(depth * 4, ' ') << std::format("[{}]\n", KindName(node));
 
-TEST(TypeChecker, ValidPrimitiveTypeVarDecl)
+        ++depth;
+        StaticAstVisitor<StaticTreePrinter>::Dispatch(node);
+        --depth;
+    }
+
+    std::ostringstream output;
+    int depth = 0;
+};
+
+TEST(StaticAstVisitor, SameOrderAsTreePrinter)
 {
-    auto source =
+    auto ast = GenerateAST(
         "module a;\n"
-        "main: func =() {\n"
-        "    i: i32 = 0;"
-        "    j: str = \"hello\";\n"
-        "}\n";
-    ExpectTypeCheckSuccess(source);
+        "s: struct = { x: i32; }\n"
+        "f: func = (a: i32[3], b: out s) -> i32 {\n"
+        "    c: i32[2] = { a[0], -a[1]++ };\n"
+        "    for (i: i32 = 0; i < 3; ++i) { if (b.x == 0) { continue; } else { break; } }\n"
+        "    for (;;) { while (true) { f(a, b); } }\n"
+        "    return \"str\" + 1.5;\n"
+        "}\n"
+    );
+
+    auto expected = std::ostringstream();
+    auto tree_printer = TreePrinter(expected, false);
+    ast->Accept(&tree_printer);
+
+    auto printer = StaticTreePrinter();
+    printer.Dispatch(ast.get());
+    ASSERT_EQ(printer.output.str(), expected.str());
 }
 
-TEST(TypeChecker, InvalidPrimitiveTypeVarDecl)
+// Prints a tree in the same format as non-verbose TreePrinter.
+class WalkingTreePrinter : public AstWalker<WalkingTreePrinter>
 {
-    auto source =
+public:
+    bool PreVisitNode(IAbstractSyntaxTree* node)
+    {
+        output << std::string(Depth() * 4, ' ') << std::format("[{}]\n", KindName(node));
+        return true;
+    }
+
+    std::ostringstream output;
+};
+
+TEST(AstWalker, SameOrderAsTreePrinter)
+{
+    auto ast = GenerateAST(
         "module a;\n"
-        "main: func =() {\n"
-        "    i: i32 = \"hello\";"
-        "}\n";
-    auto expected_error =
-        "[Semantic Error][Ln 3, Col 5] implicit conversion from base type \"str\" to \"i32\" is not allowed";
-    ExpectTypeCheckFailure(source, expected_error);
+        "s: struct = { x: i32; }\n"
+        "f: func = (a: i32[3], b: out s) -> i32 {\n"
+        "    c: i32[2] = { a[0], -a[1]++ };\n"
+        "    for (i: i32 = 0; i < 3; ++i) { if (b.x == 0) { continue; } else { break; } }\n"
+        "    for (;;) { while (true) { f(a, b); } }\n"
+        "    return \"str\" + 1.5;\n"
+        "}\n"
+    );
+
+    auto expected = std::ostringstream();
+    auto tree_printer = TreePrinter(expected, false);
+    ast->Accept(&tree_printer);
+
+    auto printer = WalkingTreePrinter();
+    printer.Walk(ast.get());
+    ASSERT_EQ(printer.output.str(), expected.str());
+}
+
+// Records every hook, and skips the rhs of each BinaryExpr.
+class WalkRecorder : public AstWalker<WalkRecorder>
+{
+public:
+    using AstWalker<WalkRecorder>::BeforeChild;
+    using AstWalker<WalkRecorder>::AfterChild;
+
+    bool PreVisitNode(IAbstractSyntaxTree* node)
+    {
+        events.push_back(std::format("pre {}", KindName(node)));
+        return AstWalker<WalkRecorder>::PreVisitNode(node);
+    }
+
+    void PostVisitNode(IAbstractSyntaxTree* node)
+    {
+        events.push_back(std::format("post {}", KindName(node)));
+    }
+
+    bool BeforeChild(BinaryExpr* node, IAbstractSyntaxTree* child)
+    {
+        events.push_back(std::format("before {}", KindName(child)));
+        return child == node->LeftHandOperand();
+    }
+
+    void AfterChild(BinaryExpr*, IAbstractSyntaxTree* child)
+    {
+        events.push_back(std::format("after {}", KindName(child)));
+    }
+
+    std::vector<std::string> events;
+};
+
+TEST(AstWalker, HooksAroundChildren)
+{
+    auto ast = GenerateAST("module a; f: func = () { a + 1; }");
+
+    auto recorder = WalkRecorder();
+    recorder.Walk(ast.get());
+
+    auto expected = std::vector<std::string>{
+        "pre Module",
+        "pre FuncDecl",
+        "pre CompoundStmt",
+        "pre ExprStmt",
+        "pre BinaryExpr",
+        "before Identifier",
+        "pre Identifier",
+        "post Identifier",
+        "after Identifier",
+        "before Literal",
+        "post BinaryExpr",
+        "post ExprStmt",
+        "post CompoundStmt",
+        "post FuncDecl",
+        "post Module",
+    };
+    ASSERT_EQ(recorder.events, expected);
 }
 
-TEST(TypeChecker, ValidArrayVarDecl)
+std::string ExportAst(IAbstractSyntaxTree* ast, AstExportFormat format)
 {
-    auto source =
-        "module a;\n"
-        "main: func =() {\n"
-        "    i: bool[2] = {true, false};\n"
-        "    j: i32[2][2] = {{1, 2}, {3, 4}};\n"
-        "    k: [(i32)];\n"
-        "}\n";
-    ExpectTypeCheckSuccess(source);
+    auto output = std::ostringstream();
+    AstExporter(output, format).Export(ast);
+    return output.str();
 }
 
-TEST(TypeChecker, ValidFuncTypeVar)
+TEST(AstExporter, JsonLines)
 {
-    auto source =
+    auto ast = GenerateAST(
         "module a;\n"
-        "add: func = (a: i32, b: i32) -> i32 {\n"
-        "    return a + b;\n"
-        "}\n"
-        "main: func =() {\n"
-        "    a: [()] = main;\n"
-        "    b: [(i32, i32)->i32] = add;\n"
-        "}\n";
-    ExpectTypeCheckSuccess(source);
+        "import export b;\n"
+        "s: struct = { x: i32; }\n"
+        "export f: func = (p: i32) -> bool { v: str = \"q\\\"\"; return !(p < 1); }\n"
+    );
+
+    auto expected =
+        R"({"id":0,"kind":"Module","line":1,"col":8,"name":"a","imports":[{"name":"b","export":true}]})" "\n"
+        R"({"id":1,"parent":0,"kind":"StructDecl","line":3,"col":1,"name":"s","export":false,"members":[{"name":"x","type":"i32"}]})" "\n"
+        R"({"id":2,"parent":0,"kind":"FuncDecl","line":4,"col":8,"name":"f","export":true,"return_type":"bool"})" "\n"
+        R"({"id":3,"parent":2,"kind":"Parameter","line":4,"col":19,"name":"p","type":"in i32"})" "\n"
+        R"({"id":4,"parent":2,"kind":"CompoundStmt","line":0,"col":0})" "\n"
+        R"({"id":5,"parent":4,"kind":"VarDeclStmt","line":4,"col":37,"name":"v","type":"str"})" "\n"
+        R"({"id":6,"parent":5,"kind":"VarInitExpr","line":4,"col":46})" "\n"
+        R"({"id":7,"parent":6,"kind":"Literal","line":4,"col":46,"value":"\"q\\\"\"","type":"str"})" "\n"
+        R"({"id":8,"parent":4,"kind":"JumpStmt","line":4,"col":53,"jump":"return"})" "\n"
+        R"({"id":9,"parent":8,"kind":"PrefixExpr","line":4,"col":60,"op":"!"})" "\n"
+        R"({"id":10,"parent":9,"kind":"BinaryExpr","line":4,"col":62,"op":"<"})" "\n"
+        R"({"id":11,"parent":10,"kind":"Identifier","line":4,"col":62,"name":"p"})" "\n"
+        R"({"id":12,"parent":10,"kind":"Literal","line":4,"col":66,"value":"1","type":"i32"})" "\n";
+    ASSERT_EQ(ExportAst(ast.get(), AstExportFormat::JsonLines), expected);
+}
+
+TEST(AstExporter, Binary)
+{
+    auto ast = GenerateAST("module a; f: func = () { x; }");
+
+    // Kinds are written plus one, so that 0 can end the children.
+    auto expected = std::string(
+        "MYAST\x01"
+        "\x01\x01\x08" "\x01" "a" "\x00"                 // Module, 1:8, "a", no imports
+        "\x03\x01\x0B" "\x01" "f" "\x00" "\x04" "void"   // FuncDecl, 1:11, "f", not exported, "void"
+        "\x05\x00\x00"                                  // CompoundStmt, unknown position
+        "\x0B\x01\x1A"                                  // ExprStmt, 1:26
+        "\x11\x01\x1A" "\x01" "x"                        // Identifier, 1:26, "x"
+        "\x00\x00\x00\x00\x00",                         // end of each node, innermost first
+        39
+    );
+    ASSERT_EQ(ExportAst(ast.get(), AstExportFormat::Binary), expected);
 }
 
-TEST(TypeChecker, InvalidFuncTypeVarUndefined)
+TEST(AstExporter, DeepTrees)
+{
+    auto ast = GenerateAST("module a; main: func = () { i = i" + Repeat(" + 1", 50000) + "; }");
+
+    // One line for each node: Module, FuncDecl, CompoundStmt, ExprStmt, the assignment,
+    // 'i' on its left, and 'i' and each "+ 1" on its right.
+    auto output = ExportAst(ast.get(), AstExportFormat::JsonLines);
+    ASSERT_EQ(std::count(output.begin(), output.end(), '\n'), 6 + 2 * 50000 + 1);
+}
+
+TEST(SyntaxAnalyzer, TreeOutlivesAnalyzer)
+{
+    // Nodes of every chunk should stay alive with the tree,
+    // after both the analyzer and the thread pool are destroyed.
+    auto source = std::string("module a;\n");
+    for (int i = 0; i < 50; ++i)
+    {
+        source += std::format("func{}: func = () -> i32 {{ return {}; }}\n", i, i);
+    }
+
+    auto expected = PrintTree(GenerateAST(std::string(source)).get());
+    auto ast = std::shared_ptr<IAbstractSyntaxTree>();
+    {
+        auto thread_pool = ThreadPool(4);
+        ast = GenerateASTConcurrently(std::string(source), thread_pool);
+    }
+    ASSERT_EQ(PrintTree(ast.get()), expected);
+}
+
+// Prints FlatAst in the same format as non-verbose TreePrinter.
+std::string PrintFlatAst(const FlatAst& ast, FlatNodeId root = 0)
+{
+    auto output = std::ostringstream();
+    for (auto cursor = FlatAstCursor(ast, root); cursor.IsValid(); cursor.Next())
+    {
+        output << std::string(cursor.Depth() * 4, ' ') << '[' << FlatNodeKindName(cursor.Kind()) << "]\n";
+    }
+    return output.str();
+}
+
+const char* FlatAstTestSource =
+    "module a;\n"
+    "import export b;\n"
+    "export vec2: struct = { x: f32; y: f32; }\n"
+    "foo: func = (x: i32[3], y: out f32) -> i32 {\n"
+    "    if (x[0] == 1) { return x[1]; } else if (true) { y = 2.0; } else {}\n"
+    "    for (i: i32 = 0; ; ++i) { while (!false) { break; } }\n"
+    "    for (;;) { continue; }\n"
+    "    arr: i32[2][2] = {{1, 2}, {3, -4}};\n"
+    "    v: vec2;\n"
+    "    v.x = foo(arr[0]--, v.y);\n"
+    "    return 0;\n"
+    "}\n";
+
+TEST(FlatAst, SameStructureAsTree)
+{
+    auto ast = GenerateAST(FlatAstTestSource);
+    auto flat_ast = CreateFlatAst(ast.get());
+
+    auto output = std::ostringstream();
+    auto printer = TreePrinter(output, false);
+    ast->Accept(&printer);
+
+    ASSERT_EQ(PrintFlatAst(flat_ast), output.str());
+    ASSERT_EQ(flat_ast.SourceNode(0), ast.get());
+}
+
+TEST(FlatAst, Payloads)
+{
+    auto ast = GenerateAST(FlatAstTestSource);
+    auto flat_ast = CreateFlatAst(ast.get());
+
+    ASSERT_EQ(flat_ast.NodeToken(0).lexeme, "a");
+    ASSERT_EQ(flat_ast.ImportList(0).size(), 1);
+    ASSERT_TRUE(flat_ast.ImportList(0)[0].should_export);
+    ASSERT_EQ(flat_ast.NumChildren(0), 2);
+
+    auto vec2 = flat_ast.Child(0, 0);
+    ASSERT_EQ(flat_ast.Kind(vec2), FlatNodeKind::StructDecl);
+    ASSERT_TRUE(flat_ast.HasFlags(vec2, FlatNodeExport));
+    ASSERT_EQ(flat_ast.Members(vec2).size(), 2);
+    ASSERT_EQ(flat_ast.Members(vec2)[1].name.lexeme, "y");
+
+    auto foo = flat_ast.Child(0, 1);
+    ASSERT_EQ(flat_ast.Kind(foo), FlatNodeKind::FuncDecl);
+    ASSERT_FALSE(flat_ast.HasFlags(foo, FlatNodeExport));
+    ASSERT_EQ(flat_ast.NodeType(foo).ToString(), "i32");
+    ASSERT_EQ(flat_ast.NodeParamType(flat_ast.Child(foo, 1)).ToString(), "out f32");
+    ASSERT_EQ(flat_ast.Child(foo, 3), InvalidFlatNodeId);
+
+    // Optional children are described by flags.
+    auto body = flat_ast.Child(foo, 2);
+    auto if_stmt = flat_ast.Child(body, 0);
+    auto for_stmt = flat_ast.Child(body, 1);
+    auto empty_for_stmt = flat_ast.Child(body, 2);
+    ASSERT_TRUE(flat_ast.HasFlags(if_stmt, FlatNodeHasElse));
+    ASSERT_TRUE(flat_ast.HasFlags(for_stmt, FlatNodeHasInitializer | FlatNodeHasIncrement));
+    ASSERT_FALSE(flat_ast.HasFlags(for_stmt, FlatNodeHasCondition));
+    ASSERT_EQ(flat_ast.NumChildren(for_stmt), 3);
+    ASSERT_EQ(flat_ast.NumChildren(empty_for_stmt), 1);
+
+    auto condition = flat_ast.Child(if_stmt, 0);
+    ASSERT_EQ(flat_ast.Kind(condition), FlatNodeKind::BinaryExpr);
+    ASSERT_EQ(flat_ast.NodeToken(condition).type, TokenType::Equal);
+    ASSERT_EQ(flat_ast.Parent(condition), if_stmt);
+    ASSERT_EQ(flat_ast.NodeType(flat_ast.Child(condition, 1)).ToString(), "i32");
+}
+
+TEST(FlatAstCursor, SubtreeAndSkipChildren)
+{
+    auto ast = GenerateAST("module a; foo: func = () { x = 1 + 2; while (x) { y; } }");
+    auto flat_ast = CreateFlatAst(ast.get());
+
+    auto body = flat_ast.Child(flat_ast.Child(0, 0), 0);
+    auto while_stmt = flat_ast.Child(body, 1);
+    ASSERT_EQ(PrintFlatAst(flat_ast, while_stmt),
+        "[WhileStmt]\n"
+        "    [Identifier]\n"
+        "    [CompoundStmt]\n"
+        "        [ExprStmt]\n"
+        "            [Identifier]\n"
+    );
+
+    // Skip every statement of the body.
+    auto kinds = std::vector<FlatNodeKind>{};
+    auto cursor = FlatAstCursor(flat_ast, body);
+    cursor.Next();
+    while (cursor.IsValid())
+    {
+        kinds.push_back(cursor.Kind());
+        cursor.SkipChildren();
+    }
+    ASSERT_EQ(kinds, (std::vector<FlatNodeKind>{FlatNodeKind::ExprStmt, FlatNodeKind::WhileStmt}));
+}
+
+TEST(AstSerializer, RoundTrip)
+{
+    auto ast = GenerateAST(FlatAstTestSource);
+    auto data = SerializeAst(ast.get());
+    auto loaded_ast = DeserializeAst(data);
+
+    ASSERT_EQ(PrintTree(loaded_ast.get()), PrintTree(ast.get()));
+    ASSERT_EQ(SerializeAst(loaded_ast.get()), data);
+
+    // Tokens are preserved, including their source positions.
+    auto flat_ast = CreateFlatAst(ast.get());
+    auto loaded_flat_ast = CreateFlatAst(loaded_ast.get());
+    auto kinds_with_token = std::set<FlatNodeKind>{
+        FlatNodeKind::Module, FlatNodeKind::Parameter, FlatNodeKind::FuncDecl, FlatNodeKind::StructDecl,
+        FlatNodeKind::JumpStmt, FlatNodeKind::VarDeclStmt, FlatNodeKind::BinaryExpr, FlatNodeKind::Identifier,
+        FlatNodeKind::Literal, FlatNodeKind::MemberAccessExpr, FlatNodeKind::PostfixExpr, FlatNodeKind::PrefixExpr
+    };
+    ASSERT_EQ(loaded_flat_ast.NumNodes(), flat_ast.NumNodes());
+    for (FlatNodeId node = 0; node < flat_ast.NumNodes(); ++node)
+    {
+        if (kinds_with_token.contains(flat_ast.Kind(node)))
+        {
+            ASSERT_EQ(loaded_flat_ast.NodeToken(node), flat_ast.NodeToken(node));
+        }
+    }
+}
+
+TEST(AstSerializer, MalformedData)
+{
+    auto data = SerializeAst(GenerateAST(FlatAstTestSource).get());
+
+    for (size_t size = 0; size < data.size(); size += 7)
+    {
+        ASSERT_THROW(DeserializeAst(std::string_view(data).substr(0, size)), std::runtime_error);
+    }
+    ASSERT_THROW(DeserializeAst(data + "x"), std::runtime_error);
+}
+
+TEST(AstSerializer, DeepTrees)
+{
+    // Neither of these chains counts as nesting, so the parser accepts them at any length.
+    auto sources = {
+        "module a; main: func = () { i = i" + Repeat(" + 1", 50000) + "; }",
+        "module a; main: func = () { if (true) {}" + Repeat(" else if (true) {}", 50000) + " }",
+    };
+    for (const auto& source : sources)
+    {
+        auto ast = GenerateAST(std::string(source));
+        auto data = SerializeAst(ast.get());
+        auto loaded_ast = DeserializeAst(data);
+
+        ASSERT_EQ(loaded_ast->StructuralHash(), ast->StructuralHash());
+        ASSERT_EQ(SerializeAst(loaded_ast.get()), data);
+    }
+}
+
+// Creates an empty directory which is removed at the end of the test.
+class AstCacheTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        auto test_name = testing::UnitTest::GetInstance()->current_test_info()->name();
+        cache_directory = std::filesystem::temp_directory_path() / std::format("mylang-ast-cache-{}", test_name);
+        std::filesystem::remove_all(cache_directory);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(cache_directory);
+    }
+
+    std::filesystem::path cache_directory;
+};
+
+TEST_F(AstCacheTest, StoreAndLoad)
+{
+    auto cache = AstCache(cache_directory);
+    auto source = std::string(FlatAstTestSource);
+    ASSERT_EQ(cache.Load("a.txt", source), nullptr);
+
+    auto ast = GenerateAST(std::string(source));
+    cache.Store("a.txt", source, ast.get());
+    auto loaded_ast = cache.Load("a.txt", source);
+
+    ASSERT_NE(loaded_ast, nullptr);
+    ASSERT_EQ(PrintTree(loaded_ast.get()), PrintTree(ast.get()));
+    ASSERT_EQ(cache.Load("a.txt", source + " "), nullptr);
+    ASSERT_EQ(cache.Load("b.txt", source), nullptr);
+}
+
+TEST_F(AstCacheTest, OneEntryPerInputPath)
+{
+    auto cache = AstCache(cache_directory);
+    auto count_entries = [&]() {
+        auto it = std::filesystem::directory_iterator(cache_directory);
+        return std::distance(std::filesystem::begin(it), std::filesystem::end(it));
+    };
+
+    // Each version of the file replaces the last one.
+    for (int i = 0; i < 5; ++i)
+    {
+        auto source = std::format("module a; foo: func = () -> i32 {{ return {}; }}", i);
+        cache.Store("dir/a.txt", source, GenerateAST(std::string(source)).get());
+        ASSERT_NE(cache.Load("dir/a.txt", source), nullptr);
+        ASSERT_EQ(count_entries(), 1);
+    }
+
+    // The same file through another relative path
+    ASSERT_NE(cache.Load("dir/../dir/./a.txt", "module a; foo: func = () -> i32 { return 4; }"), nullptr);
+    ASSERT_EQ(cache.Load("dir/a.txt", "module a; foo: func = () -> i32 { return 0; }"), nullptr);
+
+    auto source = std::string("module b;");
+    cache.Store("dir/b.txt", source, GenerateAST(std::string(source)).get());
+    ASSERT_EQ(count_entries(), 2);
+}
+
+TEST_F(AstCacheTest, DeepTrees)
+{
+    auto cache = AstCache(cache_directory);
+    auto source = "module a; main: func = () { i = i" + Repeat(" + 1", 50000) + "; }";
+    auto ast = GenerateAST(std::string(source));
+    cache.Store("a.txt", source, ast.get());
+
+    auto loaded_ast = cache.Load("a.txt", source);
+    ASSERT_NE(loaded_ast, nullptr);
+    ASSERT_EQ(SerializeAst(loaded_ast.get()), SerializeAst(ast.get()));
+}
+
+TEST_F(AstCacheTest, InvalidEntryIsIgnored)
+{
+    auto cache = AstCache(cache_directory);
+    auto source = std::string("module a; foo: func = () {}");
+    cache.Store("a.txt", source, GenerateAST(std::string(source)).get());
+
+    auto path = cache.EntryPath("a.txt");
+    auto entry = std::string();
+    {
+        auto file = std::ifstream(path, std::ios::binary);
+        entry.assign(std::istreambuf_iterator<char>(file), {});
+    }
+
+    auto overwrite_entry = [&](const std::string& content) {
+        auto file = std::ofstream(path, std::ios::binary | std::ios::trunc);
+        file << content;
+    };
+
+    // Different format version
+    auto modified_entry = entry;
+    modified_entry[8] ^= 1;
+    overwrite_entry(modified_entry);
+    ASSERT_EQ(cache.Load("a.txt", source), nullptr);
+
+    // Truncated
+    overwrite_entry(entry.substr(0, entry.size() - 1));
+    ASSERT_EQ(cache.Load("a.txt", source), nullptr);
+
+    // Corrupted payload
+    modified_entry = entry;
+    modified_entry[entry.size() - 9] ^= 1;
+    overwrite_entry(modified_entry);
+    ASSERT_EQ(cache.Load("a.txt", source), nullptr);
+
+    // Storing again fixes the entry.
+    cache.Store("a.txt", source, GenerateAST(std::string(source)).get());
+    ASSERT_NE(cache.Load("a.txt", source), nullptr);
+}
+
+// Returns the serialized tree or the error message of parsing the source code.
+template<typename Generator>
+std::string GetParseResult(Generator&& generate_ast)
+{
+    try
+    {
+        return SerializeAst(generate_ast().get());
+    }
+    catch(const std::exception& e)
+    {
+        return std::string("error: ") + e.what();
+    }
+}
+
+const char* IncrementalParserTestSource =
+    "module a;\n"
+    "import b;\n"
+    "export vec2: struct = {\n"
+    "    x: f32;\n"
+    "    y: f32;\n"
+    "}\n"
+    "/* block\n"
+    "   comment */\n"
+    "foo: func = (x: i32[3], y: out f32) -> i32 {\n"
+    "    if (x[0] == 1) { return x[1]; } else { y = 2.5; }\n"
+    "    for (i: i32 = 0; i < 10; ++i) { while (true) { break; } }\n"
+    "    arr: i32[2][2] = {{1, 2}, {3, 4}}; // line comment\n"
+    "    return 0;\n"
+    "}\n"
+    "export bar: func = () {\n"
+    "    s: str = \"hello\";\n"
+    "    f: [(i32[3], out f32) -> i32] = foo;\n"
+    "}\n"
+    "baz: struct = { v: vec2; }\n";
+
+TEST(IncrementalParser, ReuseUnchangedDecls)
+{
+    auto source = std::string(IncrementalParserTestSource);
+    auto parser = IncrementalParser(source);
+    ASSERT_EQ(SerializeAst(parser.Parse().get()), SerializeAst(GenerateAST(std::string(source)).get()));
+    ASSERT_EQ(parser.NumParsedDecls(), 4);
+
+    auto apply_edit = [&](size_t offset, size_t length, std::string replacement) {
+        source.replace(offset, length, replacement);
+        auto ast = parser.ApplyEdit({offset, length, replacement});
+        ASSERT_EQ(parser.SourceCode(), source);
+        ASSERT_EQ(SerializeAst(ast.get()), SerializeAst(GenerateAST(std::string(source)).get()));
+    };
+
+    // Within a line of foo
+    apply_edit(source.find("2.5"), 3, "12.75");
+    ASSERT_EQ(parser.NumParsedDecls(), 1);
+    ASSERT_EQ(parser.NumReusedDecls(), 3);
+
+    // New lines in vec2, which moves every later declaration
+    apply_edit(source.find("    y: f32;"), 0, "    z: f32;\n\n");
+    ASSERT_EQ(parser.NumParsedDecls(), 1);
+    ASSERT_EQ(parser.NumReusedDecls(), 3);
+
+    // New declaration between two declarations
+    apply_edit(source.find("baz"), 0, "qux: func = () {}\n");
+    ASSERT_EQ(parser.NumParsedDecls(), 1);
+    ASSERT_EQ(parser.NumReusedDecls(), 4);
+
+    // Comments don't change any token.
+    apply_edit(source.find("block"), 5, "multi-line\n  ");
+    ASSERT_EQ(parser.NumParsedDecls(), 0);
+    ASSERT_EQ(parser.NumReusedDecls(), 5);
+}
+
+TEST(IncrementalParser, SameErrorAsFreshParse)
+{
+    auto source = std::string(IncrementalParserTestSource);
+    auto parser = IncrementalParser(source);
+    parser.Parse();
+
+    // Missing semicolon
+    auto offset = source.find("return 0;") + 8;
+    auto edited_source = std::string(source).erase(offset, 1);
+    auto expected = GetParseResult([&]() { return GenerateAST(std::string(edited_source)); });
+    auto actual = GetParseResult([&]() { return parser.ApplyEdit({offset, 1, ""}); });
+    ASSERT_TRUE(expected.starts_with("error: "));
+    ASSERT_EQ(actual, expected);
+
+    // Unterminated comment
+    edited_source.insert(0, "/*");
+    expected = GetParseResult([&]() { return GenerateAST(std::string(edited_source)); });
+    actual = GetParseResult([&]() { return parser.ApplyEdit({0, 0, "/*"}); });
+    ASSERT_TRUE(expected.starts_with("error: "));
+    ASSERT_EQ(actual, expected);
+
+    // Fixing the errors brings back a valid tree.
+    GetParseResult([&]() { return parser.ApplyEdit({0, 2, ""}); });
+    auto ast = parser.ApplyEdit({offset, 0, ";"});
+    ASSERT_EQ(SerializeAst(ast.get()), SerializeAst(GenerateAST(std::string(source)).get()));
+
+    ASSERT_THROW(parser.ApplyEdit({source.size(), 1, ""}), std::out_of_range);
+}
+
+TEST(IncrementalParser, RandomEdits)
+{
+    // Fragments that are likely to merge with or split the surrounding tokens.
+    auto fragments = std::vector<std::string>{
+        "\n", " ", "x", "1", "2.", ".5", "/", "*", "//", "/*", "*/", "\"", "-", ">", "=", "+",
+        "{", "}", "(", ")", ";", ",", "return 1;", "foo: func = () {}\n", "export ", "s: struct = {}\n",
+    };
+
+    auto random = std::mt19937(12345);
+    auto source = std::string(IncrementalParserTestSource);
+    auto parser = IncrementalParser(source);
+    parser.Parse();
+
+    for (int step = 0; step < 1000; ++step)
+    {
+        auto edit = TextEdit{};
+        if (step % 50 == 49)
+        {
+            // Start over from time to time, since the source code tends to get broken.
+            edit = TextEdit{0, source.size(), IncrementalParserTestSource};
+        }
+        else
+        {
+            edit.offset = std::uniform_int_distribution<size_t>(0, source.size())(random);
+            edit.length = std::min(std::uniform_int_distribution<size_t>(0, 3)(random), source.size() - edit.offset);
+            edit.replacement = fragments[std::uniform_int_distribution<size_t>(0, fragments.size() - 1)(random)];
+            if (random() % 3 == 0)
+            {
+                edit.replacement.clear();
+            }
+        }
+
+        auto undo = TextEdit{edit.offset, edit.replacement.size(), source.substr(edit.offset, edit.length)};
+        source.replace(edit.offset, edit.length, edit.replacement);
+        auto expected = GetParseResult([&]() { return GenerateAST(std::string(source)); });
+        ASSERT_EQ(GetParseResult([&]() { return parser.ApplyEdit(edit); }), expected) << source;
+
+        // Undo half of the edits to keep the source code mostly valid.
+        if (random() % 2 == 0)
+        {
+            source.replace(undo.offset, undo.length, undo.replacement);
+            expected = GetParseResult([&]() { return GenerateAST(std::string(source)); });
+            ASSERT_EQ(GetParseResult([&]() { return parser.ApplyEdit(undo); }), expected) << source;
+        }
+    }
+}
+
+// Lexes the whole source code, and keeps the error that stopped the lexer (if any).
+std::shared_ptr<std::vector<Token>> LexAllTokens(std::string&& source_code, std::exception_ptr& error)
+{
+    auto lexer = LexicalAnalyzer(std::make_unique<DummySourceFile>(std::move(source_code)));
+    auto tokens = std::make_shared<std::vector<Token>>();
+    try
+    {
+        do
+        {
+            tokens->push_back(lexer.GetNext());
+        } while (tokens->back().type != TokenType::EndOfFile);
+    }
+    catch(...)
+    {
+        error = std::current_exception();
+    }
+    return tokens;
+}
+
+TEST(ResumableParser, ParseBeforeInputIsOver)
+{
+    auto error = std::exception_ptr{};
+    auto tokens = LexAllTokens(IncrementalParserTestSource, error);
+    ASSERT_FALSE(error);
+
+    auto parser = ResumableParser();
+    auto num_parsed_decls = std::vector<size_t>{};
+    for (const auto& token : *tokens)
+    {
+        if (token.lexeme == "bar" || token.type == TokenType::EndOfFile)
+        {
+            num_parsed_decls.push_back(parser.NumParsedDecls());
+        }
+        ASSERT_THROW(parser.Result(), std::logic_error);
+        parser.Feed(token);
+    }
+    ASSERT_TRUE(parser.IsFinished());
+
+    // The last declaration is only complete at the end of the input.
+    ASSERT_EQ(num_parsed_decls, (std::vector<size_t>{2, 3}));
+    ASSERT_EQ(parser.NumParsedDecls(), 4);
+    ASSERT_EQ(PrintTree(parser.Result().get()), PrintTree(ParseSequentially(tokens, nullptr, DefaultMaxNestingDepth).get()));
+}
+
+TEST(ResumableParser, SameErrorAsSequential)
+{
+    auto invalid_sources = std::vector<std::string>{
+        "module a; foo: func = () { x = 1 } bar: func = () {}",
+        "module a; foo: func = () {} bar: func = () { return }",
+        "module a; foo: func = () {}} bar: func = () {}",
+        "module a; import b; foo: func = () {} 1;",
+        "module a; foo: func = () {} bar: struct = { x: i32; } y",
+        "module a; foo: func = () { s: str = \"unterminated; }",
+        "module a; foo: func = () { x = 1 } s: str = \"unterminated;",
+        "module a; foo: func = () {} /* unterminated",
+        "module a",
+        "a; foo: func = () {}",
+    };
+
+    for (const auto& source : invalid_sources)
+    {
+        auto error = std::exception_ptr{};
+        auto tokens = LexAllTokens(std::string(source), error);
+        auto expected = GetSyntaxErrorMessage([&]() { ParseSequentially(tokens, error, DefaultMaxNestingDepth); });
+        ASSERT_NE(expected, "");
+
+        auto parser = ResumableParser();
+        for (const auto& token : *tokens)
+        {
+            parser.Feed(token);
+        }
+        if (error)
+        {
+            parser.Fail(error);
+        }
+        ASSERT_EQ(GetSyntaxErrorMessage([&]() { parser.Result(); }), expected);
+        ASSERT_EQ(GetSyntaxErrorMessage([&]() { GenerateAST(std::string(source)); }), expected);
+    }
+}
+
+TEST(GlobalSymbolScanner, SingleFile)
+{
+    auto environment = ProgramEnvironment();
+    auto scanner = GlobalSymbolScanner(environment);
+
+    auto ast = GenerateAST("module a; foo: func = (){}");
+    ast->Accept(&scanner);
+
+    auto symbol = environment.FindSymbol("a", "foo");
+    ASSERT_FALSE(symbol.is_public);
+    ASSERT_EQ(symbol.scope_level, 0);
+    ASSERT_EQ(symbol.declaration->DeclType().ToString(), "[()]");
+}
+
+TEST(GlobalSymbolScanner, SingleFileMultipleDecl)
+{
+    auto environment = ProgramEnvironment();
+    auto scanner = GlobalSymbolScanner(environment);
+
+    auto ast = GenerateAST("module a; A: struct = {} export B: struct = {}");
+    ast->Accept(&scanner);
+
+    auto symbol_a = environment.FindSymbol("a", "A");
+    ASSERT_FALSE(symbol_a.is_public);
+    ASSERT_EQ(symbol_a.scope_level, 0);
+    ASSERT_EQ(symbol_a.declaration->DeclType().ToString(), "A");
+
+    auto symbol_b = environment.FindSymbol("a", "B");
+    ASSERT_TRUE(symbol_b.is_public);
+    ASSERT_EQ(symbol_b.scope_level, 0);
+    ASSERT_EQ(symbol_b.declaration->DeclType().ToString(), "B");
+}
+
+TEST(GlobalSymbolScanner, TwoFiles)
+{
+    auto environment = ProgramEnvironment();
+    auto scanner = GlobalSymbolScanner(environment);
+
+    auto ast1 = GenerateAST("module a; import b; foo: func = (){}");
+    auto ast2 = GenerateAST("module b; export goo: func = (a:i32){}");
+    ast1->Accept(&scanner);
+    ast2->Accept(&scanner);
+
+    auto foo = environment.FindSymbol("a", "foo");
+    ASSERT_FALSE(foo.is_public);
+    ASSERT_EQ(foo.scope_level, 0);
+    ASSERT_EQ(foo.declaration->DeclType().ToString(), "[()]");
+
+    auto goo = environment.FindSymbol("a", "goo");
+    ASSERT_TRUE(goo.is_public);
+    ASSERT_EQ(goo.scope_level, 0);
+    ASSERT_EQ(goo.declaration->DeclType().ToString(), "[(in i32)]");
+}
+
+TEST(GlobalSymbolScanner, ThreeFilesPrivateImport)
+{
+    auto environment = ProgramEnvironment();
+    auto scanner = GlobalSymbolScanner(environment);
+
+    auto ast1 = GenerateAST("module a; import b;");
+    auto ast2 = GenerateAST("module b; import c;");
+    auto ast3 = GenerateAST("module c; foo: func = (){}");
+    ast1->Accept(&scanner);
+    ast2->Accept(&scanner);
+    ast3->Accept(&scanner);
+
+    // "foo" should not be visible outside module "c".
+    EXPECT_THROW(environment.FindSymbol("a", "foo"), std::exception);
+    EXPECT_THROW(environment.FindSymbol("b", "foo"), std::exception);
+}
+
+TEST(GlobalSymbolScanner, TwoFilesOneModule)
+{
+    auto environment = ProgramEnvironment();
+    auto scanner = GlobalSymbolScanner(environment);
+
+    auto ast1 = GenerateAST("module a; foo: func = (){}");
+    auto ast2 = GenerateAST("module a; goo: func = (a: i32){}");
+    ast1->Accept(&scanner);
+    ast2->Accept(&scanner);
+
+    // "foo" should not be visible outside module "c".
+    EXPECT_EQ(environment.FindSymbol("a", "foo").declaration->DeclType().ToString(), "[()]");
+    EXPECT_EQ(environment.FindSymbol("a", "goo").declaration->DeclType().ToString(), "[(in i32)]");
+}
+
+TEST(GlobalSymbolScanner, ExportIndexFindsTheSameSymbols)
+{
+    auto environment = ProgramEnvironment();
+    auto scanner = GlobalSymbolScanner(environment);
+
+    // Imports are searched depth-first, so "foo" of "d" (through "b") comes before the one of "c".
+    // "e" is only imported privately by "d", so its "goo" isn't visible from "a".
+    auto ast1 = GenerateAST("module a; import c; import b;");
+    auto ast2 = GenerateAST("module b; import export d; import export a;");
+    auto ast3 = GenerateAST("module c; export foo: func = () {} export goo: func = () {}");
+    auto ast4 = GenerateAST("module d; import e; export foo: func = (x: i32) {}");
+    auto ast5 = GenerateAST("module e; export goo: func = (x: i32) {}");
+    for (const auto& ast : {ast1, ast2, ast3, ast4, ast5})
+    {
+        ast->Accept(&scanner);
+    }
+
+    auto expect_symbols = [&]() {
+        EXPECT_EQ(environment.FindSymbol("a", "foo").declaration->DeclType().ToString(), "[(in i32)]");
+        EXPECT_EQ(environment.FindSymbol("a", "goo").declaration->DeclType().ToString(), "[()]");
+        EXPECT_EQ(environment.FindSymbol("b", "foo").declaration->DeclType().ToString(), "[(in i32)]");
+        EXPECT_THROW(environment.FindSymbol("b", "goo"), std::exception);
+        EXPECT_THROW(environment.FindSymbol("c", "bar"), std::exception);
+    };
+
+    // Once by searching the imported modules, and then with the index.
+    expect_symbols();
+    environment.ValidateModuleDependency();
+    expect_symbols();
+
+    // New public symbols are visible right away.
+    auto ast6 = GenerateAST("module e; export bar: func = () {}");
+    ast6->Accept(&scanner);
+    EXPECT_THROW(environment.FindSymbol("a", "bar"), std::exception);
+    EXPECT_EQ(environment.FindSymbol("d", "bar").declaration->DeclType().ToString(), "[()]");
+}
+
+TEST(ProgramEnvironment, ModuleHandles)
+{
+    auto environment = ProgramEnvironment();
+
+    // Files of the same module share its handle, and handles are given in order.
+    auto ast1 = GenerateAST("module b; foo: func = () {}");
+    auto ast2 = GenerateAST("module a; import b;");
+    auto ast3 = GenerateAST("module b;");
+    auto b = environment.AddModuleDeclaration(static_cast<Module*>(ast1.get()));
+    auto a = environment.AddModuleDeclaration(static_cast<Module*>(ast2.get()));
+    EXPECT_EQ(environment.AddModuleDeclaration(static_cast<Module*>(ast3.get())), b);
+    EXPECT_EQ(b, 0);
+    EXPECT_EQ(a, 1);
+
+    EXPECT_EQ(environment.GetModuleHandle("a"), a);
+    EXPECT_EQ(environment.GetModuleInfo(b).name, "b");
+    EXPECT_THROW(environment.GetModuleHandle("c"), std::exception);
+    EXPECT_THROW(environment.GetModuleInfo(ModuleHandle{2}), std::exception);
+
+    // Misses are reported without exceptions by the Try* versions.
+    EXPECT_FALSE(environment.TryGetModuleHandle("c").has_value());
+    EXPECT_FALSE(environment.TryFindSymbol("c", "foo").has_value());
+    EXPECT_FALSE(environment.TryFindSymbol(ModuleHandle{2}, "foo").has_value());
+    EXPECT_FALSE(environment.TryFindSymbol(a, "foo").has_value());
+
+    // Scopes opened through the handle and through the name are the same.
+    auto foo = static_cast<Module*>(ast1.get())->Declarations()[0];
+    environment.OpenScope(b);
+    environment.AddSymbol(b, foo, true);
+    EXPECT_EQ(environment.FindSymbol("b", "foo").scope_level, 1);
+    environment.CloseScope("b");
+    EXPECT_THROW(environment.FindSymbol(b, "foo"), std::exception);
+}
+
+TEST(GlobalSymbolScanner, InvalidImport)
+{
+    auto environment = ProgramEnvironment();
+    auto scanner = GlobalSymbolScanner(environment);
+
+    auto ast = GenerateAST("module a; import b;");
+    ast->Accept(&scanner);
+
+    EXPECT_THROW(environment.ValidateModuleDependency(), SemanticError);
+}
+
+TEST(GlobalSymbolScanner, ODRViolation)
+{
+    auto environment = ProgramEnvironment();
+    auto scanner = GlobalSymbolScanner(environment);
+
+    auto ast = GenerateAST("module a; foo: func = (){} foo: struct = { x: str; }");
+
+    EXPECT_THROW(ast->Accept(&scanner), SemanticError);
+}
+
+void ExpectTypeCheckSuccess(std::string&& source_file)
+{
+    auto environment = ProgramEnvironment();
+    auto bindings = NameBindings();
+    auto scanner = GlobalSymbolScanner(environment);
+    auto binder = NameBinder(environment, bindings);
+    auto type_checker = TypeChecker(bindings);
+
+    auto ast = GenerateAST(std::move(source_file));
+    ast->Accept(&scanner);
+
+    EXPECT_NO_THROW(ast->Accept(&binder));
+    EXPECT_NO_THROW(ast->Accept(&type_checker));
+}
+
+void ExpectTypeCheckFailure(std::string&& source_file, std::string_view expected_error_message)
+{
+    auto environment = ProgramEnvironment();
+    auto bindings = NameBindings();
+    auto scanner = GlobalSymbolScanner(environment);
+    auto binder = NameBinder(environment, bindings);
+    auto type_checker = TypeChecker(bindings);
+
+    auto ast = GenerateAST(std::move(source_file));
+    ast->Accept(&scanner);
+
+    // Redefinitions of local symbols are reported while binding names.
+    EXPECT_THROW(
+        try
+        {
+            ast->Accept(&binder);
+            ast->Accept(&type_checker);
+        }
+        catch (const SemanticError& e)
+        {
+            ASSERT_EQ(std::string_view(e.what()), expected_error_message);
+            throw;
+        },
+        SemanticError
+    );
+}
+
+TEST(TypeChecker, ValidMemberTypes)
+{
+    auto source = 
+        "module a;\n"
+        "A: struct = {\n"
+        "    m1: i32;\n"
+        "    m2: B[2][3];\n"
+        "}\n"
+        "B: struct = {\n"
+        "    m1: str;\n"
+        "    m2: bool;\n"
+        "}\n";
+    ExpectTypeCheckSuccess(source);
+}
+
+TEST(TypeChecker, InvalidMemberType)
+{
+    auto source =
+        "module a;\n"
+        "A: struct = {\n"
+        "    m1: i32;\n"
+        "    m2: B;\n"
+        "}\n";
+    auto expected_error =
+        "[Semantic Error][Ln 4, Col 5] member variable \"m2\" of struct \"A\" tried to use invalid type \"B\"";
+    ExpectTypeCheckFailure(source, expected_error);
+}
+
+TEST(TypeChecker, InvalidMemberTypeZeroArraySize)
+{
+    auto source =
+        "module a;\n"
+        "A: struct = {\n"
+        "    m: i32[0];\n"
+        "}\n";
+    auto expected_error =
+        "[Semantic Error][Ln 3, Col 5] member variable \"m\" of struct \"A\" tried to use invalid type \"i32[0]\"";
+    ExpectTypeCheckFailure(source, expected_error);
+}
+
+TEST(TypeChecker, InvalidLocalVarType)
+{
+    auto source =
+        "module a;\n"
+        "main: func =() {\n"
+        "    i: error_type = 0;\n"
+        "}\n";
+    auto expected_error =
+        "[Semantic Error][Ln 3, Col 5] local variable \"i\" tried to use invalid type \"error_type\"";
+    ExpectTypeCheckFailure(source, expected_error);
+}
+
+TEST(TypeChecker, ValidPrimitiveTypeVarDecl)
+{
+    auto source =
+        "module a;\n"
+        "main: func =() {\n"
+        "    i: i32 = 0;"
+        "    j: str = \"hello\";\n"
+        "}\n";
+    ExpectTypeCheckSuccess(source);
+}
+
+TEST(TypeChecker, InvalidPrimitiveTypeVarDecl)
+{
+    auto source =
+        "module a;\n"
+        "main: func =() {\n"
+        "    i: i32 = \"hello\";"
+        "}\n";
+    auto expected_error =
+        "[Semantic Error][Ln 3, Col 5] implicit conversion from base type \"str\" to \"i32\" is not allowed";
+    ExpectTypeCheckFailure(source, expected_error);
+}
+
+TEST(TypeChecker, ValidArrayVarDecl)
+{
+    auto source =
+        "module a;\n"
+        "main: func =() {\n"
+        "    i: bool[2] = {true, false};\n"
+        "    j: i32[2][2] = {{1, 2}, {3, 4}};\n"
+        "    k: [(i32)];\n"
+        "}\n";
+    ExpectTypeCheckSuccess(source);
+}
+
+TEST(TypeChecker, ValidFuncTypeVar)
+{
+    auto source =
+        "module a;\n"
+        "add: func = (a: i32, b: i32) -> i32 {\n"
+        "    return a + b;\n"
+        "}\n"
+        "main: func =() {\n"
+        "    a: [()] = main;\n"
+        "    b: [(i32, i32)->i32] = add;\n"
+        "}\n";
+    ExpectTypeCheckSuccess(source);
+}
+
+TEST(TypeChecker, InvalidFuncTypeVarUndefined)
 {
     auto source =
         "module a;\n"
@@ -1470,6 +2826,30 @@ TEST(TypeChecker, InvalidMemberAccess)
     ExpectTypeCheckFailure(source, expected_error);
 }
 
+TEST(TypeChecker, ValidNestedMemberAccess)
+{
+    auto source =
+        "module a;\n"
+        "point: struct = { x: f32; y: f32; }\n"
+        "circle: struct = { center: point; radius: f32; }\n"
+        "main: func =() {\n"
+        "    c: circle;\n"
+        "    c.center.x = c.radius + c.center.y;\n"
+        "}\n";
+    ExpectTypeCheckSuccess(source);
+}
+
+TEST(StructDecl, FindMember)
+{
+    auto ast = GenerateAST("module a; s: struct = { x: i32; y: f32; x: bool; }");
+    auto struct_decl = static_cast<StructDecl*>(static_cast<Module*>(ast.get())->Declarations()[0]);
+
+    // The first member with the name is found.
+    ASSERT_EQ(struct_decl->FindMember("x"), 0);
+    ASSERT_EQ(struct_decl->FindMember("y"), 1);
+    ASSERT_EQ(struct_decl->FindMember("z"), std::nullopt);
+}
+
 TEST(TypeChecker, InvalidTypeNameUsage)
 {
     auto source =
@@ -1680,6 +3060,33 @@ TEST(TypeChecker, VariableIdentificationWithNestedScope)
     ExpectTypeCheckSuccess(source);
 }
 
+TEST(TypeChecker, RedefinitionAfterScopeIsClosed)
+{
+    // Symbols of a closed scope neither clash with nor hide the ones declared later.
+    auto valid_source =
+        "module a;\n"
+        "main: func = () {\n"
+        "    i: i32;\n"
+        "    { i: f32; j: f32; }\n"
+        "    { i: bool; i == true; }\n"
+        "    j: i32;\n"
+        "    i == 1;\n"
+        "    j == 1;\n"
+        "}\n";
+    ExpectTypeCheckSuccess(valid_source);
+
+    auto invalid_source =
+        "module a;\n"
+        "main: func = () {\n"
+        "    i: i32;\n"
+        "    { i: f32; }\n"
+        "    { i: f32; i: bool; }\n"
+        "}\n";
+    auto expected_error =
+        "[Semantic Error][Ln 5, Col 15] ODR violation: symbol \"i\" already exists on the same scope level";
+    ExpectTypeCheckFailure(invalid_source, expected_error);
+}
+
 TEST(TypeChecker, ValidArithmeticOperations)
 {
     auto source =
@@ -1694,6 +3101,129 @@ TEST(TypeChecker, ValidArithmeticOperations)
     ExpectTypeCheckSuccess(source);
 }
 
+TEST(TypeChecker, ExprTraitsOfEveryExpression)
+{
+    auto environment = ProgramEnvironment();
+    auto bindings = NameBindings();
+    auto scanner = GlobalSymbolScanner(environment);
+    auto binder = NameBinder(environment, bindings);
+    auto type_checker = TypeChecker(bindings);
+
+    auto ast = GenerateAST(
+        "module a;\n"
+        "main: func = () {\n"
+        "    arr: f32[2] = {1.0, 2.0};\n"
+        "    r: f32 = arr[0] + 1;\n"
+        "    b: bool = !(r < 3.0);\n"
+        "}\n"
+    );
+    ast->Accept(&scanner);
+    ast->Accept(&binder);
+    ast->Accept(&type_checker);
+
+    auto flat_ast = CreateFlatAst(ast.get());
+    auto types = std::vector<std::string>{};
+    for (FlatNodeId id = 0; id < flat_ast.NumNodes(); ++id)
+    {
+        auto node = flat_ast.SourceNode(id);
+        if (auto expr = dynamic_cast<Expr*>(node))
+        {
+            const auto& trait = type_checker.ExprTraits().At(node);
+            types.push_back(std::format("{}{}", trait.type.ToString(), trait.is_lvalue ? " (lvalue)" : ""));
+        }
+    }
+
+    auto expected = std::vector<std::string>{
+        "f32", "f32",
+        "f32", "f32 (lvalue)", "f32[2] (lvalue)", "i32", "i32",
+        "bool", "bool", "f32 (lvalue)", "f32",
+    };
+    ASSERT_EQ(types, expected);
+}
+
+TEST(NameBinder, BindsNamesToTheirDeclarations)
+{
+    auto environment = ProgramEnvironment();
+    auto bindings = NameBindings();
+    auto scanner = GlobalSymbolScanner(environment);
+    auto binder = NameBinder(environment, bindings);
+    auto type_checker = TypeChecker(bindings);
+
+    auto ast = GenerateAST(
+        "module a;\n"
+        "s: struct = { x: i32; y: i32; }\n"
+        "f: func = (p: s) -> i32 {\n"
+        "    v: s = p;\n"
+        "    {\n"
+        "        p: i32 = v.y;\n"
+        "        return p;\n"
+        "    }\n"
+        "}\n"
+    );
+    ast->Accept(&scanner);
+    ast->Accept(&binder);
+    ast->Accept(&type_checker);
+
+    auto module = static_cast<Module*>(ast.get());
+    auto struct_decl = static_cast<StructDecl*>(module->Declarations()[0]);
+    auto func_decl = static_cast<FuncDecl*>(module->Declarations()[1]);
+    auto param = func_decl->Parameters()[0];
+    auto body = static_cast<CompoundStmt*>(func_decl->Body());
+    auto var_v = static_cast<VarDeclStmt*>(body->Statements()[0]);
+    auto inner_var_p = static_cast<VarDeclStmt*>(static_cast<CompoundStmt*>(body->Statements()[1])->Statements()[0]);
+
+    // Identifiers in the order they appear: "p" of the parameter, "v", and the inner "p".
+    auto flat_ast = CreateFlatAst(ast.get());
+    auto declarations = std::vector<const Decl*>{};
+    auto member_accesses = std::vector<MemberAccessExpr*>{};
+    for (FlatNodeId id = 0; id < flat_ast.NumNodes(); ++id)
+    {
+        auto node = flat_ast.SourceNode(id);
+        if (auto identifier = dynamic_cast<Identifier*>(node))
+        {
+            declarations.push_back(bindings.FindDeclaration(identifier));
+        }
+        else if (auto member_access = dynamic_cast<MemberAccessExpr*>(node))
+        {
+            member_accesses.push_back(member_access);
+        }
+    }
+    auto expected = std::vector<const Decl*>{param, var_v, inner_var_p};
+    ASSERT_EQ(declarations, expected);
+
+    // "v.y" is the second member of "s".
+    ASSERT_EQ(member_accesses.size(), 1);
+    auto member = bindings.FindMember(member_accesses[0]);
+    ASSERT_NE(member, nullptr);
+    ASSERT_EQ(member->struct_decl, struct_decl);
+    ASSERT_EQ(member->member_index, 1);
+
+    // Struct types are bound where they are used, and copies of a type share the binding.
+    auto param_type = dynamic_cast<const StructType*>(param->DeclType().BaseType());
+    ASSERT_NE(param_type, nullptr);
+    ASSERT_EQ(param_type->Declaration(), struct_decl);
+    auto func_type = dynamic_cast<const FuncType*>(func_decl->DeclType().BaseType());
+    ASSERT_EQ(func_type->ParamTypes()[0].type.BaseType(), param_type);
+    ASSERT_EQ(dynamic_cast<const StructType*>(var_v->DeclType().BaseType())->Declaration(), struct_decl);
+}
+
+TEST(NameBinder, StructTypeHiddenByLocalVariable)
+{
+    // The type of "v" is resolved before "v" itself hides the struct,
+    // but "w" can't use the struct type anymore.
+    auto source =
+        "module a;\n"
+        "v: struct = { x: i32; }\n"
+        "main: func = () {\n"
+        "    v: v;\n"
+        "    v.x = 1;\n"
+        "    w: v;\n"
+        "}\n";
+    auto expected_error =
+        "[Semantic Error][Ln 6, Col 5] local variable \"w\" tried to use invalid type \"v\"";
+    ExpectTypeCheckFailure(source, expected_error);
+}
+
 TEST(TypeChecker, InvalidArithmeticOperationArrayType)
 {
     auto source =
@@ -1792,31 +3322,39 @@ TEST(TypeChecker, InvalidArithmeticAssignmentFloatToInt)
     ExpectTypeCheckFailure(source, expected_error);
 }
 
+TEST(TypeChecker, DeepTrees)
+{
+    // Neither of these chains counts as nesting, so the parser accepts them at any length.
+    // Checking them recursively would overflow the stack.
+    ExpectTypeCheckSuccess("module a; main: func = () { i: i32 = 0; i = i" + Repeat(" + 1", 50000) + "; }");
+    ExpectTypeCheckSuccess("module a; main: func = () { if (true) {}" + Repeat(" else if (true) {}", 50000) + " }");
+    ExpectTypeCheckFailure(
+        "module a; main: func = () { i: i32 = 0; i = i" + Repeat(" + 1", 50000) + " + true; }",
+        "[Semantic Error][Ln 1, Col 200047] expected numeric type for right hand operand of arithmetic operator +, but \"bool\" was given"
+    );
+}
+
 void ExpectJumpStmtCheckSuccess(std::string&& source_file)
 {
-    auto environment = ProgramEnvironment();
-    auto scanner = GlobalSymbolScanner(environment);
     auto checker = JumpStmtUsageChecker();
+    auto pass_manager = PassManager();
+    pass_manager.AddPass(checker);
 
     auto ast = GenerateAST(std::move(source_file));
-    ast->Accept(&scanner);
-
-    EXPECT_NO_THROW(ast->Accept(&checker));
+    EXPECT_NO_THROW(pass_manager.Run({ast.get()}));
 }
 
 void ExpectJumpStmtCheckFailure(std::string&& source_file, std::string_view expected_error_message)
 {
-    auto environment = ProgramEnvironment();
-    auto scanner = GlobalSymbolScanner(environment);
     auto checker = JumpStmtUsageChecker();
+    auto pass_manager = PassManager();
+    pass_manager.AddPass(checker);
 
     auto ast = GenerateAST(std::move(source_file));
-    ast->Accept(&scanner);
-
     EXPECT_THROW(
         try
         {
-            ast->Accept(&checker);
+            pass_manager.Run({ast.get()});
         }
         catch (const SemanticError& e)
         {
@@ -1861,4 +3399,1014 @@ TEST(JumpStmtUsageChecker, InvalidBreakStmt)
     auto expected_error =
         "[Semantic Error][Ln 3, Col 5] jump statement \"break\" cannot be used outside a loop";
     ExpectJumpStmtCheckFailure(source, expected_error);
-}
\ No newline at end of file
+}
+// Records every node it enters and leaves.
+class NodeRecorderPass : public AstPass
+{
+public:
+    NodeRecorderPass(std::string_view name, AstNodeKindSet interests, std::vector<std::string_view> prerequisites = {})
+        : m_name(name), m_interests(interests), m_prerequisites(prerequisites)
+    {}
+
+    virtual std::string_view Name() const override { return m_name; }
+    virtual AstNodeKindSet Interests() const override { return m_interests; }
+    virtual std::vector<std::string_view> Prerequisites() const override { return m_prerequisites; }
+
+    virtual void Enter(IAbstractSyntaxTree* node) override { entered.push_back(node); }
+    virtual void Leave(IAbstractSyntaxTree* node) override { left.push_back(node); }
+
+    std::vector<IAbstractSyntaxTree*> entered;
+    std::vector<IAbstractSyntaxTree*> left;
+
+private:
+    std::string_view m_name;
+    AstNodeKindSet m_interests;
+    std::vector<std::string_view> m_prerequisites;
+};
+
+std::string PassManagerTestSource(std::string_view module_name)
+{
+    return std::format(
+        "module {};\n"
+        "s: struct = {{ x: i32; }}\n"
+        "f: func = (a: i32[3], b: out s) -> i32 {{\n"
+        "    for (i: i32 = 0; i < 3; ++i) {{ if (b.x == a[i]) {{ continue; }} b.x += i; }}\n"
+        "    while (true) {{ break; }}\n"
+        "    return a[0] + f(a, b);\n"
+        "}}\n",
+        module_name
+    );
+}
+
+TEST(PassManager, ObserversJoinTheWalkOfTheTypeChecker)
+{
+    auto environment = ProgramEnvironment();
+    auto bindings = NameBindings();
+    auto scanner = GlobalSymbolScanner(environment);
+    auto binder = NameBinder(environment, bindings);
+    auto type_checker = TypeChecker(bindings);
+    auto jump_stmt_checker = JumpStmtUsageChecker();
+    auto identifiers = NodeRecorderPass("identifiers", MakeAstNodeKindSet({AstNodeKind::Identifier}));
+
+    auto pass_manager = PassManager();
+    pass_manager.AddPass(jump_stmt_checker);
+    pass_manager.AddPass(type_checker);
+    pass_manager.AddPass(identifiers);
+    pass_manager.AddPass(scanner);
+    pass_manager.AddPass(binder);
+    pass_manager.EnableTimings();
+
+    auto expected_schedule = std::vector<std::vector<std::string_view>>{
+        {"global-symbol-scan"},
+        {"name-binding"},
+        {"jump-stmt-usage", "type-check", "identifiers"},
+    };
+    ASSERT_EQ(pass_manager.Schedule(), expected_schedule);
+
+    auto lhs = GenerateAST(PassManagerTestSource("a"));
+    auto rhs = GenerateAST(PassManagerTestSource("b"));
+    pass_manager.Run({lhs.get(), rhs.get()});
+
+    // The same identifiers are seen without the type checker, when PassManager walks the tree itself.
+    auto expected = NodeRecorderPass("identifiers", MakeAstNodeKindSet({AstNodeKind::Identifier}));
+    auto other_pass_manager = PassManager();
+    other_pass_manager.AddPass(expected);
+    other_pass_manager.Run({lhs.get(), rhs.get()});
+
+    ASSERT_EQ(identifiers.entered.size(), 22);
+    ASSERT_EQ(identifiers.entered, expected.entered);
+    ASSERT_EQ(identifiers.left, expected.left);
+
+    // Every pass and the tree walk are timed.
+    ASSERT_EQ(pass_manager.Timings().size(), 6);
+    ASSERT_EQ(pass_manager.Timings()[1].name, "type-check");
+    ASSERT_EQ(pass_manager.Timings()[5].name, "tree walk");
+    ASSERT_GT(pass_manager.Timings()[1].elapsed.count(), 0);
+
+    // The clock isn't read unless timings are enabled.
+    for (const auto& timing : other_pass_manager.Timings())
+    {
+        ASSERT_EQ(timing.elapsed.count(), 0);
+    }
+}
+
+TEST(PassManager, SkipsSubtreesWithoutInterestingNodes)
+{
+    auto ast = GenerateAST(PassManagerTestSource("a"));
+
+    // Nodes are left in the reverse order of entering them.
+    auto decls = NodeRecorderPass("decls", MakeAstNodeKindSet({AstNodeKind::Module, AstNodeKind::FuncDecl, AstNodeKind::StructDecl}));
+    auto pass_manager = PassManager();
+    pass_manager.AddPass(decls);
+    pass_manager.Run({ast.get()});
+
+    auto module = static_cast<Module*>(ast.get());
+    auto expected_entered = std::vector<IAbstractSyntaxTree*>{module, module->Declarations()[0], module->Declarations()[1]};
+    auto expected_left = std::vector<IAbstractSyntaxTree*>{module->Declarations()[0], module->Declarations()[1], module};
+    ASSERT_EQ(decls.entered, expected_entered);
+    ASSERT_EQ(decls.left, expected_left);
+}
+
+TEST(PassManager, OrderOfWalks)
+{
+    auto environment = ProgramEnvironment();
+    auto bindings = NameBindings();
+    auto first_checker = TypeChecker(bindings);
+    auto scanner = GlobalSymbolScanner(environment);
+    auto binder = NameBinder(environment, bindings);
+    auto a = NodeRecorderPass("a", {});
+    auto b = NodeRecorderPass("b", {}, {"a"});
+    auto c = NodeRecorderPass("c", {}, {"type-check"});
+
+    auto pass_manager = PassManager();
+    pass_manager.AddPass(c);
+    pass_manager.AddPass(b);
+    pass_manager.AddPass(a);
+    pass_manager.AddPass(first_checker);
+    pass_manager.AddPass(scanner);
+    pass_manager.AddPass(binder);
+
+    // "a" is as late as "b" allows, and "b" joins the last walk.
+    auto expected_schedule = std::vector<std::vector<std::string_view>>{
+        {"global-symbol-scan"},
+        {"name-binding"},
+        {"a", "type-check"},
+        {"c", "b"},
+    };
+    ASSERT_EQ(pass_manager.Schedule(), expected_schedule);
+
+    ASSERT_THROW(pass_manager.AddPass(a), std::invalid_argument);
+
+    auto missing = NodeRecorderPass("missing", {}, {"nothing"});
+    auto missing_pass_manager = PassManager();
+    missing_pass_manager.AddPass(missing);
+    ASSERT_THROW(missing_pass_manager.Schedule(), std::invalid_argument);
+
+    auto x = NodeRecorderPass("x", {}, {"y"});
+    auto y = NodeRecorderPass("y", {}, {"x"});
+    auto circular_pass_manager = PassManager();
+    circular_pass_manager.AddPass(x);
+    circular_pass_manager.AddPass(y);
+    ASSERT_THROW(circular_pass_manager.Run({}), std::invalid_argument);
+}
+
+TEST(PassManager, ReportsFailedModule)
+{
+    auto environment = ProgramEnvironment();
+    auto bindings = NameBindings();
+    auto scanner = GlobalSymbolScanner(environment);
+    auto binder = NameBinder(environment, bindings);
+    auto type_checker = TypeChecker(bindings);
+    auto jump_stmt_checker = JumpStmtUsageChecker();
+
+    auto pass_manager = PassManager();
+    pass_manager.AddPass(scanner);
+    pass_manager.AddPass(binder);
+    pass_manager.AddPass(type_checker);
+    pass_manager.AddPass(jump_stmt_checker);
+
+    auto valid = GenerateAST(PassManagerTestSource("a"));
+    auto invalid = GenerateAST("module b; main: func = () { x: i32 = 1; if (x == 1) { break; } }");
+
+    auto failed_module = std::optional<size_t>();
+    ASSERT_THROW(
+        pass_manager.Run({valid.get(), invalid.get()}, [&](size_t i) { failed_module = i; }),
+        SemanticError
+    );
+    ASSERT_EQ(failed_module, 1);
+}
+
+TEST(PassManager, PrerequisiteFinishedByAnotherManager)
+{
+    auto environment = ProgramEnvironment();
+    auto bindings = NameBindings();
+    auto scanner = GlobalSymbolScanner(environment);
+    auto binder = NameBinder(environment, bindings);
+    auto jump_stmt_checker = JumpStmtUsageChecker();
+
+    auto lhs = GenerateAST(PassManagerTestSource("a"));
+    auto rhs = GenerateAST(PassManagerTestSource("b"));
+    auto scanning_pass_manager = PassManager();
+    scanning_pass_manager.AddPass(scanner);
+    scanning_pass_manager.Run({lhs.get(), rhs.get()});
+
+    // Each module can then be bound on its own.
+    auto pass_manager = PassManager();
+    pass_manager.AddPass(binder);
+    pass_manager.AddPass(jump_stmt_checker);
+    ASSERT_THROW(pass_manager.Schedule(), std::invalid_argument);
+
+    pass_manager.AddFinishedPass(scanner.Name());
+    auto expected_schedule = std::vector<std::vector<std::string_view>>{
+        {"name-binding", "jump-stmt-usage"},
+    };
+    ASSERT_EQ(pass_manager.Schedule(), expected_schedule);
+
+    pass_manager.Run({rhs.get()});
+    auto type_checker = TypeChecker(bindings);
+    ASSERT_NO_THROW(type_checker.Visit(static_cast<Module*>(rhs.get())));
+}
+
+TEST(PassManager, ScanningReportsMissingImport)
+{
+    auto environment = ProgramEnvironment();
+    auto scanner = GlobalSymbolScanner(environment);
+    auto pass_manager = PassManager();
+    pass_manager.AddPass(scanner);
+
+    auto a = GenerateAST("module a; import b;");
+    auto b = GenerateAST("module b; import c; import nosuch;");
+    auto c = GenerateAST("module c;");
+    try
+    {
+        pass_manager.Run({a.get(), b.get(), c.get()});
+        FAIL();
+    }
+    catch (const SemanticError& e)
+    {
+        ASSERT_EQ(e.where(), (SourcePos{.line = 1, .column = 28}));
+    }
+
+    // None of the imports are resolved, so no module seems to depend on fewer modules than it does.
+    ASSERT_FALSE(environment.IsFrozen());
+    for (auto name : {"a", "b", "c"})
+    {
+        ASSERT_TRUE(environment.GetModuleInfo(name).resolved_imports.empty());
+    }
+}
+
+TEST(PassManager, ImportsReachTheModulesOfReturnedStructs)
+{
+    auto environment = ProgramEnvironment();
+    auto scanner = GlobalSymbolScanner(environment);
+    auto scanning_pass_manager = PassManager();
+    scanning_pass_manager.AddPass(scanner);
+
+    // "a" only imports "b", but checking it needs the members of the struct from "c".
+    auto a = GenerateAST("module a; import b; f: func = () -> i32 { s: vec = make(); return s.v.x; }");
+    auto b = GenerateAST("module b; import export c; export make: func = () -> vec { v: vec; return v; }");
+    auto c = GenerateAST("module c; inner: struct = { x: i32; } export vec: struct = { v: inner; }");
+    auto asts = std::vector<IAbstractSyntaxTree*>{a.get(), b.get(), c.get()};
+    scanning_pass_manager.Run(asts);
+
+    // Same as the modules that are bound before a module is checked in the pipeline.
+    auto reachable = std::vector<ModuleHandle>{environment.GetModuleHandle("a")};
+    for (size_t i = 0; i < reachable.size(); ++i)
+    {
+        for (const auto& imported : environment.GetModuleInfo(reachable[i]).resolved_imports)
+        {
+            if (std::find(reachable.begin(), reachable.end(), imported.module) == reachable.end())
+            {
+                reachable.push_back(imported.module);
+            }
+        }
+    }
+    auto expected_reachable = std::vector<ModuleHandle>{
+        environment.GetModuleHandle("a"),
+        environment.GetModuleHandle("b"),
+        environment.GetModuleHandle("c"),
+    };
+    ASSERT_EQ(reachable, expected_reachable);
+
+    // Each module is bound with bindings of its own.
+    auto bindings = std::vector<NameBindings>(asts.size());
+    for (auto handle : reachable)
+    {
+        auto binder = NameBinder(environment, bindings[handle]);
+        auto pass_manager = PassManager();
+        pass_manager.AddPass(binder);
+        pass_manager.AddFinishedPass(scanner.Name());
+        pass_manager.Run({asts[handle]});
+    }
+    auto type_checker = TypeChecker(bindings[0]);
+    ASSERT_NO_THROW(type_checker.Visit(static_cast<Module*>(a.get())));
+}
+
+// Scans and binds the modules, which freezes the environment, and checks them on 'thread_pool'.
+void CheckConcurrently(
+    const std::vector<IAbstractSyntaxTree*>& modules,
+    ThreadPool& thread_pool,
+    TypeChecker& type_checker,
+    ProgramEnvironment& environment,
+    NameBindings& bindings,
+    const std::function<void(size_t)>& on_error = nullptr
+)
+{
+    auto scanner = GlobalSymbolScanner(environment);
+    auto binder = NameBinder(environment, bindings);
+    auto pass_manager = PassManager();
+    pass_manager.AddPass(scanner);
+    pass_manager.AddPass(binder);
+    pass_manager.Run(modules);
+
+    type_checker.CheckConcurrently(modules, thread_pool, on_error);
+}
+
+TEST(TypeChecker, CheckConcurrentlyMatchesSequentialCheck)
+{
+    auto asts = std::vector<std::shared_ptr<IAbstractSyntaxTree>>{};
+    auto modules = std::vector<IAbstractSyntaxTree*>{};
+    for (auto name : {"a", "b", "c", "d", "e"})
+    {
+        asts.push_back(GenerateAST(PassManagerTestSource(name)));
+        modules.push_back(asts.back().get());
+    }
+
+    auto environment = ProgramEnvironment();
+    auto bindings = NameBindings();
+    auto type_checker = TypeChecker(bindings);
+    auto thread_pool = ThreadPool(4);
+    CheckConcurrently(modules, thread_pool, type_checker, environment, bindings);
+    ASSERT_TRUE(environment.IsFrozen());
+
+    // The same trees checked one after another, with the bindings they already have.
+    auto sequential_checker = TypeChecker(bindings);
+    for (auto module : modules)
+    {
+        module->Accept(&sequential_checker);
+    }
+
+    ASSERT_EQ(type_checker.ExprTraits().Size(), sequential_checker.ExprTraits().Size());
+    for (auto module : modules)
+    {
+        auto flat_ast = CreateFlatAst(module);
+        for (FlatNodeId id = 0; id < flat_ast.NumNodes(); ++id)
+        {
+            auto node = flat_ast.SourceNode(id);
+            if (dynamic_cast<Expr*>(node))
+            {
+                const auto& trait = type_checker.ExprTraits().At(node);
+                const auto& expected = sequential_checker.ExprTraits().At(node);
+                ASSERT_EQ(trait.type, expected.type);
+                ASSERT_EQ(trait.is_lvalue, expected.is_lvalue);
+            }
+            if (auto member_access = dynamic_cast<MemberAccessExpr*>(node))
+            {
+                ASSERT_NE(bindings.FindMember(member_access), nullptr);
+            }
+        }
+    }
+}
+
+TEST(TypeChecker, CheckConcurrentlyReportsTheFirstError)
+{
+    // Every declaration but the first of "b" fails, and the error of "b" comes first in order.
+    auto sources = std::vector<std::string>{
+        PassManagerTestSource("a"),
+        "module b; f: func = () { x: i32 = 1; } g: func = () { x: i32 = true; }",
+        "module c; f: func = () { y: bool = 1; }",
+    };
+    for (int run = 0; run < 8; ++run)
+    {
+        auto asts = std::vector<std::shared_ptr<IAbstractSyntaxTree>>{};
+        auto modules = std::vector<IAbstractSyntaxTree*>{};
+        for (auto source : sources)
+        {
+            asts.push_back(GenerateAST(std::move(source)));
+            modules.push_back(asts.back().get());
+        }
+
+        auto environment = ProgramEnvironment();
+        auto bindings = NameBindings();
+        auto type_checker = TypeChecker(bindings);
+        auto thread_pool = ThreadPool(4);
+        auto failed_module = std::optional<size_t>();
+        auto on_error = [&](size_t i) { failed_module = i; };
+        EXPECT_THROW(
+            try
+            {
+                CheckConcurrently(modules, thread_pool, type_checker, environment, bindings, on_error);
+            }
+            catch (const SemanticError& e)
+            {
+                ASSERT_EQ(std::string_view(e.what()),
+                    "[Semantic Error][Ln 1, Col 55] implicit conversion from base type \"bool\" to \"i32\" is not allowed");
+                throw;
+            },
+            SemanticError
+        );
+        ASSERT_EQ(failed_module, 1);
+    }
+}
+
+std::vector<std::string> ReportTypeErrors(std::string&& source_file, size_t error_limit = 0)
+{
+    auto environment = ProgramEnvironment();
+    auto bindings = NameBindings();
+    auto scanner = GlobalSymbolScanner(environment);
+    auto binder = NameBinder(environment, bindings);
+    auto diagnostics = DiagnosticSink(error_limit);
+    auto type_checker = TypeChecker(bindings, &diagnostics);
+
+    auto ast = GenerateAST(std::move(source_file));
+    ast->Accept(&scanner);
+    ast->Accept(&binder);
+
+    // With a sink, errors are reported instead of thrown.
+    EXPECT_NO_THROW(ast->Accept(&type_checker));
+
+    auto errors = std::vector<std::string>();
+    for (const auto& diagnostic : diagnostics.Diagnostics())
+    {
+        errors.push_back(diagnostic.ToString());
+    }
+    return errors;
+}
+
+TEST(TypeChecker, ReportsEveryErrorToTheSink)
+{
+    auto source =
+        "module a;\n"
+        "main: func = () {\n"
+        "    x: i32 = true;\n"
+        "    y: bool = 1;\n"
+        "    x = w;\n"
+        "    y = x;\n"
+        "}\n";
+    auto errors = ReportTypeErrors(source);
+    auto expected_errors = std::vector<std::string>{
+        "[Semantic Error][Ln 3, Col 5] implicit conversion from base type \"bool\" to \"i32\" is not allowed",
+        "[Semantic Error][Ln 4, Col 5] implicit conversion from base type \"i32\" to \"bool\" is not allowed",
+        "[Semantic Error][Ln 5, Col 9] trying to use undefined symbol \"w\" in an expression",
+        "[Semantic Error][Ln 6, Col 7] implicit conversion from base type \"i32\" to \"bool\" is not allowed",
+    };
+    ASSERT_EQ(errors, expected_errors);
+}
+
+TEST(TypeChecker, ErrorsDontCascade)
+{
+    // Each line has one error, which the rest of the line depends on.
+    auto source =
+        "module a;\n"
+        "main: func = () {\n"
+        "    x: i32 = true + 1;\n"
+        "    y: foo = 1;\n"
+        "    z: i32 = y * 2 + x;\n"
+        "    if (w) { x = 1; }\n"
+        "}\n";
+    auto errors = ReportTypeErrors(source);
+    auto expected_errors = std::vector<std::string>{
+        "[Semantic Error][Ln 3, Col 19] operation \"bool\" + \"i32\" is not allowed",
+        "[Semantic Error][Ln 4, Col 5] local variable \"y\" tried to use invalid type \"foo\"",
+        "[Semantic Error][Ln 6, Col 9] trying to use undefined symbol \"w\" in an expression",
+    };
+    ASSERT_EQ(errors, expected_errors);
+}
+
+TEST(TypeChecker, StopsReportingAtTheErrorLimit)
+{
+    auto source =
+        "module a;\n"
+        "f: func = () { x: i32 = true; }\n"
+        "g: func = () { x: i32 = true; }\n"
+        "h: func = () { x: i32 = true; }\n";
+    ASSERT_EQ(ReportTypeErrors(source, 2).size(), 2);
+    ASSERT_EQ(ReportTypeErrors(source, 0).size(), 3);
+}
+
+TEST(TypeChecker, CheckConcurrentlyReportsLikeAWalk)
+{
+    auto sources = std::vector<std::string>{
+        "module a; f: func = () { x: i32 = true; } g: func = () { y: bool = 1; }",
+        PassManagerTestSource("b"),
+        "module c; f: func = () { x: i32 = w; } g: func = () {} h: func = () { z: i32 = 1.0; }",
+    };
+    for (int run = 0; run < 8; ++run)
+    {
+        auto asts = std::vector<std::shared_ptr<IAbstractSyntaxTree>>{};
+        auto modules = std::vector<IAbstractSyntaxTree*>{};
+        for (auto source : sources)
+        {
+            asts.push_back(GenerateAST(std::move(source)));
+            modules.push_back(asts.back().get());
+        }
+
+        auto environment = ProgramEnvironment();
+        auto bindings = NameBindings();
+        auto diagnostics = DiagnosticSink();
+        auto type_checker = TypeChecker(bindings, &diagnostics);
+        auto thread_pool = ThreadPool(4);
+        EXPECT_NO_THROW(CheckConcurrently(modules, thread_pool, type_checker, environment, bindings));
+
+        auto sequential_diagnostics = DiagnosticSink();
+        auto sequential_checker = TypeChecker(bindings, &sequential_diagnostics);
+        for (auto module : modules)
+        {
+            module->Accept(&sequential_checker);
+        }
+
+        ASSERT_EQ(diagnostics.Diagnostics().size(), 4);
+        ASSERT_EQ(diagnostics.Diagnostics().size(), sequential_diagnostics.Diagnostics().size());
+        for (size_t i = 0; i < diagnostics.Diagnostics().size(); ++i)
+        {
+            ASSERT_EQ(diagnostics.Diagnostics()[i].ToString(), sequential_diagnostics.Diagnostics()[i].ToString());
+        }
+    }
+}
+
+TEST(DiagnosticSink, CountsErrorsOverTheLimit)
+{
+    auto diagnostics = DiagnosticSink(2);
+    diagnostics.Report(DiagnosticCode::NotAStruct, SourcePos{1, 2}, {"i32"});
+    ASSERT_FALSE(diagnostics.IsLimitReached());
+    diagnostics.Report(DiagnosticCode::AssignmentToRvalue, SourcePos{3, 4});
+    diagnostics.Report(DiagnosticCode::NotAStruct, SourcePos{5, 6}, {"bool"});
+
+    ASSERT_TRUE(diagnostics.IsLimitReached());
+    ASSERT_EQ(diagnostics.Diagnostics().size(), 2);
+    ASSERT_EQ(diagnostics.NumReported(), 3);
+    ASSERT_EQ(diagnostics.Diagnostics()[0].ToString(), "[Semantic Error][Ln 1, Col 2] \"i32\" is not a struct type");
+    ASSERT_EQ(diagnostics.Diagnostics()[1].Message(), "assignment to an rvalue is not allowed");
+}
+
+TEST(DiagnosticSink, MergeKeepsTheOrderWithinTheLimit)
+{
+    auto first = DiagnosticSink(3);
+    first.Report(DiagnosticCode::UndefinedSymbol, SourcePos{1, 1}, {"a"});
+    auto second = DiagnosticSink(3);
+    second.Report(DiagnosticCode::UndefinedSymbol, SourcePos{2, 1}, {"b"});
+    second.Report(DiagnosticCode::UndefinedSymbol, SourcePos{3, 1}, {"c"});
+    second.Report(DiagnosticCode::UndefinedSymbol, SourcePos{4, 1}, {"d"});
+
+    first.Merge(std::move(second));
+    ASSERT_FALSE(second.HasErrors());
+    ASSERT_EQ(first.Diagnostics().size(), 3);
+    ASSERT_EQ(first.NumReported(), 4);
+    ASSERT_EQ(first.Diagnostics()[2].Message(), "trying to use undefined symbol \"c\" in an expression");
+}
+
+TEST(LazyMessage, OnlyBuiltWhenAsked)
+{
+    auto num_builds = 0;
+    auto builder = [&]() { ++num_builds; return std::string("parameter \"x\""); };
+    auto message = LazyMessage(builder);
+    ASSERT_EQ(num_builds, 0);
+    ASSERT_EQ(message.Build(), "parameter \"x\"");
+    ASSERT_EQ(num_builds, 1);
+    ASSERT_EQ(LazyMessage("condition").Build(), "condition");
+}
+
+const std::vector<std::string> IncrementalCheckerTestSources = {
+    "module c;\n"
+    "export p: struct = { x: i32; y: bool; }\n"
+    "export q: struct = { p1: p; n: f32; }\n"
+    "export scale: func = (v: inout p, k: i32) { v.x = v.x * k; }\n",
+
+    "module b;\n"
+    "import export c;\n"
+    "export make: func = (x: i32) -> p { v: p; v.x = x; return v; }\n"
+    "export wrap: func = (v: p) -> q { w: q; w.p1 = v; return w; }\n"
+    "helper: func = (n: i32) -> i32 { return n + 1; }\n"
+    "export twice: func = (n: i32) -> i32 { return helper(n) * 2; }\n",
+
+    "module a;\n"
+    "import b;\n"
+    "main: func = () -> i32 {\n"
+    "    v: p = make(1);\n"
+    "    scale(v, twice(2));\n"
+    "    w: q = wrap(v);\n"
+    "    if (w.p1.y) { return w.p1.x; }\n"
+    "    return twice(v.x);\n"
+    "}\n"
+    "other: func = (x: f32) -> f32 { return x * 2.0; }\n",
+};
+
+std::string DescribeDiagnostics(const std::vector<Diagnostic>& diagnostics)
+{
+    auto result = std::string();
+    for (const auto& diagnostic : diagnostics)
+    {
+        result += diagnostic.ToString() + "\n";
+    }
+    return result;
+}
+
+// Types of every expression in the module, in the order of a walk.
+template<typename GetExprTraits>
+std::string DescribeExprTraits(IAbstractSyntaxTree* ast, GetExprTraits&& get_expr_traits)
+{
+    auto result = std::string();
+    for (auto decl : static_cast<Module*>(ast)->Declarations())
+    {
+        const auto& expr_traits = get_expr_traits(decl);
+        auto flat_ast = CreateFlatAst(decl);
+        for (FlatNodeId id = 0; id < flat_ast.NumNodes(); ++id)
+        {
+            auto node = flat_ast.SourceNode(id);
+            if (dynamic_cast<Expr*>(node))
+            {
+                auto trait = expr_traits.Find(node);
+                result += trait ? trait->type.ToString() + (trait->is_lvalue ? "& " : " ") : "- ";
+            }
+        }
+        result += "\n";
+    }
+    return result;
+}
+
+// Checks the modules from scratch, and describes the error that stopped the check,
+// or the diagnostics and the types of expressions of each file.
+std::string DescribeFreshCheck(const std::vector<std::string>& sources)
+{
+    auto asts = std::vector<std::shared_ptr<IAbstractSyntaxTree>>{};
+    for (auto source : sources)
+    {
+        asts.push_back(GenerateAST(std::move(source)));
+    }
+
+    auto environment = ProgramEnvironment();
+    auto bindings = NameBindings();
+    auto scanner = GlobalSymbolScanner(environment);
+    auto binder = NameBinder(environment, bindings);
+    auto result = std::string();
+    try
+    {
+        for (const auto& ast : asts)
+        {
+            ast->Accept(&scanner);
+        }
+        environment.ValidateModuleDependency();
+        for (const auto& ast : asts)
+        {
+            ast->Accept(&binder);
+        }
+        for (const auto& ast : asts)
+        {
+            auto diagnostics = DiagnosticSink();
+            auto type_checker = TypeChecker(bindings, &diagnostics);
+            ast->Accept(&type_checker);
+            result += DescribeDiagnostics(diagnostics.Diagnostics());
+            result += DescribeExprTraits(ast.get(), [&](auto) -> const auto& { return type_checker.ExprTraits(); });
+        }
+    }
+    catch (const std::exception& e)
+    {
+        return std::string("error: ") + e.what();
+    }
+    return result;
+}
+
+// Same as DescribeFreshCheck() for the incremental checker,
+// which also makes sure that no binding refers to a declaration of an old tree.
+std::string DescribeIncrementalCheck(IncrementalChecker& checker, const std::vector<std::shared_ptr<IAbstractSyntaxTree>>& asts)
+{
+    try
+    {
+        checker.Check();
+    }
+    catch (const std::exception& e)
+    {
+        return std::string("error: ") + e.what();
+    }
+
+    auto declarations = std::set<const Decl*>{};
+    for (const auto& ast : asts)
+    {
+        auto flat_ast = CreateFlatAst(ast.get());
+        for (FlatNodeId id = 0; id < flat_ast.NumNodes(); ++id)
+        {
+            if (auto decl = dynamic_cast<Decl*>(flat_ast.SourceNode(id)))
+            {
+                declarations.insert(decl);
+            }
+        }
+    }
+
+    auto result = std::string();
+    for (size_t i = 0; i < asts.size(); ++i)
+    {
+        for (auto decl : static_cast<Module*>(asts[i].get())->Declarations())
+        {
+            const auto& bindings = checker.Bindings(decl);
+            auto flat_ast = CreateFlatAst(decl);
+            for (FlatNodeId id = 0; id < flat_ast.NumNodes(); ++id)
+            {
+                auto node = flat_ast.SourceNode(id);
+                if (auto identifier = dynamic_cast<Identifier*>(node))
+                {
+                    auto declaration = bindings.FindDeclaration(identifier);
+                    EXPECT_TRUE(declaration == nullptr || declarations.contains(declaration));
+                }
+                else if (auto member_access = dynamic_cast<MemberAccessExpr*>(node))
+                {
+                    auto member = bindings.FindMember(member_access);
+                    EXPECT_TRUE(member == nullptr || declarations.contains(member->struct_decl));
+                }
+            }
+        }
+        result += DescribeDiagnostics(checker.Diagnostics(i));
+        result += DescribeExprTraits(asts[i].get(), [&](auto decl) -> const auto& { return checker.ExprTraits(decl); });
+    }
+    return result;
+}
+
+TEST(IncrementalChecker, ChecksOnlyWhatChanged)
+{
+    auto sources = IncrementalCheckerTestSources;
+    auto parsers = std::vector<IncrementalParser>{};
+    auto asts = std::vector<std::shared_ptr<IAbstractSyntaxTree>>{};
+    auto checker = IncrementalChecker();
+    for (const auto& source : sources)
+    {
+        parsers.emplace_back(source);
+        asts.push_back(parsers.back().Parse());
+        checker.UpdateFile(asts.size() - 1, asts.back());
+    }
+
+    auto expected = DescribeFreshCheck(sources);
+    ASSERT_EQ(DescribeIncrementalCheck(checker, asts), expected);
+    ASSERT_EQ(checker.NumCheckedDecls(), 9);
+    ASSERT_EQ(checker.NumReusedDecls(), 0);
+    ASSERT_TRUE(checker.Diagnostics(0).empty());
+    ASSERT_TRUE(checker.Diagnostics(1).empty());
+    ASSERT_TRUE(checker.Diagnostics(2).empty());
+
+    auto apply_edit = [&](size_t file_index, std::string_view text, size_t length, std::string replacement) {
+        auto offset = sources[file_index].find(text);
+        ASSERT_NE(offset, std::string::npos);
+        sources[file_index].replace(offset, length, replacement);
+        asts[file_index] = parsers[file_index].ApplyEdit({offset, length, replacement});
+        checker.UpdateFile(file_index, asts[file_index]);
+    };
+
+    // The body of a function doesn't change what others see.
+    apply_edit(1, "n + 1", 5, "n + 2");
+    ASSERT_EQ(DescribeIncrementalCheck(checker, asts), DescribeFreshCheck(sources));
+    ASSERT_EQ(checker.NumCheckedDecls(), 1);
+    ASSERT_EQ(checker.NumReusedDecls(), 8);
+
+    // A new parameter type is seen by the callers.
+    apply_edit(1, "i32) -> i32 { return n + 2", 3, "f32");
+    ASSERT_EQ(DescribeIncrementalCheck(checker, asts), DescribeFreshCheck(sources));
+    ASSERT_EQ(checker.NumCheckedDecls(), 2);
+    ASSERT_FALSE(checker.Diagnostics(1).empty());
+
+    // A new member is seen by the functions that access members of the struct,
+    // but not by the struct that only has a member of its type.
+    apply_edit(0, "y: bool;", 0, "z: f32; ");
+    ASSERT_EQ(DescribeIncrementalCheck(checker, asts), DescribeFreshCheck(sources));
+    ASSERT_EQ(checker.NumCheckedDecls(), 4);
+
+    // An access to a member that isn't there depends on the members as well.
+    apply_edit(0, "p1: p", 2, "r");
+    ASSERT_EQ(DescribeIncrementalCheck(checker, asts), DescribeFreshCheck(sources));
+    ASSERT_FALSE(checker.Diagnostics(1).empty());
+    apply_edit(0, "r: p", 1, "p1");
+    ASSERT_EQ(DescribeIncrementalCheck(checker, asts), DescribeFreshCheck(sources));
+
+    // "twice" is parsed again, and it can't be found from "a" anymore.
+    apply_edit(1, "export twice", 7, "");
+    ASSERT_EQ(DescribeIncrementalCheck(checker, asts), DescribeFreshCheck(sources));
+    ASSERT_EQ(checker.NumCheckedDecls(), 2);
+    ASSERT_EQ(checker.Diagnostics(2).size(), 2);
+
+    // A symbol defined twice leaves the results as they were.
+    auto diagnostics = DescribeDiagnostics(checker.Diagnostics(2));
+    apply_edit(2, "other", 0, "other: func = () {}\n");
+    expected = DescribeFreshCheck(sources);
+    ASSERT_TRUE(expected.starts_with("error: "));
+    ASSERT_EQ(DescribeIncrementalCheck(checker, asts), expected);
+    ASSERT_EQ(DescribeDiagnostics(checker.Diagnostics(2)), diagnostics);
+
+    // Undoing the edits brings back the first result.
+    apply_edit(2, "other: func = () {}\n", 20, "");
+    apply_edit(1, "twice", 0, "export ");
+    apply_edit(0, "z: f32; ", 8, "");
+    apply_edit(1, "f32) -> i32", 3, "i32");
+    apply_edit(1, "n + 2", 5, "n + 1");
+    ASSERT_EQ(DescribeIncrementalCheck(checker, asts), DescribeFreshCheck(sources));
+    ASSERT_EQ(DescribeFreshCheck(sources), DescribeFreshCheck(IncrementalCheckerTestSources));
+    ASSERT_TRUE(checker.Diagnostics(2).empty());
+}
+
+TEST(IncrementalChecker, KeepsMovedDeclarations)
+{
+    auto sources = IncrementalCheckerTestSources;
+    auto parsers = std::vector<IncrementalParser>{};
+    auto asts = std::vector<std::shared_ptr<IAbstractSyntaxTree>>{};
+    auto checker = IncrementalChecker();
+    for (const auto& source : sources)
+    {
+        parsers.emplace_back(source);
+        asts.push_back(parsers.back().Parse());
+        checker.UpdateFile(asts.size() - 1, asts.back());
+    }
+
+    auto apply_edit = [&](size_t file_index, std::string_view text, size_t length, std::string replacement) {
+        auto offset = sources[file_index].find(text);
+        ASSERT_NE(offset, std::string::npos);
+        sources[file_index].replace(offset, length, replacement);
+        asts[file_index] = parsers[file_index].ApplyEdit({offset, length, replacement});
+        checker.UpdateFile(file_index, asts[file_index]);
+    };
+
+    // "other" reports an error, which moves along with it.
+    apply_edit(2, "x * 2.0", 7, "x * true");
+    ASSERT_EQ(DescribeIncrementalCheck(checker, asts), DescribeFreshCheck(sources));
+    ASSERT_EQ(checker.Diagnostics(2).size(), 1);
+
+    // New lines above the declarations move them to other lines.
+    apply_edit(2, "main: func", 0, "\n\n");
+    ASSERT_EQ(DescribeIncrementalCheck(checker, asts), DescribeFreshCheck(sources));
+    ASSERT_EQ(checker.NumCheckedDecls(), 0);
+    ASSERT_EQ(checker.NumReusedDecls(), 9);
+
+    // Positions on the first line of a declaration move to other columns.
+    apply_edit(2, "other: func", 0, "   ");
+    ASSERT_EQ(DescribeIncrementalCheck(checker, asts), DescribeFreshCheck(sources));
+    ASSERT_EQ(checker.NumCheckedDecls(), 0);
+
+    // Whitespace within a declaration moves only a part of it, so it is checked again.
+    apply_edit(2, "x * true", 1, "x  ");
+    ASSERT_EQ(DescribeIncrementalCheck(checker, asts), DescribeFreshCheck(sources));
+    ASSERT_EQ(checker.NumCheckedDecls(), 1);
+    ASSERT_EQ(checker.Diagnostics(2).size(), 1);
+}
+
+TEST(IncrementalChecker, RandomEdits)
+{
+    // Names and literals that are likely to change what a name resolves to or the type of something.
+    auto words = std::vector<std::string>{
+        "x", "y", "n", "v", "w", "p", "q", "p1", "k", "make", "wrap", "helper", "twice", "scale", "other",
+        "i32", "f32", "bool", "1", "2.0", "true",
+    };
+    auto declarations = std::vector<std::string>{
+        "p: struct = { z: i32; }\n",
+        "export helper: func = (n: i32) -> i32 { return n; }\n",
+        "twice: func = (n: bool) -> i32 { return 0; }\n",
+        "extra: func = () { v: p; v.x = 1; }\n",
+        "export q: struct = { p1: f32; }\n",
+    };
+    auto keywords = std::set<std::string>{"func", "struct", "return", "if", "export", "in", "out", "inout"};
+
+    auto random = std::mt19937(12345);
+    auto pick = [&](size_t size) { return std::uniform_int_distribution<size_t>(0, size - 1)(random); };
+
+    auto parsers = std::vector<IncrementalParser>{};
+    auto asts = std::vector<std::shared_ptr<IAbstractSyntaxTree>>{};
+    auto checker = IncrementalChecker();
+    for (const auto& source : IncrementalCheckerTestSources)
+    {
+        parsers.emplace_back(source);
+        asts.push_back(parsers.back().Parse());
+        checker.UpdateFile(asts.size() - 1, asts.back());
+    }
+
+    // Applies the edit to a file, and compares the checks once every file parses.
+    // Only the checks that get past the global symbols are counted.
+    auto num_compared = 0;
+    auto num_checked_decls = size_t{0};
+    auto num_reused_decls = size_t{0};
+    auto apply_edit = [&](size_t file_index, const TextEdit& edit) {
+        try
+        {
+            asts[file_index] = parsers[file_index].ApplyEdit(edit);
+            checker.UpdateFile(file_index, asts[file_index]);
+        }
+        catch (const std::exception&)
+        {
+            asts[file_index] = nullptr;
+        }
+        if (std::ranges::find(asts, nullptr) != asts.end())
+        {
+            return;
+        }
+
+        auto sources = std::vector<std::string>{};
+        for (const auto& parser : parsers)
+        {
+            sources.push_back(parser.SourceCode());
+        }
+        auto expected = DescribeFreshCheck(sources);
+        ASSERT_EQ(DescribeIncrementalCheck(checker, asts), expected) << sources[0] << sources[1] << sources[2];
+        if (!expected.starts_with("error: "))
+        {
+            ++num_compared;
+        }
+        num_checked_decls += checker.NumCheckedDecls();
+        num_reused_decls += checker.NumReusedDecls();
+    };
+
+    for (int step = 0; step < 1000; ++step)
+    {
+        auto file_index = pick(parsers.size());
+        auto source = parsers[file_index].SourceCode();
+
+        // Lines of declarations, after the module name and imports.
+        auto line_offsets = std::vector<size_t>{};
+        auto body_offset = size_t{0};
+        for (size_t offset = 0; offset < source.size();)
+        {
+            auto line_end = std::min(source.find('\n', offset), source.size() - 1) + 1;
+            if (source.compare(offset, 7, "module ") == 0 || source.compare(offset, 7, "import ") == 0)
+            {
+                body_offset = line_end;
+            }
+            else if (std::isalpha(source[offset]))
+            {
+                line_offsets.push_back(offset);
+            }
+            offset = line_end;
+        }
+        line_offsets.push_back(source.size());
+
+        if (step % 20 == 19)
+        {
+            // Start over from time to time, since the source code tends to get broken.
+            for (size_t i = 0; i < parsers.size(); ++i)
+            {
+                apply_edit(i, TextEdit{0, parsers[i].SourceCode().size(), IncrementalCheckerTestSources[i]});
+            }
+            continue;
+        }
+
+        auto edit = TextEdit{};
+        auto kind = random() % 8;
+        if (kind < 4)
+        {
+            // Replace a word.
+            auto word_offsets = std::vector<std::pair<size_t, size_t>>{};
+            for (size_t offset = body_offset; offset < source.size();)
+            {
+                auto length = size_t{0};
+                while (offset + length < source.size() && (std::isalnum(source[offset + length]) || source[offset + length] == '.'))
+                {
+                    ++length;
+                }
+                if (length > 0 && !keywords.contains(source.substr(offset, length)))
+                {
+                    word_offsets.emplace_back(offset, length);
+                }
+                offset += std::max(length, size_t{1});
+            }
+            if (word_offsets.empty())
+            {
+                continue;
+            }
+            auto [offset, length] = word_offsets[pick(word_offsets.size())];
+            edit = TextEdit{offset, length, words[pick(words.size())]};
+        }
+        else if (kind == 4)
+        {
+            // Toggle "export".
+            auto offset = line_offsets[pick(line_offsets.size())];
+            if (source.compare(offset, 7, "export ") == 0)
+            {
+                edit = TextEdit{offset, 7, ""};
+            }
+            else
+            {
+                edit = TextEdit{offset, 0, "export "};
+            }
+        }
+        else if (kind == 5)
+        {
+            // Move the declarations below a line.
+            edit = TextEdit{line_offsets[pick(line_offsets.size())], 0, "\n"};
+        }
+        else if (kind == 6)
+        {
+            edit = TextEdit{line_offsets[pick(line_offsets.size())], 0, declarations[pick(declarations.size())]};
+        }
+        else
+        {
+            // Remove a line, which may be a whole declaration.
+            auto offset = line_offsets[pick(line_offsets.size())];
+            auto line_end = std::min(source.find('\n', offset), source.size() - 1) + 1;
+            if (offset == source.size())
+            {
+                continue;
+            }
+            edit = TextEdit{offset, line_end - offset, ""};
+        }
+
+        auto undo = TextEdit{edit.offset, edit.replacement.size(), source.substr(edit.offset, edit.length)};
+        apply_edit(file_index, edit);
+
+        // Undo half of the edits to keep the source code mostly valid.
+        if (random() % 2 == 0)
+        {
+            apply_edit(file_index, undo);
+        }
+    }
+
+    ASSERT_GT(num_compared, 200);
+    ASSERT_GT(num_reused_decls, num_checked_decls);
+}
+
+TEST(ProgramEnvironment, FrozenAfterScanning)
+{
+    auto environment = ProgramEnvironment();
+    auto scanner = GlobalSymbolScanner(environment);
+    auto pass_manager = PassManager();
+    pass_manager.AddPass(scanner);
+
+    auto ast = GenerateAST("module a; f: func = () {}");
+    pass_manager.Run({ast.get()});
+
+    // Symbols can still be found, but nothing can be added.
+    ASSERT_TRUE(environment.IsFrozen());
+    ASSERT_TRUE(environment.TryFindSymbol("a", "f").has_value());
+    ASSERT_ANY_THROW(environment.OpenScope("a"));
+    ASSERT_ANY_THROW(environment.AddModuleDeclaration(static_cast<Module*>(ast.get())));
+}